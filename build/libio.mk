@@ -19,6 +19,7 @@ IO_SOURCES = \
 	$(IO_SRC_DIR)/CSVLine.cpp \
 	$(IO_SRC_DIR)/BatchTextWriter.cpp \
 	$(IO_SRC_DIR)/BinaryWriter.cpp \
+	$(IO_SRC_DIR)/AsyncTextWriter.cpp \
 	$(IO_SRC_DIR)/TextWriter.cpp
 
 IO_CPPFLAGS_INTERNAL = $(ZLIB_CPPFLAGS)
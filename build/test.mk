@@ -88,20 +88,24 @@ TEST_NAMES = \
 	TestWaypoints \
 	test_pressure \
 	test_task \
-	TestOverwritingRingBuffer \
+	TestOverwritingRingBuffer TestConcurrentRingBuffer \
 	TestDateTime TestRoughTime TestWrapClock \
 	TestMathTables \
+	TestSlopeShading \
 	TestAngle TestARange \
 	TestUnits TestEarth TestSunEphemeris \
 	TestValidity TestUTM TestProfile \
 	TestAllocatedGrid \
-	TestRadixTree TestGeoBounds TestGeoClip \
+	TestRadixTree TestRadixHeap TestGeoBounds TestGeoClip \
+	TestParallelJobRunner \
+	TestReachabilityTable \
 	TestLogger TestGRecord TestDriver TestClimbAvCalc \
 	TestWaypointReader TestThermalBase \
 	TestFlarmNet \
 	TestColorRamp TestGeoPoint TestDiffFilter \
 	TestFileUtil TestPolars TestCSVLine TestGlidePolar \
 	test_replay_task TestProjection TestFlatPoint TestFlatLine TestFlatGeoPoint \
+	TestPackedRTree TestPolygonSlabs \
 	TestMacCready TestOrderedTask TestAATPoint \
 	TestPlanes \
 	TestTaskPoint \
@@ -137,6 +141,12 @@ TEST_OVERWRITING_RING_BUFFER_SOURCES = \
 TEST_OVERWRITING_RING_BUFFER_DEPENDS = MATH
 $(eval $(call link-program,TestOverwritingRingBuffer,TEST_OVERWRITING_RING_BUFFER))
 
+TEST_CONCURRENT_RING_BUFFER_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestConcurrentRingBuffer.cpp
+TEST_CONCURRENT_RING_BUFFER_DEPENDS = THREAD MATH
+$(eval $(call link-program,TestConcurrentRingBuffer,TEST_CONCURRENT_RING_BUFFER))
+
 TEST_IGC_PARSER_SOURCES = \
 	$(SRC)/IGC/IGCParser.cpp \
 	$(TEST_SRC_DIR)/tap.c \
@@ -275,7 +285,7 @@ TEST_TROUTE_SOURCES = \
 	$(TEST_SRC_DIR)/Printing.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/test_troute.cpp
-TEST_TROUTE_DEPENDS = TERRAIN IO ZZIP OS ROUTE GLIDE GEO MATH UTIL
+TEST_TROUTE_DEPENDS = TERRAIN IO ZZIP OS THREAD ROUTE GLIDE GEO MATH UTIL
 $(eval $(call link-program,test_troute,TEST_TROUTE))
 
 TEST_REACH_SOURCES = \
@@ -284,7 +294,7 @@ TEST_REACH_SOURCES = \
 	$(TEST_SRC_DIR)/Printing.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/test_reach.cpp
-TEST_REACH_DEPENDS = TERRAIN IO ZZIP OS ROUTE GLIDE GEO MATH UTIL
+TEST_REACH_DEPENDS = TERRAIN IO ZZIP OS THREAD ROUTE GLIDE GEO MATH UTIL
 $(eval $(call link-program,test_reach,TEST_REACH))
 
 TEST_ROUTE_SOURCES = \
@@ -300,7 +310,7 @@ TEST_ROUTE_SOURCES = \
 	$(TEST_SRC_DIR)/harness_airspace.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/test_route.cpp
-TEST_ROUTE_DEPENDS = TERRAIN IO ZZIP OS ROUTE AIRSPACE GLIDE GEO MATH UTIL
+TEST_ROUTE_DEPENDS = TERRAIN IO ZZIP OS THREAD ROUTE AIRSPACE GLIDE GEO MATH UTIL
 $(eval $(call link-program,test_route,TEST_ROUTE))
 
 TEST_REPLAY_TASK_SOURCES = \
@@ -343,6 +353,13 @@ TEST_MATH_TABLES_SOURCES = \
 TEST_MATH_TABLES_DEPENDS = MATH
 $(eval $(call link-program,TestMathTables,TEST_MATH_TABLES))
 
+TEST_SLOPE_SHADING_SOURCES = \
+	$(SRC)/Terrain/SlopeShading.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestSlopeShading.cpp
+TEST_SLOPE_SHADING_DEPENDS = MATH
+$(eval $(call link-program,TestSlopeShading,TEST_SLOPE_SHADING))
+
 TEST_ANGLE_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestAngle.cpp
@@ -370,6 +387,7 @@ $(eval $(call link-program,TestGeoBounds,TEST_GEO_BOUNDS))
 
 TEST_FLARM_NET_SOURCES = \
 	$(SRC)/FLARM/FlarmNetReader.cpp \
+	$(SRC)/FLARM/FlarmNetCache.cpp \
 	$(SRC)/FLARM/FlarmId.cpp \
 	$(SRC)/FLARM/FlarmNetRecord.cpp \
 	$(SRC)/FLARM/FlarmNetDatabase.cpp \
@@ -525,6 +543,18 @@ TEST_FLAT_GEO_POINT_SOURCES = \
 TEST_FLAT_GEO_POINT_DEPENDS = GEO MATH
 $(eval $(call link-program,TestFlatGeoPoint,TEST_FLAT_GEO_POINT))
 
+TEST_PACKED_RTREE_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestPackedRTree.cpp
+TEST_PACKED_RTREE_DEPENDS = GEO MATH
+$(eval $(call link-program,TestPackedRTree,TEST_PACKED_RTREE))
+
+TEST_POLYGON_SLABS_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestPolygonSlabs.cpp
+TEST_POLYGON_SLABS_DEPENDS = GEO MATH
+$(eval $(call link-program,TestPolygonSlabs,TEST_POLYGON_SLABS))
+
 TEST_FLAT_LINE_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestFlatLine.cpp
@@ -582,6 +612,31 @@ TEST_RADIX_TREE_SOURCES = \
 TEST_RADIX_TREE_DEPENDS = UTIL
 $(eval $(call link-program,TestRadixTree,TEST_RADIX_TREE))
 
+TEST_RADIX_HEAP_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestRadixHeap.cpp
+$(eval $(call link-program,TestRadixHeap,TEST_RADIX_HEAP))
+
+TEST_REACHABILITY_TABLE_SOURCES = \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(SRC)/Task/ReachabilityTable.cpp \
+	$(SRC)/Task/RoutePlannerGlue.cpp \
+	$(SRC)/Airspace/ActivePredicate.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestReachabilityTable.cpp
+TEST_REACHABILITY_TABLE_DEPENDS = WAYPOINT ROUTE AIRSPACE TERRAIN IO ZZIP OS THREAD GLIDE GEO MATH UTIL
+$(eval $(call link-program,TestReachabilityTable,TEST_REACHABILITY_TABLE))
+
+TEST_PARALLEL_JOB_RUNNER_SOURCES = \
+	$(SRC)/Job/Parallel.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestParallelJobRunner.cpp
+TEST_PARALLEL_JOB_RUNNER_DEPENDS = THREAD OS UTIL
+$(eval $(call link-program,TestParallelJobRunner,TEST_PARALLEL_JOB_RUNNER))
+
 TEST_LOGGER_SOURCES = \
 	$(SRC)/IGC/IGCFix.cpp \
 	$(SRC)/IGC/IGCWriter.cpp \
@@ -597,7 +652,7 @@ TEST_LOGGER_SOURCES = \
 	$(SRC)/Atmosphere/Pressure.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestLogger.cpp
-TEST_LOGGER_DEPENDS = IO OS GEO MATH UTIL
+TEST_LOGGER_DEPENDS = IO OS THREAD TIME GEO MATH UTIL
 $(eval $(call link-program,TestLogger,TEST_LOGGER))
 
 TEST_GRECORD_SOURCES = \
@@ -702,7 +757,16 @@ DEBUG_PROGRAM_NAMES = \
 	RunWaveComputer \
 	FlightPath \
 	BenchmarkProjection \
+	BenchmarkAbortTask \
+	BenchmarkHeights \
+	BenchmarkTerrainHeight \
 	BenchmarkFAITriangleSector \
+	BenchmarkContest BenchmarkTrace \
+	BenchmarkDijkstra \
+	BenchmarkAirspaces BenchmarkLoadCache \
+	BenchmarkDeviceMerge BenchmarkNMEA \
+	BenchmarkFlarmNet \
+	BenchmarkTopography \
 	DumpTextFile DumpTextZip DumpTextInflate WriteTextFile RunTextWriter \
 	DumpHexColor \
 	RunXMLParser \
@@ -714,6 +778,7 @@ DEBUG_PROGRAM_NAMES = \
 	KeyCodeDumper \
 	LoadTopography LoadTerrain \
 	RunHeightMatrix \
+	TestTerrainScroll \
 	RunInputParser \
 	RunWaypointParser RunAirspaceParser \
 	RunFlightParser \
@@ -728,6 +793,7 @@ DEBUG_PROGRAM_NAMES = \
 	RunCirclingWind RunWindEKF RunWindComputer \
 	RunExternalWind \
 	RunTask \
+	RunAirspaceWarning \
 	LoadImage ViewImage \
 	RunCanvas RunMapWindow \
 	RunListControl \
@@ -849,10 +915,26 @@ DEBUG_REPLAY_LDADD = \
 BENCHMARK_PROJECTION_SOURCES = \
 	$(SRC)/Projection/Projection.cpp \
 	$(TEST_SRC_DIR)/BenchmarkProjection.cpp
-BENCHMARK_PROJECTION_DEPENDS = MATH
+BENCHMARK_PROJECTION_DEPENDS = OS MATH
 BENCHMARK_PROJECTION_CPPFLAGS = $(SCREEN_CPPFLAGS)
 $(eval $(call link-program,BenchmarkProjection,BENCHMARK_PROJECTION))
 
+$(eval $(call link-harness-program,BenchmarkAbortTask))
+
+BENCHMARK_HEIGHTS_SOURCES = \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/BenchmarkHeights.cpp
+BENCHMARK_HEIGHTS_CPPFLAGS = $(SCREEN_CPPFLAGS)
+BENCHMARK_HEIGHTS_DEPENDS = TERRAIN GEO MATH IO OS THREAD TIME ZZIP UTIL
+$(eval $(call link-program,BenchmarkHeights,BENCHMARK_HEIGHTS))
+
+BENCHMARK_TERRAIN_HEIGHT_SOURCES = \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/BenchmarkTerrainHeight.cpp
+BENCHMARK_TERRAIN_HEIGHT_CPPFLAGS = $(SCREEN_CPPFLAGS)
+BENCHMARK_TERRAIN_HEIGHT_DEPENDS = TERRAIN GEO MATH IO OS THREAD TIME ZZIP UTIL
+$(eval $(call link-program,BenchmarkTerrainHeight,BENCHMARK_TERRAIN_HEIGHT))
+
 BENCHMARK_FAI_TRIANGLE_SECTOR_SOURCES = \
 	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleSettings.cpp \
 	$(ENGINE_SRC_DIR)/Task/Shapes/FAITriangleArea.cpp \
@@ -1061,6 +1143,7 @@ $(eval $(call link-program,KeyCodeDumper,KEY_CODE_DUMPER))
 LOAD_TOPOGRAPHY_SOURCES = \
 	$(SRC)/Topography/TopographyStore.cpp \
 	$(SRC)/Topography/TopographyFile.cpp \
+	$(SRC)/Topography/TopographyCache.cpp \
 	$(SRC)/Topography/XShape.cpp \
 	$(SRC)/Projection/Projection.cpp \
 	$(SRC)/Projection/WindowProjection.cpp \
@@ -1070,15 +1153,32 @@ ifeq ($(OPENGL),y)
 LOAD_TOPOGRAPHY_SOURCES += \
 	$(SCREEN_SRC_DIR)/OpenGL/Triangulate.cpp
 endif
-LOAD_TOPOGRAPHY_DEPENDS = RESOURCE GEO MATH THREAD IO UTIL SHAPELIB ZZIP
+LOAD_TOPOGRAPHY_DEPENDS = RESOURCE GEO MATH THREAD IO OS UTIL SHAPELIB ZZIP
 LOAD_TOPOGRAPHY_CPPFLAGS = $(SCREEN_CPPFLAGS)
 $(eval $(call link-program,LoadTopography,LOAD_TOPOGRAPHY))
 
+BENCHMARK_TOPOGRAPHY_SOURCES = \
+	$(SRC)/Topography/TopographyStore.cpp \
+	$(SRC)/Topography/TopographyFile.cpp \
+	$(SRC)/Topography/TopographyCache.cpp \
+	$(SRC)/Topography/XShape.cpp \
+	$(SRC)/Projection/Projection.cpp \
+	$(SRC)/Projection/WindowProjection.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/BenchmarkTopography.cpp
+ifeq ($(OPENGL),y)
+BENCHMARK_TOPOGRAPHY_SOURCES += \
+	$(SCREEN_SRC_DIR)/OpenGL/Triangulate.cpp
+endif
+BENCHMARK_TOPOGRAPHY_DEPENDS = RESOURCE GEO MATH THREAD IO OS UTIL SHAPELIB ZZIP
+BENCHMARK_TOPOGRAPHY_CPPFLAGS = $(SCREEN_CPPFLAGS)
+$(eval $(call link-program,BenchmarkTopography,BENCHMARK_TOPOGRAPHY))
+
 LOAD_TERRAIN_SOURCES = \
 	$(SRC)/Operation/Operation.cpp \
 	$(TEST_SRC_DIR)/LoadTerrain.cpp
 LOAD_TERRAIN_CPPFLAGS = $(SCREEN_CPPFLAGS)
-LOAD_TERRAIN_DEPENDS = TERRAIN GEO MATH IO OS ZZIP UTIL
+LOAD_TERRAIN_DEPENDS = TERRAIN GEO MATH IO OS THREAD ZZIP UTIL
 $(eval $(call link-program,LoadTerrain,LOAD_TERRAIN))
 
 RUN_HEIGHT_MATRIX_SOURCES = \
@@ -1087,9 +1187,21 @@ RUN_HEIGHT_MATRIX_SOURCES = \
 	$(SRC)/Operation/Operation.cpp \
 	$(TEST_SRC_DIR)/RunHeightMatrix.cpp
 RUN_HEIGHT_MATRIX_CPPFLAGS = $(SCREEN_CPPFLAGS)
-RUN_HEIGHT_MATRIX_DEPENDS = TERRAIN GEO MATH IO OS ZZIP UTIL
+RUN_HEIGHT_MATRIX_DEPENDS = TERRAIN GEO MATH IO OS THREAD ZZIP UTIL
 $(eval $(call link-program,RunHeightMatrix,RUN_HEIGHT_MATRIX))
 
+TEST_TERRAIN_SCROLL_SOURCES = \
+	$(SRC)/Projection/Projection.cpp \
+	$(SRC)/Projection/WindowProjection.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/Event/Idle.cpp \
+	$(SRC)/Screen/Ramp.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTerrainScroll.cpp
+TEST_TERRAIN_SCROLL_CPPFLAGS = $(SCREEN_CPPFLAGS)
+TEST_TERRAIN_SCROLL_DEPENDS = TERRAIN SCREEN GEO MATH IO OS THREAD ZZIP UTIL
+$(eval $(call link-program,TestTerrainScroll,TEST_TERRAIN_SCROLL))
+
 RUN_INPUT_PARSER_SOURCES = \
 	$(SRC)/Input/InputKeys.cpp \
 	$(SRC)/Input/InputConfig.cpp \
@@ -1164,6 +1276,46 @@ RUN_AIRSPACE_PARSER_LDADD = $(FAKE_LIBS)
 RUN_AIRSPACE_PARSER_DEPENDS = IO OS AIRSPACE ZZIP GEO MATH UTIL
 $(eval $(call link-program,RunAirspaceParser,RUN_AIRSPACE_PARSER))
 
+BENCHMARK_AIRSPACES_SOURCES = \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/FakeLanguage.cpp \
+	$(TEST_SRC_DIR)/BenchmarkAirspaces.cpp
+BENCHMARK_AIRSPACES_LDADD = $(FAKE_LIBS)
+BENCHMARK_AIRSPACES_DEPENDS = IO OS AIRSPACE ZZIP GEO MATH TIME UTIL
+$(eval $(call link-program,BenchmarkAirspaces,BENCHMARK_AIRSPACES))
+
+BENCHMARK_LOAD_CACHE_SOURCES = \
+	$(SRC)/Waypoint/WaypointCache.cpp \
+	$(SRC)/Waypoint/WaypointFileType.cpp \
+	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/Waypoint/WaypointReader.cpp \
+	$(SRC)/Waypoint/WaypointReaderWinPilot.cpp \
+	$(SRC)/Waypoint/WaypointReaderFS.cpp \
+	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
+	$(SRC)/Waypoint/WaypointReaderSeeYou.cpp \
+	$(SRC)/Waypoint/WaypointReaderZander.cpp \
+	$(SRC)/Waypoint/WaypointReaderCompeGPS.cpp \
+	$(SRC)/Waypoint/WaypointWriter.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/Compatibility/fmode.c \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/FakeLanguage.cpp \
+	$(TEST_SRC_DIR)/BenchmarkLoadCache.cpp
+BENCHMARK_LOAD_CACHE_LDADD = $(FAKE_LIBS)
+BENCHMARK_LOAD_CACHE_DEPENDS = WAYPOINT AIRSPACE IO OS THREAD ZZIP GEO MATH TIME UTIL
+$(eval $(call link-program,BenchmarkLoadCache,BENCHMARK_LOAD_CACHE))
+
 ENUMERATE_PORTS_SOURCES = \
 	$(TEST_SRC_DIR)/EnumeratePorts.cpp
 ENUMERATE_PORTS_DEPENDS = PORT
@@ -1209,6 +1361,64 @@ LOG_PORT_SOURCES = \
 LOG_PORT_DEPENDS = PORT ASYNC LIBNET OS THREAD UTIL
 $(eval $(call link-program,LogPort,LOG_PORT))
 
+BENCHMARK_DEVICE_MERGE_SOURCES = \
+	$(SRC)/Device/Descriptor.cpp \
+	$(SRC)/Device/MultipleDevices.cpp \
+	$(SRC)/Device/Dispatcher.cpp \
+	$(SRC)/Device/Parser.cpp \
+	$(SRC)/Device/Simulator.cpp \
+	$(SRC)/Device/Port/Port.cpp \
+	$(SRC)/Device/Port/DumpPort.cpp \
+	$(SRC)/Device/Util/LineSplitter.cpp \
+	$(SRC)/Device/Util/NMEAWriter.cpp \
+	$(SRC)/Device/Util/NMEAReader.cpp \
+	$(SRC)/Device/Config.cpp \
+	$(SRC)/Blackboard/DeviceBlackboard.cpp \
+	$(SRC)/Simulator.cpp \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/IGC/Generator.cpp \
+	$(SRC)/FLARM/FlarmId.cpp \
+	$(SRC)/FLARM/Traffic.cpp \
+	$(SRC)/FLARM/List.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/NMEA/Info.cpp \
+	$(SRC)/NMEA/MoreData.cpp \
+	$(SRC)/NMEA/Acceleration.cpp \
+	$(SRC)/NMEA/Attitude.cpp \
+	$(SRC)/NMEA/ExternalSettings.cpp \
+	$(SRC)/NMEA/SwitchState.cpp \
+	$(SRC)/NMEA/InputLine.cpp \
+	$(SRC)/NMEA/Checksum.cpp \
+	$(SRC)/NMEA/Derived.cpp \
+	$(SRC)/NMEA/VarioInfo.cpp \
+	$(SRC)/NMEA/ClimbInfo.cpp \
+	$(SRC)/NMEA/ClimbHistory.cpp \
+	$(SRC)/NMEA/CirclingInfo.cpp \
+	$(SRC)/NMEA/ThermalBand.cpp \
+	$(SRC)/NMEA/ThermalLocator.cpp \
+	$(SRC)/NMEA/FlyingState.cpp \
+	$(SRC)/Engine/Navigation/TraceHistory.cpp \
+	$(SRC)/Engine/GlideSolvers/GlidePolar.cpp \
+	$(SRC)/Engine/GlideSolvers/PolarCoefficients.cpp \
+	$(SRC)/Engine/GlideSolvers/GlideResult.cpp \
+	$(SRC)/Engine/Task/Stats/TaskStats.cpp \
+	$(SRC)/Engine/Task/Stats/CommonStats.cpp \
+	$(SRC)/Engine/Task/Stats/ElementStat.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/Operation/ProxyOperationEnvironment.cpp \
+	$(SRC)/Operation/NoCancelOperationEnvironment.cpp \
+	$(SRC)/Atmosphere/AirDensity.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(TEST_SRC_DIR)/FakeMessage.cpp \
+	$(TEST_SRC_DIR)/FakeNMEALogger.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/FakeLanguage.cpp \
+	$(TEST_SRC_DIR)/FakeGeoid.cpp \
+	$(TEST_SRC_DIR)/BenchmarkDeviceMerge.cpp
+BENCHMARK_DEVICE_MERGE_DEPENDS = DRIVER IO OS THREAD GEO MATH UTIL TIME
+$(eval $(call link-program,BenchmarkDeviceMerge,BENCHMARK_DEVICE_MERGE))
+
 RUN_DEVICE_DRIVER_SOURCES = \
 	$(SRC)/FLARM/FlarmId.cpp \
 	$(SRC)/Units/Descriptor.cpp \
@@ -1244,6 +1454,12 @@ RUN_DEVICE_DRIVER_SOURCES = \
 RUN_DEVICE_DRIVER_DEPENDS = DRIVER IO OS THREAD GEO MATH UTIL TIME
 $(eval $(call link-program,RunDeviceDriver,RUN_DEVICE_DRIVER))
 
+BENCHMARK_NMEA_SOURCES = \
+	$(filter-out %/RunDeviceDriver.cpp,$(RUN_DEVICE_DRIVER_SOURCES)) \
+	$(TEST_SRC_DIR)/BenchmarkNMEA.cpp
+BENCHMARK_NMEA_DEPENDS = $(RUN_DEVICE_DRIVER_DEPENDS)
+$(eval $(call link-program,BenchmarkNMEA,BENCHMARK_NMEA))
+
 RUN_DECLARE_SOURCES = \
 	$(SRC)/Device/Port/ConfiguredPort.cpp \
 	$(SRC)/Units/Descriptor.cpp \
@@ -1492,7 +1708,7 @@ RUN_IGC_WRITER_SOURCES = \
 	$(SRC)/Operation/Operation.cpp \
 	$(TEST_SRC_DIR)/RunIGCWriter.cpp
 RUN_IGC_WRITER_LDADD = $(DEBUG_REPLAY_LDADD)
-RUN_IGC_WRITER_DEPENDS = GEO MATH UTIL TIME
+RUN_IGC_WRITER_DEPENDS = IO OS THREAD GEO MATH UTIL TIME
 $(eval $(call link-program,RunIGCWriter,RUN_IGC_WRITER))
 
 RUN_FLIGHT_LOGGER_SOURCES = \
@@ -1513,6 +1729,17 @@ RUN_FLYING_COMPUTER_LDADD = $(DEBUG_REPLAY_LDADD)
 RUN_FLYING_COMPUTER_DEPENDS = GEO MATH UTIL TIME
 $(eval $(call link-program,RunFlyingComputer,RUN_FLYING_COMPUTER))
 
+RUN_AIRSPACE_WARNING_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/Formatter/TimeFormatter.cpp \
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/RunAirspaceWarning.cpp
+RUN_AIRSPACE_WARNING_LDADD = $(DEBUG_REPLAY_LDADD)
+RUN_AIRSPACE_WARNING_DEPENDS = AIRSPACE IO OS ZZIP GEO MATH UTIL TIME
+$(eval $(call link-program,RunAirspaceWarning,RUN_AIRSPACE_WARNING))
+
 RUN_CIRCLING_WIND_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/Formatter/TimeFormatter.cpp \
@@ -1610,6 +1837,37 @@ RUN_OLC_LDADD = $(DEBUG_REPLAY_LDADD)
 RUN_OLC_DEPENDS = CONTEST UTIL GEO MATH TIME
 $(eval $(call link-program,RunOLCAnalysis,RUN_OLC))
 
+BENCHMARK_CONTEST_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(SRC)/Computer/ContestSolverThread.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/BenchmarkContest.cpp
+BENCHMARK_CONTEST_LDADD = $(DEBUG_REPLAY_LDADD)
+BENCHMARK_CONTEST_DEPENDS = CONTEST UTIL GEO MATH TIME THREAD
+$(eval $(call link-program,BenchmarkContest,BENCHMARK_CONTEST))
+
+BENCHMARK_TRACE_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
+	$(TEST_SRC_DIR)/BenchmarkTrace.cpp
+BENCHMARK_TRACE_LDADD = $(DEBUG_REPLAY_LDADD)
+BENCHMARK_TRACE_DEPENDS = UTIL GEO MATH TIME OS
+$(eval $(call link-program,BenchmarkTrace,BENCHMARK_TRACE))
+
+BENCHMARK_DIJKSTRA_SOURCES = \
+	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
+	$(TEST_SRC_DIR)/BenchmarkDijkstra.cpp
+BENCHMARK_DIJKSTRA_DEPENDS = CONTEST TASK GEO MATH TIME OS UTIL
+$(eval $(call link-program,BenchmarkDijkstra,BENCHMARK_DIJKSTRA))
+
 RUN_WAVE_COMPUTER_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/Computer/WaveComputer.cpp \
@@ -1720,6 +1978,8 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Renderer/TransparentRendererCache.cpp \
 	$(SRC)/Renderer/AirspaceRendererSettings.cpp \
 	$(SRC)/Renderer/BackgroundRenderer.cpp \
+	$(SRC)/Terrain/RenderThread.cpp \
+	$(SRC)/Terrain/Thread.cpp \
 	$(SRC)/Renderer/MarkerRenderer.cpp \
 	$(SRC)/LocalPath.cpp \
 	$(SRC)/Projection/Projection.cpp \
@@ -1797,7 +2057,9 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Task/ProtectedTaskManager.cpp \
 	$(SRC)/Task/ProtectedRoutePlanner.cpp \
 	$(SRC)/Task/RoutePlannerGlue.cpp \
+	$(SRC)/Task/ReachabilityTable.cpp \
 	$(SRC)/Topography/TopographyFile.cpp \
+	$(SRC)/Topography/TopographyCache.cpp \
 	$(SRC)/Topography/TopographyStore.cpp \
 	$(SRC)/Topography/Thread.cpp \
 	$(SRC)/Topography/TopographyFileRenderer.cpp \
@@ -1828,6 +2090,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Waypoint/LastUsed.cpp \
 	$(SRC)/Waypoint/WaypointFileType.cpp \
 	$(SRC)/Waypoint/WaypointGlue.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/WaypointReader.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
 	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
@@ -2161,6 +2424,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Task/ProtectedTaskManager.cpp \
 	$(SRC)/Task/ProtectedRoutePlanner.cpp \
 	$(SRC)/Task/RoutePlannerGlue.cpp \
+	$(SRC)/Task/ReachabilityTable.cpp \
 	$(SRC)/Task/TaskFile.cpp \
 	$(SRC)/Task/TaskFileXCSoar.cpp \
 	$(SRC)/Task/TaskFileSeeYou.cpp \
@@ -2231,6 +2495,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Computer/Wind/Computer.cpp \
 	$(SRC)/Computer/Wind/Settings.cpp \
 	$(SRC)/Computer/ContestComputer.cpp \
+	$(SRC)/Computer/ContestSolverThread.cpp \
 	$(SRC)/Computer/TraceComputer.cpp \
 	$(SRC)/Computer/WarningComputer.cpp \
 	$(SRC)/Computer/LiftDatabaseComputer.cpp \
@@ -2269,6 +2534,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
 	$(SRC)/Airspace/AirspaceParser.cpp \
 	$(SRC)/Airspace/AirspaceGlue.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Airspace/AirspaceVisibility.cpp \
 	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
 	$(SRC)/Renderer/AirspaceRendererSettings.cpp \
@@ -2411,6 +2677,7 @@ RUN_TASK_EDITOR_DIALOG_SOURCES = \
 	$(SRC)/Formatter/Units.cpp \
 	$(SRC)/Waypoint/WaypointFileType.cpp \
 	$(SRC)/Waypoint/WaypointGlue.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
 	$(SRC)/Waypoint/WaypointReader.cpp \
 	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
@@ -2549,6 +2816,16 @@ DUMP_FLARM_NET_SOURCES = \
 DUMP_FLARM_NET_DEPENDS = IO OS MATH UTIL
 $(eval $(call link-program,DumpFlarmNet,DUMP_FLARM_NET))
 
+BENCHMARK_FLARM_NET_SOURCES = \
+	$(SRC)/FLARM/FlarmNetReader.cpp \
+	$(SRC)/FLARM/FlarmNetCache.cpp \
+	$(SRC)/FLARM/FlarmId.cpp \
+	$(SRC)/FLARM/FlarmNetRecord.cpp \
+	$(SRC)/FLARM/FlarmNetDatabase.cpp \
+	$(TEST_SRC_DIR)/BenchmarkFlarmNet.cpp
+BENCHMARK_FLARM_NET_DEPENDS = IO OS MATH UTIL
+$(eval $(call link-program,BenchmarkFlarmNet,BENCHMARK_FLARM_NET))
+
 IGC2NMEA_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(TEST_SRC_DIR)/IGC2NMEA.cpp
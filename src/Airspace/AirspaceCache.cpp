@@ -0,0 +1,210 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "AirspaceCache.hpp"
+#include "Airspace/Airspaces.hpp"
+#include "Airspace/AirspacePolygon.hpp"
+#include "Airspace/AirspaceCircle.hpp"
+#include "IO/FileCache.hpp"
+#include "IO/CacheWriter.hpp"
+#include "IO/CacheReader.hpp"
+#include "OS/FileMapping.hpp"
+
+#include <memory>
+#include <vector>
+
+#include <string.h>
+
+/**
+ * The format version passed to FileCache::SaveMapped().
+ */
+static constexpr unsigned VERSION = 2;
+
+struct AirspaceCacheHeader {
+  /**
+   * Catch builds with a different #fixed implementation.
+   */
+  unsigned fixed_size;
+
+  unsigned n_airspaces;
+};
+
+static void
+WriteAirspace(CacheWriter &writer, const AbstractAirspace &as)
+{
+  const AbstractAirspace::Shape shape = as.GetShape();
+  writer.Write(shape);
+  writer.Write(as.GetType());
+  writer.Write(as.GetBase());
+  writer.Write(as.GetTop());
+  writer.Write(as.GetDays());
+  writer.WriteString(as.GetName(), _tcslen(as.GetName()));
+  writer.WriteString(as.GetRadioText());
+
+  switch (shape) {
+  case AbstractAirspace::Shape::CIRCLE: {
+    const AirspaceCircle &circle = (const AirspaceCircle &)as;
+    writer.Write(circle.GetCenter());
+    writer.Write(circle.GetRadius());
+    break;
+  }
+
+  case AbstractAirspace::Shape::POLYGON: {
+    const SearchPointVector &border = as.GetPoints();
+    const uint32_t n = border.size();
+    writer.Write(n);
+    for (const auto &i : border)
+      writer.Write(i.GetLocation());
+
+    /* the edge index is built from geographic coordinates; it does
+       not depend on the projection of the #Airspaces object */
+    ((const AirspacePolygon &)as).GetSlabs().Save(writer);
+    break;
+  }
+  }
+}
+
+static AbstractAirspace *
+ReadAirspace(CacheReader &reader, std::vector<GeoPoint> &points)
+{
+  AbstractAirspace::Shape shape;
+  AirspaceClass type;
+  AirspaceAltitude base, top;
+  AirspaceActivity days;
+  tstring name, radio;
+  if (!reader.Read(shape) || !reader.Read(type) ||
+      !reader.Read(base) || !reader.Read(top) || !reader.Read(days) ||
+      !reader.ReadString(name) || !reader.ReadString(radio))
+    return nullptr;
+
+  AbstractAirspace *as;
+  switch (shape) {
+  case AbstractAirspace::Shape::CIRCLE: {
+    GeoPoint center;
+    fixed radius;
+    if (!reader.Read(center) || !reader.Read(radius))
+      return nullptr;
+
+    as = new AirspaceCircle(center, radius);
+    break;
+  }
+
+  case AbstractAirspace::Shape::POLYGON: {
+    uint32_t n;
+    if (!reader.Read(n) || n < 3)
+      return nullptr;
+
+    const void *src = reader.ReadArray(n, sizeof(GeoPoint));
+    if (src == nullptr)
+      return nullptr;
+
+    points.resize(n);
+    memcpy(points.data(), src, n * sizeof(GeoPoint));
+
+    AirspacePolygon *polygon = new AirspacePolygon(points);
+    if (!polygon->GetSlabs().Load(reader, polygon->GetPoints())) {
+      delete polygon;
+      return nullptr;
+    }
+
+    as = polygon;
+    break;
+  }
+
+  default:
+    return nullptr;
+  }
+
+  as->SetProperties(std::move(name), type, base, top);
+  as->SetRadio(radio);
+  as->SetDays(days);
+  return as;
+}
+
+bool
+AirspaceCache::Load(FileCache &cache, const TCHAR *name, const TCHAR *path,
+                    Airspaces &airspaces)
+{
+  size_t offset;
+  const std::unique_ptr<FileMapping> mapping =
+    cache.LoadMapped(name, path, VERSION, offset);
+  if (!mapping)
+    return false;
+
+  CacheReader reader(mapping->at(offset), mapping->end());
+
+  AirspaceCacheHeader header;
+  if (!reader.Read(header) ||
+      header.fixed_size != sizeof(fixed) ||
+      /* each airspace takes at least as much as its center */
+      header.n_airspaces > mapping->size() / sizeof(GeoPoint))
+    return false;
+
+  /* decode everything before adding the first airspace, to be able
+     to fall back to parsing the file cleanly */
+  std::vector<std::unique_ptr<AbstractAirspace>> result;
+  result.reserve(header.n_airspaces);
+
+  std::vector<GeoPoint> points;
+  for (unsigned i = 0; i < header.n_airspaces; ++i) {
+    AbstractAirspace *as = ReadAirspace(reader, points);
+    if (as == nullptr)
+      return false;
+
+    result.emplace_back(as);
+  }
+
+  if (!reader.IsEnd())
+    return false;
+
+  for (auto &as : result)
+    airspaces.Add(as.release());
+
+  return true;
+}
+
+bool
+AirspaceCache::Save(FileCache &cache, const TCHAR *name, const TCHAR *path,
+                    const Airspaces &airspaces)
+{
+  FILE *file = cache.SaveMapped(name, path, VERSION);
+  if (file == nullptr)
+    return false;
+
+  AirspaceCacheHeader header;
+  header.fixed_size = sizeof(fixed);
+  header.n_airspaces = airspaces.GetSize();
+
+  CacheWriter writer(file);
+  writer.Write(header);
+
+  for (const auto &i : airspaces)
+    WriteAirspace(writer, i.GetAirspace());
+
+  if (writer.HasError()) {
+    cache.Cancel(name, file);
+    return false;
+  }
+
+  return cache.Commit(name, file);
+}
@@ -0,0 +1,57 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_AIRSPACE_CACHE_HPP
+#define XCSOAR_AIRSPACE_CACHE_HPP
+
+#include <tchar.h>
+
+class FileCache;
+class Airspaces;
+
+/**
+ * A binary snapshot of a parsed airspace file, stored in the
+ * #FileCache.  It is invalidated when the airspace file changes.
+ * Flight levels and ground levels are not part of the snapshot; they
+ * are applied after loading, just like after parsing.
+ */
+namespace AirspaceCache {
+  /**
+   * Add the airspaces of the specified file from its snapshot.
+   *
+   * @param name the name of the cache file
+   * @return true on success, false if there is no valid snapshot
+   * (nothing has been added then)
+   */
+  bool Load(FileCache &cache, const TCHAR *name, const TCHAR *path,
+            Airspaces &airspaces);
+
+  /**
+   * Save all airspaces of the given (optimised) object, which
+   * contains just the airspaces parsed from the specified file.
+   */
+  bool Save(FileCache &cache, const TCHAR *name, const TCHAR *path,
+            const Airspaces &airspaces);
+}
+
+#endif
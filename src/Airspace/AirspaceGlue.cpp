@@ -23,6 +23,8 @@ Copyright_License {
 
 #include "Airspace/AirspaceGlue.hpp"
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceCache.hpp"
+#include "IO/FileCache.hpp"
 #include "Engine/Airspace/Airspaces.hpp"
 #include "Profile/ProfileKeys.hpp"
 #include "Operation/Operation.hpp"
@@ -38,7 +40,7 @@ Copyright_License {
 #include <string.h>
 
 static bool
-ParseAirspaceFile(AirspaceParser &parser, const TCHAR *path,
+ParseAirspaceFile(Airspaces &airspaces, const TCHAR *path,
                   OperationEnvironment &operation)
 {
   std::unique_ptr<TLineReader> reader(OpenTextFile(path, Charset::AUTO));
@@ -47,6 +49,7 @@ ParseAirspaceFile(AirspaceParser &parser, const TCHAR *path,
     return false;
   }
 
+  AirspaceParser parser(airspaces);
   if (!parser.Parse(*reader, operation)) {
     LogFormat(_T("Failed to parse airspace file: %s"), path);
     return false;
@@ -55,9 +58,44 @@ ParseAirspaceFile(AirspaceParser &parser, const TCHAR *path,
   return true;
 }
 
+/**
+ * Load an airspace file, preferring its snapshot in the #FileCache.
+ *
+ * @param cache_name the name of the snapshot; each file slot has its
+ * own
+ */
+static bool
+LoadAirspaceFile(Airspaces &airspaces, const TCHAR *path,
+                 FileCache *cache, const TCHAR *cache_name,
+                 OperationEnvironment &operation)
+{
+  if (cache == nullptr || !FileCache::IsCacheable(path))
+    return ParseAirspaceFile(airspaces, path, operation);
+
+  if (AirspaceCache::Load(*cache, cache_name, path, airspaces))
+    return true;
+
+  /* parse into a separate object, which can then be saved as a
+     whole */
+  Airspaces parsed;
+  const bool success = ParseAirspaceFile(parsed, path, operation);
+  if (success) {
+    parsed.Optimise();
+
+    if (!AirspaceCache::Save(*cache, cache_name, path, parsed))
+      LogFormat(_T("Failed to save airspace cache: %s"), cache_name);
+  }
+
+  /* this also keeps the airspaces parsed before an error, as without
+     a cache */
+  airspaces.MoveFrom(parsed);
+  return success;
+}
+
 void
 ReadAirspace(Airspaces &airspaces,
              RasterTerrain *terrain,
+             FileCache *cache,
              const AtmosphericPressure &press,
              OperationEnvironment &operation)
 {
@@ -66,19 +104,20 @@ ReadAirspace(Airspaces &airspaces,
 
   bool airspace_ok = false;
 
-  AirspaceParser parser(airspaces);
-
   // Read the airspace filenames from the registry
   TCHAR path[MAX_PATH];
   if (Profile::GetPath(ProfileKeys::AirspaceFile, path))
-    airspace_ok |= ParseAirspaceFile(parser, path, operation);
+    airspace_ok |= LoadAirspaceFile(airspaces, path, cache, _T("airspace1"),
+                                    operation);
 
   if (Profile::GetPath(ProfileKeys::AdditionalAirspaceFile, path))
-    airspace_ok |= ParseAirspaceFile(parser, path, operation);
+    airspace_ok |= LoadAirspaceFile(airspaces, path, cache, _T("airspace2"),
+                                    operation);
 
   if (Profile::GetPath(ProfileKeys::MapFile, path)) {
     _tcscat(path, _T("/airspace.txt"));
-    airspace_ok |= ParseAirspaceFile(parser, path, operation);
+    airspace_ok |= LoadAirspaceFile(airspaces, path, cache, _T("airspace0"),
+                                    operation);
   }
 
   if (airspace_ok) {
@@ -25,16 +25,21 @@ Copyright_License {
 #define XCSOAR_AIRSPACE_GLUE_HPP
 
 class RasterTerrain;
+class FileCache;
 class AtmosphericPressure;
 class Airspaces;
 class OperationEnvironment;
 
 /**
  * Reads the airspace files into the memory
+ *
+ * @param cache an optional #FileCache for binary snapshots of the
+ * parsed files
  */
 void
 ReadAirspace(Airspaces &airspaces,
              RasterTerrain *terrain,
+             FileCache *cache,
              const AtmosphericPressure &press,
              OperationEnvironment &operation);
 
@@ -69,10 +69,18 @@ DeviceBlackboard::SetStartupLocation(const GeoPoint &loc, const fixed alt)
   if (Calculated().flight.flying)
     return;
 
-  for (unsigned i = 0; i < unsigned(NUMDEV); ++i)
+  for (unsigned i = 0; i < unsigned(NUMDEV); ++i) {
     if (!per_device_data[i].location_available)
       per_device_data[i].SetFakeLocation(loc, alt);
 
+    /* the parser's copy would overwrite it on the next update */
+    ParsedState &parsed = parsed_state[i];
+    ScopeLock protect2(parsed.mutex);
+    parsed.fake_location_pending = true;
+    parsed.fake_location = loc;
+    parsed.fake_altitude = alt;
+  }
+
   if (!real_data.location_available)
     real_data.SetFakeLocation(loc, alt);
 
@@ -218,6 +226,41 @@ DeviceBlackboard::ExpireWallClock()
     ScheduleMerge();
 }
 
+void
+DeviceBlackboard::ResetRealState(unsigned i)
+{
+  assert(i < NUMDEV);
+
+  per_device_data[i].Reset();
+
+  ParsedState &parsed = parsed_state[i];
+  ScopeLock protect(parsed.mutex);
+  parsed.modified = false;
+  parsed.fake_location_pending = false;
+}
+
+void
+DeviceBlackboard::PublishParsedState(unsigned i, NMEAInfo &data)
+{
+  assert(i < NUMDEV);
+
+  {
+    ParsedState &parsed = parsed_state[i];
+    ScopeLock protect(parsed.mutex);
+
+    if (parsed.fake_location_pending) {
+      parsed.fake_location_pending = false;
+      if (!data.location_available)
+        data.SetFakeLocation(parsed.fake_location, parsed.fake_altitude);
+    }
+
+    parsed.data = data;
+    parsed.modified = true;
+  }
+
+  ScheduleMerge();
+}
+
 void
 DeviceBlackboard::ScheduleMerge()
 {
@@ -231,6 +274,14 @@ DeviceBlackboard::Merge()
 
   real_data.Reset();
   for (unsigned i = 0; i < unsigned(NUMDEV); ++i) {
+    ParsedState &parsed = parsed_state[i];
+    parsed.mutex.Lock();
+    if (parsed.modified) {
+      per_device_data[i] = parsed.data;
+      parsed.modified = false;
+    }
+    parsed.mutex.Unlock();
+
     if (!per_device_data[i].alive)
       continue;
 
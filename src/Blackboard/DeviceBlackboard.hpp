@@ -59,6 +59,41 @@ class DeviceBlackboard
    */
   NMEAInfo per_device_data[NUMDEV];
 
+  /**
+   * The state published by a device's NMEA parser.  The parser runs
+   * in the port thread and owns its copy of the #NMEAInfo (see
+   * DeviceDescriptor::ParseLine()); PublishParsedState() copies it
+   * here without locking #mutex, and Merge() moves it to
+   * #per_device_data.
+   */
+  struct ParsedState {
+    /**
+     * Protects the other attributes.  If both are needed,
+     * DeviceBlackboard::mutex must be locked first.
+     */
+    Mutex mutex;
+
+    NMEAInfo data;
+
+    /**
+     * Has #data been published since the last Merge()?
+     */
+    bool modified;
+
+    /**
+     * Has SetStartupLocation() set a fake location which the parser
+     * has not applied to its copy yet?
+     */
+    bool fake_location_pending;
+
+    GeoPoint fake_location;
+    fixed fake_altitude;
+
+    ParsedState():modified(false), fake_location_pending(false) {}
+  };
+
+  ParsedState parsed_state[NUMDEV];
+
   /**
    * Merged data from the physical devices.
    */
@@ -109,6 +144,23 @@ public:
     return per_device_data[i];
   }
 
+  /**
+   * Clear the state of the specified device, including a state
+   * published with PublishParsedState() which has not been merged
+   * yet.  Caller must lock the blackboard.
+   */
+  void ResetRealState(unsigned i);
+
+  /**
+   * Publish the state of the specified device, which was parsed
+   * without holding the blackboard lock, and schedule a merge.  The
+   * caller must not lock the blackboard.
+   *
+   * @param data the parser's copy; a fake location set by
+   * SetStartupLocation() in the meantime is applied to it
+   */
+  void PublishParsedState(unsigned i, NMEAInfo &data);
+
   NMEAInfo &SetSimulatorState() { return simulator_data; }
   NMEAInfo &SetReplayState() { return replay_data; }
 
@@ -24,14 +24,88 @@ Copyright_License {
 #include "ContestComputer.hpp"
 #include "Engine/Contest/Settings.hpp"
 
-ContestComputer::ContestComputer(const Trace &trace_full,
-                                 const Trace &trace_triangle,
-                                 const Trace &trace_sprint)
-  :contest_manager(Contest::OLC_SPRINT, trace_full, trace_triangle, trace_sprint, true)
+ContestComputer::ContestComputer(const Trace &_trace_full,
+                                 const Trace &_trace_triangle,
+                                 const Trace &_trace_sprint)
+  :master_full(_trace_full),
+   master_triangle(_trace_triangle),
+   master_sprint(_trace_sprint),
+   trace_full(_trace_full.GetNoThinTime(), _trace_full.GetMaxTime(),
+              _trace_full.GetMaxSize()),
+   trace_triangle(_trace_triangle.GetNoThinTime(),
+                  _trace_triangle.GetMaxTime(),
+                  _trace_triangle.GetMaxSize()),
+   trace_sprint(_trace_sprint.GetNoThinTime(), _trace_sprint.GetMaxTime(),
+                _trace_sprint.GetMaxSize()),
+   contest_manager(Contest::OLC_SPRINT, trace_full, trace_triangle,
+                   trace_sprint, true),
+   n_jobs(0),
+   predicted(TracePoint::Invalid())
 {
   contest_manager.SetIncremental(true);
 }
 
+ContestComputer::~ContestComputer()
+{
+  for (auto &thread : threads)
+    thread.LockStop();
+}
+
+bool
+ContestComputer::IsIdle()
+{
+  for (unsigned i = 0; i < n_jobs; ++i)
+    if (!threads[i].IsDone())
+      return false;
+
+  return true;
+}
+
+bool
+ContestComputer::Wait()
+{
+  if (n_jobs == 0)
+    return false;
+
+  SolverResult results[ContestManager::MAX_SOLVERS];
+  for (unsigned i = 0; i < n_jobs; ++i)
+    results[i] = threads[i].Wait();
+
+  const unsigned n = n_jobs;
+  n_jobs = 0;
+
+  return contest_manager.Merge(jobs, results, n, jobs_exhaustive);
+}
+
+void
+ContestComputer::Start(const ContestSettings &settings, bool exhaustive)
+{
+  assert(n_jobs == 0);
+
+  contest_manager.SetHandicap(settings.handicap);
+  contest_manager.SetContest(settings.contest);
+  contest_manager.SetPredicted(predicted);
+
+  /* the calculation thread may modify the original traces while the
+     solvers are running */
+  trace_full.CopyFrom(master_full);
+  trace_triangle.CopyFrom(master_triangle);
+  trace_sprint.CopyFrom(master_sprint);
+
+  n_jobs = contest_manager.GetSolvers(jobs);
+  jobs_exhaustive = exhaustive;
+
+  for (unsigned i = 0; i < n_jobs; ++i)
+    threads[i].Start(*jobs[i].solver, exhaustive);
+}
+
+void
+ContestComputer::Reset()
+{
+  Wait();
+  contest_manager.Reset();
+}
+
 void
 ContestComputer::Solve(const ContestSettings &settings,
                        ContestStatistics &contest_stats)
@@ -39,12 +113,14 @@ ContestComputer::Solve(const ContestSettings &settings,
   if (!settings.enable)
     return;
 
-  contest_manager.SetHandicap(settings.handicap);
-  contest_manager.SetContest(settings.contest);
-
-  contest_manager.UpdateIdle();
+  if (!IsIdle())
+    /* try again later */
+    return;
 
+  Wait();
   contest_stats = contest_manager.GetStats();
+
+  Start(settings, false);
 }
 
 bool
@@ -54,10 +130,10 @@ ContestComputer::SolveExhaustive(const ContestSettings &settings,
   if (!settings.enable)
     return false;
 
-  contest_manager.SetHandicap(settings.handicap);
-  contest_manager.SetContest(settings.contest);
-
-  bool result = contest_manager.SolveExhaustive();
+  /* finish the incremental round, then run the exhaustive one */
+  Wait();
+  Start(settings, true);
+  bool result = Wait();
 
   contest_stats = contest_manager.GetStats();
 
@@ -25,32 +25,63 @@ Copyright_License {
 #define XCSOAR_CONTEST_COMPUTER_HPP
 
 #include "Engine/Contest/ContestManager.hpp"
+#include "Engine/Trace/Trace.hpp"
+#include "ContestSolverThread.hpp"
 
 struct ContestSettings;
 struct ContestStatistics;
-class Trace;
 
+/**
+ * Runs the contest solvers in a small pool of threads, so the
+ * calculation thread does not have to wait for them.  The solvers
+ * operate on private copies of the traces, which are updated only
+ * when no solver is running.  Each call to Solve() collects the
+ * results of the previous round and starts a new one.
+ */
 class ContestComputer {
+  const Trace &master_full, &master_triangle, &master_sprint;
+
+  /**
+   * Copies of the traces which are read by the solver threads.
+   */
+  Trace trace_full, trace_triangle, trace_sprint;
+
   ContestManager contest_manager;
 
+  ContestSolverThread threads[ContestManager::MAX_SOLVERS];
+
+  /**
+   * The solvers of the current round; #n_jobs is zero if no round
+   * is running.
+   */
+  ContestManager::SolverJob jobs[ContestManager::MAX_SOLVERS];
+  unsigned n_jobs;
+  bool jobs_exhaustive;
+
+  /**
+   * The value passed to SetPredicted(), to be applied before the
+   * next round.
+   */
+  TracePoint predicted;
+
 public:
   ContestComputer(const Trace &trace_full,
                   const Trace &trace_triangle,
                   const Trace &trace_sprint);
+  ~ContestComputer();
 
   void SetIncremental(bool incremental) {
+    Wait();
     contest_manager.SetIncremental(incremental);
   }
 
-  void Reset() {
-    contest_manager.Reset();
-  }
+  void Reset();
 
   /**
    * @see ContestDijkstra::SetPredicted()
    */
-  void SetPredicted(const TracePoint &predicted) {
-    contest_manager.SetPredicted(predicted);
+  void SetPredicted(const TracePoint &_predicted) {
+    predicted = _predicted;
   }
 
   void Solve(const ContestSettings &settings_computer,
@@ -58,6 +89,25 @@ public:
 
   bool SolveExhaustive(const ContestSettings &settings_computer,
                        ContestStatistics &contest_stats);
+
+private:
+  /**
+   * Has the current round finished (or is there none)?
+   */
+  bool IsIdle();
+
+  /**
+   * Wait for the current round to finish and merge its results.
+   *
+   * @return true if the #ContestStatistics have changed
+   */
+  bool Wait();
+
+  /**
+   * Start a new round for the given settings.  No round must be
+   * running.
+   */
+  void Start(const ContestSettings &settings, bool exhaustive);
 };
 
 #endif
@@ -0,0 +1,89 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CONTEST_SOLVER_THREAD_HPP
+#define XCSOAR_CONTEST_SOLVER_THREAD_HPP
+
+#include "Thread/StandbyThread.hpp"
+#include "Engine/PathSolvers/SolverResult.hpp"
+
+#include <assert.h>
+
+class AbstractContest;
+
+/**
+ * A thread which runs AbstractContest::Solve() in background.
+ * #ContestComputer uses a small pool of these to run the solvers of
+ * one contest concurrently.
+ */
+class ContestSolverThread final : private StandbyThread {
+  AbstractContest *solver;
+  bool exhaustive;
+  SolverResult result;
+
+public:
+  ContestSolverThread()
+    :StandbyThread("Contest"), solver(nullptr) {}
+
+  using StandbyThread::LockStop;
+
+  /**
+   * Start solving.  The thread must be idle, see Wait().  The solver
+   * and its #Trace must not be accessed by the caller until Wait()
+   * has returned.
+   */
+  void Start(AbstractContest &_solver, bool _exhaustive) {
+    const ScopeLock protect(mutex);
+    assert(!IsBusy());
+
+    solver = &_solver;
+    exhaustive = _exhaustive;
+    Trigger();
+  }
+
+  /**
+   * Has the solver returned?
+   */
+  bool IsDone() {
+    const ScopeLock protect(mutex);
+    return !IsBusy();
+  }
+
+  /**
+   * Wait until the solver has returned.
+   *
+   * @return the return value of AbstractContest::Solve()
+   */
+  SolverResult Wait() {
+    const ScopeLock protect(mutex);
+    WaitDone();
+    return result;
+  }
+
+private:
+  /* virtual methods from class StandbyThread*/
+  void OnStart() override;
+  void Tick() override;
+};
+
+#endif
@@ -40,7 +40,8 @@ GlideComputer::GlideComputer(const Waypoints &_way_points,
                              GlideComputerTaskEvents& events):
   air_data_computer(_way_points),
   warning_computer(_airspace_database),
-  task_computer(task, _airspace_database, &warning_computer.GetManager()),
+  task_computer(task, _way_points, _airspace_database,
+                &warning_computer.GetManager()),
   waypoints(_way_points),
   retrospective(_way_points),
   team_code_ref_id(-1)
@@ -28,12 +28,16 @@ Copyright_License {
 #include "NMEA/Derived.hpp"
 #include "NMEA/Aircraft.hpp"
 #include "Navigation/Aircraft.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "GlideSolvers/GlidePolar.hpp"
 
 #include <algorithm>
 
-RouteComputer::RouteComputer(const Airspaces &airspace_database,
+RouteComputer::RouteComputer(const Waypoints &_waypoints,
+                             const Airspaces &airspace_database,
                              const ProtectedAirspaceWarningManager *warnings)
-  :protected_route_planner(route_planner, airspace_database, warnings),
+  :waypoints(_waypoints),
+   protected_route_planner(route_planner, airspace_database, warnings),
    terrain(NULL)
 {}
 
@@ -52,6 +56,7 @@ void
 RouteComputer::ProcessRoute(const MoreData &basic, DerivedInfo &calculated,
                             const GlideSettings &settings,
                             const RoutePlannerConfig &config,
+                            const fixed safety_height_arrival,
                             const GlidePolar &glide_polar,
                             const GlidePolar &safety_polar)
 {
@@ -62,6 +67,8 @@ RouteComputer::ProcessRoute(const MoreData &basic, DerivedInfo &calculated,
                                     calculated.GetWindOrZero());
 
   Reach(basic, calculated, config);
+  UpdateReachability(config, safety_height_arrival, glide_polar, safety_polar,
+                     calculated.GetWindOrZero());
   TerrainWarning(basic, calculated, config);
 }
 
@@ -145,6 +152,7 @@ RouteComputer::Reach(const MoreData &basic, DerivedInfo &calculated,
 
   if (reach_clock.CheckAdvance(basic.time, PERIOD)) {
     protected_route_planner.SolveReach(start, config, h_ceiling, do_solve);
+    reach_origin = start;
 
     if (do_solve) {
       calculated.terrain_base = route_planner.GetTerrainBase();
@@ -153,6 +161,43 @@ RouteComputer::Reach(const MoreData &basic, DerivedInfo &calculated,
   }
 }
 
+inline void
+RouteComputer::UpdateReachability(const RoutePlannerConfig &config,
+                                  const fixed safety_height_arrival,
+                                  const GlidePolar &glide_polar,
+                                  const GlidePolar &safety_polar,
+                                  const SpeedVector &wind)
+{
+  /* this is the only thread which modifies the route planner, so it
+     may be read without a lock */
+  if (route_planner.IsReachEmpty())
+    return;
+
+  const GlidePolar &polar =
+    config.reach_polar_mode == RoutePlannerConfig::Polar::TASK
+    ? glide_polar
+    : safety_polar;
+
+  const ReachabilityParameters parameters{
+    polar.GetMC(), polar.GetBugs(), polar.GetBallast(),
+    wind, safety_height_arrival,
+  };
+
+  if (route_planner.GetReachability().IsValid(route_planner.GetReachSerial(),
+                                              waypoints.GetSerial()) &&
+      parameters.IsCloseTo(reachability_parameters))
+    return;
+
+  reachability_parameters = parameters;
+
+  /* calculate without holding the lock, the map renderer falls back
+     to its own calculation meanwhile */
+  ReachabilityTable table;
+  table.Calculate(route_planner, waypoints, reach_origin,
+                  safety_height_arrival);
+  protected_route_planner.SetReachability(std::move(table));
+}
+
 void
 RouteComputer::set_terrain(const RasterTerrain* _terrain) {
   terrain = _terrain;
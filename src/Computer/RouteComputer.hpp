@@ -36,10 +36,13 @@ struct RoutePlannerConfig;
 class ProtectedAirspaceWarningManager;
 class RasterTerrain;
 class GlidePolar;
+class Waypoints;
 
 class RouteComputer {
   static constexpr unsigned PERIOD = 5;
 
+  const Waypoints &waypoints;
+
   RoutePlannerGlue route_planner;
   ProtectedRoutePlanner protected_route_planner;
 
@@ -51,8 +54,19 @@ class RouteComputer {
   TaskType last_task_type;
   unsigned last_active_tp;
 
+  /**
+   * The location the reach fan was last solved for.
+   */
+  AGeoPoint reach_origin;
+
+  /**
+   * The glide parameters the #ReachabilityTable was calculated with.
+   */
+  ReachabilityParameters reachability_parameters;
+
 public:
-  RouteComputer(const Airspaces &airspace_database,
+  RouteComputer(const Waypoints &_waypoints,
+                const Airspaces &airspace_database,
                 const ProtectedAirspaceWarningManager *warnings);
 
   /**
@@ -79,6 +93,7 @@ public:
   void ProcessRoute(const MoreData &basic, DerivedInfo &calculated,
                     const GlideSettings &settings,
                     const RoutePlannerConfig &config,
+                    fixed safety_height_arrival,
                     const GlidePolar &glide_polar,
                     const GlidePolar &safety_polar);
 
@@ -91,6 +106,16 @@ private:
 
   void Reach(const MoreData &basic, DerivedInfo &calculated,
              const RoutePlannerConfig &config);
+
+  /**
+   * Recalculate the #ReachabilityTable if the reach fan, the waypoint
+   * database or the glide parameters have changed.
+   */
+  void UpdateReachability(const RoutePlannerConfig &config,
+                          fixed safety_height_arrival,
+                          const GlidePolar &glide_polar,
+                          const GlidePolar &safety_polar,
+                          const SpeedVector &wind);
 };
 
 #endif
@@ -38,10 +38,11 @@ using std::max;
 // call any event
 
 TaskComputer::TaskComputer(ProtectedTaskManager &_task,
+                           const Waypoints &waypoints,
                            const Airspaces &airspace_database,
                            const ProtectedAirspaceWarningManager *warnings)
   :task(_task),
-   route(airspace_database, warnings),
+   route(waypoints, airspace_database, warnings),
    contest(trace.GetFull(), trace.GetContest(), trace.GetSprint())
 {
   task.SetRoutePlanner(&route.GetRoutePlanner());
@@ -111,6 +112,7 @@ TaskComputer::ProcessMoreTask(const MoreData &basic,
   route.ProcessRoute(basic, calculated,
                      settings_computer.task.glide,
                      settings_computer.task.route_planner,
+                     settings_computer.task.safety_height_arrival,
                      glide_polar, safety_polar);
 
   if (settings_computer.features.block_stf_enabled)
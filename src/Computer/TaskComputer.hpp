@@ -53,6 +53,7 @@ class TaskComputer
 
 public:
   TaskComputer(ProtectedTaskManager &_task,
+               const Waypoints &waypoints,
                const Airspaces &airspace_database,
                const ProtectedAirspaceWarningManager *warnings);
 
@@ -240,13 +240,7 @@ DeviceDescriptor::OpenOnPort(DumpPort *_port, OperationEnvironment &env)
 
   reopen_clock.Update();
 
-  device_blackboard->mutex.Lock();
-  device_blackboard->SetRealState(index).Reset();
-  device_blackboard->ScheduleMerge();
-  device_blackboard->mutex.Unlock();
-
-  settings_sent.Clear();
-  settings_received.Clear();
+  ResetState();
   was_alive = false;
 
   port = _port;
@@ -530,13 +524,7 @@ DeviceDescriptor::Close()
 
   ticker = false;
 
-  device_blackboard->mutex.Lock();
-  device_blackboard->SetRealState(index).Reset();
-  device_blackboard->ScheduleMerge();
-  device_blackboard->mutex.Unlock();
-
-  settings_sent.Clear();
-  settings_received.Clear();
+  ResetState();
 }
 
 void
@@ -693,7 +681,8 @@ DeviceDescriptor::IsAlive() const
 }
 
 bool
-DeviceDescriptor::ParseNMEA(const char *line, NMEAInfo &info)
+DeviceDescriptor::ParseNMEA(const char *line, NMEAInfo &info,
+                            const ExternalSettings &sent)
 {
   assert(line != nullptr);
 
@@ -711,7 +700,7 @@ DeviceDescriptor::ParseNMEA(const char *line, NMEAInfo &info)
        sent to the device */
     const ExternalSettings old_received = settings_received;
     settings_received = info.settings;
-    info.settings.EliminateRedundant(settings_sent, old_received);
+    info.settings.EliminateRedundant(sent, old_received);
 
     return true;
   }
@@ -786,7 +775,8 @@ DeviceDescriptor::PutMacCready(fixed value, OperationEnvironment &env)
     return false;
 
   ScopeLock protect(device_blackboard->mutex);
-  NMEAInfo &basic = device_blackboard->SetRealState(index);
+  const NMEAInfo &basic = device_blackboard->RealState(index);
+  ScopeLock protect2(settings_mutex);
   settings_sent.mac_cready = value;
   settings_sent.mac_cready_available.Update(basic.clock);
 
@@ -811,7 +801,8 @@ DeviceDescriptor::PutBugs(fixed value, OperationEnvironment &env)
     return false;
 
   ScopeLock protect(device_blackboard->mutex);
-  NMEAInfo &basic = device_blackboard->SetRealState(index);
+  const NMEAInfo &basic = device_blackboard->RealState(index);
+  ScopeLock protect2(settings_mutex);
   settings_sent.bugs = value;
   settings_sent.bugs_available.Update(basic.clock);
 
@@ -838,7 +829,8 @@ DeviceDescriptor::PutBallast(fixed fraction, fixed overload,
     return false;
 
   ScopeLock protect(device_blackboard->mutex);
-  NMEAInfo &basic = device_blackboard->SetRealState(index);
+  const NMEAInfo &basic = device_blackboard->RealState(index);
+  ScopeLock protect2(settings_mutex);
   settings_sent.ballast_fraction = fraction;
   settings_sent.ballast_fraction_available.Update(basic.clock);
   settings_sent.ballast_overload = overload;
@@ -918,7 +910,8 @@ DeviceDescriptor::PutQNH(const AtmosphericPressure &value,
     return false;
 
   ScopeLock protect(device_blackboard->mutex);
-  NMEAInfo &basic = device_blackboard->SetRealState(index);
+  const NMEAInfo &basic = device_blackboard->RealState(index);
+  ScopeLock protect2(settings_mutex);
   settings_sent.qnh = value;
   settings_sent.qnh_available.Update(basic.clock);
 
@@ -1104,13 +1097,55 @@ DeviceDescriptor::OnCalculatedUpdate(const MoreData &basic,
     device->OnCalculatedUpdate(basic, calculated);
 }
 
+void
+DeviceDescriptor::ResetState()
+{
+  parse_data.Reset();
+  parse_expire_clock = fixed(0);
+
+  device_blackboard->mutex.Lock();
+  device_blackboard->ResetRealState(index);
+  device_blackboard->ScheduleMerge();
+  device_blackboard->mutex.Unlock();
+
+  settings_sent.Clear();
+  settings_received.Clear();
+}
+
+void
+DeviceDescriptor::BeginParse(ExternalSettings &sent)
+{
+  {
+    ScopeLock protect(settings_mutex);
+    sent = settings_sent;
+  }
+
+  NMEAInfo &basic = parse_data;
+  basic.UpdateClock();
+
+  if (basic.clock >= parse_expire_clock + fixed(1)) {
+    parse_expire_clock = basic.clock;
+    basic.ExpireWallClock();
+    basic.Expire();
+  }
+}
+
 bool
 DeviceDescriptor::ParseLine(const char *line)
 {
-  ScopeLock protect(device_blackboard->mutex);
-  NMEAInfo &basic = device_blackboard->SetRealState(index);
-  basic.UpdateClock();
-  return ParseNMEA(line, basic);
+  /* the parser owns #parse_data and only publishes the result, so it
+     neither waits for the DeviceBlackboard lock (which is shared with
+     the other devices, the MergeThread and the CalculationThread)
+     nor overwrites modifications made by others in the meantime */
+  ExternalSettings sent;
+  BeginParse(sent);
+
+  NMEAInfo &basic = parse_data;
+  const bool result = ParseNMEA(line, basic, sent);
+  if (result)
+    device_blackboard->PublishParsedState(index, basic);
+
+  return result;
 }
 
 void
@@ -1135,17 +1170,17 @@ DeviceDescriptor::DataReceived(const void *data, size_t length)
 
   // Pass data directly to drivers that use binary data protocols
   if (driver != nullptr && device != nullptr && driver->UsesRawData()) {
-    ScopeLock protect(device_blackboard->mutex);
-    NMEAInfo &basic = device_blackboard->SetRealState(index);
-    basic.UpdateClock();
+    ExternalSettings sent;
+    BeginParse(sent);
 
+    NMEAInfo &basic = parse_data;
     const ExternalSettings old_settings = basic.settings;
 
     if (device->DataReceived(data, length, basic)) {
       if (!config.sync_from_device)
         basic.settings = old_settings;
 
-      device_blackboard->ScheduleMerge();
+      device_blackboard->PublishParsedState(index, basic);
     }
 
     return;
@@ -1163,6 +1198,5 @@ DeviceDescriptor::LineReceived(const char *line)
   if (dispatcher != nullptr)
     dispatcher->LineReceived(line);
 
-  if (ParseLine(line))
-    device_blackboard->ScheduleMerge();
+  ParseLine(line);
 }
@@ -31,6 +31,7 @@ Copyright_License {
 #include "Port/State.hpp"
 #include "Device/Parser.hpp"
 #include "RadioFrequency.hpp"
+#include "NMEA/Info.hpp"
 #include "NMEA/ExternalSettings.hpp"
 #include "Time/PeriodClock.hpp"
 #include "Job/Async.hpp"
@@ -177,6 +178,13 @@ class DeviceDescriptor final : private Notify, private PortLineSplitter {
    */
   ExternalSettings settings_sent;
 
+  /**
+   * Protects #settings_sent, which is read by the port thread.  The
+   * main thread modifies it while holding the DeviceBlackboard lock,
+   * which must be locked first.
+   */
+  Mutex settings_mutex;
+
   /**
    * The settings that were received from the device.  This temporary
    * buffer mirrors NMEA_INFO::settings; NMEA_INFO::settings may get
@@ -186,6 +194,19 @@ class DeviceDescriptor final : private Notify, private PortLineSplitter {
    */
   ExternalSettings settings_received;
 
+  /**
+   * This device's #NMEAInfo as seen by the parser.  It is owned by
+   * the port thread (ParseLine() and DataReceived()), which modifies
+   * it without holding the DeviceBlackboard lock and publishes it
+   * with DeviceBlackboard::PublishParsedState().
+   */
+  NMEAInfo parse_data;
+
+  /**
+   * The #NMEAInfo::clock value when #parse_data was last expired.
+   */
+  fixed parse_expire_clock;
+
   /**
    * Number of port failures since the device was last reset.
    *
@@ -436,7 +457,30 @@ public:
   bool IsAlive() const;
 
 private:
-  bool ParseNMEA(const char *line, struct NMEAInfo &info);
+  /**
+   * @param sent a copy of #settings_sent, which is protected by
+   * #settings_mutex
+   */
+  bool ParseNMEA(const char *line, struct NMEAInfo &info,
+                 const ExternalSettings &sent);
+
+  /**
+   * Prepare #parse_data for the next update: expire old values, the
+   * way DeviceBlackboard::Merge() and
+   * DeviceBlackboard::ExpireWallClock() do with the published copy.
+   * This is done at most once per second, because the shortest
+   * timeouts are a few seconds, and Merge() expires the published
+   * copy anyway.
+   *
+   * @param sent receives a copy of #settings_sent
+   */
+  void BeginParse(ExternalSettings &sent);
+
+  /**
+   * Reset the state of this device, both #parse_data and the one in
+   * the DeviceBlackboard.  The port thread must not be running.
+   */
+  void ResetState();
 
 public:
   void SetMonitor(DataHandler  *_monitor) {
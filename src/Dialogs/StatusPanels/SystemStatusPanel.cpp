@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "SystemStatusPanel.hpp"
 #include "Logger/Logger.hpp"
+#include "Logger/NMEALogger.hpp"
 #include "Components.hpp"
 #include "Interface.hpp"
 #include "Language/Language.hpp"
@@ -35,6 +36,7 @@ enum Controls {
   Vario,
   FLARM,
   Logger,
+  NMEALog,
   Battery,
   Network,
 };
@@ -108,6 +110,17 @@ SystemStatusPanel::Refresh()
           ? _("On")
           : _("Off"));
 
+  if (NMEALogger::enabled) {
+    const unsigned lost = NMEALogger::GetLostLines();
+    if (lost > 0)
+      Temp.Format(_T("%s (%u %s)"), _("On"), lost, _("lines lost"));
+    else
+      Temp = _("On");
+  } else
+    Temp = _("Off");
+
+  SetText(NMEALog, Temp);
+
   Temp.clear();
 #ifdef HAVE_BATTERY
   if (Power::Battery::RemainingPercentValid) {
@@ -132,6 +145,7 @@ SystemStatusPanel::Prepare(ContainerWindow &parent, const PixelRect &rc)
   AddReadOnly(_("Variometer"));
   AddReadOnly(_T("FLARM"));
   AddReadOnly(_("Logger"));
+  AddReadOnly(_("NMEA logger"));
   AddReadOnly(_("Supply voltage"));
   AddReadOnly(_("Network"));
 }
@@ -231,6 +231,10 @@ public:
     days_of_operation = mask;
   }
 
+  AirspaceActivity GetDays() const {
+    return days_of_operation;
+  }
+
   /**
    * Get type of airspace
    *
@@ -364,7 +368,7 @@ public:
 
 protected:
   /** Project border */
-  void Project(const FlatProjection &tp);
+  virtual void Project(const FlatProjection &tp);
 
 private:
   /**
@@ -0,0 +1,77 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "AirspaceClearanceCache.hpp"
+#include "Airspaces.hpp"
+#include "AbstractAirspace.hpp"
+
+/**
+ * The distance an aircraft may move before the cache needs a full
+ * query again [m].
+ */
+#define CLEARANCE_MARGIN fixed(5000)
+
+/**
+ * Intersections are calculated in the integer flat projection, with
+ * a resolution of about 100m.  The clearance is reduced by this
+ * relative and absolute tolerance [m] to stay on the safe side.
+ */
+#define CLEARANCE_TOLERANCE fixed(0.05)
+#define CLEARANCE_SLACK fixed(500)
+
+bool
+AirspaceClearanceCache::IsValid(const Airspaces &airspaces,
+                                const GeoPoint &location, fixed reach) const
+{
+  return center.IsValid() && airspaces.GetSerial() == serial &&
+    (reach + center.Distance(location)) * (fixed(1) + CLEARANCE_TOLERANCE)
+    + CLEARANCE_SLACK <= radius;
+}
+
+void
+AirspaceClearanceCache::Update(const Airspaces &airspaces,
+                               const GeoPoint &location, fixed reach)
+{
+  Clear();
+
+  center = location;
+  radius = reach * 2 + CLEARANCE_MARGIN + CLEARANCE_SLACK;
+  serial = airspaces.GetSerial();
+
+  const FlatProjection &projection = airspaces.GetProjection();
+
+  const auto found = airspaces.ScanRange(location, radius);
+
+  items.reserve(found.size());
+  for (const auto &i : found) {
+    const AbstractAirspace &airspace = i.GetAirspace();
+
+    fixed clearance = fixed(0);
+    if (!airspace.Inside(location)) {
+      const GeoPoint closest = airspace.ClosestPoint(location, projection);
+      clearance = location.Distance(closest) * (fixed(1) - CLEARANCE_TOLERANCE)
+        - CLEARANCE_SLACK;
+    }
+
+    items.emplace_back(i, clearance);
+  }
+}
@@ -0,0 +1,129 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+#ifndef AIRSPACE_CLEARANCE_CACHE_HPP
+#define AIRSPACE_CLEARANCE_CACHE_HPP
+
+#include "Airspace.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Util/Serial.hpp"
+#include "Compiler.h"
+
+#include <vector>
+
+class Airspaces;
+
+/**
+ * Remembers the airspaces around the location of the last full
+ * query, together with their horizontal distance ("clearance") from
+ * that location.  As long as the aircraft stays well inside the
+ * cached radius, a prediction from the current location needs
+ * neither a tree query nor an intersection test for airspaces which
+ * the aircraft cannot have approached closely enough since.
+ */
+class AirspaceClearanceCache {
+  struct Item {
+    Airspace airspace;
+
+    /**
+     * A lower bound for the horizontal distance between #center and
+     * the airspace [m].  Zero if #center is inside.
+     */
+    fixed clearance;
+
+    Item(const Airspace &_airspace, fixed _clearance)
+      :airspace(_airspace), clearance(_clearance) {}
+  };
+
+  std::vector<Item> items;
+
+  /**
+   * The location of the last full query.  Invalid if the cache is
+   * empty.
+   */
+  GeoPoint center;
+
+  /**
+   * All airspaces within this distance of #center are in #items [m].
+   */
+  fixed radius;
+
+  /**
+   * The #Airspaces serial at the time of the last full query.
+   */
+  Serial serial;
+
+public:
+  AirspaceClearanceCache() {
+    Clear();
+  }
+
+  void Clear() {
+    items.clear();
+    center.SetInvalid();
+  }
+
+  unsigned size() const {
+    return items.size();
+  }
+
+  /**
+   * Can this cache answer queries from the specified location,
+   * reaching out to the specified distance?
+   */
+  gcc_pure
+  bool IsValid(const Airspaces &airspaces, const GeoPoint &location,
+               fixed reach) const;
+
+  /**
+   * Query all airspaces around the specified location, with some
+   * room for the aircraft to move before the next call.
+   */
+  void Update(const Airspaces &airspaces, const GeoPoint &location,
+              fixed reach);
+
+  /**
+   * Invoke the visitor for each #Airspace which may be within the
+   * specified distance of the location.  The cache must be valid for
+   * these parameters.
+   *
+   * @return the number of airspaces visited
+   */
+  template<typename V>
+  unsigned VisitWithinReach(const GeoPoint &location, fixed reach,
+                            V &&visitor) const {
+    /* the aircraft has come at most this much closer to each
+       airspace since the full query */
+    const fixed limit = reach + center.Distance(location);
+
+    unsigned n = 0;
+    for (const auto &i : items) {
+      if (i.clearance <= limit) {
+        visitor(i.airspace);
+        ++n;
+      }
+    }
+
+    return n;
+  }
+};
+
+#endif
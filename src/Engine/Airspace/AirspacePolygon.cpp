@@ -23,9 +23,21 @@
 #include "AirspacePolygon.hpp"
 #include "Geo/Flat/FlatProjection.hpp"
 #include "Geo/Flat/FlatRay.hpp"
+#include "Geo/Flat/FlatBoundingBox.hpp"
 #include "AirspaceIntersectSort.hpp"
 #include "AirspaceIntersectionVector.hpp"
 
+/**
+ * Polygons with fewer points are scanned linearly; building the
+ * #PolygonSlabs would not pay off.
+ */
+static constexpr unsigned SLABS_MIN_POINTS = 32;
+
+/**
+ * The average number of edges in one slab of #PolygonSlabs.
+ */
+static constexpr unsigned SLABS_EDGES_PER_SLAB = 4;
+
 AirspacePolygon::AirspacePolygon(const std::vector<GeoPoint> &pts,
                                  const bool prune)
   :AbstractAirspace(Shape::POLYGON)
@@ -79,10 +91,23 @@ AirspacePolygon::GetCenter() const
   return GeoPoint(Angle::Native(lon), Angle::Native(lat));
 }
 
+void
+AirspacePolygon::Project(const FlatProjection &projection)
+{
+  AbstractAirspace::Project(projection);
+
+  /* the slabs are in geographic coordinates; they don't depend on
+     the projection */
+  if (!slabs.IsDefined() && m_border.size() >= SLABS_MIN_POINTS)
+    slabs.Build(m_border, SLABS_EDGES_PER_SLAB);
+}
+
 bool
 AirspacePolygon::Inside(const GeoPoint &loc) const
 {
-  return m_border.IsInside(loc);
+  return slabs.IsDefined()
+    ? slabs.IsInside(m_border, loc)
+    : m_border.IsInside(loc);
 }
 
 AirspaceIntersectionVector
@@ -94,13 +119,30 @@ AirspacePolygon::Intersects(const GeoPoint &start, const GeoPoint &end,
 
   AirspaceIntersectSort sorter(start, *this);
 
-  for (auto it = m_border.begin(); it + 1 != m_border.end(); ++it) {
+  FlatBoundingBox ray_box(ray.point);
+  ray_box.Expand(ray.point + ray.vector);
+
+  auto check_edge = [this, &ray, &ray_box, &projection, &sorter](unsigned i){
+    const FlatGeoPoint &a = m_border[i].GetFlatLocation();
+    const FlatGeoPoint &b = m_border[i + 1].GetFlatLocation();
 
-    const FlatRay r_seg(it->GetFlatLocation(), (it + 1)->GetFlatLocation());
+    /* cheap rejection before the exact intersection test */
+    FlatBoundingBox edge_box(a);
+    edge_box.Expand(b);
+    if (!edge_box.Overlaps(ray_box))
+      return;
+
+    const FlatRay r_seg(a, b);
     fixed t = ray.DistinctIntersection(r_seg);
     if (!negative(t))
       sorter.add(t, projection.Unproject(ray.Parametric(t)));
-  }
+  };
+
+  if (slabs.IsDefined())
+    slabs.VisitEdges(start.latitude, end.latitude, check_edge);
+  else
+    for (unsigned i = 0; i + 1 < m_border.size(); ++i)
+      check_edge(i);
 
   return sorter.all();
 }
@@ -24,6 +24,8 @@
 #define AIRSPACEPOLYGON_HPP
 
 #include "AbstractAirspace.hpp"
+#include "Geo/PolygonSlabs.hpp"
+
 #include <vector>
 
 #ifdef DO_PRINT
@@ -32,6 +34,14 @@
 
 /** General polygon form airspace */
 class AirspacePolygon final : public AbstractAirspace {
+  /**
+   * An index over the edges of #m_border for Inside() and
+   * Intersects().  It is built by Project(), i.e. when the airspace is
+   * inserted into the #Airspaces tree, and only for polygons with
+   * many points.
+   */
+  PolygonSlabs slabs;
+
 public:
   /**
    * Constructor.  For testing, pts vector is a cloud of points,
@@ -54,6 +64,21 @@ public:
   GeoPoint ClosestPoint(const GeoPoint &loc,
                         const FlatProjection &projection) const override;
 
+  const PolygonSlabs &GetSlabs() const {
+    return slabs;
+  }
+
+  /**
+   * Writable access to the index, for loading it from a snapshot;
+   * Project() does not rebuild an index which is already defined.
+   */
+  PolygonSlabs &GetSlabs() {
+    return slabs;
+  }
+
+protected:
+  void Project(const FlatProjection &projection) override;
+
 public:
 #ifdef DO_PRINT
   friend std::ostream &operator<<(std::ostream &f,
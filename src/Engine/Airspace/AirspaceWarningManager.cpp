@@ -22,6 +22,7 @@
 
 #include "AirspaceWarningManager.hpp"
 #include "Geo/GeoVector.hpp"
+#include "Geo/Flat/FlatRay.hpp"
 #include "Airspaces.hpp"
 #include "AbstractAirspace.hpp"
 #include "AirspaceIntersectionVisitor.hpp"
@@ -34,6 +35,8 @@
 AirspaceWarningManager::AirspaceWarningManager(const Airspaces &_airspaces)
   :airspaces(_airspaces), serial(0)
 {
+  statistics.Clear();
+
   /* force filter initialisation in the first SetConfig() call */
   config.warning_time = -1;
 }
@@ -63,6 +66,9 @@ AirspaceWarningManager::Reset(const AircraftState &state)
 {
   ++serial;
   warnings.clear();
+  task_cache.Clear();
+  filter_cache.Clear();
+  glide_cache.Clear();
   cruise_filter.Reset(state);
   circling_filter.Reset(state);
 }
@@ -276,7 +282,8 @@ AirspaceWarningManager::UpdatePredicted(const AircraftState& state,
                                          const GeoPoint &location_predicted,
                                          const AirspaceAircraftPerformance &perf,
                                          const AirspaceWarning::State warning_state,
-                                         const fixed max_time) 
+                                         const fixed max_time,
+                                         AirspaceClearanceCache &cache)
 {
   // this is the time limit of intrusions, beyond which we are not interested.
   // it can be the minimum of the user set warning time, or the time of the 
@@ -300,10 +307,42 @@ AirspaceWarningManager::UpdatePredicted(const AircraftState& state,
                                              warning_state, max_time_limit,
                                              ceiling);
 
-  airspaces.VisitIntersecting(state.location, location_predicted, visitor);
+  /* only airspaces the aircraft may have approached closer than the
+     length of the prediction since the last full query need to be
+     tested */
+  const fixed reach = state.location.Distance(location_predicted);
+  if (!cache.IsValid(airspaces, state.location, reach)) {
+    cache.Update(airspaces, state.location, reach);
+    ++statistics.queries;
+  }
+
+  const FlatProjection &projection = GetProjection();
+  const FlatGeoPoint flat_location = projection.ProjectInteger(state.location);
+  const FlatRay ray(flat_location,
+                    projection.ProjectInteger(location_predicted));
+
+  const auto intersecting = [&](const Airspace &as){
+    if (as.Intersects(ray) &&
+        visitor.SetIntersections(as.Intersects(state.location,
+                                               location_predicted,
+                                               projection)))
+      visitor.Visit(as);
+  };
+
+  const unsigned n = cache.VisitWithinReach(state.location, reach,
+                                            intersecting);
+  statistics.evaluated += n;
+  statistics.skipped += cache.size() - n;
 
   visitor.SetMode(true);
-  airspaces.VisitInside(state.location, visitor);
+
+  const auto inside = [&](const Airspace &as){
+    if (as.FlatBoundingBox::IsInside(flat_location) &&
+        as.IsInside(state.location))
+      visitor.Visit(as);
+  };
+
+  cache.VisitWithinReach(state.location, fixed(0), inside);
 
   return visitor.Found();
 }
@@ -340,7 +379,8 @@ AirspaceWarningManager::UpdateTask(const AircraftState &state,
     location_tp = state.location.IntermediatePoint(location_tp, max_distance);
 
   return UpdatePredicted(state, location_tp, perf_task,
-                          AirspaceWarning::WARNING_TASK, time_remaining);
+                          AirspaceWarning::WARNING_TASK, time_remaining,
+                          task_cache);
 }
 
 
@@ -358,11 +398,13 @@ AirspaceWarningManager::UpdateFilter(const AircraftState& state, const bool circ
   if (circling) 
     return UpdatePredicted(state, location_predicted,
                            AirspaceAircraftPerformance(circling_filter),
-                            AirspaceWarning::WARNING_FILTER, prediction_time_filter);
+                            AirspaceWarning::WARNING_FILTER, prediction_time_filter,
+                            filter_cache);
   else
     return UpdatePredicted(state, location_predicted,
                            AirspaceAircraftPerformance(cruise_filter),
-                            AirspaceWarning::WARNING_FILTER, prediction_time_filter);
+                            AirspaceWarning::WARNING_FILTER, prediction_time_filter,
+                            filter_cache);
 }
 
 
@@ -379,7 +421,8 @@ AirspaceWarningManager::UpdateGlide(const AircraftState &state,
   const AirspaceAircraftPerformance perf_glide(glide_polar);
   return UpdatePredicted(state, location_predicted,
                           perf_glide,
-                          AirspaceWarning::WARNING_GLIDE, prediction_time_glide);
+                          AirspaceWarning::WARNING_GLIDE, prediction_time_glide,
+                          glide_cache);
 }
 
 
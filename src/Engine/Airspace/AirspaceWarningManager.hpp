@@ -24,6 +24,7 @@
 
 #include "AirspaceWarning.hpp"
 #include "AirspaceWarningConfig.hpp"
+#include "AirspaceClearanceCache.hpp"
 #include "Util/AircraftStateFilter.hpp"
 #include "Compiler.h"
 
@@ -47,6 +48,34 @@ class AirspaceAircraftPerformance;
  *
  */
 class AirspaceWarningManager {
+public:
+  /**
+   * Counters which show how effective the #AirspaceClearanceCache
+   * objects are, e.g. for tuning them in a replay.
+   */
+  struct Statistics {
+    /**
+     * Number of airspaces which were tested against a prediction.
+     */
+    unsigned evaluated;
+
+    /**
+     * Number of airspaces which were skipped because they were out
+     * of reach of a prediction.
+     */
+    unsigned skipped;
+
+    /**
+     * Number of full airspace queries which refilled a cache.
+     */
+    unsigned queries;
+
+    void Clear() {
+      evaluated = skipped = queries = 0;
+    }
+  };
+
+private:
   AirspaceWarningConfig config;
 
   const Airspaces &airspaces;
@@ -61,6 +90,13 @@ class AirspaceWarningManager {
 
   AirspaceWarningList warnings;
 
+  /**
+   * The airspaces around the aircraft for each of the predictions.
+   */
+  AirspaceClearanceCache task_cache, filter_cache, glide_cache;
+
+  Statistics statistics;
+
   /**
    * This number is incremented each time this object is modified.
    */
@@ -97,6 +133,14 @@ public:
     return serial;
   }
 
+  const Statistics &GetStatistics() const {
+    return statistics;
+  }
+
+  void ResetStatistics() {
+    statistics.Clear();
+  }
+
   /**
    * Reset warning list and filter (as in new flight)
    *
@@ -270,7 +314,8 @@ private:
                        const GeoPoint &location_predicted,
                        const AirspaceAircraftPerformance &perf,
                        const AirspaceWarning::State warning_state,
-                       const fixed max_time);
+                       const fixed max_time,
+                       AirspaceClearanceCache &cache);
 };
 
 #endif
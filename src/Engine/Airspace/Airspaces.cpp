@@ -64,7 +64,7 @@ Airspaces::VisitWithinRange(const GeoPoint &location, fixed range,
   Airspace bb_target(location, task_projection);
   int projected_range = task_projection.ProjectRangeInteger(location, range);
   AirspacePredicateVisitorAdapter adapter(predicate, visitor);
-  airspace_tree.visit_within_range(bb_target, -projected_range, adapter);
+  airspace_tree.VisitWithinRange(bb_target, projected_range, adapter);
 
 #ifdef INSTRUMENT_TASK
   n_queries++;
@@ -105,7 +105,7 @@ Airspaces::VisitIntersecting(const GeoPoint &loc, const GeoPoint &end,
   Airspace bb_target(c, task_projection);
   int projected_range = task_projection.ProjectRangeInteger(c, loc.Distance(end) / 2);
   IntersectingAirspaceVisitorAdapter adapter(loc, end, task_projection, visitor);
-  airspace_tree.visit_within_range(bb_target, -projected_range, adapter);
+  airspace_tree.VisitWithinRange(bb_target, projected_range, adapter);
 
 #ifdef INSTRUMENT_TASK
   n_queries++;
@@ -136,9 +136,8 @@ Airspaces::FindNearest(const GeoPoint &location,
   const int projected_range =
     task_projection.ProjectRangeInteger(location, fixed(30000));
   const AirspacePredicateAdapter predicate(condition);
-  std::pair<AirspaceTree::const_iterator, AirspaceTree::distance_type> found =
-    airspace_tree.find_nearest_if(bb_target, BBDist(0, projected_range),
-                                  predicate);
+  const auto found =
+    airspace_tree.FindNearestIf(bb_target, projected_range, predicate);
 
   return found.first != airspace_tree.end() ? &*found.first : nullptr;
 }
@@ -168,7 +167,7 @@ Airspaces::ScanRange(const GeoPoint &location, fixed range,
       res.push_back(v);
   };
 
-  airspace_tree.visit_within_range(bb_target, -projected_range, visitor);
+  airspace_tree.VisitWithinRange(bb_target, projected_range, visitor);
 
   return res;
 }
@@ -197,7 +196,7 @@ Airspaces::FindInside(const AircraftState &state,
       vectors.push_back(v);
   };
 
-  airspace_tree.visit_within_range(bb_target, 0, visitor);
+  airspace_tree.VisitWithinRange(bb_target, 0, visitor);
 
   return vectors;
 }
@@ -217,15 +216,14 @@ Airspaces::Optimise()
     airspace_tree.clear();
   }
 
-  if (!tmp_as.empty()) {
-    while (!tmp_as.empty()) {
-      Airspace as(*tmp_as.front(), task_projection);
-      airspace_tree.insert(as);
-      tmp_as.pop_front();
-    }
-    airspace_tree.optimise();
+  while (!tmp_as.empty()) {
+    Airspace as(*tmp_as.front(), task_projection);
+    airspace_tree.insert(as);
+    tmp_as.pop_front();
   }
 
+  airspace_tree.Optimise();
+
   ++serial;
 }
 
@@ -254,6 +252,23 @@ Airspaces::Add(AbstractAirspace *airspace)
   tmp_as.push_back(airspace);
 }
 
+void
+Airspaces::MoveFrom(Airspaces &other)
+{
+  assert(owns_children);
+  assert(other.owns_children);
+
+  for (const auto &i : other.airspace_tree)
+    Add(&i.GetAirspace());
+
+  for (AbstractAirspace *as : other.tmp_as)
+    Add(as);
+
+  other.airspace_tree.clear();
+  other.tmp_as.clear();
+  ++other.serial;
+}
+
 void
 Airspaces::Clear()
 {
@@ -276,6 +291,8 @@ Airspaces::Clear()
 
   // then delete the tree
   airspace_tree.clear();
+
+  ++serial;
 }
 
 unsigned
@@ -287,7 +304,7 @@ Airspaces::GetSize() const
 bool
 Airspaces::IsEmpty() const
 {
-  return airspace_tree.empty() && tmp_as.empty();
+  return airspace_tree.IsEmpty() && tmp_as.empty();
 }
 
 void
@@ -333,7 +350,8 @@ Airspaces::SynchroniseInRange(const Airspaces &master,
   bool changed = false;
   const AirspaceVector contents_master = master.ScanRange(location, range, condition);
   AirspaceVector contents_self;
-  contents_self.reserve(std::max(airspace_tree.size(), contents_master.size()));
+  contents_self.reserve(std::max<size_t>(airspace_tree.size(),
+                                         contents_master.size()));
 
   task_projection = master.task_projection; // ensure these are up to date
 
@@ -362,18 +380,7 @@ Airspaces::SynchroniseInRange(const Airspaces &master,
   // anything left in the self list are items that were not in the query,
   // so delete them --- including the clearances!
   for (auto v = contents_self.begin(); v != contents_self.end();) {
-    gcc_unused bool found = false;
-    for (auto t = airspace_tree.begin(); t != airspace_tree.end(); ) {
-      if (&t->GetAirspace() == &v->GetAirspace()) {
-        AirspaceTree::const_iterator new_t = t;
-        ++new_t;
-        airspace_tree.erase_exact(*t);
-        t = new_t;
-        found = true;
-      } else {
-        ++t;
-      }
-    }
+    gcc_unused const bool found = airspace_tree.erase(*v);
     assert(found);
     v->ClearClearance();
     v = contents_self.erase(v);
@@ -399,5 +406,5 @@ Airspaces::VisitInside(const GeoPoint &loc, AirspaceVisitor &visitor) const
       visitor.Visit(v);
   };
 
-  airspace_tree.visit_within_range(bb_target, 0, visitor2);
+  airspace_tree.VisitWithinRange(bb_target, 0, visitor2);
 }
@@ -38,21 +38,21 @@ class AirspaceVisitor;
 class AirspaceIntersectionVisitor;
 
 /**
- * Container for airspaces using kd-tree representation internally for
- * fast geospatial lookups.
+ * Container for airspaces using a packed R-tree representation
+ * internally for fast geospatial lookups.
  *
- * Complexity analysis (with kdtree):
+ * Complexity analysis (with R-tree):
  *
- *    Find within range (k points found):
- *     O(n^(3/4) + k)
+ *    Find within range (k airspaces found):
+ *     O(log(n) + k) typical, O(n) worst case
  *
  *    Find intersecting:
- *     O(n^(3/4) + k)
+ *     O(log(n) + k) typical, O(n) worst case
  *
  *    Find nearest:
- *     O(log(n))
+ *     O(log(n)) typical
  *
- *  Without kd-tree:
+ *  Without R-tree:
  *
  *    Find within range:
  *     O(n)
@@ -115,6 +115,14 @@ public:
    */
   void Add(AbstractAirspace *asp);
 
+  /**
+   * Transfer all airspaces of another instance to this one.  Both
+   * must own their airspaces.  Call Optimise() afterwards.
+   *
+   * @param other the source; it is empty afterwards
+   */
+  void MoveFrom(Airspaces &other);
+
   /**
    * Re-organise the internal airspace tree after inserting/deleting.
    * Should be called after inserting/deleting airspaces prior to performing
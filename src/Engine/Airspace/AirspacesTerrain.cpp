@@ -21,19 +21,59 @@
 */
 
 #include "Airspaces.hpp"
+#include "AbstractAirspace.hpp"
 #include "Terrain/RasterTerrain.hpp"
+#include "Util/Macros.hpp"
+
+#include <assert.h>
+
+/**
+ * Look up the terrain heights of the collected airspaces and apply
+ * them.
+ */
+static void
+ApplyGroundLevels(const RasterTerrain &terrain,
+                  AbstractAirspace *const*airspaces,
+                  const GeoPoint *locations, unsigned n)
+{
+  short heights[64];
+  assert(n <= ARRAY_SIZE(heights));
+
+  terrain.GetTerrainHeights(locations, heights, n);
+
+  for (unsigned i = 0; i < n; ++i) {
+    short h = heights[i];
+    if (RasterBuffer::IsSpecial(h))
+      /* apply fallback, see RasterTerrain::GetTerrainHeightOr0() */
+      h = 0;
+
+    airspaces[i]->SetGroundLevel(fixed(h));
+  }
+}
 
 void 
 Airspaces::SetGroundLevels(const RasterTerrain &terrain)
 {
+  /* query the terrain in batches, which is cheaper than looking up
+     each airspace individually */
+  AbstractAirspace *airspaces[64];
+  GeoPoint locations[ARRAY_SIZE(airspaces)];
+  unsigned n = 0;
+
   for (auto &v : airspace_tree) {
     // If we don't need the ground level we don't have to calculate it
     if (!v.NeedGroundLevel())
       continue;
 
     FlatGeoPoint c_flat = v.GetCenter();
-    GeoPoint g = task_projection.Unproject(c_flat);
-    v.SetGroundLevel(fixed(terrain.GetTerrainHeightOr0(g)));
+    airspaces[n] = &v.GetAirspace();
+    locations[n] = task_projection.Unproject(c_flat);
+
+    if (++n == ARRAY_SIZE(airspaces)) {
+      ApplyGroundLevels(terrain, airspaces, locations, n);
+      n = 0;
+    }
   }
-}
 
+  ApplyGroundLevels(terrain, airspaces, locations, n);
+}
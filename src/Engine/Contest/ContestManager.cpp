@@ -94,6 +94,24 @@ ContestManager::SetHandicap(unsigned handicap)
   net_coupe.SetHandicap(handicap);
 }
 
+/**
+ * Copy the best result of a solver which has returned
+ * SolverResult::VALID.
+ */
+static void
+CopyResult(const AbstractContest &_contest,
+           ContestResult &result, ContestTraceVector &solution)
+{
+  // if no improved solution was found, must have finished processing
+  // with invalid data
+  result = _contest.GetBestResult();
+
+  // solver finished and improved solution was found.  save solution
+  // and retrieve new trace.
+
+  solution = _contest.GetBestSolution();
+}
+
 static bool
 RunContest(AbstractContest &_contest,
            ContestResult &result, ContestTraceVector &solution,
@@ -105,46 +123,83 @@ RunContest(AbstractContest &_contest,
   if (r != SolverResult::VALID)
     return false;
 
-  // if no improved solution was found, must have finished processing
-  // with invalid data
-  result = _contest.GetBestResult();
-
-  // solver finished and improved solution was found.  save solution
-  // and retrieve new trace.
-
-  solution = _contest.GetBestSolution();
-
+  CopyResult(_contest, result, solution);
   return true;
 }
 
-bool
-ContestManager::UpdateIdle(bool exhaustive)
+unsigned
+ContestManager::GetSolvers(SolverJob jobs[MAX_SOLVERS])
 {
-  bool retval = false;
-
   switch (contest) {
   case Contest::NONE:
     break;
 
   case Contest::OLC_SPRINT:
-    retval = RunContest(olc_sprint, stats.result[0],
-                        stats.solution[0], exhaustive);
-    break;
+    jobs[0] = {&olc_sprint, 0};
+    return 1;
 
   case Contest::OLC_FAI:
-    retval = RunContest(olc_fai, stats.result[0],
-                        stats.solution[0], exhaustive);
-    break;
+    jobs[0] = {&olc_fai, 0};
+    return 1;
 
   case Contest::OLC_CLASSIC:
-    retval = RunContest(olc_classic, stats.result[0],
-                        stats.solution[0], exhaustive);
-    break;
+    jobs[0] = {&olc_classic, 0};
+    return 1;
 
   case Contest::OLC_LEAGUE:
-    retval = RunContest(olc_classic, stats.result[1],
-                        stats.solution[1], exhaustive);
+    /* the league is solved by Merge(), from the classic solution */
+    jobs[0] = {&olc_classic, 1};
+    return 1;
 
+  case Contest::OLC_PLUS:
+    /* the "plus" score is calculated by Merge() */
+    jobs[0] = {&olc_classic, 0};
+    jobs[1] = {&olc_fai, 1};
+    return 2;
+
+  case Contest::DMST:
+    jobs[0] = {&dmst_quad, 0};
+    return 1;
+
+  case Contest::XCONTEST:
+    jobs[0] = {&xcontest_free, 0};
+    jobs[1] = {&xcontest_triangle, 1};
+    return 2;
+
+  case Contest::DHV_XC:
+    jobs[0] = {&dhv_xc_free, 0};
+    jobs[1] = {&dhv_xc_triangle, 1};
+    return 2;
+
+  case Contest::SIS_AT:
+    jobs[0] = {&sis_at, 0};
+    return 1;
+
+  case Contest::NET_COUPE:
+    jobs[0] = {&net_coupe, 0};
+    return 1;
+  };
+
+  return 0;
+}
+
+bool
+ContestManager::Merge(const SolverJob jobs[], const SolverResult results[],
+                      unsigned n, bool exhaustive)
+{
+  bool retval = false;
+
+  for (unsigned i = 0; i < n; ++i) {
+    if (results[i] != SolverResult::VALID)
+      continue;
+
+    const unsigned index = jobs[i].index;
+    CopyResult(*jobs[i].solver, stats.result[index], stats.solution[index]);
+    retval = true;
+  }
+
+  switch (contest) {
+  case Contest::OLC_LEAGUE:
     olc_league.Feed(stats.solution[1]);
 
     retval |= RunContest(olc_league, stats.result[0],
@@ -152,12 +207,6 @@ ContestManager::UpdateIdle(bool exhaustive)
     break;
 
   case Contest::OLC_PLUS:
-    retval = RunContest(olc_classic, stats.result[0],
-                        stats.solution[0], exhaustive);
-
-    retval |= RunContest(olc_fai, stats.result[1],
-                         stats.solution[1], exhaustive);
-
     if (retval) {
       olc_plus.Feed(stats.result[0], stats.solution[0],
                     stats.result[1], stats.solution[1]);
@@ -168,38 +217,24 @@ ContestManager::UpdateIdle(bool exhaustive)
 
     break;
 
-  case Contest::DMST:
-    retval = RunContest(dmst_quad, stats.result[0],
-                        stats.solution[0], exhaustive);
-    break;
-
-  case Contest::XCONTEST:
-    retval = RunContest(xcontest_free, stats.result[0],
-                        stats.solution[0], exhaustive);
-    retval |= RunContest(xcontest_triangle, stats.result[1],
-                         stats.solution[1], exhaustive);
-    break;
-
-  case Contest::DHV_XC:
-    retval = RunContest(dhv_xc_free, stats.result[0],
-                        stats.solution[0], exhaustive);
-    retval |= RunContest(dhv_xc_triangle, stats.result[1],
-                         stats.solution[1], exhaustive);
+  default:
     break;
+  }
 
-  case Contest::SIS_AT:
-    retval = RunContest(sis_at, stats.result[0],
-                        stats.solution[0], exhaustive);
-    break;
+  return retval;
+}
 
-  case Contest::NET_COUPE:
-    retval = RunContest(net_coupe, stats.result[0],
-                        stats.solution[0], exhaustive);
-    break;
+bool
+ContestManager::UpdateIdle(bool exhaustive)
+{
+  SolverJob jobs[MAX_SOLVERS];
+  SolverResult results[MAX_SOLVERS];
 
-  };
+  const unsigned n = GetSolvers(jobs);
+  for (unsigned i = 0; i < n; ++i)
+    results[i] = jobs[i].solver->Solve(exhaustive);
 
-  return retval;
+  return Merge(jobs, results, n, exhaustive);
 }
 
 void
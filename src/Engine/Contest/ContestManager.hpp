@@ -96,6 +96,47 @@ public:
 
   void SetHandicap(unsigned handicap);
 
+  /**
+   * The maximum number of independent solvers used by one contest.
+   */
+  static constexpr unsigned MAX_SOLVERS = 2;
+
+  /**
+   * One solver which needs to run for the current contest.
+   */
+  struct SolverJob {
+    AbstractContest *solver;
+
+    /**
+     * The index in ContestStatistics::result and
+     * ContestStatistics::solution where the result will be stored.
+     */
+    unsigned index;
+  };
+
+  /**
+   * Obtain the solvers which need to run for the current contest.
+   * They are independent of each other: their
+   * AbstractContest::Solve() methods may be called concurrently, as
+   * long as the #Trace objects are not modified meanwhile.  After
+   * all of them have returned, call Merge().
+   *
+   * @return the number of solvers
+   */
+  unsigned GetSolvers(SolverJob jobs[MAX_SOLVERS]);
+
+  /**
+   * Copy the results of the solvers obtained by GetSolvers() to the
+   * #ContestStatistics, and run the contests which combine them
+   * (OLC League, OLC Plus).
+   *
+   * @param results the return values of AbstractContest::Solve(), in
+   * the same order as the jobs
+   * @return True if internal state changed
+   */
+  bool Merge(const SolverJob jobs[], const SolverResult results[],
+             unsigned n, bool exhaustive);
+
   /**
    * Update internal states (non-essential) for housework,
    * or where functions are slow and would cause loss to real-time performance.
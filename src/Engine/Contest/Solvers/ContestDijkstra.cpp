@@ -30,9 +30,6 @@ Copyright_License {
 #include <assert.h>
 #include <limits.h>
 
-// set size of reserved queue elements (may differ from Dijkstra default)
-static constexpr unsigned CONTEST_QUEUE_SIZE = 5000;
-
 ContestDijkstra::ContestDijkstra(const Trace &_trace,
                                  bool _continuous,
                                  const unsigned n_legs,
@@ -118,8 +115,8 @@ ContestDijkstra::Solve(bool exhaustive)
     trace_dirty = false;
     finished = false;
 
-    dijkstra.Clear();
-    dijkstra.Reserve(CONTEST_QUEUE_SIZE);
+    /* one more column for the predicted point */
+    ClearDijkstra(trace_master.GetMaxSize() + 1);
 
     StartSearch();
     AddStartEdges();
@@ -85,6 +85,7 @@ OLCTriangle::Reset()
   ClearTrace();
 
   ResetBranchAndBound();
+  completed_runs.clear();
   AbstractContest::Reset();
 }
 
@@ -115,6 +116,10 @@ OLCTriangle::UpdateTrace(bool force)
   if (IsMasterAppended()) return; /* unmodified */
 
   if (force || IsMasterUpdated(false)) {
+    if (CheckMasterSerial())
+      /* the master trace was thinned, point indices have changed */
+      completed_runs.clear();
+
     UpdateTraceFull();
 
     is_complete = false;
@@ -307,6 +312,79 @@ OLCTriangle::SolveTriangle(bool exhaustive)
 }
 
 
+/**
+ * Upper limit for the number of cached branch and bound runs.  This
+ * is only reached if the closing pairs change all the time; the cache
+ * is flushed then.
+ */
+static constexpr unsigned MAX_COMPLETED_RUNS = 1024;
+
+std::tuple<unsigned, unsigned, unsigned, unsigned>
+OLCTriangle::GetRunResult(const BranchAndBoundRun &run, unsigned worst_d) const
+{
+  if (run.df_max > 0 && run.df_min >= worst_d)
+    return std::make_tuple(run.tp1, run.tp2, run.tp3, run.df_max);
+  else
+    return std::tuple<unsigned, unsigned, unsigned, unsigned>(0, 0, 0, 0);
+}
+
+bool
+OLCTriangle::StartBranchAndBound(unsigned from, unsigned to, unsigned worst_d,
+                                 unsigned large_triangle_check)
+{
+  current_run.from = from;
+  current_run.to = to;
+  current_run.worst_d = worst_d;
+  current_run.tp1 = current_run.tp2 = current_run.tp3 = 0;
+  current_run.df_min = current_run.df_max = 0;
+
+  /* the last turn point of the triangles which need to be searched
+     is at or after this index */
+  unsigned tp3_min = from;
+
+  auto i = completed_runs.lower_bound(ClosingPair(from, to));
+  if (i != completed_runs.end() && i->first == ClosingPair(from, to) &&
+      i->second.worst_d <= worst_d) {
+    /* this range has been searched already */
+    current_run = i->second;
+    current_run.worst_d = worst_d;
+    return false;
+  }
+
+  if (i != completed_runs.begin()) {
+    const auto previous = std::prev(i);
+    if (previous->first.first == from &&
+        previous->second.worst_d <= worst_d) {
+      /* a shorter range with the same start has been searched
+         already: start with its result, and search only the
+         triangles which end in the new points */
+      const BranchAndBoundRun &run = previous->second;
+      if (run.df_max > 0 && run.df_min >= worst_d) {
+        current_run.tp1 = run.tp1;
+        current_run.tp2 = run.tp2;
+        current_run.tp3 = run.tp3;
+        current_run.df_min = run.df_min;
+        current_run.df_max = run.df_max;
+      }
+
+      tp3_min = run.to + 1;
+      completed_runs.erase(previous);
+    }
+  }
+
+  worst_d = std::max(worst_d, current_run.df_min);
+
+  // initialize bound-and-branch tree with root node (note: Candidate set interval is [min, max))
+  CandidateSet root_candidates(TurnPointRange(this, from, to + 1),
+                               TurnPointRange(this, from, to + 1),
+                               TurnPointRange(this, tp3_min, to + 1));
+  if (root_candidates.IsFeasible(is_fai, large_triangle_check) &&
+      root_candidates.df_max >= worst_d)
+    branch_and_bound.push(root_candidates);
+
+  return true;
+}
+
 std::tuple<unsigned, unsigned, unsigned, unsigned>
 OLCTriangle::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d, bool exhaustive)
 {
@@ -326,11 +404,6 @@ OLCTriangle::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d, boo
   if (fastskiprange_flat < worst_d)
     return std::tuple<unsigned, unsigned, unsigned, unsigned>(0, 0, 0, 0);
 
-  bool integral_feasible = false;
-  unsigned best_d = 0,
-           tp1 = 0,
-           tp2 = 0,
-           tp3 = 0;
   unsigned iterations = 0;
 
   // note: this is _not_ the breakepoint between small and large triangles,
@@ -338,154 +411,192 @@ OLCTriangle::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d, boo
   const unsigned large_triangle_check =
     trace_master.ProjectRange(GetPoint(from).GetLocation(), fixed(500000)) * 0.99;
 
+  if (running && (current_run.from != from || current_run.to != to))
+    /* the unfinished run was for another closing pair; its nodes
+       can't be used for this one */
+    ResetBranchAndBound();
+
   if (!running) {
     // initiate algorithm. otherwise continue unfinished run
-    running = true;
+    if (!StartBranchAndBound(from, to, worst_d, large_triangle_check))
+      return GetRunResult(current_run, worst_d);
 
-    // initialize bound-and-branch tree with root node (note: Candidate set interval is [min, max))
-    CandidateSet root_candidates(this, from, to + 1);
-    if (root_candidates.IsFeasible(is_fai, large_triangle_check) &&
-        root_candidates.df_max >= worst_d)
-      branch_and_bound.insert(std::pair<unsigned, CandidateSet>(root_candidates.df_max, root_candidates));
+    running = true;
   }
 
+  /* nodes below the requested distance will be discarded, so the
+     result of this run is only valid above it */
+  const unsigned requested_d = worst_d;
+  current_run.worst_d = std::max(current_run.worst_d, requested_d);
+  worst_d = std::max(worst_d, current_run.df_min);
+
   // set max_iterations only if non-exhaustive and predictive solving is enabled.
   // otherwise use predefined value.
   if (!exhaustive && predict)
     max_iterations = tick_iterations;
 
-  while (!branch_and_bound.empty()) {
+  /* the node being worked on; in depth-first mode, this is one of the
+     children of the previous node, which was not added to the tree */
+  CandidateSet node;
+  bool dive = false;
+
+  while (dive || !branch_and_bound.empty()) {
     /* now loop over the tree, branching each found candidate set, adding the branch if it's feasible.
      * remove all candidate sets with d_max smaller than d_min of the largest integral candidate set
-     * always work on the node with largest d_min
+     * always work on the node with largest d_max
      */
 
     iterations++;
 
+    // remove nodes with d_max < worst_d before checking the tree size
+    if (branch_and_bound.size() > max_tree_size)
+      branch_and_bound.Prune(worst_d);
+
     // break loop if max_iterations or max_tree_size exceeded
     if (iterations > max_iterations || branch_and_bound.size() > max_tree_size)
       break;
 
-    // first clean up tree, removeing all nodes with d_max < worst_d
-    branch_and_bound.erase(branch_and_bound.begin(), branch_and_bound.lower_bound(worst_d));
-
-    // we might have cleaned up the whole tree. nothing to do then...
-    if (branch_and_bound.empty())
-      break;
-
-    /* get node to work on.
-     * change node selection strategy if the tree grows too big.
-     * this is a mixed depht-first/breadth-first approach, the latter
-     * beeing faster, but the first a lot more memory efficient.
-     */
-    std::multimap<unsigned, CandidateSet>::iterator node;
-
-    if (branch_and_bound.size() > n_points * 4 && iterations % 16 != 0) {
-      node = branch_and_bound.upper_bound(branch_and_bound.rbegin()->first / 2);
-      if (node == branch_and_bound.end()) --node;
+    if (dive) {
+      dive = false;
+      if (node.df_max < worst_d)
+        continue;
     } else {
-      node = --branch_and_bound.end();
+      // the heap's top has the largest d_max: if it's smaller than
+      // worst_d, the whole tree can be discarded
+      if (branch_and_bound.top().df_max < worst_d) {
+        branch_and_bound.clear();
+        break;
+      }
+
+      node = branch_and_bound.pop();
     }
 
-    if (node->second.df_min >= worst_d &&
-        node->second.IsIntegral(this, is_fai, large_triangle_check)) {
+    if (node.df_min >= worst_d &&
+        node.IsIntegral(this, is_fai, large_triangle_check)) {
       // node is integral feasible -> a possible solution
 
-      worst_d = node->second.df_min;
+      worst_d = node.df_min;
+
+      unsigned tp1 = node.tp1.index_min;
+      unsigned tp2 = node.tp2.index_min;
+      unsigned tp3 = node.tp3.index_min;
 
-      tp1 = node->second.tp1.index_min;
-      tp2 = node->second.tp2.index_min;
-      tp3 = node->second.tp3.index_min;
-      best_d = node->first;
+      if (tp1 > tp2) std::swap(tp1, tp2);
+      if (tp2 > tp3) std::swap(tp2, tp3);
+      if (tp1 > tp2) std::swap(tp1, tp2);
 
-      integral_feasible = true;
+      current_run.tp1 = tp1;
+      current_run.tp2 = tp2;
+      current_run.tp3 = tp3;
+      current_run.df_min = node.df_min;
+      current_run.df_max = node.df_max;
 
     } else {
       // split largest bounding box of node and create child nodes
 
-      const unsigned tp1_diag = node->second.tp1.GetDiagnoal();
-      const unsigned tp2_diag = node->second.tp2.GetDiagnoal();
-      const unsigned tp3_diag = node->second.tp3.GetDiagnoal();
+      const unsigned tp1_diag = node.tp1.GetDiagnoal();
+      const unsigned tp2_diag = node.tp2.GetDiagnoal();
+      const unsigned tp3_diag = node.tp3.GetDiagnoal();
 
       const unsigned max_diag = std::max({tp1_diag, tp2_diag, tp3_diag});
 
       CandidateSet left, right;
       bool add = false;
 
-      if (tp1_diag == max_diag && node->second.tp1.GetSize() != 1) {
+      if (tp1_diag == max_diag && node.tp1.GetSize() != 1) {
         // split tp1 range
-        const unsigned split = (node->second.tp1.index_min + node->second.tp1.index_max) / 2;
+        const unsigned split = (node.tp1.index_min + node.tp1.index_max) / 2;
 
-        if (split <= node->second.tp2.index_max) {
+        if (split <= node.tp2.index_max) {
           add = true;
 
-          left = CandidateSet(TurnPointRange(this, node->second.tp1.index_min, split),
-                              node->second.tp2, node->second.tp3);
+          left = CandidateSet(TurnPointRange(this, node.tp1.index_min, split),
+                              node.tp2, node.tp3);
 
-          right = CandidateSet(TurnPointRange(this, split, node->second.tp1.index_max),
-                               node->second.tp2, node->second.tp3);
+          right = CandidateSet(TurnPointRange(this, split, node.tp1.index_max),
+                               node.tp2, node.tp3);
         }
-      } else if (tp2_diag == max_diag && node->second.tp2.GetSize() != 1) {
+      } else if (tp2_diag == max_diag && node.tp2.GetSize() != 1) {
         // split tp2 range
-        const unsigned split = (node->second.tp2.index_min + node->second.tp2.index_max) / 2;
+        const unsigned split = (node.tp2.index_min + node.tp2.index_max) / 2;
 
-        if (split <= node->second.tp3.index_max && split >= node->second.tp1.index_min) {
+        if (split <= node.tp3.index_max && split >= node.tp1.index_min) {
           add = true;
 
-          left = CandidateSet(node->second.tp1,
-                              TurnPointRange(this, node->second.tp2.index_min, split),
-                              node->second.tp3);
+          left = CandidateSet(node.tp1,
+                              TurnPointRange(this, node.tp2.index_min, split),
+                              node.tp3);
 
-          right = CandidateSet(node->second.tp1,
-                               TurnPointRange(this, split, node->second.tp2.index_max),
-                               node->second.tp3);
+          right = CandidateSet(node.tp1,
+                               TurnPointRange(this, split, node.tp2.index_max),
+                               node.tp3);
         }
-      } else if (node->second.tp3.GetSize() != 1) {
+      } else if (node.tp3.GetSize() != 1) {
         // split tp3 range
-        const unsigned split = (node->second.tp3.index_min + node->second.tp3.index_max) / 2;
+        const unsigned split = (node.tp3.index_min + node.tp3.index_max) / 2;
 
-        if (split >= node->second.tp2.index_min) {
+        if (split >= node.tp2.index_min) {
           add = true;
 
-          left = CandidateSet(node->second.tp1, node->second.tp2,
-                              TurnPointRange(this, node->second.tp3.index_min, split));
+          left = CandidateSet(node.tp1, node.tp2,
+                              TurnPointRange(this, node.tp3.index_min, split));
 
-          right = CandidateSet(node->second.tp1, node->second.tp2,
-                               TurnPointRange(this, split, node->second.tp3.index_max));
+          right = CandidateSet(node.tp1, node.tp2,
+                               TurnPointRange(this, split, node.tp3.index_max));
         }
       }
 
       if (add) {
         // add the new candidate set only if it it's feasible and has d_min >= worst_d
-        if (left.df_max >= worst_d &&
-            left.IsFeasible(is_fai, large_triangle_check)) {
-          branch_and_bound.insert(std::pair<unsigned, CandidateSet>(left.df_max, left));
-        }
+        const bool add_left = left.df_max >= worst_d &&
+          left.IsFeasible(is_fai, large_triangle_check);
+        const bool add_right = right.df_max >= worst_d &&
+          right.IsFeasible(is_fai, large_triangle_check);
+
+        /* change node selection strategy if the tree grows too big.
+         * this is a mixed depth-first/best-first approach, the latter
+         * being faster, but the first a lot more memory efficient:
+         * continue with the better child, which quickly leads to an
+         * integral solution and raises worst_d.
+         */
+        if (add_left && add_right &&
+            branch_and_bound.size() > n_points * 4 && iterations % 16 != 0) {
+          if (left.df_max >= right.df_max) {
+            node = left;
+            branch_and_bound.push(right);
+          } else {
+            node = right;
+            branch_and_bound.push(left);
+          }
+
+          dive = true;
+        } else {
+          if (add_left)
+            branch_and_bound.push(left);
 
-        if (right.df_max >= worst_d &&
-            right.IsFeasible(is_fai, large_triangle_check)) {
-          branch_and_bound.insert(std::pair<unsigned, CandidateSet>(right.df_max, right));
+          if (add_right)
+            branch_and_bound.push(right);
         }
       }
     }
-
-    // remove current node
-    branch_and_bound.erase(node);
   }
 
+  if (dive)
+    /* suspended in depth-first mode: keep the node for the next
+       run */
+    branch_and_bound.push(node);
 
-  if (branch_and_bound.empty())
+  if (branch_and_bound.empty()) {
     running = false;
 
-  if (integral_feasible) {
-    if (tp1 > tp2) std::swap(tp1, tp2);
-    if (tp2 > tp3) std::swap(tp2, tp3);
-    if (tp1 > tp2) std::swap(tp1, tp2);
+    if (completed_runs.size() >= MAX_COMPLETED_RUNS)
+      completed_runs.clear();
 
-    return std::tuple<unsigned, unsigned, unsigned, unsigned>(tp1, tp2, tp3, best_d);
-  } else {
-    return std::tuple<unsigned, unsigned, unsigned, unsigned>(0, 0, 0, 0);
+    completed_runs[ClosingPair(current_run.from, current_run.to)] =
+      current_run;
   }
+
+  return GetRunResult(current_run, requested_d);
 }
 
 ContestResult
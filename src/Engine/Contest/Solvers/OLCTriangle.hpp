@@ -28,7 +28,10 @@
 #include "Trace/Point.hpp"
 
 #include <map>
+#include <vector>
+#include <algorithm>
 #include <cstdlib>
+#include <assert.h>
 
 /**
  * Specialisation of AbstractContest for OLC Triangle (triangle) rules
@@ -360,7 +363,102 @@ private:
     }
   };
 
-  std::multimap<unsigned, CandidateSet> branch_and_bound;
+  /**
+   * The branch and bound tree: a binary max-heap of candidate sets,
+   * ordered by df_max.  The backing vector keeps its capacity between
+   * runs, so after warming up, the solver doesn't allocate memory.
+   */
+  class CandidateHeap {
+    std::vector<CandidateSet> heap;
+
+    struct Compare {
+      gcc_pure
+      bool operator()(const CandidateSet &a, const CandidateSet &b) const {
+        return a.df_max < b.df_max;
+      }
+    };
+
+  public:
+    bool empty() const {
+      return heap.empty();
+    }
+
+    unsigned size() const {
+      return heap.size();
+    }
+
+    void clear() {
+      heap.clear();
+    }
+
+    const CandidateSet &top() const {
+      assert(!empty());
+      return heap.front();
+    }
+
+    void push(const CandidateSet &c) {
+      heap.push_back(c);
+      std::push_heap(heap.begin(), heap.end(), Compare());
+    }
+
+    CandidateSet pop() {
+      assert(!empty());
+      std::pop_heap(heap.begin(), heap.end(), Compare());
+      CandidateSet c = heap.back();
+      heap.pop_back();
+      return c;
+    }
+
+    /**
+     * Remove all candidate sets with df_max < worst_d.
+     */
+    void Prune(unsigned worst_d) {
+      heap.erase(std::remove_if(heap.begin(), heap.end(),
+                                [worst_d](const CandidateSet &c) {
+                                  return c.df_max < worst_d;
+                                }),
+                 heap.end());
+      std::make_heap(heap.begin(), heap.end(), Compare());
+    }
+  };
+
+  CandidateHeap branch_and_bound;
+
+  /**
+   * The state of a branch and bound run over the closing pair
+   * [from, to].
+   */
+  struct BranchAndBoundRun {
+    unsigned from, to;
+
+    /**
+     * Triangles with df_min below this value were not searched.
+     */
+    unsigned worst_d;
+
+    /**
+     * The best triangle found so far (sorted indices); df_max is 0 if
+     * there is none.
+     */
+    unsigned tp1, tp2, tp3;
+    unsigned df_min, df_max;
+  };
+
+  /**
+   * The run which is currently in the #branch_and_bound tree.  Only
+   * valid while #running is set.
+   */
+  BranchAndBoundRun current_run;
+
+  /**
+   * Completed runs, indexed by their closing pair.  As long as the
+   * master trace is only appended to, point indices remain stable, so
+   * these results stay valid: a run over the same range is skipped,
+   * and a run over a range that was extended at the end only searches
+   * triangles with the last turn point among the new points.  The
+   * cache is flushed when the trace gets thinned.
+   */
+  std::map<ClosingPair, BranchAndBoundRun> completed_runs;
 
 public:
   OLCTriangle(const Trace &_trace,
@@ -382,6 +480,20 @@ protected:
   void UpdateTrace(bool force) override;
   void ResetBranchAndBound();
 
+private:
+  /**
+   * Look up #completed_runs and prepare #current_run and the root of
+   * the #branch_and_bound tree for a new run over [from, to].
+   *
+   * @return false if a completed run covers the whole range, and no
+   * search is necessary
+   */
+  bool StartBranchAndBound(unsigned from, unsigned to, unsigned worst_d,
+                           unsigned large_triangle_check);
+
+  std::tuple<unsigned, unsigned, unsigned, unsigned>
+  GetRunResult(const BranchAndBoundRun &run, unsigned worst_d) const;
+
 public:
   void SetMaxIterations(unsigned _max_iterations) {
     max_iterations = _max_iterations;
@@ -24,9 +24,11 @@ Copyright_License {
 #ifndef DIJKSTRA_HPP
 #define DIJKSTRA_HPP
 
-#include "Util/ReservablePriorityQueue.hpp"
+#include "Util/RadixHeap.hpp"
 #include "Compiler.h"
 
+#include <utility>
+
 #define DIJKSTRA_MINMAX_OFFSET 134217727
 
 /**
@@ -62,10 +64,10 @@ private:
       :edge_value(_edge_value), iterator(_iterator) {}
   };
 
-  struct Rank : public std::binary_function<Value, Value, bool> {
+  struct GetValueKey {
     gcc_pure
-    bool operator()(const Value &x, const Value &y) const {
-      return x.edge_value > y.edge_value;
+    unsigned operator()(const Value &x) const {
+      return x.edge_value;
     }
   };
 
@@ -77,8 +79,13 @@ private:
 
   /**
    * A sorted list of all possible node paths, lowest distance first.
+   * The distances are integers, and Dijkstra never pushes a distance
+   * lower than the one just popped, which makes a radix heap cheaper
+   * than a binary heap.  Paths of the same distance are popped in the
+   * order they were pushed; this decides which of them a contest
+   * solver keeps.
    */
-  reservable_priority_queue<Value, std::vector<Value>, Rank> q;
+  RadixHeap<Value, GetValueKey> q;
 
   /**
    * The value of the current edge, i.e. the one that was consumed by
@@ -195,10 +202,12 @@ public:
   }
 
   /**
-   * Reserve queue size (if available)
+   * Pass the dimensions of the search to the edge map, e.g. to size a
+   * flat array.  Call this before the first Link(), or after Clear().
    */
-  void Reserve(unsigned size) {
-    q.reserve(size);
+  template<typename... Args>
+  void ResizeEdgeMap(Args&&... args) {
+    edges.Resize(std::forward<Args>(args)...);
   }
 
   /**
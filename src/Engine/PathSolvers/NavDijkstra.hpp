@@ -26,10 +26,10 @@ Copyright_License {
 
 #include "Dijkstra.hpp"
 #include "ScanTaskPoint.hpp"
+#include "ScanTaskPointMap.hpp"
 #include "SolverResult.hpp"
 #include "Compiler.h"
 
-#include <unordered_map>
 #include <assert.h>
 
 /**
@@ -45,21 +45,8 @@ protected:
   static constexpr unsigned MAX_STAGES = 32;
 
   struct DijkstraMap {
-    struct Hash {
-      std::size_t operator()(ScanTaskPoint p) const {
-        return p.Key();
-      }
-    };
-
-    struct Equal {
-      std::size_t operator()(ScanTaskPoint a, ScanTaskPoint b) const {
-        return a.Key() == b.Key();
-      }
-    };
-
     template<typename Value>
-    struct Bind : public std::unordered_map<ScanTaskPoint, Value,
-                                            Hash, Equal> {
+    struct Bind : public ScanTaskPointMap<Value> {
     };
   };
 
@@ -100,6 +87,17 @@ protected:
     num_stages =_num_stages;
   }
 
+  /**
+   * Clear the #Dijkstra object and prepare its edge map for the
+   * current number of stages.
+   *
+   * @param stage_size the maximum number of points in one stage
+   */
+  void ClearDijkstra(unsigned stage_size) {
+    dijkstra.Clear();
+    dijkstra.ResizeEdgeMap(num_stages, stage_size);
+  }
+
   /**
    * Determine whether a finished path is valid
    *
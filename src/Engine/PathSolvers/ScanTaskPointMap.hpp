@@ -0,0 +1,163 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef SCAN_TASK_POINT_MAP_HPP
+#define SCAN_TASK_POINT_MAP_HPP
+
+#include "ScanTaskPoint.hpp"
+#include "Compiler.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <assert.h>
+
+/**
+ * A map from #ScanTaskPoint to a value, stored in a flat array which
+ * is indexed by "stage * stage_size + point_index".  Lookups don't
+ * hash and insertions don't allocate; clear() only touches the
+ * entries inserted since the last call.
+ *
+ * Before inserting, call Resize() with the dimensions of the search.
+ * Point indices at or beyond the stage size are mapped to the last
+ * column of their stage; this is used for ContestDijkstra's
+ * "predicted" point.
+ *
+ * Entries are stored in insertion order, and iterators remain valid
+ * until clear() or Resize() is called.
+ */
+template<typename Value>
+class ScanTaskPointMap {
+public:
+  typedef std::pair<ScanTaskPoint, Value> value_type;
+  typedef value_type *iterator;
+  typedef const value_type *const_iterator;
+
+private:
+  unsigned n_stages = 0, stage_size = 0;
+
+  /**
+   * The position of each node in #entries plus one; 0 means the node
+   * is not in the map.
+   */
+  std::vector<unsigned> index;
+
+  /**
+   * The entries in insertion order.  Its capacity is reserved by
+   * Resize(), so it never reallocates while inserting.
+   */
+  std::vector<value_type> entries;
+
+public:
+  /**
+   * Prepare the map for a search with the given dimensions.  This is
+   * a no-op if the dimensions have not changed.
+   */
+  void Resize(unsigned _n_stages, unsigned _stage_size) {
+    if (_n_stages == n_stages && _stage_size == stage_size)
+      return;
+
+    n_stages = _n_stages;
+    stage_size = _stage_size;
+
+    const unsigned n = n_stages * stage_size;
+    index.assign(n, 0);
+
+    if (n > entries.capacity()) {
+      assert(entries.empty());
+      entries.reserve(n);
+    } else {
+      for (unsigned i = 0, end = entries.size(); i != end; ++i)
+        index[GetIndex(entries[i].first)] = i + 1;
+    }
+  }
+
+  gcc_pure
+  bool empty() const {
+    return entries.empty();
+  }
+
+  gcc_pure
+  unsigned size() const {
+    return entries.size();
+  }
+
+  void clear() {
+    for (const auto &i : entries)
+      index[GetIndex(i.first)] = 0;
+    entries.clear();
+  }
+
+  iterator begin() {
+    return entries.data();
+  }
+
+  iterator end() {
+    return entries.data() + entries.size();
+  }
+
+  const_iterator begin() const {
+    return entries.data();
+  }
+
+  const_iterator end() const {
+    return entries.data() + entries.size();
+  }
+
+  gcc_pure
+  iterator find(ScanTaskPoint p) {
+    const unsigned i = index[GetIndex(p)];
+    return i > 0 ? begin() + i - 1 : end();
+  }
+
+  gcc_pure
+  const_iterator find(ScanTaskPoint p) const {
+    const unsigned i = index[GetIndex(p)];
+    return i > 0 ? begin() + i - 1 : end();
+  }
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    unsigned &i = index[GetIndex(value.first)];
+    if (i > 0)
+      return std::make_pair(begin() + i - 1, false);
+
+    assert(entries.size() < entries.capacity());
+
+    entries.push_back(value);
+    i = entries.size();
+    return std::make_pair(end() - 1, true);
+  }
+
+private:
+  gcc_pure
+  unsigned GetIndex(ScanTaskPoint p) const {
+    assert(p.GetStageNumber() < n_stages);
+    assert(stage_size > 0);
+
+    return p.GetStageNumber() * stage_size +
+      std::min(p.GetPointIndex(), stage_size - 1);
+  }
+};
+
+#endif
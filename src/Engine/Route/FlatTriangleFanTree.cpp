@@ -26,6 +26,7 @@
 #include "ReachFanParms.hpp"
 #include "Util/GlobalSliceAllocator.hpp"
 #include "Geo/Flat/FlatProjection.hpp"
+#include "Util/Macros.hpp"
 
 #define REACH_BUFFER 1
 #define REACH_SWEEP (ROUTEPOLAR_Q1-REACH_BUFFER)
@@ -211,17 +212,30 @@ FlatTriangleFanTree::UpdateTerrainBase(const FlatGeoPoint &o,
     return;
   }
 
-  for (const auto &x : vs) {
-    const FlatGeoPoint av = (o + x) * fixed(0.5);
-    const GeoPoint p = parms.projection.Unproject(av);
-    short h = parms.terrain->GetHeight(p);
-
-    if (RasterBuffer::IsWater(h))
-      /* water: assume 0m MSL */
-      parms.terrain_counter++;
-    else if (!RasterBuffer::IsInvalid(h)) {
-      parms.terrain_counter++;
-      parms.terrain_base += h;
+  /* look up the heights in batches, which is cheaper than one at a
+     time */
+  GeoPoint locations[64];
+  short heights[ARRAY_SIZE(locations)];
+
+  for (auto i = vs.begin(), end = vs.end(); i != end;) {
+    unsigned n = 0;
+    for (; i != end && n < ARRAY_SIZE(locations); ++i, ++n) {
+      const FlatGeoPoint av = (o + *i) * fixed(0.5);
+      locations[n] = parms.projection.Unproject(av);
+    }
+
+    parms.terrain->GetHeights(locations, heights, n);
+
+    for (unsigned j = 0; j < n; ++j) {
+      const short h = heights[j];
+
+      if (RasterBuffer::IsWater(h))
+        /* water: assume 0m MSL */
+        parms.terrain_counter++;
+      else if (!RasterBuffer::IsInvalid(h)) {
+        parms.terrain_counter++;
+        parms.terrain_base += h;
+      }
     }
   }
 
@@ -268,6 +268,16 @@ public:
     return reach.GetTerrainBase();
   }
 
+  /**
+   * Returns the maximum distance (m) of a glide from the specified
+   * altitude down to MSL, with the reach polar.  Destinations
+   * further away can't be reached.
+   */
+  gcc_pure
+  fixed GetMaxReachDistance(RoughAltitude altitude) const {
+    return rpolars_reach.GetMaxGlideDistance(altitude);
+  }
+
 protected:
   /**
    * Test whether a solution is required or the solution is trivial
@@ -26,6 +26,8 @@
 #include "Geo/Flat/FlatProjection.hpp"
 #include "Terrain/RasterMap.hpp"
 
+#include <algorithm>
+
 #define MC_CEILING_PENALTY_FACTOR 5.0
 
 GeoPoint
@@ -45,6 +47,17 @@ RoutePolars::MSLIntercept(const int index, const AGeoPoint& p,
   return proj.Unproject(dp);
 }
 
+fixed
+RoutePolars::GetMaxGlideDistance(const RoughAltitude height) const
+{
+  fixed max_inv_gradient = fixed(0);
+  for (unsigned i = 0; i < ROUTEPOLAR_POINTS; ++i)
+    max_inv_gradient = std::max(max_inv_gradient,
+                                polar_glide.GetPoint(i).inv_gradient);
+
+  return height * max_inv_gradient;
+}
+
 void
 RoutePolars::Initialise(const GlideSettings &settings, const GlidePolar &polar,
                         const SpeedVector &wind)
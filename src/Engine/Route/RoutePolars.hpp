@@ -228,6 +228,13 @@ public:
                                  const FlatGeoPoint& dest,
                                  const FlatProjection &proj) const;
 
+  /**
+   * Calculate the maximum distance (m) of a glide in any direction
+   * which loses the specified height, ignoring terrain.
+   */
+  gcc_pure
+  fixed GetMaxGlideDistance(RoughAltitude height) const;
+
   RoughAltitude GetSafetyHeight() const {
     return RoughAltitude(config.safety_height_terrain);
   }
@@ -39,6 +39,16 @@ TaskDijkstra::GetStageSize(const unsigned stage) const
   return boundaries[stage]->size();
 }
 
+unsigned
+TaskDijkstra::GetMaxStageSize() const
+{
+  unsigned result = 0;
+  for (unsigned stage = 0; stage < num_stages; ++stage)
+    result = std::max(result, GetStageSize(stage));
+
+  return result;
+}
+
 const SearchPoint &
 TaskDijkstra::GetPoint(const ScanTaskPoint sp) const
 {
@@ -91,6 +91,12 @@ protected:
 
   bool Run();
 
+  /**
+   * Returns the number of points in the largest stage.
+   */
+  gcc_pure
+  unsigned GetMaxStageSize() const;
+
   bool Link(const ScanTaskPoint node, const ScanTaskPoint parent,
             unsigned value) {
     if (!is_min)
@@ -25,8 +25,7 @@
 bool
 TaskDijkstraMax::DistanceMax()
 {
-  dijkstra.Clear();
-  dijkstra.Reserve(256);
+  ClearDijkstra(GetMaxStageSize());
   AddZeroStartEdges();
   return Run();
 }
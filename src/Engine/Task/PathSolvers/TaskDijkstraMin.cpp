@@ -25,8 +25,7 @@
 bool
 TaskDijkstraMin::DistanceMin(const SearchPoint &currentLocation)
 {
-  dijkstra.Clear();
-  dijkstra.Reserve(256);
+  ClearDijkstra(GetMaxStageSize());
 
   if (currentLocation.IsValid()) {
     AddStartEdges(0, currentLocation);
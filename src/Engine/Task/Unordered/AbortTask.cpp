@@ -22,7 +22,6 @@
 
 #include "AbortTask.hpp"
 #include "AbortIntersectionTest.hpp"
-#include "AlternateList.hpp"
 #include "Navigation/Aircraft.hpp"
 #include "Task/Visitors/TaskPointVisitor.hpp"
 #include "Task/Solvers/TaskSolution.hpp"
@@ -37,6 +36,18 @@ static constexpr fixed min_search_range = fixed(50000);
 /** max search range in m */
 static constexpr fixed max_search_range = fixed(100000);
 
+/**
+ * The glide solutions of the previous update are reused if the
+ * aircraft has moved less than this distance [m] ...
+ */
+static constexpr fixed cache_max_distance = fixed(10);
+
+/** ... and its altitude has changed less than this [m] ... */
+static constexpr fixed cache_max_altitude = fixed(1);
+
+/** ... and the wind has changed less than this [m/s] */
+static constexpr fixed cache_max_wind = fixed(0.5);
+
 AbortTask::AbortTask(const TaskBehaviour &_task_behaviour,
                      const Waypoints &wps)
   :UnorderedTask(TaskType::ABORT, _task_behaviour),
@@ -45,6 +56,7 @@ AbortTask::AbortTask(const TaskBehaviour &_task_behaviour,
    active_waypoint(0)
 {
   task_points.reserve(32);
+  cache_key.valid = false;
 }
 
 void
@@ -52,6 +64,10 @@ AbortTask::SetTaskBehaviour(const TaskBehaviour &tb)
 {
   UnorderedTask::SetTaskBehaviour(tb);
 
+  /* the safety height and the glide settings are part of the
+     solutions */
+  cache_key.valid = false;
+
   for (auto &tp : task_points)
     tp.point.SetTaskBehaviour(tb);
 }
@@ -117,12 +133,13 @@ AbortTask::IsTaskFull() const
 
 /** Function object used to rank waypoints by arrival time */
 struct AbortRank
-  : public std::binary_function<AlternatePoint, AlternatePoint, bool>
+  : public std::binary_function<const AlternatePoint *,
+                                const AlternatePoint *, bool>
 {
   /** Condition, ranks by arrival time */
-  bool operator()(const AlternatePoint &x, const AlternatePoint &y) const {
-    return x.solution.time_elapsed + x.solution.time_virtual >
-           y.solution.time_elapsed + y.solution.time_virtual;
+  bool operator()(const AlternatePoint *x, const AlternatePoint *y) const {
+    return x->solution.time_elapsed + x->solution.time_virtual >
+           y->solution.time_elapsed + y->solution.time_virtual;
   }
 };
 
@@ -135,57 +152,78 @@ IsReachable(const GlideResult &result, bool final_glide)
     : result.IsAchievable();
 }
 
+/**
+ * Calculate an upper bound for the glide ratio over ground.  No speed
+ * gives a better glide ratio through the air than best L/D, and no
+ * speed below Vmin helps, so a tail wind can improve it by at most
+ * wind/Vmin.
+ */
+gcc_pure
+static fixed
+GetMaxGroundGlideRatio(const GlidePolar &polar, const SpeedVector &wind)
+{
+  return polar.GetBestLD() * (fixed(1) + wind.norm / polar.GetVMin());
+}
+
 bool
 AbortTask::FillReachable(const AircraftState &state,
-                         AlternateList &approx_waypoints,
                          const GlidePolar &polar, bool only_airfield,
                          bool final_glide, bool safety)
 {
-  if (IsTaskFull() || approx_waypoints.empty())
+  if (IsTaskFull() || candidates.empty())
     return false;
 
-  const AGeoPoint p_start(state.location, state.altitude);
+  const fixed max_glide_ratio = GetMaxGroundGlideRatio(polar, state.wind);
 
   bool found_final_glide = false;
-  reservable_priority_queue<AlternatePoint, AlternateList, AbortRank> q;
+  reservable_priority_queue<const Candidate *, std::vector<const Candidate *>,
+                            AbortRank> q;
   q.reserve(32);
 
-  for (auto v = approx_waypoints.begin(); v != approx_waypoints.end();) {
-    if (only_airfield && !v->waypoint.IsAirport()) {
-      ++v;
+  for (auto &c : candidates) {
+    if (c.added || (only_airfield && !c.waypoint.IsAirport()))
       continue;
-    }
 
-    UnorderedTaskPoint t(v->waypoint, task_behaviour);
-    GlideResult result =
-        TaskSolution::GlideSolutionRemaining(t, state,
-                                             task_behaviour.glide, polar);
+    if (!c.solved) {
+      if (final_glide) {
+        /* cheap lower bound: skip the full solution if the height
+           above the arrival altitude is not enough even at the best
+           possible glide ratio over ground */
+        const fixed height = state.altitude - c.waypoint.elevation -
+          task_behaviour.safety_height_arrival;
+        if (height * max_glide_ratio <
+            state.location.Distance(c.waypoint.location))
+          continue;
+      }
 
-    if (IsReachable(result, final_glide)) {
-      bool intersects = false;
-      const bool is_reachable_final = IsReachable(result, true);
+      UnorderedTaskPoint t(c.waypoint, task_behaviour);
+      c.solution = TaskSolution::GlideSolutionRemaining(t, state,
+                                                        task_behaviour.glide,
+                                                        polar);
+      c.solved = true;
+    }
 
-      if (intersection_test && final_glide && is_reachable_final)
-        intersects = intersection_test->Intersects(
-            AGeoPoint(v->waypoint.location, result.min_arrival_altitude));
+    const GlideResult &result = c.solution;
+    if (!IsReachable(result, final_glide))
+      continue;
 
-      if (!intersects) {
-        q.push(AlternatePoint(v->waypoint, result));
-        // remove it since it's already in the list now      
-        v = approx_waypoints.erase(v);
+    const bool is_reachable_final = IsReachable(result, true);
 
-        if (is_reachable_final)
-          found_final_glide = true;
+    if (intersection_test && final_glide && is_reachable_final &&
+        intersection_test->Intersects(AGeoPoint(c.waypoint.location,
+                                                result.min_arrival_altitude)))
+      continue;
 
-        continue; // skip incrementing v since we just erased it
-      }
-    } 
+    q.push(&c);
+    // mark it since it's already in the list now
+    c.added = true;
 
-    ++v;
+    if (is_reachable_final)
+      found_final_glide = true;
   }
 
   while (!q.empty() && !IsTaskFull()) {
-    const AlternatePoint top = q.top();
+    const Candidate &top = *q.top();
     task_points.emplace_back(top.waypoint, task_behaviour, top.solution);
 
     const int i = task_points.size() - 1;
@@ -202,9 +240,10 @@ AbortTask::FillReachable(const AircraftState &state,
  * Class to build vector from visited waypoints.
  * Intended to be used temporarily.
  */
+template<typename V>
 class WaypointVisitorVector: public WaypointVisitor
 {
-  AlternateList &vector;
+  V &vector;
 
 public:
   /**
@@ -214,7 +253,7 @@ public:
    *
    * @return Initialised object
    */
-  WaypointVisitorVector(AlternateList &wpv):vector(wpv) {}
+  WaypointVisitorVector(V &wpv):vector(wpv) {}
 
   /**
    * Visit method, adds result to vector
@@ -227,6 +266,61 @@ public:
   }
 };
 
+/**
+ * Calculate the squared magnitude of the difference of two wind
+ * vectors.
+ */
+gcc_const
+static fixed
+WindDifferenceSquared(const SpeedVector a, const SpeedVector b)
+{
+  return sqr(a.norm) + sqr(b.norm) -
+    Double(a.norm * b.norm * (a.bearing - b.bearing).cos());
+}
+
+bool
+AbortTask::IsCacheValid(const AircraftState &state,
+                        const GlidePolar &polar) const
+{
+  return cache_key.valid &&
+    cache_key.waypoints_serial == waypoints.GetSerial() &&
+    cache_key.mc == polar.GetMC() &&
+    cache_key.bugs == polar.GetBugs() &&
+    cache_key.ballast == polar.GetBallast() &&
+    cache_key.best_ld == polar.GetBestLD() &&
+    fabs(cache_key.altitude - state.altitude) < cache_max_altitude &&
+    WindDifferenceSquared(cache_key.wind, state.wind) <
+    sqr(cache_max_wind) &&
+    cache_key.location.Distance(state.location) < cache_max_distance;
+}
+
+void
+AbortTask::UpdateCandidates(const AircraftState &state,
+                            const GlidePolar &polar)
+{
+  if (IsCacheValid(state, polar)) {
+    for (auto &c : candidates)
+      c.added = false;
+    return;
+  }
+
+  candidates.clear();
+
+  WaypointVisitorVector<std::vector<Candidate>> wvv(candidates);
+  waypoints.VisitWithinRange(state.location,
+                             GetAbortRange(state, polar), wvv);
+
+  cache_key.valid = true;
+  cache_key.location = state.location;
+  cache_key.altitude = state.altitude;
+  cache_key.wind = state.wind;
+  cache_key.mc = polar.GetMC();
+  cache_key.bugs = polar.GetBugs();
+  cache_key.ballast = polar.GetBallast();
+  cache_key.best_ld = polar.GetBestLD();
+  cache_key.waypoints_serial = waypoints.GetSerial();
+}
+
 void 
 AbortTask::ClientUpdate(const AircraftState &state_now, bool reachable)
 {
@@ -256,13 +350,8 @@ AbortTask::UpdateSample(const AircraftState &state,
     /* can't work without a polar */
     return false;
 
-  AlternateList approx_waypoints;
-  approx_waypoints.reserve(128);
-
-  WaypointVisitorVector wvv(approx_waypoints);
-  waypoints.VisitWithinRange(state.location,
-                             GetAbortRange(state, glide_polar), wvv);
-  if (approx_waypoints.empty()) {
+  UpdateCandidates(state, glide_polar);
+  if (candidates.empty()) {
     /** @todo increase range */
     return false;
   }
@@ -270,16 +359,16 @@ AbortTask::UpdateSample(const AircraftState &state,
   // sort by arrival time
 
   // first try with final glide only
-  reachable_landable |=  FillReachable(state, approx_waypoints, glide_polar,
+  reachable_landable |=  FillReachable(state, glide_polar,
                                        true, true, true);
-  reachable_landable |=  FillReachable(state, approx_waypoints, glide_polar,
+  reachable_landable |=  FillReachable(state, glide_polar,
                                        false, true, true);
 
   // inform clients that the landable reachable scan has been performed 
   ClientUpdate(state, true);
 
   // now try without final glide constraint and not preferring airports
-  FillReachable(state, approx_waypoints, glide_polar, false, false, false);
+  FillReachable(state, glide_polar, false, false, false);
 
   // inform clients that the landable unreachable scan has been performed 
   ClientUpdate(state, false);
@@ -308,6 +397,7 @@ void
 AbortTask::Reset()
 {
   Clear();
+  cache_key.valid = false;
   UnorderedTask::Reset();
 }
 
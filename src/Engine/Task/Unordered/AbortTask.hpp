@@ -25,7 +25,10 @@
 
 #include "UnorderedTask.hpp"
 #include "UnorderedTaskPoint.hpp"
+#include "AlternatePoint.hpp"
 #include "GlideSolvers/GlidePolar.hpp"
+#include "Geo/SpeedVector.hpp"
+#include "Util/Serial.hpp"
 
 #include <vector>
 
@@ -33,7 +36,6 @@
 
 class Waypoints;
 class AbortIntersectionTest;
-class AlternateList;
 
 /**
  * Abort task provides automatic management of a sorted list of task points
@@ -81,6 +83,39 @@ private:
   unsigned active_waypoint;
   bool reachable_landable;
 
+  /**
+   * A landable waypoint within the search range.
+   */
+  struct Candidate : public AlternatePoint {
+    /** Has AlternatePoint::solution been calculated yet? */
+    bool solved;
+
+    /** Has it been added to #task_points in this update? */
+    bool added;
+
+    Candidate(const Waypoint &_waypoint)
+      :AlternatePoint(_waypoint), solved(false), added(false) {}
+  };
+
+  /**
+   * The candidates of the last update, with the glide solutions
+   * calculated so far.  They are reused by the next update if the
+   * inputs have changed only a little, see IsCacheValid().
+   */
+  std::vector<Candidate> candidates;
+
+  /**
+   * The inputs #candidates was built for.
+   */
+  struct {
+    bool valid;
+    GeoPoint location;
+    fixed altitude;
+    SpeedVector wind;
+    fixed mc, bugs, ballast, best_ld;
+    Serial waypoints_serial;
+  } cache_key;
+
 public:
   /** 
    * Base constructor.
@@ -156,12 +191,26 @@ protected:
                       const GlidePolar &glide_polar) const;
 
   /**
-   * Fill abort task list with candidate waypoints given a list of
-   * waypoints satisfying approximate range queries.  Can be used
-   * to add airfields only, or landpoints.
+   * Can the glide solutions in #candidates be reused for this
+   * aircraft state and polar?
+   */
+  gcc_pure
+  bool IsCacheValid(const AircraftState &state,
+                    const GlidePolar &polar) const;
+
+  /**
+   * Rebuild #candidates from the landable waypoints within range.
+   */
+  void UpdateCandidates(const AircraftState &state, const GlidePolar &polar);
+
+  /**
+   * Fill abort task list with candidate waypoints from #candidates.
+   * Can be used to add airfields only, or landpoints.  Each
+   * candidate is solved at most once per update, and candidates
+   * which cannot be reached on final glide even at best L/D are
+   * skipped without solving them when a final glide is required.
    *
    * @param state Aircraft state
-   * @param approx_waypoints List of candidate waypoints
    * @param polar Polar used for tests
    * @param only_airfield If true, only add waypoints that are airfields.
    * @param final_glide Whether solution must be glide only or climb allowed
@@ -170,7 +219,6 @@ protected:
    * @return True if a landpoint within final glide was found
    */
   bool FillReachable(const AircraftState &state,
-                     AlternateList &approx_waypoints,
                      const GlidePolar &polar, bool only_airfield,
                      bool final_glide, bool safety);
 
@@ -23,17 +23,19 @@ Copyright_License {
 
 #include "Trace.hpp"
 #include "Vector.hpp"
-#include "Util/GlobalSliceAllocator.hpp"
 
 #include <algorithm>
+#include <vector>
 
 Trace::Trace(const unsigned _no_thin_time, const unsigned max_time,
              const unsigned max_size)
-  :cached_size(0),
+  :nodes(max_size), head(0), cached_size(0),
+   heap(max_size), heap_size(0),
    max_time(max_time),
    no_thin_time(_no_thin_time),
    max_size(max_size),
-   opt_size((3 * max_size) / 4)
+   opt_size((3 * max_size) / 4),
+   average_delta_time(0), average_delta_distance(0)
 {
   assert(max_size >= 4);
 }
@@ -41,23 +43,47 @@ Trace::Trace(const unsigned _no_thin_time, const unsigned max_time,
 void
 Trace::clear()
 {
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
-
   average_delta_distance = 0;
   average_delta_time = 0;
 
-  delta_list.clear();
-  chronological_list.clear_and_dispose(MakeDisposer());
+  head = 0;
   cached_size = 0;
-
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
+  heap_size = 0;
 
   ++modify_serial;
   ++append_serial;
 }
 
+void
+Trace::CopyFrom(const Trace &src)
+{
+  assert(max_time == src.max_time);
+  assert(no_thin_time == src.no_thin_time);
+  assert(max_size == src.max_size);
+
+  if (append_serial == src.append_serial &&
+      modify_serial == src.modify_serial)
+    /* unmodified since the last call */
+    return;
+
+  /* copying the whole ring buffer keeps the physical location of
+     each point, which is what keeps pointers valid */
+  std::copy_n(src.nodes.begin(), max_size, nodes.begin());
+  head = src.head;
+  cached_size = src.cached_size;
+
+  std::copy_n(src.heap.begin(), src.heap_size, heap.begin());
+  heap_size = src.heap_size;
+
+  task_projection = src.task_projection;
+
+  average_delta_time = src.average_delta_time;
+  average_delta_distance = src.average_delta_distance;
+
+  append_serial = src.append_serial;
+  modify_serial = src.modify_serial;
+}
+
 unsigned
 Trace::GetRecentTime(const unsigned t) const
 {
@@ -72,101 +98,214 @@ Trace::GetRecentTime(const unsigned t) const
 }
 
 void
-Trace::UpdateDelta(TraceDelta &td)
+Trace::HeapSiftUp(unsigned i)
+{
+  const RankEntry entry = heap[i];
+
+  while (i > 0) {
+    const unsigned parent = (i - 1) / 2;
+    if (!(entry < heap[parent]))
+      break;
+
+    HeapSet(i, heap[parent]);
+    i = parent;
+  }
+
+  HeapSet(i, entry);
+}
+
+void
+Trace::HeapSiftDown(unsigned i)
+{
+  const RankEntry entry = heap[i];
+  const unsigned n = heap_size;
+
+  while (true) {
+    unsigned child = 2 * i + 1;
+    if (child >= n)
+      break;
+
+    if (child + 1 < n && heap[child + 1] < heap[child])
+      ++child;
+
+    if (!(heap[child] < entry))
+      break;
+
+    HeapSet(i, heap[child]);
+    i = child;
+  }
+
+  HeapSet(i, entry);
+}
+
+void
+Trace::HeapInsert(unsigned node)
+{
+  assert(heap_size < max_size);
+
+  const unsigned i = heap_size++;
+  HeapSet(i, RankEntry(nodes[node], node));
+  HeapSiftUp(i);
+}
+
+void
+Trace::HeapErase(unsigned node)
 {
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
+  assert(heap_size > 0);
+
+  const unsigned i = nodes[node].heap_index;
+  assert(i < heap_size);
+  nodes[node].heap_index = npos;
 
-  if (&td == &chronological_list.front() ||
-      &td == &chronological_list.back())
+  if (i == --heap_size)
+    /* this was the last element */
     return;
 
-  const auto ci = chronological_list.iterator_to(td);
-  const TraceDelta &previous = *std::prev(ci);
-  const TraceDelta &next = *std::next(ci);
+  /* move the last element into the gap */
+  const RankEntry last = heap[heap_size];
+  HeapSet(i, last);
+  HeapSiftUp(i);
+  HeapSiftDown(nodes[last.node].heap_index);
+}
+
+void
+Trace::HeapUpdate(unsigned node)
+{
+  const unsigned i = nodes[node].heap_index;
+  if (i == npos)
+    return;
 
-  delta_list.erase(delta_list.iterator_to(td));
-  td.Update(previous.point, next.point);
-  delta_list.insert(td);
+  heap[i] = RankEntry(nodes[node], node);
+  HeapSiftUp(i);
+  HeapSiftDown(nodes[node].heap_index);
 }
 
 void
-Trace::EraseInside(DeltaList::iterator it)
+Trace::UpdateDelta(unsigned node, const TracePoint &previous,
+                   const TracePoint &next)
+{
+  nodes[node].Update(previous, next);
+  HeapUpdate(node);
+}
+
+void
+Trace::UpdateLinkedDelta(unsigned node)
+{
+  const TraceDelta &td = nodes[node];
+  if (td.prev == npos || td.next == npos)
+    return;
+
+  UpdateDelta(node, nodes[td.prev].point, nodes[td.next].point);
+}
+
+void
+Trace::EraseInside(unsigned node)
 {
   assert(cached_size > 0);
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
-  assert(it != delta_list.end());
 
-  const TraceDelta &td = *it;
+  TraceDelta &td = nodes[node];
   assert(!td.IsEdge());
+  assert(td.prev != npos && td.next != npos);
 
-  const auto ci = chronological_list.iterator_to(td);
-  TraceDelta &previous = const_cast<TraceDelta &>(*std::prev(ci));
-  TraceDelta &next = const_cast<TraceDelta &>(*std::next(ci));
+  const unsigned previous = td.prev, next = td.next;
 
   // now delete the item
-  chronological_list.erase(chronological_list.iterator_to(td));
-  delta_list.erase_and_dispose(it, MakeDisposer());
+  nodes[previous].next = next;
+  nodes[next].prev = previous;
   --cached_size;
+  HeapErase(node);
 
   // and update the deltas
-  UpdateDelta(previous);
-  UpdateDelta(next);
+  UpdateLinkedDelta(previous);
+  UpdateLinkedDelta(next);
+}
+
+void
+Trace::Compact(unsigned span)
+{
+  unsigned dest = 0;
+  for (unsigned i = 0; i < span; ++i) {
+    const unsigned src = Physical(i);
+    const TraceDelta &td = nodes[src];
+    if (td.heap_index == npos)
+      /* erased by EraseInside() */
+      continue;
+
+    const unsigned d = Physical(dest++);
+    if (d != src) {
+      nodes[d] = td;
+      heap[nodes[d].heap_index].node = d;
+    }
+  }
+
+  assert(dest == cached_size);
 }
 
 bool
 Trace::EraseDelta(const unsigned target_size, const unsigned recent)
 {
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
-
   if (size() <= 2)
     return false;
 
+  const unsigned span = size();
+
+  /* link the points, so they can be erased from the middle */
+  for (unsigned i = 0; i < span; ++i) {
+    TraceDelta &td = nodes[Physical(i)];
+    td.prev = i > 0 ? Physical(i - 1) : npos;
+    td.next = i + 1 < span ? Physical(i + 1) : npos;
+  }
+
   bool modified = false;
 
   const unsigned recent_time = GetRecentTime(recent);
 
-  auto candidate = delta_list.begin();
-  while (size() > target_size) {
-    const TraceDelta &td = *candidate;
+  /* points which must not be erased are moved out of the heap
+     temporarily, so the heap's top is always the best candidate */
+  std::vector<unsigned> suppressed;
+
+  while (size() > target_size && heap_size > 0) {
+    const unsigned node = heap[0].node;
+    const TraceDelta &td = nodes[node];
     if (!td.IsEdge() && td.point.GetTime() < recent_time) {
-      EraseInside(candidate);
-      candidate = delta_list.begin(); // find new top
+      EraseInside(node);
       modified = true;
     } else {
-      ++candidate;
       // suppressed removal, skip it.
+      suppressed.push_back(node);
+      HeapErase(node);
     }
   }
 
+  for (const unsigned node : suppressed)
+    HeapInsert(node);
+
+  if (modified)
+    Compact(span);
+
   return modified;
 }
 
 bool
 Trace::EraseEarlierThan(const unsigned p_time)
 {
-  if (p_time == 0 || empty() || GetFront().point.GetTime() >= p_time)
+  if (p_time == 0 || empty() || front().GetTime() >= p_time)
     // there will be nothing to remove
     return false;
 
   do {
-    auto ci = chronological_list.begin();
-    TraceDelta &td = *ci;
-    chronological_list.erase(ci);
-
-    auto i = delta_list.find(td);
-    assert(i != delta_list.end());
-    delta_list.erase_and_dispose(i, MakeDisposer());
+    const unsigned node = head;
+    if (++head == max_size)
+      head = 0;
 
     --cached_size;
-  } while (!empty() && GetFront().point.GetTime() < p_time);
+    HeapErase(node);
+  } while (!empty() && front().GetTime() < p_time);
 
   // need to set deltas for first point, only one of these
   // will occur (have to search for this point)
   if (!empty())
-    EraseStart(GetFront());
+    EraseStart(head);
 
   ++modify_serial;
   ++append_serial;
@@ -179,44 +318,34 @@ Trace::EraseLaterThan(const unsigned min_time)
   assert(min_time > 0);
   assert(!empty());
 
-  while (!empty() && GetBack().point.GetTime() > min_time) {
-    TraceDelta &td = GetBack();
-
-    chronological_list.erase(chronological_list.iterator_to(td));
-
-    auto i = delta_list.find(td);
-    assert(i != delta_list.end());
-    delta_list.erase_and_dispose(i, MakeDisposer());
-
+  while (!empty() && back().GetTime() > min_time) {
+    const unsigned node = Physical(cached_size - 1);
     --cached_size;
+    HeapErase(node);
   }
 
   /* need to set deltas for first point, only one of these will occur
      (have to search for this point) */
   if (!empty())
-    EraseStart(GetBack());
+    EraseStart(Physical(cached_size - 1));
 }
 
 /**
  * Update start node (and neighbour) after min time pruning
  */
 void
-Trace::EraseStart(TraceDelta &td)
+Trace::EraseStart(unsigned node)
 {
-  delta_list.erase(delta_list.iterator_to(td));
-
+  TraceDelta &td = nodes[node];
   td.elim_distance = null_delta;
   td.elim_time = null_time;
 
-  delta_list.insert(td);
+  HeapUpdate(node);
 }
 
 void
 Trace::push_back(const TracePoint &point)
 {
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
-
   if (empty()) {
     // first point determines origin for flat projection
     task_projection.Reset(point.GetLocation());
@@ -244,17 +373,17 @@ Trace::push_back(const TracePoint &point)
 
   assert(size() < max_size);
 
-  TraceDelta *td = allocator.allocate(1);
-  allocator.construct(td, point);
-  td->point.Project(task_projection);
-
-  delta_list.insert(*td);
-  chronological_list.push_back(*td);
+  const unsigned node = Physical(cached_size);
+  TraceDelta &td = nodes[node];
+  td = TraceDelta(point);
+  td.point.Project(task_projection);
 
   ++cached_size;
+  HeapInsert(node);
 
-  if (td != &chronological_list.front())
-    UpdateDelta(*std::prev(chronological_list.iterator_to(*td)));
+  if (cached_size > 2)
+    UpdateDelta(Physical(cached_size - 2),
+                nodes[Physical(cached_size - 3)].point, td.point);
 
   ++append_serial;
 }
@@ -266,10 +395,13 @@ Trace::CalcAverageDeltaDistance(const unsigned no_thin) const
   unsigned acc = 0;
   unsigned counter = 0;
 
-  const auto end = chronological_list.end();
-  for (auto it = chronological_list.begin();
-       it != end && it->point.GetTime() < r; ++it, ++counter)
-    acc += it->delta_distance;
+  for (; counter < cached_size; ++counter) {
+    const TraceDelta &td = nodes[Physical(counter)];
+    if (td.point.GetTime() >= r)
+      break;
+
+    acc += td.delta_distance;
+  }
 
   if (counter)
     return acc / counter;
@@ -284,9 +416,9 @@ Trace::CalcAverageDeltaTime(const unsigned no_thin) const
   unsigned counter = 0;
 
   /* find the last item before the "r" timestamp */
-  const auto end = chronological_list.end();
-  ChronologicalList::const_iterator it;
-  for (it = chronological_list.begin(); it != end && it->point.GetTime() < r; ++it)
+  const auto end = this->end();
+  const_iterator it;
+  for (it = begin(); it != end && it->GetTime() < r; ++it)
     ++counter;
 
   if (counter < 2)
@@ -296,7 +428,7 @@ Trace::CalcAverageDeltaTime(const unsigned no_thin) const
   --counter;
 
   unsigned start_time = front().GetTime();
-  unsigned end_time = it->point.GetTime();
+  unsigned end_time = it->GetTime();
   return (end_time - start_time) / counter;
 }
 
@@ -337,8 +469,6 @@ Trace::Thin2()
 void
 Trace::Thin()
 {
-  assert(cached_size == delta_list.size());
-  assert(cached_size == chronological_list.size());
   assert(size() == max_size);
 
   Thin2();
@@ -360,52 +490,13 @@ Trace::GetPoints(TracePointVector& iov) const
   std::copy(begin(), end(), std::back_inserter(iov));
 }
 
-template<typename I>
-class PointerIterator {
-  I i;
-
-public:
-  typedef typename I::iterator_category iterator_category;
-  typedef typename I::pointer value_type;
-  typedef typename I::pointer *pointer;
-  typedef value_type &reference;
-  typedef typename I::difference_type difference_type;
-
-  PointerIterator() = default;
-  explicit PointerIterator(I _i):i(_i) {}
-  PointerIterator<I> &operator=(const PointerIterator<I> &other) = default;
-
-  PointerIterator<I> &operator--() {
-    --i;
-    return *this;
-  }
-
-  PointerIterator<I> &operator++() {
-    ++i;
-    return *this;
-  }
-
-  typename I::pointer operator*() {
-    return &*i;
-  }
-
-  bool operator==(const PointerIterator<I> &other) const {
-    return i == other.i;
-  }
-
-  bool operator!=(const PointerIterator<I> &other) const {
-    return i != other.i;
-  }
-};
-
 void
 Trace::GetPoints(TracePointerVector &v) const
 {
   v.clear();
   v.reserve(size());
-  std::copy(PointerIterator<decltype(begin())>(begin()),
-            PointerIterator<decltype(end())>(end()),
-            std::back_inserter(v));
+  for (const TracePoint &point : *this)
+    v.push_back(&point);
 }
 
 bool
@@ -419,9 +510,9 @@ Trace::SyncPoints(TracePointerVector &v) const
 
   v.reserve(size());
 
-  PointerIterator<decltype(end())> e(end());
-  std::copy(std::prev(e, size() - v.size()), e,
-            std::back_inserter(v));
+  for (auto i = begin() + v.size(), e = end(); i != e; ++i)
+    v.push_back(&*i);
+
   assert(v.size() == size());
   return true;
 }
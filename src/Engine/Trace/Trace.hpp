@@ -26,13 +26,13 @@ Copyright_License {
 
 #include "Point.hpp"
 #include "Util/NonCopyable.hpp"
-#include "Util/SliceAllocator.hpp"
+#include "Util/AllocatedArray.hpp"
 #include "Util/Serial.hpp"
 #include "Geo/Flat/TaskProjection.hpp"
 #include "Compiler.h"
 
-#include <boost/intrusive/list.hpp>
-#include <boost/intrusive/set.hpp>
+#include <algorithm>
+#include <iterator>
 
 #include <assert.h>
 #include <stdlib.h>
@@ -49,73 +49,41 @@ class TracePointerVector;
  * the candidate point removed.  In this version, time differences is also a
  * secondary factor, such that thinning attempts to remove points such that,
  * for equal distance ranking, smaller time step details are removed first.
+ *
+ * The points are stored in a ring buffer which is allocated once
+ * (#max_size elements) and kept in chronological order.  The
+ * elimination ranking is an indexed binary heap of small records
+ * which refer to the ring buffer.
  */
 class Trace : private NonCopyable
 {
-  struct TraceDelta
-    : boost::intrusive::set_base_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>>,
-      boost::intrusive::list_base_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>> {
-
-    /**
-     * Function used to points for sorting by deltas.
-     * Ranking is primarily by distance delta; for equal distances, rank by
-     * time delta.
-     * This is like a modified Douglas-Peuker algorithm
-     */
-    gcc_pure
-    static bool DeltaRank(const TraceDelta &x, const TraceDelta &y) {
-      // distance is king
-      if (x.elim_distance < y.elim_distance)
-        return true;
-
-      if (x.elim_distance > y.elim_distance)
-        return false;
-
-      // distance is equal, so go by time error
-      if (x.elim_time < y.elim_time)
-        return true;
-
-      if (x.elim_time > y.elim_time)
-        return false;
-
-      // all else fails, go by age
-      if (x.point.IsOlderThan(y.point))
-        return true;
-
-      if (x.point.IsNewerThan(y.point))
-        return false;
-
-      return false;
-    }
-
-    struct DeltaRankOp {
-      gcc_pure
-      bool operator()(const TraceDelta &s1, const TraceDelta &s2) const {
-        return DeltaRank(s1, s2);
-      }
-    };
-
+  struct TraceDelta {
     TracePoint point;
 
     unsigned elim_time;
     unsigned elim_distance;
     unsigned delta_distance;
 
+    /**
+     * The position of this point's #RankEntry in #heap, or
+     * #npos if it is not in the heap.
+     */
+    unsigned heap_index;
+
+    /**
+     * The physical indices of the chronological neighbours.  These
+     * are only valid inside EraseDelta(), where points are removed
+     * from the middle of the ring buffer.
+     */
+    unsigned prev, next;
+
+    TraceDelta() = default;
+
     explicit TraceDelta(const TracePoint &p)
       :point(p),
        elim_time(null_time), elim_distance(null_delta),
        delta_distance(0) {}
 
-    TraceDelta(const TracePoint &p_last, const TracePoint &p,
-               const TracePoint &p_next)
-      :point(p),
-       elim_time(TimeMetric(p_last, p, p_next)),
-       elim_distance(DistanceMetric(p_last, p, p_next)),
-       delta_distance(p.FlatDistanceTo(p_last))
-    {
-      assert(elim_distance != null_delta);
-    }
-
     /**
      * Is this the first or the last point?
      */
@@ -166,21 +134,65 @@ class Trace : private NonCopyable
     }
   };
 
-  /* using multiset, not because we need multiple values (we don't),
-     but to avoid set's overhead for duplicate elimination */
-  typedef boost::intrusive::multiset<TraceDelta,
-                                     boost::intrusive::compare<TraceDelta::DeltaRankOp>,
-                                     boost::intrusive::constant_time_size<false>> DeltaList;
+  /**
+   * An element of the elimination heap.  It contains a copy of the
+   * ranking key, so sifting does not need to touch the
+   * #TraceDelta objects.
+   */
+  struct RankEntry {
+    unsigned elim_distance;
+    unsigned elim_time;
+    unsigned time;
 
-  typedef boost::intrusive::list<TraceDelta,
-                                 boost::intrusive::constant_time_size<false>> ChronologicalList;
+    /**
+     * The physical index of the #TraceDelta in #nodes.
+     */
+    unsigned node;
+
+    RankEntry() = default;
 
-  SliceAllocator<TraceDelta, 128u> allocator;
+    RankEntry(const TraceDelta &td, unsigned _node)
+      :elim_distance(td.elim_distance), elim_time(td.elim_time),
+       time(td.point.GetTime()), node(_node) {}
+
+    /**
+     * Ranking is primarily by distance delta; for equal distances,
+     * rank by time delta; all else fails, go by age.  This is like a
+     * modified Douglas-Peuker algorithm.
+     */
+    gcc_pure
+    bool operator<(const RankEntry &other) const {
+      // distance is king
+      if (elim_distance != other.elim_distance)
+        return elim_distance < other.elim_distance;
 
-  DeltaList delta_list;
-  ChronologicalList chronological_list;
+      // distance is equal, so go by time error
+      if (elim_time != other.elim_time)
+        return elim_time < other.elim_time;
+
+      return time < other.time;
+    }
+  };
+
+  static constexpr unsigned npos = 0 - 1;
+
+  /**
+   * A ring buffer of #max_size points.  The chronological order
+   * begins at #head; all #cached_size points are contiguous (modulo
+   * wraparound) except while EraseDelta() is running.
+   */
+  AllocatedArray<TraceDelta> nodes;
+  unsigned head;
   unsigned cached_size;
 
+  /**
+   * A binary min-heap of all points, ranked by their elimination
+   * error.  It has #heap_size elements, which is equal to
+   * #cached_size except while EraseDelta() is running.
+   */
+  AllocatedArray<RankEntry> heap;
+  unsigned heap_size;
+
   TaskProjection task_projection;
 
   const unsigned max_time;
@@ -193,25 +205,6 @@ class Trace : private NonCopyable
 
   Serial append_serial, modify_serial;
 
-  template<typename Alloc>
-  struct Disposer {
-    Alloc &alloc;
-
-    void operator()(typename Alloc::pointer td) {
-      alloc.destroy(td);
-      alloc.deallocate(td, 1);
-    }
-  };
-
-  template<typename Alloc>
-  static Disposer<Alloc> MakeDisposer(Alloc &alloc) {
-    return {alloc};
-  }
-
-  Disposer<decltype(allocator)> MakeDisposer() {
-    return MakeDisposer(allocator);
-  }
-
 public:
   /**
    * Constructor.  Task projection is updated after first call to append().
@@ -225,10 +218,6 @@ public:
                  const unsigned max_time = null_time,
                  const unsigned max_size = 1000);
 
-  ~Trace() {
-    clear();
-  }
-
 protected:
   /**
    * Find recent time after which points should not be culled
@@ -242,25 +231,69 @@ protected:
   unsigned GetRecentTime(const unsigned t) const;
 
   /**
-   * Update delta values for specified item in the delta list and the
-   * tree.  This repositions the item after into its sorted position.
-   *
-   * @param it Item to update
-   * @param tree Tree containing leaf
-   *
-   * @return Iterator to updated item
+   * Convert a chronological index to a physical index in #nodes.
    */
-  void UpdateDelta(TraceDelta &td);
+  gcc_pure
+  unsigned Physical(unsigned i) const {
+    assert(i < max_size);
+
+    i += head;
+    if (i >= max_size)
+      i -= max_size;
+    return i;
+  }
+
+  void HeapSet(unsigned i, const RankEntry &entry) {
+    heap[i] = entry;
+    nodes[entry.node].heap_index = i;
+  }
+
+  void HeapSiftUp(unsigned i);
+  void HeapSiftDown(unsigned i);
 
   /**
-   * Erase a non-edge item from delta list and tree, updating
-   * deltas in the process.  This Invalidates the calling iterator.
-   *
-   * @param it Item to erase
-   * @param tree Tree to remove from
+   * Add a point to the heap, ranked by its current deltas.
+   */
+  void HeapInsert(unsigned node);
+
+  /**
+   * Remove a point from the heap.
+   */
+  void HeapErase(unsigned node);
+
+  /**
+   * Reposition a point in the heap after its deltas have been
+   * modified.  This is a no-op if the point is not in the heap.
+   */
+  void HeapUpdate(unsigned node);
+
+  /**
+   * Update delta values for the specified point and reposition it
+   * in the heap.
+   */
+  void UpdateDelta(unsigned node, const TracePoint &previous,
+                   const TracePoint &next);
+
+  /**
+   * Like UpdateDelta(), but look up the neighbours with the links
+   * of EraseDelta().  Edges are not modified.
+   */
+  void UpdateLinkedDelta(unsigned node);
+
+  /**
+   * Erase a non-edge item, updating the deltas of its neighbours.
+   * Only to be used by EraseDelta().
+   */
+  void EraseInside(unsigned node);
+
+  /**
+   * Move all remaining points after EraseDelta() to the beginning
+   * of the ring buffer, to restore the chronological order.
    *
+   * @param span the number of chronological slots which were
+   * occupied before the thinning
    */
-  void EraseInside(DeltaList::iterator it);
+  void Compact(unsigned span);
 
   /**
    * Erase elements based on delta metric until the size is
@@ -271,7 +304,6 @@ protected:
    * fail to set the target size.
    *
    * @param target_size Size of desired list.
-   * @param tree Tree to remove from
    * @param recent Time window for which to not remove points
    *
    * @return True if items were erased
@@ -284,7 +316,6 @@ protected:
    * and update earliest item to become the new start
    *
    * @param p_time Time to remove
-   * @param tree Tree to remove from
    *
    * @return True if items were erased
    */
@@ -299,7 +330,7 @@ protected:
   /**
    * Update start node (and neighbour) after min time pruning
    */
-  void EraseStart(TraceDelta &td_start);
+  void EraseStart(unsigned node);
 
 public:
   /**
@@ -323,6 +354,22 @@ public:
     EraseLaterThan((unsigned)time);
   }
 
+  /**
+   * Copy all points from another #Trace which was constructed with
+   * the same parameters.  This object's serials will mirror those of
+   * the source, and pointers to its points remain valid unless
+   * GetModifySerial() changes, just like in the source object.
+   */
+  void CopyFrom(const Trace &src);
+
+  unsigned GetNoThinTime() const {
+    return no_thin_time;
+  }
+
+  unsigned GetMaxTime() const {
+    return max_time;
+  }
+
   unsigned GetMaxSize() const {
     return max_size;
   }
@@ -398,13 +445,13 @@ public:
   const TracePoint &front() const {
     assert(!empty());
 
-    return chronological_list.front().point;
+    return nodes[head].point;
   }
 
   const TracePoint &back() const {
     assert(!empty());
 
-    return chronological_list.back().point;
+    return nodes[Physical(cached_size - 1)].point;
   }
 
 private:
@@ -431,18 +478,6 @@ private:
    */
   void Thin();
 
-  TraceDelta &GetFront() {
-    assert(!empty());
-
-    return chronological_list.front();
-  }
-
-  TraceDelta &GetBack() {
-    assert(!empty());
-
-    return chronological_list.back();
-  }
-
   gcc_pure
   unsigned CalcAverageDeltaDistance(const unsigned no_thin) const;
 
@@ -463,15 +498,18 @@ public:
   }
 
 public:
-  class const_iterator : public ChronologicalList::const_iterator {
+  class const_iterator {
     friend class Trace;
 
-    const_iterator(ChronologicalList::const_iterator &&_iterator)
-      :ChronologicalList::const_iterator(std::move(_iterator)) {}
+    const Trace *trace;
+    unsigned i;
+
+    const_iterator(const Trace &_trace, unsigned _i)
+      :trace(&_trace), i(_i) {}
 
   public:
-    using ChronologicalList::const_iterator::iterator_category;
-    using ChronologicalList::const_iterator::difference_type;
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef int difference_type;
     typedef const TracePoint value_type;
     typedef const TracePoint *pointer;
     typedef const TracePoint &reference;
@@ -479,13 +517,55 @@ public:
     const_iterator() = default;
 
     const TracePoint &operator*() const {
-      const TraceDelta &td = ChronologicalList::const_iterator::operator*();
-      return td.point;
+      return trace->nodes[trace->Physical(i)].point;
     }
 
     const TracePoint *operator->() const {
-      const TraceDelta &td = ChronologicalList::const_iterator::operator*();
-      return &td.point;
+      return &**this;
+    }
+
+    const_iterator &operator++() {
+      ++i;
+      return *this;
+    }
+
+    const_iterator &operator--() {
+      --i;
+      return *this;
+    }
+
+    const_iterator &operator+=(difference_type n) {
+      i += n;
+      return *this;
+    }
+
+    const_iterator &operator-=(difference_type n) {
+      i -= n;
+      return *this;
+    }
+
+    const_iterator operator+(difference_type n) const {
+      return const_iterator(*trace, i + n);
+    }
+
+    const_iterator operator-(difference_type n) const {
+      return const_iterator(*trace, i - n);
+    }
+
+    difference_type operator-(const const_iterator &other) const {
+      return difference_type(i) - difference_type(other.i);
+    }
+
+    bool operator==(const const_iterator &other) const {
+      return i == other.i;
+    }
+
+    bool operator!=(const const_iterator &other) const {
+      return i != other.i;
+    }
+
+    bool operator<(const const_iterator &other) const {
+      return i < other.i;
     }
 
     const_iterator &NextSquareRange(unsigned sq_resolution,
@@ -497,19 +577,18 @@ public:
         if (*this == end)
           return *this;
 
-        const TraceDelta &td = (const TraceDelta &)**this;
-        if (td.point.FlatSquareDistanceTo(previous) >= sq_resolution)
+        if ((*this)->FlatSquareDistanceTo(previous) >= sq_resolution)
           return *this;
       }
     }
   };
 
   const_iterator begin() const {
-    return chronological_list.begin();
+    return const_iterator(*this, 0);
   }
 
   const_iterator end() const {
-    return chronological_list.end();
+    return const_iterator(*this, cached_size);
   }
 
   const TaskProjection &GetProjection() const {
@@ -0,0 +1,78 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "FlarmNetCache.hpp"
+#include "FlarmNetDatabase.hpp"
+#include "IO/FileCache.hpp"
+#include "IO/CacheWriter.hpp"
+#include "IO/CacheReader.hpp"
+#include "OS/FileMapping.hpp"
+
+/**
+ * The format version passed to FileCache::SaveMapped().
+ */
+static constexpr unsigned VERSION = 2;
+
+/**
+ * The arrays used in place are aligned to this.
+ */
+static constexpr size_t ALIGNMENT = 4;
+
+bool
+FlarmNetCache::Load(FileCache &cache, const TCHAR *name, const TCHAR *path,
+                    FlarmNetDatabase &database)
+{
+  database.Clear();
+
+  size_t offset;
+  std::unique_ptr<FileMapping> mapping =
+    cache.LoadMapped(name, path, VERSION, offset);
+  if (!mapping)
+    return false;
+
+  CacheReader reader(mapping->at(offset), mapping->end());
+  if (!reader.Align(ALIGNMENT))
+    return false;
+
+  return database.Load(std::move(mapping), reader);
+}
+
+bool
+FlarmNetCache::Save(FileCache &cache, const TCHAR *name, const TCHAR *path,
+                    const FlarmNetDatabase &database)
+{
+  FILE *file = cache.SaveMapped(name, path, VERSION);
+  if (file == nullptr)
+    return false;
+
+  CacheWriter writer(file);
+  writer.Align(ALIGNMENT);
+  database.Save(writer);
+
+  if (writer.HasError()) {
+    cache.Cancel(name, file);
+    return false;
+  }
+
+  return cache.Commit(name, file);
+}
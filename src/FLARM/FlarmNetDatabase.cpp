@@ -22,10 +22,121 @@ Copyright_License {
 */
 
 #include "FlarmNetDatabase.hpp"
+#include "IO/CacheReader.hpp"
+#include "IO/CacheWriter.hpp"
+#include "OS/FileMapping.hpp"
 #include "Util/StringUtil.hpp"
+#include "Util/StringAPI.hpp"
+
+#include <algorithm>
 
 #include <assert.h>
 
+static constexpr unsigned N_STRINGS = 7;
+
+/**
+ * The FNV-1a hash of a string.
+ */
+gcc_pure
+static uint32_t
+HashString(const TCHAR *s)
+{
+  uint32_t hash = 2166136261u;
+  while (*s != _T('\0'))
+    hash = (hash ^ uint32_t(*s++)) * 16777619u;
+  return hash;
+}
+
+static void
+ToOffsets(const FlarmNetRecord &record, const TCHAR *pool, uint32_t *dest)
+{
+  *dest++ = record.id.c_str() - pool;
+  *dest++ = record.pilot.c_str() - pool;
+  *dest++ = record.airfield.c_str() - pool;
+  *dest++ = record.plane_type.c_str() - pool;
+  *dest++ = record.registration.c_str() - pool;
+  *dest++ = record.callsign.c_str() - pool;
+  *dest++ = record.frequency.c_str() - pool;
+}
+
+static FlarmNetRecord
+FromOffsets(const uint32_t *src, const TCHAR *pool)
+{
+  FlarmNetRecord record;
+  record.id = pool + *src++;
+  record.pilot = pool + *src++;
+  record.airfield = pool + *src++;
+  record.plane_type = pool + *src++;
+  record.registration = pool + *src++;
+  record.callsign = pool + *src++;
+  record.frequency = pool + *src++;
+  return record;
+}
+
+FlarmNetDatabase::FlarmNetDatabase()
+  :n_interned(0), ids(nullptr), pool(nullptr), index(nullptr) {}
+
+FlarmNetDatabase::~FlarmNetDatabase() {}
+
+void
+FlarmNetDatabase::Clear()
+{
+  std::vector<PendingRecord>().swap(pending);
+  std::vector<uint32_t>().swap(interned);
+  n_interned = 0;
+
+  ids = nullptr;
+  records.clear();
+  pool = nullptr;
+  index = nullptr;
+
+  id_buffer.clear();
+  pool_buffer.clear();
+  index_buffer.clear();
+  mapping.reset();
+}
+
+void
+FlarmNetDatabase::GrowInternTable()
+{
+  std::vector<uint32_t> old;
+  old.swap(interned);
+
+  interned.resize(std::max<size_t>(old.size() * 2, 4096), 0);
+
+  const unsigned mask = interned.size() - 1;
+  for (const uint32_t i : old) {
+    if (i == 0)
+      continue;
+
+    unsigned h = HashString(pool_buffer.data() + i - 1) & mask;
+    while (interned[h] != 0)
+      h = (h + 1) & mask;
+
+    interned[h] = i;
+  }
+}
+
+uint32_t
+FlarmNetDatabase::Intern(const TCHAR *s)
+{
+  /* keep the load factor at or below 0.5 */
+  if ((n_interned + 1) * 2 > interned.size())
+    GrowInternTable();
+
+  const unsigned mask = interned.size() - 1;
+  unsigned h = HashString(s) & mask;
+  for (uint32_t i; (i = interned[h]) != 0; h = (h + 1) & mask)
+    if (StringIsEqual(pool_buffer.data() + i - 1, s))
+      return i - 1;
+
+  const uint32_t offset = pool_buffer.size();
+  pool_buffer.insert(pool_buffer.end(), s, s + _tcslen(s) + 1);
+  interned[h] = offset + 1;
+  ++n_interned;
+  return offset;
+}
+
 void
 FlarmNetDatabase::Insert(const FlarmNetRecord &record)
 {
@@ -34,21 +145,246 @@ FlarmNetDatabase::Insert(const FlarmNetRecord &record)
     /* ignore malformed records */
     return;
 
-  map.insert(std::make_pair(id, record));
+  if (pending.empty() && !records.empty()) {
+    /* move the committed records back to the pending list, so
+       Commit() can rebuild the arrays; keep their storage alive
+       until they have been copied */
+    const auto old_records = std::move(records);
+    const auto old_ids = std::move(id_buffer);
+    const auto old_pool = std::move(pool_buffer);
+    const auto old_mapping = std::move(mapping);
+    const auto old_id_view = ids;
+
+    Clear();
+
+    pending.reserve(old_records.size());
+    for (unsigned i = 0; i < old_records.size(); ++i)
+      pending.push_back(MakePending(old_id_view.data[i], old_records[i]));
+  }
+
+  pending.push_back(MakePending(id, record));
+}
+
+FlarmNetDatabase::PendingRecord
+FlarmNetDatabase::MakePending(FlarmId id, const FlarmNetRecord &record)
+{
+  PendingRecord p;
+  p.id = id;
+
+  uint32_t *dest = p.strings;
+  *dest++ = Intern(record.id);
+  *dest++ = Intern(record.pilot);
+  *dest++ = Intern(record.airfield);
+  *dest++ = Intern(record.plane_type);
+  *dest++ = Intern(record.registration);
+  *dest++ = Intern(record.callsign);
+  *dest++ = Intern(record.frequency);
+  return p;
+}
+
+void
+FlarmNetDatabase::Commit()
+{
+  if (pending.empty())
+    return;
+
+  assert(mapping == nullptr);
+
+  /* sort by id; on duplicates, the first one wins, like
+     std::map::insert() did */
+  std::stable_sort(pending.begin(), pending.end(),
+                   [](const PendingRecord &a, const PendingRecord &b){
+                     return a.id < b.id;
+                   });
+  pending.erase(std::unique(pending.begin(), pending.end(),
+                            [](const PendingRecord &a,
+                               const PendingRecord &b){
+                              return a.id == b.id;
+                            }),
+                pending.end());
+
+  /* the pool is complete now, and pointers into it remain valid */
+  pool_buffer.shrink_to_fit();
+  pool = ConstBuffer<TCHAR>(pool_buffer.data(), pool_buffer.size());
+
+  id_buffer.clear();
+  id_buffer.reserve(pending.size());
+  records.clear();
+  records.reserve(pending.size());
+  for (const auto &p : pending) {
+    id_buffer.push_back(p.id);
+    records.push_back(FromOffsets(p.strings, pool.data));
+  }
+
+  ids = ConstBuffer<FlarmId>(id_buffer.data(), id_buffer.size());
+
+  std::vector<PendingRecord>().swap(pending);
+  std::vector<uint32_t>().swap(interned);
+  n_interned = 0;
+
+  /* build the callsign index with a load factor of at most 0.5 */
+  unsigned n_callsigns = 0;
+  for (const auto &record : records)
+    if (!record.callsign.empty())
+      ++n_callsigns;
+
+  index_buffer.clear();
+  if (n_callsigns > 0) {
+    unsigned size = 2;
+    while (size < n_callsigns * 2)
+      size <<= 1;
+
+    index_buffer.resize(size, 0);
+
+    const unsigned mask = size - 1;
+    for (unsigned i = 0; i < records.size(); ++i) {
+      const TCHAR *callsign = records[i].callsign;
+      if (StringIsEmpty(callsign))
+        continue;
+
+      unsigned h = HashString(callsign) & mask;
+      while (index_buffer[h] != 0)
+        h = (h + 1) & mask;
+
+      index_buffer[h] = i + 1;
+    }
+  }
+
+  index = ConstBuffer<uint32_t>(index_buffer.data(), index_buffer.size());
+}
+
+void
+FlarmNetDatabase::Save(CacheWriter &writer) const
+{
+  const uint32_t n_records = records.size();
+  const uint32_t pool_size = pool.size;
+  const uint32_t index_size = index.size;
+  writer.Write(n_records);
+  writer.Write(pool_size);
+  writer.Write(index_size);
+
+  writer.Write(ids.data, ids.size * sizeof(*ids.data));
+  writer.Write(index.data, index.size * sizeof(*index.data));
+
+  for (const auto &record : records) {
+    uint32_t offsets[N_STRINGS];
+    ToOffsets(record, pool.data, offsets);
+    writer.Write(offsets);
+  }
+
+  writer.Write(pool.data, pool.size * sizeof(*pool.data));
+}
+
+template<typename T>
+static bool
+IsAligned(const void *p)
+{
+  return (size_t)p % alignof(T) == 0;
+}
+
+bool
+FlarmNetDatabase::Load(std::unique_ptr<FileMapping> &&_mapping,
+                       CacheReader &reader)
+{
+  Clear();
+
+  uint32_t n_records, pool_size, index_size;
+  if (!reader.Read(n_records) || !reader.Read(pool_size) ||
+      !reader.Read(index_size))
+    return false;
+
+  const FlarmId *_ids = (const FlarmId *)
+    reader.ReadArray(n_records, sizeof(FlarmId));
+  const uint32_t *_index = (const uint32_t *)
+    reader.ReadArray(index_size, sizeof(uint32_t));
+  const uint32_t *offsets = (const uint32_t *)
+    reader.ReadArray(n_records, N_STRINGS * sizeof(uint32_t));
+  const TCHAR *_pool = (const TCHAR *)
+    reader.ReadArray(pool_size, sizeof(TCHAR));
+  if (reader.HasError() || !reader.IsEnd() ||
+      !IsAligned<FlarmId>(_ids) || !IsAligned<uint32_t>(_index) ||
+      !IsAligned<uint32_t>(offsets) || !IsAligned<TCHAR>(_pool))
+    return false;
+
+  /* validate everything which is used without bounds checks */
+
+  if (n_records > 0 && (pool_size == 0 || _pool[pool_size - 1] != 0))
+    return false;
+
+  /* the index size must be a power of two, and the index must have
+     at least one free slot, or a lookup would never end */
+  if ((index_size & (index_size - 1)) != 0 ||
+      (index_size > 0 &&
+       std::find(_index, _index + index_size, 0u) == _index + index_size))
+    return false;
+
+  for (unsigned i = 0; i < index_size; ++i)
+    if (_index[i] > n_records)
+      return false;
+
+  for (unsigned i = 0; i < n_records * N_STRINGS; ++i)
+    if (offsets[i] >= pool_size)
+      return false;
+
+  for (unsigned i = 1; i < n_records; ++i)
+    if (!(_ids[i - 1] < _ids[i]))
+      return false;
+
+  records.reserve(n_records);
+  for (unsigned i = 0; i < n_records; ++i)
+    records.push_back(FromOffsets(offsets + i * N_STRINGS, _pool));
+
+  ids = ConstBuffer<FlarmId>(_ids, n_records);
+  pool = ConstBuffer<TCHAR>(_pool, pool_size);
+  index = ConstBuffer<uint32_t>(_index, index_size);
+  mapping = std::move(_mapping);
+  return true;
 }
 
 const FlarmNetRecord *
-FlarmNetDatabase::FindFirstRecordByCallSign(const TCHAR *cn) const
+FlarmNetDatabase::FindRecordById(FlarmId id) const
+{
+  auto i = std::lower_bound(ids.begin(), ids.end(), id);
+  return i != ids.end() && *i == id
+    ? &records[i - ids.begin()]
+    : nullptr;
+}
+
+template<typename F>
+void
+FlarmNetDatabase::VisitCallSign(const TCHAR *cn, F &&f) const
 {
-  for (const auto &i : map) {
-    assert(i.first.IsDefined());
+  if (StringIsEmpty(cn)) {
+    /* records without a callsign are not in the index */
+    for (const auto &record : records)
+      if (record.callsign.empty() && !f(record))
+        return;
+
+    return;
+  }
+
+  if (index.IsEmpty())
+    return;
 
-    const FlarmNetRecord &record = i.second;
-    if (StringIsEqual(record.callsign, cn))
-      return &record;
+  const unsigned mask = index.size - 1;
+  for (unsigned h = HashString(cn) & mask; index.data[h] != 0;
+       h = (h + 1) & mask) {
+    const FlarmNetRecord &record = records[index.data[h] - 1];
+    if (StringIsEqual(record.callsign, cn) && !f(record))
+      return;
   }
+}
 
-  return NULL;
+const FlarmNetRecord *
+FlarmNetDatabase::FindFirstRecordByCallSign(const TCHAR *cn) const
+{
+  const FlarmNetRecord *result = nullptr;
+  VisitCallSign(cn, [&result](const FlarmNetRecord &record){
+      result = &record;
+      return false;
+    });
+
+  return result;
 }
 
 unsigned
@@ -57,14 +393,13 @@ FlarmNetDatabase::FindRecordsByCallSign(const TCHAR *cn,
                                         unsigned size) const
 {
   unsigned count = 0;
+  if (size == 0)
+    return count;
 
-  for (const auto &i : map) {
-    assert(i.first.IsDefined());
-
-    const FlarmNetRecord &record = i.second;
-    if (StringIsEqual(record.callsign, cn))
+  VisitCallSign(cn, [array, size, &count](const FlarmNetRecord &record){
       array[count++] = &record;
-  }
+      return count < size;
+    });
 
   return count;
 }
@@ -74,14 +409,13 @@ FlarmNetDatabase::FindIdsByCallSign(const TCHAR *cn, FlarmId array[],
                                     unsigned size) const
 {
   unsigned count = 0;
+  if (size == 0)
+    return count;
 
-  for (const auto &i : map) {
-    assert(i.first.IsDefined());
-
-    const FlarmNetRecord &record = i.second;
-    if (StringIsEqual(record.callsign, cn))
-      array[count++] = i.first;
-  }
+  VisitCallSign(cn, [this, array, size, &count](const FlarmNetRecord &record){
+      array[count++] = ids.data[&record - records.data()];
+      return count < size;
+    });
 
   return count;
 }
@@ -26,41 +26,136 @@ Copyright_License {
 
 #include "FlarmId.hpp"
 #include "FlarmNetRecord.hpp"
+#include "Util/ConstBuffer.hxx"
 #include "Compiler.h"
 
-#include <map>
+#include <memory>
+#include <vector>
+
+#include <stdint.h>
 #include <tchar.h>
 
+class FileMapping;
+class CacheReader;
+class CacheWriter;
+
 /**
  * An in-memory representation of the FlarmNet.org database.
+ *
+ * The records are stored in one array sorted by FLARM id, and their
+ * strings in a pool where each distinct string is stored only once.
+ * An open addressing hash table on the callsign speeds up the
+ * callsign lookups.  The pool, the ids and the index can be saved
+ * with Save() and used in place from a memory mapped file with
+ * Load().
  */
 class FlarmNetDatabase {
-  typedef std::map<FlarmId, FlarmNetRecord> RecordMap;
-  RecordMap map;
+  /**
+   * A record while loading: the strings are offsets in the pool,
+   * because the pool may still be reallocated.
+   */
+  struct PendingRecord {
+    FlarmId id;
+
+    uint32_t strings[7];
+  };
+
+  /**
+   * The records added by Insert() since the last Commit().
+   */
+  std::vector<PendingRecord> pending;
+
+  /**
+   * An open addressing hash table of the strings in #pool_buffer
+   * while loading.  Each element is an offset plus one, or zero if
+   * it is unused.
+   */
+  std::vector<uint32_t> interned;
+  unsigned n_interned;
+
+  /**
+   * The FLARM ids of #records, sorted.  A separate array makes the
+   * binary search touch less memory.
+   */
+  ConstBuffer<FlarmId> ids;
+
+  std::vector<FlarmNetRecord> records;
+
+  /**
+   * All strings, null-terminated.
+   */
+  ConstBuffer<TCHAR> pool;
+
+  /**
+   * The callsign hash table.  Its size is a power of two, and each
+   * element is the index of a record plus one, or zero if it is
+   * unused.  Records with the same callsign are stored in the order
+   * of their ids.
+   */
+  ConstBuffer<uint32_t> index;
+
+  /**
+   * These own #ids, #pool and #index unless they point into
+   * #mapping.
+   */
+  std::vector<FlarmId> id_buffer;
+  std::vector<TCHAR> pool_buffer;
+  std::vector<uint32_t> index_buffer;
+
+  std::unique_ptr<FileMapping> mapping;
 
 public:
+  FlarmNetDatabase();
+  ~FlarmNetDatabase();
+
+  FlarmNetDatabase(const FlarmNetDatabase &) = delete;
+  FlarmNetDatabase &operator=(const FlarmNetDatabase &) = delete;
+
   bool IsEmpty() const {
-    return map.empty();
+    return records.empty();
   }
 
-  void Clear() {
-    map.clear();
-  }
+  void Clear();
 
+  /**
+   * Add a record.  Its strings are copied.  The record becomes
+   * visible after the next Commit() call.  If there are several
+   * records with the same id, the first one wins.
+   */
   void Insert(const FlarmNetRecord &record);
 
+  /**
+   * Sort the records added by Insert() into the database and rebuild
+   * the index.
+   */
+  void Commit();
+
+  /**
+   * Write the database (without records which have not been
+   * committed yet) in a format which can be read by Load().
+   */
+  void Save(CacheWriter &writer) const;
+
+  /**
+   * Replace the contents of the database with data written by
+   * Save().  Only the record array is rebuilt; the strings, the ids
+   * and the index are used in place, and the database takes over
+   * the mapping which contains them.
+   *
+   * @param reader reads from the #mapping; it must be aligned to
+   * four bytes
+   * @return false if the data is malformed (the database is empty
+   * then)
+   */
+  bool Load(std::unique_ptr<FileMapping> &&mapping, CacheReader &reader);
+
   /**
    * Finds a FLARMNetRecord object based on the given FLARM id
    * @param id FLARM id
    * @return FLARMNetRecord object
    */
   gcc_pure
-  const FlarmNetRecord *FindRecordById(FlarmId id) const {
-    auto i = map.find(id);
-    return i != map.end()
-      ? &i->second
-      : NULL;
-  }
+  const FlarmNetRecord *FindRecordById(FlarmId id) const;
 
   /**
    * Finds a FLARMNetRecord object based on the given Callsign
@@ -76,13 +171,25 @@ public:
   unsigned FindIdsByCallSign(const TCHAR *cn, FlarmId array[],
                              unsigned size) const;
 
-  RecordMap::const_iterator begin() const {
-    return map.begin();
+  std::vector<FlarmNetRecord>::const_iterator begin() const {
+    return records.begin();
   }
 
-  RecordMap::const_iterator end() const {
-    return map.end();
+  std::vector<FlarmNetRecord>::const_iterator end() const {
+    return records.end();
   }
+
+private:
+  void GrowInternTable();
+  uint32_t Intern(const TCHAR *s);
+  PendingRecord MakePending(FlarmId id, const FlarmNetRecord &record);
+
+  /**
+   * Call the given function for each record with the specified
+   * callsign, in the order of their ids, until it returns false.
+   */
+  template<typename F>
+  void VisitCallSign(const TCHAR *cn, F &&f) const;
 };
 
 #endif
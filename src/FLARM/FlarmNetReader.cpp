@@ -28,6 +28,7 @@ Copyright_License {
 #include "Util/CharUtil.hpp"
 #include "IO/LineReader.hpp"
 #include "IO/FileLineReader.hpp"
+#include "Util/StaticString.hxx"
 
 #ifndef _UNICODE
 #include "Util/UTF8.hpp"
@@ -36,6 +37,64 @@ Copyright_License {
 #include <stdio.h>
 #include <stdlib.h>
 
+constexpr
+static inline size_t
+LatinBufferSize(size_t size)
+{
+#ifdef _UNICODE
+/* with wide characters, the exact size of the FLARMNet database field
+   (plus one for the terminator) is just right, ... */
+  return size;
+#else
+/* ..., but when we convert Latin-1 to UTF-8, we need a little bit
+   more buffer */
+  return size * 3 / 2 + 1;
+#endif
+}
+
+/**
+ * The decoded strings of one record.  The #FlarmNetRecord passed to
+ * FlarmNetDatabase::Insert() points to these buffers.
+ */
+struct RecordBuffer {
+  StaticString<LatinBufferSize(7)> id;
+  StaticString<LatinBufferSize(22)> pilot;
+  StaticString<LatinBufferSize(22)> airfield;
+  StaticString<LatinBufferSize(22)> plane_type;
+  StaticString<LatinBufferSize(8)> registration;
+  StaticString<LatinBufferSize(4)> callsign;
+  StaticString<LatinBufferSize(8)> frequency;
+
+  FlarmNetRecord ToRecord() const {
+    FlarmNetRecord record;
+    record.id = id.c_str();
+    record.pilot = pilot.c_str();
+    record.airfield = airfield.c_str();
+    record.plane_type = plane_type.c_str();
+    record.registration = registration.c_str();
+    record.callsign = callsign.c_str();
+    record.frequency = frequency.c_str();
+    return record;
+  }
+};
+
+/**
+ * @return the value of the hex digit or -1 if it is not one
+ */
+gcc_const
+static int
+ParseHexDigit(char ch)
+{
+  if (ch >= '0' && ch <= '9')
+    return ch - '0';
+  else if (ch >= 'A' && ch <= 'F')
+    return ch - 'A' + 10;
+  else if (ch >= 'a' && ch <= 'f')
+    return ch - 'a' + 10;
+  else
+    return -1;
+}
+
 /**
  * Decodes the FlarmNet.org file and puts the wanted
  * characters into the res pointer
@@ -63,7 +122,11 @@ LoadString(const char *bytes, size_t length, TCHAR *res, size_t res_size)
 
     /* FLARMNet files are ISO-Latin-1, which is kind of short-sighted */
 
-    const unsigned char ch = (unsigned char)strtoul(tmp, NULL, 16);
+    const int high = ParseHexDigit(tmp[0]), low = ParseHexDigit(tmp[1]);
+    const unsigned char ch = high >= 0 && low >= 0
+      ? (unsigned char)(high << 4 | low)
+      /* leave malformed input to strtoul() */
+      : (unsigned char)strtoul(tmp, NULL, 16);
 #ifdef _UNICODE
     /* Latin-1 can be converted to WIN32 wchar_t by casting */
     *p++ = ch;
@@ -101,7 +164,7 @@ LoadString(const char *bytes, size_t length, StaticString<size> &dest)
  * The caller is responsible for deleting the object again!
  */
 static bool
-LoadRecord(FlarmNetRecord &record, const char *line)
+LoadRecord(RecordBuffer &record, const char *line)
 {
   if (strlen(line) < 172)
     return false;
@@ -131,14 +194,16 @@ FlarmNetReader::LoadFile(NLineReader &reader, FlarmNetDatabase &database)
     return 0;
 
   int itemCount = 0;
+  RecordBuffer record;
   while ((line = reader.ReadLine()) != NULL) {
-    FlarmNetRecord record;
     if (LoadRecord(record, line)) {
-      database.Insert(record);
+      database.Insert(record.ToRecord());
       itemCount++;
     }
   }
 
+  database.Commit();
+
   return itemCount;
 }
 
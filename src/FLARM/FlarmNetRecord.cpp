@@ -27,5 +27,5 @@ Copyright_License {
 FlarmId
 FlarmNetRecord::GetId() const
 {
-  return FlarmId::Parse(this->id, NULL);
+  return FlarmId::Parse(this->id, nullptr);
 };
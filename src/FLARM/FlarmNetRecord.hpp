@@ -24,50 +24,55 @@ Copyright_License {
 #ifndef XCSOAR_FLARM_NET_RECORD_HPP
 #define XCSOAR_FLARM_NET_RECORD_HPP
 
-#include "Util/StaticString.hxx"
+#include "Util/StringPointer.hxx"
 #include "Compiler.h"
 
-class FlarmId;
+#include <tchar.h>
 
-constexpr
-static inline size_t
-LatinBufferSize(size_t size)
-{
-#ifdef _UNICODE
-/* with wide characters, the exact size of the FLARMNet database field
-   (plus one for the terminator) is just right, ... */
-  return size;
-#else
-/* ..., but when we convert Latin-1 to UTF-8, we need a little bit
-   more buffer */
-  return size * 3 / 2 + 1;
-#endif
-}
+class FlarmId;
 
 /**
- * FlarmNet.org file entry
+ * FlarmNet.org file entry.  The strings point into the string pool
+ * of the #FlarmNetDatabase which owns the record.
  */
 struct FlarmNetRecord {
+  /**
+   * A pointer to a null-terminated string in the string pool.
+   */
+  class String : public StringPointer<TCHAR> {
+  public:
+    String() = default;
+    constexpr String(const TCHAR *_value):StringPointer<TCHAR>(_value) {}
+
+    bool empty() const {
+      return *c_str() == _T('\0');
+    }
+
+    operator const TCHAR *() const {
+      return c_str();
+    }
+  };
+
   /**< FLARM id 6 bytes */
-  StaticString<LatinBufferSize(7)> id;
+  String id;
 
   /**< Name 15 bytes */
-  StaticString<LatinBufferSize(22)> pilot;
+  String pilot;
 
   /**< Airfield 4 bytes */
-  StaticString<LatinBufferSize(22)> airfield;
+  String airfield;
 
   /**< Aircraft type 1 byte */
-  StaticString<LatinBufferSize(22)> plane_type;
+  String plane_type;
 
   /**< Registration 7 bytes */
-  StaticString<LatinBufferSize(8)> registration;
+  String registration;
 
   /**< Callsign 3 bytes */
-  StaticString<LatinBufferSize(4)> callsign;
+  String callsign;
 
   /**< Radio frequency 6 bytes */
-  StaticString<LatinBufferSize(8)> frequency;
+  String frequency;
 
   gcc_pure
   FlarmId GetId() const;
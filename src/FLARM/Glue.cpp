@@ -25,22 +25,38 @@ Copyright_License {
 #include "Global.hpp"
 #include "TrafficDatabases.hpp"
 #include "FlarmNetReader.hpp"
+#include "FlarmNetCache.hpp"
 #include "NameFile.hpp"
 #include "Components.hpp"
 #include "MergeThread.hpp"
 #include "IO/DataFile.hpp"
 #include "IO/LineReader.hpp"
 #include "IO/TextWriter.hpp"
+#include "IO/FileCache.hpp"
+#include "LocalPath.hpp"
 #include "Profile/FlarmProfile.hpp"
 #include "Profile/Current.hpp"
 #include "LogFile.hpp"
 
+#include <windef.h> // for MAX_PATH
+
+static const TCHAR *const FLARMNET_CACHE = _T("flarmnet");
+
 /**
- * Loads the FLARMnet file
+ * Loads the FLARMnet file, preferring its snapshot in the #FileCache
  */
 static void
 LoadFLARMnet(FlarmNetDatabase &db)
 {
+  TCHAR path[MAX_PATH];
+  LocalPath(path, _T("data.fln"));
+
+  if (file_cache != nullptr &&
+      FlarmNetCache::Load(*file_cache, FLARMNET_CACHE, path, db)) {
+    LogFormat("FLARMnet loaded from cache");
+    return;
+  }
+
   NLineReader *reader = OpenDataTextFileA(_T("data.fln"));
   if (reader == NULL)
     return;
@@ -48,8 +64,13 @@ LoadFLARMnet(FlarmNetDatabase &db)
   unsigned num_records = FlarmNetReader::LoadFile(*reader, db);
   delete reader;
 
-  if (num_records > 0)
+  if (num_records > 0) {
     LogFormat("%u FLARMnet ids found", num_records);
+
+    if (file_cache != nullptr &&
+        !FlarmNetCache::Save(*file_cache, FLARMNET_CACHE, path, db))
+      LogFormat("Failed to save FLARMnet cache");
+  }
 }
 
 /**
@@ -65,6 +65,33 @@ isLeft( const FlatGeoPoint &P0, const FlatGeoPoint &P1, const FlatGeoPoint &P2 )
 //               V[] = vertex points of a polygon V[n+1] with V[n]=V[0]
 //      Return:  true if P is inside V
 
+int
+PolygonWinding(const GeoPoint &P, const GeoPoint &a, const GeoPoint &b)
+{
+  // edge from a to b
+  if (a.latitude <= P.latitude) {
+    // start y <= P.latitude
+
+    if (b.latitude > P.latitude)
+      // an upward crossing
+      if (isLeft(a, b, P) > 0)
+        // P left of edge
+        // have a valid up intersect
+        return 1;
+  } else {
+    // start y > P.latitude (no test needed)
+
+    if (b.latitude <= P.latitude)
+      // a downward crossing
+      if (isLeft(a, b, P) < 0)
+        // P right of edge
+        // have a valid down intersect
+        return -1;
+  }
+
+  return 0;
+}
+
 bool
 PolygonInterior(const GeoPoint &P,
                 SearchPointVector::const_iterator begin,
@@ -77,28 +104,9 @@ PolygonInterior(const GeoPoint &P,
 
   // loop through all edges of the polygon
   for (auto i = begin, next = std::next(i); next != end;
-       i = next, next = std::next(i)) {
-    // edge from current to next
-    if (i->GetLocation().latitude <= P.latitude) {
-      // start y <= P.latitude
-
-      if (next->GetLocation().latitude > P.latitude)
-        // an upward crossing
-        if (isLeft(i->GetLocation(), next->GetLocation(), P) > 0)
-          // P left of edge
-          // have a valid up intersect
-          ++wn;
-    } else {
-      // start y > P.latitude (no test needed)
+       i = next, next = std::next(i))
+    wn += PolygonWinding(P, i->GetLocation(), next->GetLocation());
 
-      if (next->GetLocation().latitude <= P.latitude)
-        // a downward crossing
-        if (isLeft(i->GetLocation(), next->GetLocation(), P) < 0)
-          // P right of edge
-          // have a valid down intersect
-          --wn;
-    }
-  }
   return wn != 0;
 }
 
@@ -38,6 +38,15 @@ PolygonInterior(const GeoPoint &p,
                 SearchPointVector::const_iterator begin,
                 SearchPointVector::const_iterator end);
 
+/**
+ * Returns the contribution of the edge from a to b to the winding
+ * number of p: 1 for an upward crossing with p on its left, -1 for a
+ * downward crossing with p on its right, 0 otherwise.  Only edges
+ * which span the latitude of p can contribute.
+ */
+gcc_pure int
+PolygonWinding(const GeoPoint &p, const GeoPoint &a, const GeoPoint &b);
+
 gcc_pure bool
 PolygonInterior(const FlatGeoPoint &p,
                 SearchPointVector::const_iterator begin,
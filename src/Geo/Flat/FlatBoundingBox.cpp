@@ -100,21 +100,6 @@ FlatBoundingBox::GetCenter() const
                       (bb_ll.latitude + bb_ur.latitude) / 2);
 }
 
-bool
-FlatBoundingBox::Overlaps(const FlatBoundingBox& other) const
-{
-  if (bb_ll.longitude > other.bb_ur.longitude)
-    return false;
-  if (bb_ur.longitude < other.bb_ll.longitude)
-    return false;
-  if (bb_ll.latitude > other.bb_ur.latitude)
-    return false;
-  if (bb_ur.latitude < other.bb_ll.latitude)
-    return false;
-
-  return true;
-}
-
 bool
 FlatBoundingBox::IsInside(const FlatGeoPoint& loc) const
 {
@@ -115,8 +115,13 @@ public:
   /**
    * Determine whether these bounding boxes overlap
    */
-  gcc_pure
-  bool Overlaps(const FlatBoundingBox& other) const;
+  constexpr
+  bool Overlaps(const FlatBoundingBox& other) const {
+    return bb_ll.longitude <= other.bb_ur.longitude &&
+      bb_ur.longitude >= other.bb_ll.longitude &&
+      bb_ll.latitude <= other.bb_ur.latitude &&
+      bb_ur.latitude >= other.bb_ll.latitude;
+  }
 
   /**
    * Expand the bounding box to include this point
@@ -0,0 +1,357 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_PACKED_RTREE_HPP
+#define XCSOAR_PACKED_RTREE_HPP
+
+#include "FlatBoundingBox.hpp"
+#include "Compiler.h"
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#include <assert.h>
+#include <math.h>
+
+/**
+ * A static R-tree of objects with a #FlatBoundingBox, bulk-loaded
+ * with the "Sort-Tile-Recursive" algorithm.  The objects are stored
+ * in one contiguous array in STR order; the bounding boxes of the
+ * tree nodes are stored level by level in another array, and the
+ * children of a node are found by index arithmetic.
+ *
+ * New objects are appended with insert(), but they are not indexed
+ * until the next Optimise() call; until then, searches check them
+ * one by one.  Removing an object with erase() discards the index.
+ *
+ * @param T a class derived from #FlatBoundingBox
+ *
+ * @see http://en.wikipedia.org/wiki/R-tree
+ */
+template<typename T>
+class PackedRTree {
+  /**
+   * The number of children of each node.
+   */
+  static constexpr unsigned FANOUT = 16;
+
+  typedef std::vector<T> ItemVector;
+
+  /**
+   * All objects.  The first #n_packed are indexed by #nodes.
+   */
+  ItemVector items;
+
+  unsigned n_packed = 0;
+
+  /**
+   * The bounding boxes of all nodes, level by level.  The first level
+   * contains the leaf nodes, the last one contains only the root.
+   */
+  std::vector<FlatBoundingBox> nodes;
+
+  /**
+   * The position of each level in #nodes, plus one element for the
+   * end of the root level.
+   */
+  std::vector<unsigned> levels;
+
+public:
+  typedef unsigned distance_type;
+  typedef typename ItemVector::const_iterator const_iterator;
+
+  gcc_pure
+  const_iterator begin() const {
+    return items.begin();
+  }
+
+  gcc_pure
+  const_iterator end() const {
+    return items.end();
+  }
+
+  gcc_pure
+  unsigned size() const {
+    return items.size();
+  }
+
+  gcc_pure
+  bool IsEmpty() const {
+    return items.empty();
+  }
+
+  void clear() {
+    items.clear();
+    n_packed = 0;
+    nodes.clear();
+    levels.clear();
+  }
+
+  /**
+   * Add an object.  It will be indexed by the next Optimise() call.
+   */
+  template<typename U>
+  void insert(U &&value) {
+    items.emplace_back(std::forward<U>(value));
+  }
+
+  /**
+   * Remove the first object which equals the specified one.  This
+   * discards the index; call Optimise() afterwards.
+   *
+   * @return true if an object was removed
+   */
+  bool erase(const T &value) {
+    auto i = std::find(items.begin(), items.end(), value);
+    if (i == items.end())
+      return false;
+
+    items.erase(i);
+    n_packed = 0;
+    nodes.clear();
+    levels.clear();
+    return true;
+  }
+
+  gcc_pure
+  bool IsOptimised() const {
+    return n_packed == items.size();
+  }
+
+  /**
+   * Sort all objects and rebuild the index, unless it is up to date.
+   */
+  void Optimise() {
+    if (!IsOptimised())
+      Build();
+  }
+
+  /**
+   * Invoke the visitor on all objects whose bounding box overlaps the
+   * specified box after expanding it by the given range.
+   */
+  template<class V>
+  void VisitWithinRange(const FlatBoundingBox &box, distance_type range,
+                        V &visitor) const {
+    const int r = range;
+    const FlatBoundingBox query(FlatGeoPoint(box.GetLowerLeft().longitude - r,
+                                             box.GetLowerLeft().latitude - r),
+                                FlatGeoPoint(box.GetUpperRight().longitude + r,
+                                             box.GetUpperRight().latitude + r));
+
+    if (n_packed > 0 && nodes.back().Overlaps(query))
+      VisitNode(levels.size() - 2, 0, query, visitor);
+
+    for (auto i = items.begin() + n_packed, end = items.end(); i != end; ++i)
+      if (i->Overlaps(query))
+        visitor(*i);
+  }
+
+  /**
+   * Find the object whose bounding box is nearest to the specified
+   * box, and which matches the predicate.
+   *
+   * @param range the maximum distance
+   * @return the object (or end()) and its distance
+   */
+  template<class P>
+  gcc_pure
+  std::pair<const_iterator, distance_type>
+  FindNearestIf(const FlatBoundingBox &box, distance_type range,
+                const P &predicate) const {
+    std::pair<const_iterator, distance_type> result(end(), range);
+
+    if (n_packed > 0 && nodes.back().Distance(box) <= range)
+      FindNearestInNode(levels.size() - 2, 0, box, predicate, result);
+
+    for (auto i = items.begin() + n_packed, end = items.end(); i != end; ++i)
+      CheckNearest(i, box, predicate, result);
+
+    return result;
+  }
+
+private:
+  gcc_pure
+  unsigned GetLevelSize(unsigned level) const {
+    return levels[level + 1] - levels[level];
+  }
+
+  /**
+   * Returns the range of children of the specified node: indices into
+   * #items for the leaf level, indices relative to the level below
+   * otherwise.
+   */
+  gcc_pure
+  std::pair<unsigned, unsigned> GetChildren(unsigned level,
+                                            unsigned node) const {
+    const unsigned n_children = level == 0
+      ? n_packed
+      : GetLevelSize(level - 1);
+    const unsigned begin = node * FANOUT;
+    return std::make_pair(begin, std::min(begin + FANOUT, n_children));
+  }
+
+  template<class V>
+  void VisitNode(unsigned level, unsigned node,
+                 const FlatBoundingBox &query, V &visitor) const {
+    const auto children = GetChildren(level, node);
+
+    if (level == 0) {
+      for (unsigned i = children.first; i < children.second; ++i)
+        if (items[i].Overlaps(query))
+          visitor(items[i]);
+    } else {
+      const FlatBoundingBox *below = &nodes[levels[level - 1]];
+      for (unsigned i = children.first; i < children.second; ++i)
+        if (below[i].Overlaps(query))
+          VisitNode(level - 1, i, query, visitor);
+    }
+  }
+
+  /**
+   * Can an object at the specified distance improve the result of
+   * FindNearestIf()?
+   */
+  gcc_pure
+  bool IsCandidate(distance_type distance,
+                   const std::pair<const_iterator, distance_type> &result) const {
+    return distance < result.second ||
+      (distance == result.second && result.first == end());
+  }
+
+  template<class P>
+  void CheckNearest(const_iterator i, const FlatBoundingBox &box,
+                    const P &predicate,
+                    std::pair<const_iterator, distance_type> &result) const {
+    const distance_type distance = i->Distance(box);
+    if (IsCandidate(distance, result) && predicate(*i)) {
+      result.first = i;
+      result.second = distance;
+    }
+  }
+
+  template<class P>
+  void FindNearestInNode(unsigned level, unsigned node,
+                         const FlatBoundingBox &box, const P &predicate,
+                         std::pair<const_iterator, distance_type> &result) const {
+    const auto children = GetChildren(level, node);
+
+    if (level == 0) {
+      for (unsigned i = children.first; i < children.second; ++i)
+        CheckNearest(items.begin() + i, box, predicate, result);
+    } else {
+      /* descend into the nearest child first, to narrow the search
+         radius quickly */
+      const FlatBoundingBox *below = &nodes[levels[level - 1]];
+      std::pair<distance_type, unsigned> order[FANOUT];
+      unsigned n = 0;
+      for (unsigned i = children.first; i < children.second; ++i)
+        order[n++] = std::make_pair(below[i].Distance(box), i);
+
+      std::sort(order, order + n);
+
+      for (unsigned i = 0; i < n && IsCandidate(order[i].first, result); ++i)
+        FindNearestInNode(level - 1, order[i].second, box, predicate, result);
+    }
+  }
+
+  static int GetCenterX(const T &value) {
+    return value.GetLowerLeft().longitude + value.GetUpperRight().longitude;
+  }
+
+  static int GetCenterY(const T &value) {
+    return value.GetLowerLeft().latitude + value.GetUpperRight().latitude;
+  }
+
+  /**
+   * Returns the bounding box of the specified range of boxes.
+   */
+  template<typename I>
+  gcc_pure
+  static FlatBoundingBox GetBounds(I begin, I end) {
+    assert(begin != end);
+
+    FlatBoundingBox result(begin->GetLowerLeft(), begin->GetUpperRight());
+    for (++begin; begin != end; ++begin)
+      result.Merge(*begin);
+    return result;
+  }
+
+  /**
+   * Sort the objects into tiles: vertical slices ordered by x,
+   * each sorted by y, so each leaf node covers a compact area.
+   */
+  void SortTiles() {
+    const unsigned n = items.size();
+    const unsigned n_leaves = (n + FANOUT - 1) / FANOUT;
+    const unsigned n_slices = (unsigned)ceil(sqrt((double)n_leaves));
+    const unsigned slice_size = n_slices * FANOUT;
+
+    std::sort(items.begin(), items.end(), [](const T &a, const T &b){
+        return GetCenterX(a) < GetCenterX(b);
+      });
+
+    for (unsigned i = 0; i < n; i += slice_size) {
+      const auto begin = items.begin() + i;
+      const auto end = items.begin() + std::min(i + slice_size, n);
+      std::sort(begin, end, [](const T &a, const T &b){
+          return GetCenterY(a) < GetCenterY(b);
+        });
+    }
+  }
+
+  void Build() {
+    n_packed = items.size();
+    nodes.clear();
+    levels.clear();
+
+    if (items.empty())
+      return;
+
+    SortTiles();
+
+    levels.push_back(0);
+    for (unsigned i = 0; i < n_packed; i += FANOUT)
+      nodes.push_back(GetBounds(items.begin() + i,
+                                items.begin() + std::min(i + FANOUT,
+                                                         n_packed)));
+
+    /* the nodes of each level are in STR order already, because their
+       children are */
+    while (nodes.size() - levels.back() > 1) {
+      const unsigned begin = levels.back(), end = nodes.size();
+      levels.push_back(end);
+
+      for (unsigned i = begin; i < end; i += FANOUT) {
+        const FlatBoundingBox bounds =
+          GetBounds(nodes.begin() + i,
+                    nodes.begin() + std::min(i + FANOUT, end));
+        nodes.push_back(bounds);
+      }
+    }
+
+    levels.push_back(nodes.size());
+  }
+};
+
+#endif
@@ -0,0 +1,131 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "PolygonSlabs.hpp"
+#include "ConvexHull/PolygonInterior.hpp"
+
+#include <algorithm>
+
+void
+PolygonSlabs::Clear()
+{
+  n_slabs = 0;
+  offsets.clear();
+  edges.clear();
+}
+
+unsigned
+PolygonSlabs::GetSlab(Angle latitude) const
+{
+  const fixed offset = latitude.Native() - south;
+  if (!positive(offset))
+    return 0;
+
+  const unsigned slab = (unsigned)(offset / slab_height);
+  return std::min(slab, n_slabs - 1);
+}
+
+void
+PolygonSlabs::Build(const SearchPointVector &polygon,
+                    unsigned edges_per_slab)
+{
+  Clear();
+
+  if (polygon.size() < 4)
+    return;
+
+  const unsigned n_edges = polygon.size() - 1;
+
+  Angle min = polygon.front().GetLocation().latitude, max = min;
+  for (const auto &i : polygon) {
+    min = std::min(min, i.GetLocation().latitude);
+    max = std::max(max, i.GetLocation().latitude);
+  }
+
+  if (!(max > min))
+    return;
+
+  south = min.Native();
+  n_slabs = std::max(n_edges / edges_per_slab, 1u);
+  slab_height = (max.Native() - south) / n_slabs;
+
+  /* count the edges of each slab, then fill them in */
+  offsets.assign(n_slabs + 1, 0);
+  for (unsigned edge = 0; edge < n_edges; ++edge) {
+    const unsigned first = GetFirstSlab(polygon, edge);
+    const unsigned last = GetLastSlab(polygon, edge);
+    for (unsigned slab = first; slab <= last; ++slab)
+      ++offsets[slab + 1];
+  }
+
+  for (unsigned slab = 0; slab < n_slabs; ++slab)
+    offsets[slab + 1] += offsets[slab];
+
+  edges.resize(offsets.back());
+  std::vector<unsigned> fill(offsets.begin(), offsets.end() - 1);
+  for (unsigned edge = 0; edge < n_edges; ++edge) {
+    const unsigned first = GetFirstSlab(polygon, edge);
+    const unsigned last = GetLastSlab(polygon, edge);
+    for (unsigned slab = first; slab <= last; ++slab)
+      edges[fill[slab]++] = (edge << 1) | (slab == first);
+  }
+}
+
+bool
+PolygonSlabs::IsValid(const SearchPointVector &polygon) const
+{
+  if (polygon.size() < 4 || !positive(slab_height) ||
+      offsets.size() != n_slabs + 1 || offsets.front() != 0 ||
+      offsets.back() != edges.size())
+    return false;
+
+  for (unsigned slab = 0; slab < n_slabs; ++slab)
+    if (offsets[slab] > offsets[slab + 1])
+      return false;
+
+  const unsigned n_edges = polygon.size() - 1;
+  for (const unsigned i : edges)
+    if ((i >> 1) >= n_edges)
+      return false;
+
+  return true;
+}
+
+bool
+PolygonSlabs::IsInside(const SearchPointVector &polygon,
+                       const GeoPoint &p) const
+{
+  assert(IsDefined());
+
+  /* only edges spanning p's latitude contribute to the winding
+     number, and all of them are in p's slab */
+  const unsigned slab = GetSlab(p.latitude);
+
+  int wn = 0;
+  for (unsigned i = offsets[slab], end = offsets[slab + 1]; i != end; ++i) {
+    const unsigned edge = edges[i] >> 1;
+    wn += PolygonWinding(p, polygon[edge].GetLocation(),
+                         polygon[edge + 1].GetLocation());
+  }
+
+  return wn != 0;
+}
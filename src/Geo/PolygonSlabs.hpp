@@ -0,0 +1,209 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_GEO_POLYGON_SLABS_HPP
+#define XCSOAR_GEO_POLYGON_SLABS_HPP
+
+#include "SearchPointVector.hpp"
+#include "Math/fixed.hpp"
+#include "Compiler.h"
+
+#include <vector>
+
+#include <assert.h>
+#include <string.h>
+
+/**
+ * An index over the edges of a closed polygon, i.e. a
+ * #SearchPointVector whose last point equals the first one.  The
+ * latitude range of the polygon is divided into slabs of equal
+ * height, and each slab lists the edges which overlap it.  A
+ * point-in-polygon test needs only the edges of one slab, and a line
+ * only needs the edges of the slabs it passes.
+ *
+ * Edge i connects point i and point i+1.  This object does not keep a
+ * reference to the polygon; the caller passes it to each method, and
+ * must call Build() again after modifying it.
+ */
+class PolygonSlabs {
+  fixed south, slab_height;
+
+  unsigned n_slabs = 0;
+
+  /**
+   * The position of each slab's edge list in #edges, plus one element
+   * for the end of the last one.
+   */
+  std::vector<unsigned> offsets;
+
+  /**
+   * The edge indices of all slabs, shifted left by one bit.  Bit 0 is
+   * set in the first (southernmost) slab of each edge.
+   */
+  std::vector<unsigned> edges;
+
+public:
+  bool IsDefined() const {
+    return n_slabs > 0;
+  }
+
+  void Clear();
+
+  /**
+   * Build the index.
+   *
+   * @param edges_per_slab the desired average number of edges per
+   * slab
+   */
+  void Build(const SearchPointVector &polygon, unsigned edges_per_slab);
+
+  /**
+   * Write the index to a binary snapshot.
+   *
+   * @param writer an object like #CacheWriter
+   */
+  template<typename W>
+  void Save(W &writer) const {
+    writer.Write(n_slabs);
+    if (!IsDefined())
+      return;
+
+    writer.Write(south);
+    writer.Write(slab_height);
+
+    const unsigned n_entries = edges.size();
+    writer.Write(n_entries);
+    writer.Write(offsets.data(), offsets.size() * sizeof(offsets.front()));
+    writer.Write(edges.data(), edges.size() * sizeof(edges.front()));
+  }
+
+  /**
+   * Load an index written by Save(), and validate it against the
+   * polygon, which must be the same that was used to build it.
+   *
+   * @param reader an object like #CacheReader
+   * @return false on error
+   */
+  template<typename R>
+  bool Load(R &reader, const SearchPointVector &polygon) {
+    Clear();
+
+    unsigned _n_slabs, n_entries;
+    if (!reader.Read(_n_slabs))
+      return false;
+
+    if (_n_slabs == 0)
+      return true;
+
+    const void *src_offsets, *src_edges;
+    if (!reader.Read(south) || !reader.Read(slab_height) ||
+        !reader.Read(n_entries) ||
+        (src_offsets = reader.ReadArray(_n_slabs + 1,
+                                        sizeof(offsets.front()))) == nullptr ||
+        (src_edges = reader.ReadArray(n_entries,
+                                      sizeof(edges.front()))) == nullptr)
+      return false;
+
+    offsets.resize(_n_slabs + 1);
+    memcpy(offsets.data(), src_offsets,
+           offsets.size() * sizeof(offsets.front()));
+    edges.resize(n_entries);
+    memcpy(edges.data(), src_edges, edges.size() * sizeof(edges.front()));
+
+    n_slabs = _n_slabs;
+    if (!IsValid(polygon)) {
+      Clear();
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Is the given location inside the polygon?  This gives the same
+   * result as PolygonInterior().
+   */
+  gcc_pure
+  bool IsInside(const SearchPointVector &polygon, const GeoPoint &p) const;
+
+  /**
+   * Invoke the visitor once for each edge which may overlap the
+   * specified latitude range.  This includes the edges of the
+   * adjacent slabs, to allow for rounding errors when the caller
+   * works with projected coordinates.
+   *
+   * @param visitor a function object taking the edge index
+   */
+  template<typename V>
+  void VisitEdges(Angle a, Angle b, V &&visitor) const {
+    assert(IsDefined());
+
+    unsigned first = GetSlab(std::min(a, b));
+    unsigned last = GetSlab(std::max(a, b));
+    if (first > 0)
+      --first;
+    if (last + 1 < n_slabs)
+      ++last;
+
+    /* an edge spanning several slabs is visited only in the first
+       slab of the range, or in its own first slab */
+    for (unsigned i = offsets[first], end = offsets[first + 1];
+         i != end; ++i)
+      visitor(edges[i] >> 1);
+
+    for (unsigned i = offsets[first + 1], end = offsets[last + 1];
+         i != end; ++i)
+      if (edges[i] & 1)
+        visitor(edges[i] >> 1);
+  }
+
+private:
+  /**
+   * Check the structure of a loaded index: the offsets must be
+   * ordered and the edge indices must exist in the polygon.
+   */
+  gcc_pure
+  bool IsValid(const SearchPointVector &polygon) const;
+
+  /**
+   * Returns the slab containing the specified latitude, clipped to
+   * the valid range.
+   */
+  gcc_pure
+  unsigned GetSlab(Angle latitude) const;
+
+  gcc_pure
+  unsigned GetFirstSlab(const SearchPointVector &polygon,
+                        unsigned edge) const {
+    return GetSlab(std::min(polygon[edge].GetLocation().latitude,
+                            polygon[edge + 1].GetLocation().latitude));
+  }
+
+  gcc_pure
+  unsigned GetLastSlab(const SearchPointVector &polygon,
+                       unsigned edge) const {
+    return GetSlab(std::max(polygon[edge].GetLocation().latitude,
+                            polygon[edge + 1].GetLocation().latitude));
+  }
+};
+
+#endif
@@ -30,7 +30,7 @@ Copyright_License {
 #include <assert.h>
 
 IGCWriter::IGCWriter(const TCHAR *path)
-  :file(path)
+  :file(path, false, QUEUE_SIZE)
 {
   fix.Clear();
 
@@ -190,7 +190,7 @@ NormalizeIGCAltitude(int value)
   return value;
 }
 
-void
+bool
 IGCWriter::LogPoint(const IGCFix &fix, int epe, int satellites)
 {
   char b_record[128];
@@ -207,44 +207,43 @@ IGCWriter::LogPoint(const IGCFix &fix, int epe, int satellites)
           NormalizeIGCAltitude(fix.gps_altitude),
           epe, satellites);
 
-  WriteLine(b_record);
-  Flush();
+  return WriteLine(b_record);
 }
 
-void
+bool
 IGCWriter::LogPoint(const NMEAInfo& gps_info)
 {
-  if (fix.Apply(gps_info))
+  return !fix.Apply(gps_info) ||
     LogPoint(fix, (int)GetEPE(gps_info.gps), GetSIU(gps_info.gps));
 }
 
-void
+bool
 IGCWriter::LogEvent(const BrokenTime &time, const char *event)
 {
   char e_record[30];
   sprintf(e_record, "E%02d%02d%02d%s",
           time.hour, time.minute, time.second, event);
 
-  WriteLine(e_record);
+  return WriteLine(e_record);
 }
 
-void
+bool
 IGCWriter::LogEvent(const IGCFix &fix, int epe, int satellites,
                     const char *event)
 {
-  LogEvent(fix.time, event);
+  const bool success = LogEvent(fix.time, event);
 
   // tech_spec_gnss.pdf says we need a B record immediately after an E record
-  LogPoint(fix, epe, satellites);
+  return LogPoint(fix, epe, satellites) && success;
 }
 
-void
+bool
 IGCWriter::LogEvent(const NMEAInfo &gps_info, const char *event)
 {
-  LogEvent(gps_info.date_time_utc, event);
+  const bool success = LogEvent(gps_info.date_time_utc, event);
 
   // tech_spec_gnss.pdf says we need a B record immediately after an E record
-  LogPoint(gps_info);
+  return LogPoint(gps_info) && success;
 }
 
 void
@@ -271,11 +270,19 @@ IGCWriter::LogFRecord(const BrokenTime &time, const int *satellite_ids)
   WriteLine(f_record);
 }
 
-void
+bool
 IGCWriter::Sign()
 {
   assert(file.IsOpen());
 
   grecord.FinalizeBuffer();
-  grecord.WriteTo(file);
+
+  GRecord::Line lines[GRecord::N_LINES];
+  grecord.GetLines(lines);
+
+  for (const GRecord::Line &line : lines)
+    if (!file.WriteLine(line))
+      return false;
+
+  return true;
 }
@@ -27,7 +27,7 @@ Copyright_License {
 #include "Logger/GRecord.hpp"
 #include "Math/fixed.hpp"
 #include "IGCFix.hpp"
-#include "IO/TextWriter.hpp"
+#include "IO/AsyncTextWriter.hpp"
 
 #include <tchar.h>
 
@@ -41,7 +41,15 @@ class IGCWriter {
     MAX_IGC_BUFF = 255,
   };
 
-  TextWriter file;
+  /**
+   * The maximum number of lines waiting to be written.  This must
+   * hold the header and a long task declaration, which are written
+   * in one burst; at one B record per second, it also covers two
+   * minutes of stalled storage.
+   */
+  static constexpr size_t QUEUE_SIZE = 128;
+
+  AsyncTextWriter file;
 
   GRecord grecord;
 
@@ -59,11 +67,28 @@ public:
     return file.IsOpen();
   }
 
+  /**
+   * Wait until all lines have been passed to the operating system.
+   */
   bool Flush() {
     return file.Flush();
   }
 
-  void Sign();
+  /**
+   * The number of lines which could not be queued for writing.
+   * These are not included in the G record.
+   */
+  unsigned GetLostLines() const {
+    return file.GetLostLines();
+  }
+
+  /**
+   * Append the G record.
+   *
+   * @return false if a G line could not be queued; the file cannot
+   * be verified then
+   */
+  bool Sign();
 
 private:
   /**
@@ -112,16 +137,24 @@ public:
 
   void LoggerNote(const TCHAR *text);
 
-  void LogPoint(const IGCFix &fix, int epe, int satellites);
-  void LogPoint(const NMEAInfo &gps_info);
-  void LogEvent(const IGCFix &fix, int epe, int satellites, const char *event);
-  void LogEvent(const NMEAInfo &gps_info, const char *event);
+  /**
+   * @return false if the B record was dropped
+   */
+  bool LogPoint(const IGCFix &fix, int epe, int satellites);
+  bool LogPoint(const NMEAInfo &gps_info);
+
+  /**
+   * @return false if the E record or the following B record was
+   * dropped
+   */
+  bool LogEvent(const IGCFix &fix, int epe, int satellites, const char *event);
+  bool LogEvent(const NMEAInfo &gps_info, const char *event);
 
   void LogEmptyFRecord(const BrokenTime &time);
   void LogFRecord(const BrokenTime &time, const int *satellite_ids);
 
 protected:
-  void LogEvent(const BrokenTime &time, const char *event = "");
+  bool LogEvent(const BrokenTime &time, const char *event = "");
 };
 
 #endif
@@ -0,0 +1,150 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "AsyncTextWriter.hpp"
+#include "Time/PeriodClock.hpp"
+
+#include <string.h>
+
+/**
+ * How long the thread waits for more lines before writing them (in
+ * milliseconds).  Lines reach the operating system at most this late.
+ */
+static constexpr unsigned WRITE_INTERVAL = 250;
+
+/**
+ * How often the file is synced to the physical device (in
+ * milliseconds).
+ */
+static constexpr unsigned SYNC_INTERVAL = 10000;
+
+AsyncTextWriter::AsyncTextWriter(const TCHAR *path, bool append,
+                                 size_t capacity)
+  :writer(path, append), queue(capacity), lost_lines(0),
+   stop(false), error(false), flush_requested(0), flush_done(0)
+{
+  if (writer.IsOpen())
+    Start();
+}
+
+AsyncTextWriter::~AsyncTextWriter()
+{
+  if (!IsDefined())
+    return;
+
+  mutex.Lock();
+  stop = true;
+  cond.Broadcast();
+  mutex.Unlock();
+
+  Join();
+}
+
+bool
+AsyncTextWriter::WriteLine(const char *line)
+{
+  assert(IsOpen());
+  assert(strchr(line, '\r') == nullptr);
+  assert(strchr(line, '\n') == nullptr);
+
+  const size_t length = strlen(line);
+  if (length > MAX_LINE_LENGTH ||
+      !queue.Push([line, length](Line &dest){
+          memcpy(dest, line, length + 1);
+        })) {
+    lost_lines.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  return true;
+}
+
+bool
+AsyncTextWriter::Flush()
+{
+  assert(IsOpen());
+
+  ScopeLock protect(mutex);
+  const unsigned request = ++flush_requested;
+  cond.Broadcast();
+
+  while (int(flush_done - request) < 0)
+    cond.Wait(mutex);
+
+  return !error;
+}
+
+bool
+AsyncTextWriter::WriteQueue()
+{
+  bool success = true, written = false;
+  while (queue.Pop([this, &success](const Line &line){
+        success &= writer.WriteLine(line);
+      }))
+    written = true;
+
+  /* one flush for the whole batch; the stdio buffer combines the
+     lines into few write() calls */
+  if (written)
+    success &= writer.Flush();
+
+  return success;
+}
+
+void
+AsyncTextWriter::Run()
+{
+  PeriodClock sync_clock;
+  sync_clock.Update();
+
+  mutex.Lock();
+
+  while (true) {
+    const unsigned request = flush_requested;
+    const bool stopping = stop;
+
+    mutex.Unlock();
+
+    bool success = WriteQueue();
+    if (stopping || sync_clock.CheckUpdate(SYNC_INTERVAL))
+      success &= writer.Sync();
+
+    mutex.Lock();
+
+    if (!success)
+      error = true;
+
+    if (flush_done != request) {
+      flush_done = request;
+      cond.Broadcast();
+    }
+
+    if (stopping)
+      break;
+
+    if (!stop && flush_requested == request)
+      cond.Wait(mutex, WRITE_INTERVAL);
+  }
+
+  mutex.Unlock();
+}
@@ -0,0 +1,139 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_IO_ASYNC_TEXT_WRITER_HPP
+#define XCSOAR_IO_ASYNC_TEXT_WRITER_HPP
+
+#include "TextWriter.hpp"
+#include "Thread/Thread.hpp"
+#include "Thread/Mutex.hpp"
+#include "Thread/Cond.hpp"
+#include "Util/ConcurrentRingBuffer.hpp"
+
+#include <atomic>
+
+#include <tchar.h>
+
+/**
+ * A text file which is written by a background thread.  Callers
+ * queue lines with WriteLine(), which never blocks on file I/O; the
+ * thread writes all queued lines in one batch, flushes them to the
+ * operating system and periodically syncs the file to the physical
+ * device.
+ *
+ * If the queue is full (because the device is too slow), lines are
+ * dropped and counted; see GetLostLines().
+ */
+class AsyncTextWriter final : private Thread {
+public:
+  /**
+   * The maximum length of a line, excluding the line terminator.
+   * Longer lines are dropped.
+   */
+  static constexpr size_t MAX_LINE_LENGTH = 255;
+
+private:
+  typedef char Line[MAX_LINE_LENGTH + 1];
+
+  TextWriter writer;
+
+  ConcurrentRingBuffer<Line> queue;
+
+  std::atomic<unsigned> lost_lines;
+
+  Mutex mutex;
+  Cond cond;
+
+  /**
+   * Asks the thread to write the remaining lines and exit.
+   * Protected by #mutex.
+   */
+  bool stop;
+
+  /**
+   * Has a write failed?  Protected by #mutex.
+   */
+  bool error;
+
+  /**
+   * Flush() increments #flush_requested and waits until the thread
+   * has copied it to #flush_done after writing all queued lines.
+   * Both are protected by #mutex.
+   */
+  unsigned flush_requested, flush_done;
+
+public:
+  /**
+   * Create the file and start the thread.  The caller must check
+   * IsOpen().
+   *
+   * @param capacity the maximum number of lines waiting in the
+   * queue; must be a power of two
+   */
+  AsyncTextWriter(const TCHAR *path, bool append, size_t capacity);
+
+  /**
+   * Writes all queued lines and closes the file.
+   */
+  ~AsyncTextWriter();
+
+  bool IsOpen() const {
+    return IsDefined();
+  }
+
+  /**
+   * Queue a line.  This method is thread-safe and does not block.
+   *
+   * @return false if the line was dropped
+   */
+  bool WriteLine(const char *line);
+
+  /**
+   * Wait until all lines queued so far have been passed to the
+   * operating system.
+   *
+   * @return false if a write has failed
+   */
+  bool Flush();
+
+  /**
+   * The number of lines which were dropped because the queue was full
+   * or because they were too long.  This method is thread-safe.
+   */
+  unsigned GetLostLines() const {
+    return lost_lines.load(std::memory_order_relaxed);
+  }
+
+private:
+  /**
+   * Write and flush all queued lines.  Runs in the thread.
+   *
+   * @return false on error
+   */
+  bool WriteQueue();
+
+  /* virtual methods from class Thread */
+  void Run() override;
+};
+
+#endif
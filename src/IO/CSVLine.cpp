@@ -23,11 +23,144 @@ Copyright_License {
 
 #include "NMEA/InputLine.hpp"
 #include "Util/StringAPI.hpp"
+#include "Util/CharUtil.hpp"
 
 #include <algorithm>
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+/*
+ * The following functions parse the plain decimal (and hexadecimal)
+ * numbers found in NMEA sentences much faster than strtod() and
+ * strtol(), which have to deal with locales, exponents, "inf" and
+ * other shapes.  Anything they don't understand is passed on to the
+ * C library, so the results are the same.
+ */
+
+/**
+ * More digits may not fit into the 53 bit mantissa of a double.
+ */
+static constexpr unsigned MAX_DECIMAL_DIGITS = 15;
+
+/**
+ * More digits may overflow a 32 bit long.
+ */
+static constexpr unsigned MAX_INTEGER_DIGITS = 9;
+
+/**
+ * Powers of ten which are exact in a double; dividing by one of
+ * them is correctly rounded, just like strtod().
+ */
+static constexpr double powers_of_ten[MAX_DECIMAL_DIGITS + 1] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+  1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+};
+
+static constexpr bool
+IsHexDigitASCII(char ch)
+{
+  return IsDigitASCII(ch) || (ch >= 'a' && ch <= 'f') ||
+    (ch >= 'A' && ch <= 'F');
+}
+
+static constexpr unsigned
+HexDigitValue(char ch)
+{
+  return IsDigitASCII(ch)
+    ? unsigned(ch - '0')
+    : unsigned((ch | 0x20) - 'a' + 10);
+}
+
+static double
+FastParseDouble(const char *p, char **endptr)
+{
+  const char *q = p;
+  const bool negative = *q == '-';
+  if (negative || *q == '+')
+    ++q;
+
+  uint64_t mantissa = 0;
+  unsigned n_digits = 0, n_fraction = 0;
+  for (; IsDigitASCII(*q); ++q, ++n_digits)
+    mantissa = mantissa * 10 + unsigned(*q - '0');
+
+  if (*q == '.')
+    for (++q; IsDigitASCII(*q); ++q, ++n_fraction)
+      mantissa = mantissa * 10 + unsigned(*q - '0');
+
+  n_digits += n_fraction;
+  if (n_digits == 0 || n_digits > MAX_DECIMAL_DIGITS ||
+      IsAlphaNumericASCII(*q))
+    return strtod(p, endptr);
+
+  *endptr = const_cast<char *>(q);
+
+  double value = double(mantissa);
+  if (n_fraction > 0)
+    value /= powers_of_ten[n_fraction];
+  return negative ? -value : value;
+}
+
+static long
+FastParseLong(const char *p, char **endptr)
+{
+  const char *q = p;
+  const bool negative = *q == '-';
+  if (negative || *q == '+')
+    ++q;
+
+  unsigned long value = 0;
+  unsigned n_digits = 0;
+  for (; IsDigitASCII(*q); ++q, ++n_digits)
+    value = value * 10 + unsigned(*q - '0');
+
+  if (n_digits == 0 || n_digits > MAX_INTEGER_DIGITS ||
+      IsAlphaNumericASCII(*q))
+    return strtol(p, endptr, 10);
+
+  *endptr = const_cast<char *>(q);
+  return negative ? -long(value) : long(value);
+}
+
+static unsigned long
+FastParseUnsignedLong(const char *p, char **endptr)
+{
+  const char *q = p;
+  if (*q == '+')
+    ++q;
+
+  unsigned long value = 0;
+  unsigned n_digits = 0;
+  for (; IsDigitASCII(*q); ++q, ++n_digits)
+    value = value * 10 + unsigned(*q - '0');
+
+  if (n_digits == 0 || n_digits > MAX_INTEGER_DIGITS ||
+      IsAlphaNumericASCII(*q))
+    return strtoul(p, endptr, 10);
+
+  *endptr = const_cast<char *>(q);
+  return value;
+}
+
+static unsigned long
+FastParseHex(const char *p, char **endptr)
+{
+  const char *q = p;
+  unsigned long value = 0;
+  unsigned n_digits = 0;
+  for (; IsHexDigitASCII(*q); ++q, ++n_digits)
+    value = (value << 4) | HexDigitValue(*q);
+
+  /* this also catches the "0x" prefix */
+  if (n_digits == 0 || n_digits > 7 || IsAlphaNumericASCII(*q))
+    return strtoul(p, endptr, 16);
+
+  *endptr = const_cast<char *>(q);
+  return value;
+}
 
 static const char *
 EndOfLine(const char *line)
@@ -41,8 +174,8 @@ CSVLine::CSVLine(const char *line):
 size_t
 CSVLine::Skip()
 {
-  const char* _seperator = strchr(data, ',');
-  if (_seperator != nullptr && _seperator < end) {
+  const char *_seperator = (const char *)memchr(data, ',', end - data);
+  if (_seperator != nullptr) {
     size_t length = _seperator - data;
     data = _seperator + 1;
     return length;
@@ -97,7 +230,7 @@ unsigned
 CSVLine::ReadHex(unsigned default_value)
 {
   char *endptr;
-  unsigned long value = strtoul(data, &endptr, 16);
+  unsigned long value = FastParseHex(data, &endptr);
   assert(endptr >= data && endptr <= end);
   if (endptr == data)
     /* nothing was parsed */
@@ -127,7 +260,7 @@ bool
 CSVLine::ReadChecked(double &value_r)
 {
   char *endptr;
-  double value = strtod(data, &endptr);
+  double value = FastParseDouble(data, &endptr);
   assert(endptr >= data && endptr <= end);
 
   bool success = endptr > data;
@@ -185,7 +318,7 @@ bool
 CSVLine::ReadChecked(long &value_r)
 {
   char *endptr;
-  long value = strtol(data, &endptr, 10);
+  long value = FastParseLong(data, &endptr);
   assert(endptr >= data && endptr <= end);
 
   bool success = endptr > data;
@@ -208,7 +341,7 @@ bool
 CSVLine::ReadHexChecked(unsigned &value_r)
 {
   char *endptr;
-  unsigned long value = strtoul(data, &endptr, 16);
+  unsigned long value = FastParseHex(data, &endptr);
   assert(endptr >= data && endptr <= end);
 
   bool success = endptr > data;
@@ -231,7 +364,7 @@ bool
 CSVLine::ReadChecked(unsigned long &value_r)
 {
   char *endptr;
-  unsigned long value = strtoul(data, &endptr, 10);
+  unsigned long value = FastParseUnsignedLong(data, &endptr);
   assert(endptr >= data && endptr <= end);
 
   bool success = endptr > data;
@@ -36,6 +36,9 @@ class CSVLine {
 protected:
   const char *data, *end;
 
+  CSVLine(const char *_data, const char *_end)
+    :data(_data), end(_end) {}
+
 public:
   CSVLine(const char *line);
 
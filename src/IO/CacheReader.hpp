@@ -0,0 +1,127 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_IO_CACHE_READER_HPP
+#define XCSOAR_IO_CACHE_READER_HPP
+
+#include "Util/tstring.hpp"
+
+#include <stdint.h>
+#include <string.h>
+#include <tchar.h>
+
+/**
+ * Reads values written by #CacheWriter from a memory buffer,
+ * usually a #FileMapping.  Reading beyond the end of the buffer
+ * fails and latches the error flag.
+ */
+class CacheReader {
+  const uint8_t *p;
+  const uint8_t *const end;
+  bool error;
+
+public:
+  CacheReader(const void *_begin, const void *_end)
+    :p((const uint8_t *)_begin), end((const uint8_t *)_end), error(false) {}
+
+  bool HasError() const {
+    return error;
+  }
+
+  /**
+   * Returns a pointer to the next byte to be read.
+   */
+  const void *GetPosition() const {
+    return p;
+  }
+
+  /**
+   * Has all data been consumed?
+   */
+  bool IsEnd() const {
+    return p == end;
+  }
+
+  /**
+   * Obtain a pointer to the next #size bytes and skip them.  Returns
+   * nullptr if the buffer is too short.
+   */
+  const void *ReadRaw(size_t size) {
+    if (error || size > size_t(end - p)) {
+      error = true;
+      return nullptr;
+    }
+
+    const void *result = p;
+    p += size;
+    return result;
+  }
+
+  /**
+   * Like ReadRaw(), but for an array of #n elements of the given
+   * size.  The pointer may not be aligned.
+   */
+  const void *ReadArray(size_t n, size_t element_size) {
+    if (n > size_t(end - p) / element_size) {
+      error = true;
+      return nullptr;
+    }
+
+    return ReadRaw(n * element_size);
+  }
+
+  /**
+   * Skip the padding written by CacheWriter::Align().  This assumes
+   * that the buffer is aligned like the file, e.g. because it is a
+   * #FileMapping.
+   */
+  bool Align(size_t alignment) {
+    const size_t misalignment = (size_t)p % alignment;
+    return misalignment == 0 || ReadRaw(alignment - misalignment) != nullptr;
+  }
+
+  template<typename T>
+  bool Read(T &value) {
+    const void *src = ReadRaw(sizeof(value));
+    if (src == nullptr)
+      return false;
+
+    memcpy(&value, src, sizeof(value));
+    return true;
+  }
+
+  bool ReadString(tstring &dest) {
+    uint32_t length;
+    if (!Read(length))
+      return false;
+
+    const void *src = ReadArray(length, sizeof(TCHAR));
+    if (src == nullptr)
+      return false;
+
+    dest.assign((const TCHAR *)src, length);
+    return true;
+  }
+};
+
+#endif
@@ -0,0 +1,93 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_IO_CACHE_WRITER_HPP
+#define XCSOAR_IO_CACHE_WRITER_HPP
+
+#include "Util/tstring.hpp"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <tchar.h>
+
+/**
+ * Writes plain values to a #FileCache file, to be read back with
+ * #CacheReader.  The format is specific to the host; it is not meant
+ * to be portable.  The first error is latched, and all following
+ * writes are ignored; check HasError() at the end.
+ */
+class CacheWriter {
+  FILE *file;
+  bool error;
+
+public:
+  explicit CacheWriter(FILE *_file):file(_file), error(false) {}
+
+  bool HasError() const {
+    return error;
+  }
+
+  void Write(const void *data, size_t size) {
+    if (!error && size > 0 && fwrite(data, size, 1, file) != 1)
+      error = true;
+  }
+
+  /**
+   * Write zero bytes up to the next file position which is a
+   * multiple of the given alignment (at most 16), for data which
+   * shall be used in place from a #FileMapping.
+   */
+  void Align(size_t alignment) {
+    const long position = ftell(file);
+    if (position < 0) {
+      error = true;
+      return;
+    }
+
+    static constexpr uint8_t zero[16] = {};
+    const size_t misalignment = size_t(position) % alignment;
+    if (misalignment > 0)
+      Write(zero, alignment - misalignment);
+  }
+
+  /**
+   * Write the raw bytes of a value.  Must only be used for types
+   * without pointers.
+   */
+  template<typename T>
+  void Write(const T &value) {
+    Write(&value, sizeof(value));
+  }
+
+  void WriteString(const TCHAR *s, size_t length) {
+    const uint32_t length32 = length;
+    Write(length32);
+    Write(s, length * sizeof(*s));
+  }
+
+  void WriteString(const tstring &s) {
+    WriteString(s.data(), s.length());
+  }
+};
+
+#endif
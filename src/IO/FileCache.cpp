@@ -22,7 +22,10 @@ Copyright_License {
 */
 
 #include "FileCache.hpp"
+#include "CacheReader.hpp"
+#include "CacheWriter.hpp"
 #include "OS/FileUtil.hpp"
+#include "OS/FileMapping.hpp"
 #include "OS/PathName.hpp"
 #include "Compatibility/path.h"
 #include "Compiler.h"
@@ -42,6 +45,19 @@ Copyright_License {
 
 static constexpr unsigned FILE_CACHE_MAGIC = 0xab352f8a;
 
+/**
+ * The header written by FileCache::SaveMapped() after the #FileInfo.
+ * It is followed by the source path.
+ */
+struct MappedCacheHeader {
+  uint32_t version;
+
+  /**
+   * Catch builds with a different character type.
+   */
+  uint32_t tchar_size;
+};
+
 #ifndef HAVE_POSIX
 
 constexpr
@@ -129,7 +145,7 @@ FileCache::~FileCache() {
   free(cache_path);
 }
 
-inline size_t
+size_t
 FileCache::PathBufferSize(const TCHAR *name) const
 {
   return cache_path_length + _tcslen(name) + 2;
@@ -144,6 +160,25 @@ FileCache::MakeCachePath(TCHAR *buffer, const TCHAR *name) const
   return buffer;
 }
 
+bool
+FileCache::IsCacheable(const TCHAR *original_path)
+{
+  FileInfo info;
+  return GetRegularFileInfo(original_path, info);
+}
+
+bool
+FileCache::GetIdentity(const TCHAR *path, Identity &identity_r)
+{
+  FileInfo info;
+  if (!GetRegularFileInfo(path, info))
+    return false;
+
+  identity_r.mtime = info.mtime;
+  identity_r.size = info.size;
+  return true;
+}
+
 void
 FileCache::Flush(const TCHAR *name)
 {
@@ -238,3 +273,63 @@ FileCache::Cancel(const TCHAR *name, FILE *file)
   TCHAR path[PathBufferSize(name)];
   File::Delete(MakeCachePath(path, name));
 }
+
+FILE *
+FileCache::SaveMapped(const TCHAR *name, const TCHAR *original_path,
+                      uint32_t version)
+{
+  FILE *file = Save(name, original_path);
+  if (file == nullptr)
+    return nullptr;
+
+  MappedCacheHeader header;
+  header.version = version;
+  header.tchar_size = sizeof(TCHAR);
+
+  CacheWriter writer(file);
+  writer.Write(header);
+  writer.WriteString(original_path, _tcslen(original_path));
+
+  if (writer.HasError()) {
+    Cancel(name, file);
+    return nullptr;
+  }
+
+  return file;
+}
+
+std::unique_ptr<FileMapping>
+FileCache::LoadMapped(const TCHAR *name, const TCHAR *original_path,
+                      uint32_t version, size_t &payload_offset_r)
+{
+  FILE *file = Load(name, original_path);
+  if (file == nullptr)
+    return nullptr;
+
+  const long offset = ftell(file);
+  fclose(file);
+  if (offset < 0)
+    return nullptr;
+
+  TCHAR path[PathBufferSize(name)];
+  MakeCachePath(path, name);
+
+  std::unique_ptr<FileMapping> mapping(new FileMapping(path));
+  if (mapping->error() || mapping->size() < size_t(offset))
+    return nullptr;
+
+  CacheReader reader(mapping->at(offset), mapping->end());
+
+  MappedCacheHeader header;
+  tstring cached_path;
+  if (!reader.Read(header) ||
+      header.version != version ||
+      header.tchar_size != sizeof(TCHAR) ||
+      !reader.ReadString(cached_path) ||
+      cached_path != original_path)
+    return nullptr;
+
+  payload_offset_r = (const uint8_t *)reader.GetPosition() -
+    (const uint8_t *)mapping->data();
+  return mapping;
+}
@@ -24,28 +24,101 @@ Copyright_License {
 #ifndef XCSOAR_FILE_CACHE_HPP
 #define XCSOAR_FILE_CACHE_HPP
 
+#include "Compiler.h"
+
+#include <memory>
+
+#include <stdint.h>
 #include <stdio.h>
 #include <tchar.h>
 
+class FileMapping;
+
 class FileCache {
   TCHAR *cache_path;
   size_t cache_path_length;
 
 public:
+  /**
+   * Identifies the version of a source file by its modification time
+   * and size, just like Load() does.
+   */
+  struct Identity {
+    uint64_t mtime;
+    uint64_t size;
+
+    bool operator==(const Identity &other) const {
+      return mtime == other.mtime && size == other.size;
+    }
+
+    bool operator!=(const Identity &other) const {
+      return !(*this == other);
+    }
+  };
+
   FileCache(const TCHAR *_cache_path);
   ~FileCache();
 
-protected:
+  /**
+   * Returns the buffer size (in characters) required by
+   * MakeCachePath().
+   */
   size_t PathBufferSize(const TCHAR *name) const;
+
+  /**
+   * Build the path of the specified cache file.  This can be used to
+   * access a file validated by Load() by other means, e.g. with
+   * #FileMapping.
+   */
   const TCHAR *MakeCachePath(TCHAR *buffer, const TCHAR *name) const;
 
-public:
+  /**
+   * Can a cache be saved for this file?  This requires that it is a
+   * regular file or a member of one (e.g. inside the map file),
+   * because the cache is keyed on its size and modification time.
+   * Callers can skip the cache for other paths instead of letting
+   * Save() fail.
+   */
+  gcc_pure
+  static bool IsCacheable(const TCHAR *original_path);
+
+  /**
+   * Determine the #Identity of a file.  A cache which depends on
+   * additional files (besides its #original_path) can store their
+   * identities, and discard itself when one of them is replaced.
+   *
+   * @return false if the file is not cacheable, see IsCacheable()
+   */
+  static bool GetIdentity(const TCHAR *path, Identity &identity_r);
+
   void Flush(const TCHAR *name);
   FILE *Load(const TCHAR *name, const TCHAR *original_path);
 
   FILE *Save(const TCHAR *name, const TCHAR *original_path);
   bool Commit(const TCHAR *name, FILE *file);
   void Cancel(const TCHAR *name, FILE *file);
+
+  /**
+   * Like Save(), but writes a header for LoadMapped(): the format
+   * version, the character type size and #original_path.  The caller
+   * appends its payload and finishes with Commit() or Cancel().
+   */
+  FILE *SaveMapped(const TCHAR *name, const TCHAR *original_path,
+                   uint32_t version);
+
+  /**
+   * Validate a file written by SaveMapped() with Load(), check its
+   * header and map it into memory.
+   *
+   * @param payload_offset_r on success, the position of the payload
+   * within the mapping
+   * @return the mapping or nullptr if the cache is missing, stale or
+   * was written for a different version or source path
+   */
+  std::unique_ptr<FileMapping> LoadMapped(const TCHAR *name,
+                                          const TCHAR *original_path,
+                                          uint32_t version,
+                                          size_t &payload_offset_r);
 };
 
 #endif
@@ -28,6 +28,10 @@ Copyright_License {
 #include <stddef.h>
 #include <stdio.h>
 
+#ifdef HAVE_POSIX
+#include <unistd.h>
+#endif
+
 #ifdef _UNICODE
 #include <tchar.h>
 #endif
@@ -87,6 +91,21 @@ public:
     return fflush(file) == 0;
   }
 
+  /**
+   * Like Flush(), but also ask the operating system to write its
+   * cache to the physical device.  This is expensive.
+   */
+  bool Sync() {
+    if (!Flush())
+      return false;
+
+#ifdef HAVE_POSIX
+    return fsync(fileno(file)) == 0;
+#else
+    return true;
+#endif
+  }
+
   bool Seek(long offset, int whence) {
     assert(file != nullptr);
     return fseek(file, offset, whence) == 0;
@@ -101,6 +101,15 @@ public:
     return file.Flush();
   }
 
+  /**
+   * Flush and write the operating system's cache to the physical
+   * device.
+   */
+  bool Sync() {
+    assert(file.IsOpen());
+    return file.Sync();
+  }
+
   /**
    * Write one character.
    */
@@ -0,0 +1,251 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Parallel.hpp"
+#include "Job.hpp"
+#include "Thread/Thread.hpp"
+#include "OS/Sleep.h"
+
+#include <algorithm>
+
+#include <assert.h>
+
+class ParallelJobRunner::Worker final : public Thread {
+  ParallelJobRunner &runner;
+
+public:
+  explicit Worker(ParallelJobRunner &_runner)
+    :Thread("Job"), runner(_runner) {}
+
+protected:
+  /* virtual methods from class Thread */
+  void Run() override {
+    runner.RunJobs();
+  }
+};
+
+unsigned
+ParallelJobRunner::Entry::GetProgress() const
+{
+  if (state == State::DONE)
+    return PROGRESS_SCALE;
+
+  if (progress_range == 0)
+    return 0;
+
+  return std::min(progress_position, progress_range) * PROGRESS_SCALE
+    / progress_range;
+}
+
+bool
+ParallelJobRunner::Entry::IsCancelled() const
+{
+  return false;
+}
+
+void
+ParallelJobRunner::Entry::Sleep(unsigned ms)
+{
+  ::Sleep(ms);
+}
+
+void
+ParallelJobRunner::Entry::SetErrorMessage(const TCHAR *_error)
+{
+  const ScopeLock protect(runner.mutex);
+  error = _error;
+  error_modified = true;
+}
+
+void
+ParallelJobRunner::Entry::SetText(const TCHAR *_text)
+{
+  const ScopeLock protect(runner.mutex);
+  text = _text;
+  text_modified = true;
+  text_serial = ++runner.text_serial;
+}
+
+void
+ParallelJobRunner::Entry::SetProgressRange(unsigned range)
+{
+  const ScopeLock protect(runner.mutex);
+  progress_range = range;
+  progress_position = 0;
+}
+
+void
+ParallelJobRunner::Entry::SetProgressPosition(unsigned position)
+{
+  const ScopeLock protect(runner.mutex);
+  progress_position = position;
+}
+
+unsigned
+ParallelJobRunner::Add(Job &job, std::initializer_list<unsigned> dependencies)
+{
+#ifndef NDEBUG
+  /* only jobs which were added before are allowed, which rules out
+     cycles */
+  for (unsigned i : dependencies)
+    assert(i < index.size());
+#endif
+
+  entries.emplace_front(*this, job, dependencies);
+  index.push_back(&entries.front());
+  return index.size() - 1;
+}
+
+ParallelJobRunner::Entry *
+ParallelJobRunner::FindReady() const
+{
+  for (Entry *entry : index) {
+    if (entry->state != State::WAITING)
+      continue;
+
+    if (std::all_of(entry->dependencies.begin(), entry->dependencies.end(),
+                    [this](unsigned i){
+                      return index[i]->state == State::DONE;
+                    }))
+      return entry;
+  }
+
+  return nullptr;
+}
+
+bool
+ParallelJobRunner::IsDone() const
+{
+  return std::all_of(index.begin(), index.end(), [](const Entry *entry){
+      return entry->state == State::DONE;
+    });
+}
+
+bool
+ParallelJobRunner::IsAllStarted() const
+{
+  return std::none_of(index.begin(), index.end(), [](const Entry *entry){
+      return entry->state == State::WAITING;
+    });
+}
+
+void
+ParallelJobRunner::RunJobs()
+{
+  const ScopeLock protect(mutex);
+
+  while (!IsAllStarted()) {
+    Entry *entry = FindReady();
+    if (entry == nullptr) {
+      /* wait for a running job to finish */
+      cond.Wait(mutex);
+      continue;
+    }
+
+    entry->state = State::RUNNING;
+
+    mutex.Unlock();
+    entry->job.Run(*entry);
+    mutex.Lock();
+
+    entry->state = State::DONE;
+    cond.Broadcast();
+  }
+}
+
+void
+ParallelJobRunner::Report(OperationEnvironment &env)
+{
+  StaticString<128u> text;
+  text.clear();
+  bool text_modified = false;
+
+  std::vector<StaticString<256u>> errors;
+
+  unsigned progress = 0;
+
+  {
+    const ScopeLock protect(mutex);
+
+    const Entry *latest = nullptr;
+    for (Entry *entry : index) {
+      progress += entry->GetProgress();
+
+      if (entry->text_modified &&
+          (latest == nullptr || entry->text_serial > latest->text_serial))
+        latest = entry;
+
+      entry->text_modified = false;
+
+      if (entry->error_modified) {
+        errors.push_back(entry->error);
+        entry->error_modified = false;
+      }
+    }
+
+    if (latest != nullptr) {
+      text = latest->text;
+      text_modified = true;
+    }
+  }
+
+  for (const auto &error : errors)
+    env.SetErrorMessage(error);
+
+  if (text_modified) {
+    env.SetText(text);
+    env.SetProgressRange(index.size() * PROGRESS_SCALE);
+  }
+
+  env.SetProgressPosition(progress);
+}
+
+void
+ParallelJobRunner::Run(OperationEnvironment &env, unsigned n_threads)
+{
+  assert(n_threads > 0);
+
+  env.SetProgressRange(index.size() * PROGRESS_SCALE);
+
+  std::forward_list<Worker> workers;
+  n_threads = std::min<unsigned>(n_threads, index.size());
+  for (unsigned i = 0; i < n_threads; ++i) {
+    workers.emplace_front(*this);
+    workers.front().Start();
+  }
+
+  while (true) {
+    Report(env);
+
+    const ScopeLock protect(mutex);
+    if (IsDone())
+      break;
+
+    cond.Wait(mutex, 200);
+  }
+
+  Report(env);
+
+  for (auto &worker : workers)
+    worker.Join();
+}
@@ -0,0 +1,193 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_PARALLEL_JOB_RUNNER_HPP
+#define XCSOAR_PARALLEL_JOB_RUNNER_HPP
+
+#include "Operation/Operation.hpp"
+#include "Thread/Mutex.hpp"
+#include "Thread/Cond.hpp"
+#include "Util/StaticString.hxx"
+
+#include <forward_list>
+#include <vector>
+#include <initializer_list>
+
+#include <stdint.h>
+
+class Job;
+
+/**
+ * Runs a set of #Job instances on a small pool of threads.  A #Job
+ * may depend on others which were added before; it is started only
+ * after all of them have finished.
+ *
+ * The calling thread waits in Run() until all jobs have finished,
+ * and meanwhile reports their combined progress to its
+ * #OperationEnvironment.  Therefore, that object does not need to be
+ * thread-safe.
+ */
+class ParallelJobRunner {
+  class Worker;
+
+  enum class State : uint8_t {
+    WAITING,
+    RUNNING,
+    DONE,
+  };
+
+  /**
+   * One #Job and the #OperationEnvironment passed to it.  It
+   * remembers the progress until the calling thread collects it.
+   */
+  class Entry final : public OperationEnvironment {
+    ParallelJobRunner &runner;
+
+  public:
+    Job &job;
+
+    std::vector<unsigned> dependencies;
+
+    State state;
+
+    /**
+     * Were #text or #error modified since the calling thread has
+     * last shown them?
+     */
+    bool text_modified, error_modified;
+
+    StaticString<128u> text;
+    StaticString<256u> error;
+
+    unsigned progress_range, progress_position;
+
+    /**
+     * The value of ParallelJobRunner::text_serial at the last
+     * SetText() call, used to show the most recent text of all jobs.
+     */
+    unsigned text_serial;
+
+    Entry(ParallelJobRunner &_runner, Job &_job,
+          std::initializer_list<unsigned> _dependencies)
+      :runner(_runner), job(_job), dependencies(_dependencies),
+       state(State::WAITING),
+       text_modified(false), error_modified(false),
+       text(_T("")), error(_T("")),
+       progress_range(0), progress_position(0), text_serial(0) {}
+
+    /**
+     * Returns the progress of this job, 0 to #PROGRESS_SCALE.
+     */
+    gcc_pure
+    unsigned GetProgress() const;
+
+    /* virtual methods from class OperationEnvironment */
+    bool IsCancelled() const override;
+    void Sleep(unsigned ms) override;
+    void SetErrorMessage(const TCHAR *text) override;
+    void SetText(const TCHAR *text) override;
+    void SetProgressRange(unsigned range) override;
+    void SetProgressPosition(unsigned position) override;
+  };
+
+  /**
+   * The progress bar range of each job.
+   */
+  static constexpr unsigned PROGRESS_SCALE = 100;
+
+  /**
+   * Protects #text_serial and the state and progress of all entries.
+   */
+  mutable Mutex mutex;
+
+  /**
+   * Signalled when a job finishes.
+   */
+  Cond cond;
+
+  std::forward_list<Entry> entries;
+
+  /**
+   * Points to the entries in the order they were added.
+   */
+  std::vector<Entry *> index;
+
+  unsigned text_serial;
+
+public:
+  ParallelJobRunner():text_serial(0) {}
+
+  ParallelJobRunner(const ParallelJobRunner &) = delete;
+
+  /**
+   * Add a #Job.  The object must stay alive until Run() returns.
+   *
+   * @param dependencies the handles (as returned by this method) of
+   * the jobs which must finish before this one is started
+   * @return a handle for the new job
+   */
+  unsigned Add(Job &job, std::initializer_list<unsigned> dependencies={});
+
+  /**
+   * Run all jobs and wait for them.
+   *
+   * @param n_threads the number of threads to run the jobs in
+   */
+  void Run(OperationEnvironment &env, unsigned n_threads);
+
+private:
+  /**
+   * Find a job which may be started now.  Caller must lock the
+   * mutex.
+   *
+   * @return the job or nullptr if there is none right now
+   */
+  gcc_pure
+  Entry *FindReady() const;
+
+  /**
+   * Are all jobs finished?  Caller must lock the mutex.
+   */
+  gcc_pure
+  bool IsDone() const;
+
+  /**
+   * Are all jobs started or finished?  Caller must lock the mutex.
+   */
+  gcc_pure
+  bool IsAllStarted() const;
+
+  /**
+   * Take jobs which are ready and run them, until all jobs have been
+   * started.  This is the loop of each worker thread.
+   */
+  void RunJobs();
+
+  /**
+   * Pass the combined progress, the most recent text and all new
+   * error messages to the caller's #OperationEnvironment.
+   */
+  void Report(OperationEnvironment &env);
+};
+
+#endif
@@ -27,6 +27,8 @@
 #include "IO/TextWriter.hpp"
 #include "Util/Macros.hpp"
 
+#include <algorithm>
+
 #include <tchar.h>
 #include <string.h>
 
@@ -145,22 +147,32 @@ GRecord::LoadFileToBuffer(const TCHAR *filename)
 }
 
 void
-GRecord::WriteTo(TextWriter &writer) const
+GRecord::GetLines(Line lines[N_LINES]) const
 {
   char digest[DIGEST_LENGTH + 1];
   GetDigest(digest);
 
-  static constexpr size_t chars_per_line = 16;
-  static_assert(DIGEST_LENGTH % chars_per_line == 0, "wrong digest length");
+  static_assert(DIGEST_LENGTH % CHARS_PER_LINE == 0, "wrong digest length");
 
-  for (const char *i = digest, *end = digest + DIGEST_LENGTH;
-       i != end; i += chars_per_line) {
-    writer.Write('G');
-    writer.Write(i, chars_per_line);
-    writer.NewLine();
+  const char *src = digest;
+  for (unsigned i = 0; i < N_LINES; ++i, src += CHARS_PER_LINE) {
+    Line &line = lines[i];
+    line[0] = 'G';
+    std::copy_n(src, CHARS_PER_LINE, line + 1);
+    line[1 + CHARS_PER_LINE] = '\0';
   }
 }
 
+void
+GRecord::WriteTo(TextWriter &writer) const
+{
+  Line lines[N_LINES];
+  GetLines(lines);
+
+  for (const Line &line : lines)
+    writer.WriteLine(line);
+}
+
 bool
 GRecord::AppendGRecordToFile(const TCHAR *filename)
 {
@@ -36,6 +36,19 @@ class GRecord
 public:
   static constexpr size_t DIGEST_LENGTH = 4 * MD5::DIGEST_LENGTH;
 
+  /**
+   * The number of digest characters in one G line.
+   */
+  static constexpr size_t CHARS_PER_LINE = 16;
+
+  static constexpr unsigned N_LINES = DIGEST_LENGTH / CHARS_PER_LINE;
+
+  /**
+   * One G line without the line terminator: the letter 'G', a part
+   * of the digest and the null terminator.
+   */
+  typedef char Line[1 + CHARS_PER_LINE + 1];
+
 private:
   MD5 md5[4];
 
@@ -73,6 +86,11 @@ public:
    */
   void GetDigest(char *buffer) const;
 
+  /**
+   * Split the digest into the G lines to be written to the IGC file.
+   */
+  void GetLines(Line lines[N_LINES]) const;
+
   /** loads a file into the data buffer */
   bool LoadFileToBuffer(const TCHAR *path);
 
@@ -77,7 +77,7 @@ LoggerImpl::PreTakeoffBuffer::operator=(const NMEAInfo &src)
 }
 
 LoggerImpl::LoggerImpl()
-  :writer(nullptr)
+  :writer(nullptr), records_lost(false)
 {
   filename[0] = 0;
 }
@@ -96,11 +96,15 @@ LoggerImpl::StopLogger(const NMEAInfo &gps_info)
 
   writer->Flush();
 
-  if (!simulator)
-    writer->Sign();
+  if (!simulator && !writer->Sign())
+    LogFormat(_T("Logger: failed to sign %s"), filename);
 
   LogFormat(_T("Logger stopped: %s"), filename);
 
+  const unsigned lost_lines = writer->GetLostLines();
+  if (lost_lines > 0)
+    LogFormat("Logger: %u lines lost", lost_lines);
+
   // Logger off
   delete writer;
   writer = nullptr;
@@ -129,8 +133,8 @@ LoggerImpl::LogEvent(const NMEAInfo &gps_info, const char *event)
   if (gps_info.location_available && !gps_info.gps.real)
     simulator = true;
 
-  if (writer != nullptr)
-    writer->LogEvent(gps_info, event);
+  if (writer != nullptr && !writer->LogEvent(gps_info, event))
+    OnRecordLost();
 }
 
 void
@@ -218,7 +222,19 @@ LoggerImpl::WritePoint(const NMEAInfo &gps_info)
       writer->LogEmptyFRecord(gps_info.date_time_utc);
   }
 
-  writer->LogPoint(gps_info);
+  if (!writer->LogPoint(gps_info))
+    OnRecordLost();
+}
+
+void
+LoggerImpl::OnRecordLost()
+{
+  /* report only the first loss; StopLogger() logs the total */
+  if (records_lost)
+    return;
+
+  records_lost = true;
+  LogFormat(_T("Logger: storage too slow, records lost in %s"), filename);
 }
 
 bool
@@ -251,6 +267,7 @@ LoggerImpl::StartLogger(const NMEAInfo &gps_info,
   }
 
   frecord.Reset();
+  records_lost = false;
   writer = new IGCWriter(filename);
   if (!writer->IsOpen()) {
     LogFormat(_T("Failed to create file %s"), filename);
@@ -105,6 +105,12 @@ private:
    */
   bool simulator;
 
+  /**
+   * Has a B or E record been dropped in the current file, because
+   * the storage was too slow?
+   */
+  bool records_lost;
+
 public:
   /** Default constructor */
   LoggerImpl();
@@ -140,6 +146,11 @@ private:
 private:
   void LogPointToBuffer(const NMEAInfo &gps_info);
   void WritePoint(const NMEAInfo &gps_info);
+
+  /**
+   * A B or E record has been dropped by the #IGCWriter.
+   */
+  void OnRecordLost();
 };
 
 #endif
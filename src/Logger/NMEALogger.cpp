@@ -22,31 +22,62 @@ Copyright_License {
 */
 
 #include "Logger/NMEALogger.hpp"
-#include "IO/TextWriter.hpp"
+#include "IO/AsyncTextWriter.hpp"
 #include "LocalPath.hpp"
+#include "LogFile.hpp"
 #include "Time/BrokenDateTime.hpp"
 #include "Thread/Mutex.hpp"
 #include "OS/FileUtil.hpp"
 #include "Util/StaticString.hxx"
 
+#include <atomic>
+
 #include <windef.h> // for MAX_PATH
 #include <stdio.h>
 
 namespace NMEALogger
 {
+  /**
+   * The number of lines which may wait for the writer thread.  With
+   * the usual sentence rates, this covers several seconds of a stalled
+   * SD card.
+   */
+  static constexpr size_t QUEUE_SIZE = 512;
+
+  /**
+   * Protects the creation of #writer.
+   */
   static Mutex mutex;
-  static TextWriter *writer;
+
+  /**
+   * The log file; created by the first Log() call.  It is atomic
+   * because Log() reads it without locking.
+   */
+  static std::atomic<AsyncTextWriter *> writer;
+
+  /**
+   * Set when the log file could not be created; Log() does not try
+   * again until Shutdown() is called.
+   */
+  static std::atomic<bool> failed;
 
   bool enabled = false;
 
-  static bool Start();
+  static AsyncTextWriter *Start();
 }
 
-bool
+AsyncTextWriter *
 NMEALogger::Start()
 {
-  if (writer != nullptr)
-    return true;
+  ScopeLock protect(mutex);
+
+  AsyncTextWriter *w = writer.load(std::memory_order_relaxed);
+  if (w != nullptr)
+    return w;
+
+  if (failed.load(std::memory_order_relaxed))
+    /* another thread has just tried */
+    return nullptr;
 
   BrokenDateTime dt = BrokenDateTime::NowUTC();
   assert(dt.IsPlausible());
@@ -62,23 +93,53 @@ NMEALogger::Start()
 
   LocalPath(path, _T("logs"), name);
 
-  writer = new TextWriter(path, false);
-  return writer != nullptr;
+  w = new AsyncTextWriter(path, false, QUEUE_SIZE);
+  if (!w->IsOpen()) {
+    delete w;
+    LogFormat(_T("NMEA logger: failed to create %s"), path);
+    failed.store(true, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  writer.store(w, std::memory_order_release);
+  return w;
 }
 
 void
 NMEALogger::Shutdown()
 {
-  delete writer;
+  failed.store(false, std::memory_order_relaxed);
+
+  AsyncTextWriter *w = writer.exchange(nullptr);
+  if (w == nullptr)
+    return;
+
+  const unsigned lost = w->GetLostLines();
+  if (lost > 0)
+    LogFormat("NMEA logger: %u lines lost", lost);
+
+  delete w;
+}
+
+unsigned
+NMEALogger::GetLostLines()
+{
+  const AsyncTextWriter *w = writer.load(std::memory_order_acquire);
+  return w != nullptr ? w->GetLostLines() : 0;
 }
 
 void
 NMEALogger::Log(const char *text)
 {
-  if (!enabled)
+  if (!enabled || failed.load(std::memory_order_relaxed))
     return;
 
-  ScopeLock protect(mutex);
-  if (Start())
-    writer->WriteLine(text);
+  AsyncTextWriter *w = writer.load(std::memory_order_acquire);
+  if (w == nullptr) {
+    w = Start();
+    if (w == nullptr)
+      return;
+  }
+
+  w->WriteLine(text);
 }
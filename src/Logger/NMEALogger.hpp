@@ -31,10 +31,17 @@ namespace NMEALogger
   void Shutdown();
 
   /**
-   * Logs NMEA string to log file
+   * Logs NMEA string to log file.  The line is written by a
+   * background thread; this function does not block on file I/O.
    * @param text
    */
   void Log(const char *line);
+
+  /**
+   * Returns the number of lines which could not be logged because
+   * the log file could not keep up.
+   */
+  unsigned GetLostLines();
 }
 
 #endif
@@ -30,10 +30,12 @@ Copyright_License {
 #include "Time/PeriodClock.hpp"
 #include "Event/Idle.hpp"
 #include "Topography/Thread.hpp"
+#include "Terrain/Thread.hpp"
 
 GlueMapWindow::GlueMapWindow(const Look &look)
   :MapWindow(look.map, look.traffic),
    topography_thread(nullptr),
+   terrain_thread(nullptr),
 #ifdef ENABLE_OPENGL
    data_timer(*this),
 #endif
@@ -53,6 +55,9 @@ GlueMapWindow::GlueMapWindow(const Look &look)
    gesture_look(look.gesture),
    map_item_timer(*this)
 {
+  background.EnableAsync([this](){
+                           SendUser(unsigned(Command::INVALIDATE));
+                         });
 }
 
 GlueMapWindow::~GlueMapWindow()
@@ -79,6 +84,30 @@ GlueMapWindow::SetTopography(TopographyStore *_topography)
                            });
 }
 
+void
+GlueMapWindow::SetTerrain(RasterTerrain *_terrain)
+{
+  if (terrain_thread != nullptr) {
+    terrain_thread->LockStop();
+    delete terrain_thread;
+    terrain_thread = nullptr;
+  }
+
+  MapWindow::SetTerrain(_terrain);
+
+  if (_terrain != nullptr) {
+    terrain_thread =
+      new TerrainThread(*_terrain,
+                        [this](){
+                          SendUser(unsigned(Command::INVALIDATE));
+                        });
+
+    if (visible_projection.IsValid())
+      terrain_thread->Trigger(visible_projection.GetGeoScreenCenter(),
+                              visible_projection.GetScreenWidthMeters() / 2);
+  }
+}
+
 void
 GlueMapWindow::Create(ContainerWindow &parent, const PixelRect &rc)
 {
@@ -237,7 +266,7 @@ GlueMapWindow::Idle()
   bool still_dirty;
 
   do {
-    still_dirty = UpdateWeather() || UpdateTerrain();
+    still_dirty = UpdateWeather();
   } while (!clock.Check(700) && /* stop after 700ms */
 #ifndef ENABLE_OPENGL
            !draw_thread->IsTriggered() &&
@@ -24,6 +24,7 @@ Copyright_License {
 #include "GlueMapWindow.hpp"
 #include "Terrain/RasterTerrain.hpp"
 #include "Topography/Thread.hpp"
+#include "Terrain/Thread.hpp"
 #include "Interface.hpp"
 #include "Profile/Profile.hpp"
 #include "Screen/Layout.hpp"
@@ -115,6 +116,12 @@ GlueMapWindow::UpdateScreenBounds()
   if (topography_thread != nullptr &&
       CommonInterface::GetMapSettings().topography_enabled)
     topography_thread->Trigger(visible_projection);
+
+  // always service terrain even if it's not used by the map,
+  // because it's used by other calculations
+  if (terrain_thread != nullptr)
+    terrain_thread->Trigger(visible_projection.GetGeoScreenCenter(),
+                            visible_projection.GetScreenWidthMeters() / 2);
 }
 
 void
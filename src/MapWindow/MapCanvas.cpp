@@ -92,8 +92,8 @@ MapCanvas::PreparePolygon(const SearchPointVector &points)
 
   /* project all GeoPoints to screen coordinates */
   raster_points.GrowDiscard(num_raster_points);
-  for (unsigned i = 0; i < num_raster_points; ++i)
-    raster_points[i] = projection.GeoToScreen(geo_points[i]);
+  projection.GeoToScreen(geo_points.begin(), raster_points.begin(),
+                         num_raster_points);
 
   return true;
 }
@@ -43,7 +43,6 @@ MapWindow::MapWindow(const MapLook &_look,
    waypoints(nullptr),
    topography(nullptr), topography_renderer(nullptr),
    terrain(nullptr),
-   terrain_radius(fixed(0)),
    weather(nullptr),
    traffic_look(_traffic_look),
    waypoint_renderer(nullptr, look.waypoint),
@@ -135,32 +134,6 @@ MapWindow::UpdateTopography(unsigned max_update)
     return 0;
 }
 
-bool
-MapWindow::UpdateTerrain()
-{
-  if (terrain == nullptr)
-    return false;
-
-  GeoPoint location = visible_projection.GetGeoScreenCenter();
-  fixed radius = visible_projection.GetScreenWidthMeters() / 2;
-  if (terrain_radius >= radius && terrain_center.IsValid() &&
-      terrain_center.DistanceS(location) < fixed(1000))
-    return false;
-
-  // always service terrain even if it's not used by the map,
-  // because it's used by other calculations
-  RasterTerrain::ExclusiveLease lease(*terrain);
-  lease->SetViewCenter(location, radius);
-  if (lease->IsDirty())
-    terrain_radius = fixed(0);
-  else {
-    terrain_radius = radius;
-    terrain_center = location;
-  }
-
-  return lease->IsDirty();
-}
-
 bool
 MapWindow::UpdateWeather()
 {
@@ -219,7 +192,6 @@ void
 MapWindow::SetTerrain(RasterTerrain *_terrain)
 {
   terrain = _terrain;
-  terrain_center = GeoPoint::Invalid();
   background.SetTerrain(_terrain);
 }
 
@@ -119,8 +119,6 @@ protected:
   CachedTopographyRenderer *topography_renderer;
 
   RasterTerrain *terrain;
-  GeoPoint terrain_center;
-  fixed terrain_radius;
 
   RasterWeatherCache *weather;
 
@@ -301,11 +299,6 @@ protected:
 
   unsigned UpdateTopography(unsigned max_update=1024);
 
-  /**
-   * @return true if UpdateTerrain() should be called again
-   */
-  bool UpdateTerrain();
-
   /**
    * @return true if UpdateWeather() should be called again
    */
@@ -313,7 +306,6 @@ protected:
 
   void UpdateAll() {
     UpdateTopography();
-    UpdateTerrain();
     UpdateWeather();
   }
 
@@ -77,8 +77,7 @@ StencilMapCanvas::DrawSearchPointVector(const SearchPointVector &points)
 
   /* draw it all */
   RasterPoint screen[size];
-  for (unsigned i = 0; i < size; ++i)
-    screen[i] = proj.GeoToScreen(geo_points[i]);
+  proj.GeoToScreen(geo_points.begin(), screen, size);
 
   buffer.DrawPolygon(&screen[0], size);
   if (use_stencil)
@@ -101,6 +101,20 @@ public:
     return *this;
   }
 
+  /**
+   * Returns the cosine of the angle, multiplied by 1024.
+   */
+  int GetCosine() const {
+    return cost;
+  }
+
+  /**
+   * Returns the sine of the angle, multiplied by 1024.
+   */
+  int GetSine() const {
+    return sint;
+  }
+
   /**
    * Rotates the point (xin, yin).
    *
@@ -22,13 +22,21 @@ Copyright_License {
 */
 
 #include "NMEA/InputLine.hpp"
+#include "Compiler.h"
 
 #include <string.h>
 
-NMEAInputLine::NMEAInputLine(const char* line):
-  CSVLine(line)
+gcc_pure
+static const char *
+EndOfSentence(const char *line)
 {
-  const char* asterisk = strchr(line, '*');
-  if (asterisk != NULL)
-    end = asterisk;
+  /* the checksum is not part of the data; searching for the
+     asterisk first saves a strlen() call in the common case */
+  const char *asterisk = strchr(line, '*');
+  return asterisk != nullptr
+    ? asterisk
+    : line + strlen(line);
 }
+
+NMEAInputLine::NMEAInputLine(const char* line):
+  CSVLine(line, EndOfSentence(line)) {}
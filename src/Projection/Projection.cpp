@@ -24,9 +24,14 @@ Copyright_License {
 #include "Projection.hpp"
 #include "Geo/FAISphere.hpp"
 #include "Math/Angle.hpp"
+#include "Math/FastTrig.hpp"
 
 #include <algorithm>
 
+#if defined(__SSE2__) && !defined(FIXED_MATH)
+#include <emmintrin.h>
+#endif
+
 Projection::Projection()
   :geo_location(GeoPoint::Invalid()),
    screen_rotation(Angle::Zero())
@@ -77,6 +82,140 @@ Projection::GeoToScreen(const GeoPoint &g) const
   return sc;
 }
 
+#if defined(__SSE2__) && !defined(FIXED_MATH)
+
+/**
+ * Round to the nearest integer, halfway cases away from zero, like
+ * lround().
+ */
+static inline __m128i
+RoundToInt(__m128d x)
+{
+  const __m128d one = _mm_set1_pd(1);
+  const __m128d half = _mm_set1_pd(0.5), minus_half = _mm_set1_pd(-0.5);
+
+  /* x - trunc(x) is exact */
+  const __m128d t = _mm_cvtepi32_pd(_mm_cvttpd_epi32(x));
+  const __m128d fraction = _mm_sub_pd(x, t);
+  const __m128d up = _mm_and_pd(_mm_cmpge_pd(fraction, half), one);
+  const __m128d down = _mm_and_pd(_mm_cmple_pd(fraction, minus_half), one);
+  return _mm_cvttpd_epi32(_mm_add_pd(t, _mm_sub_pd(up, down)));
+}
+
+#endif
+
+void
+Projection::GeoToScreen(const GeoPoint *src, RasterPoint *dest,
+                        unsigned n) const
+{
+  assert(IsValid());
+
+  unsigned i = 0;
+
+#if defined(__SSE2__) && !defined(FIXED_MATH)
+  /* two points per iteration: each GeoPoint consists of two doubles
+     (longitude, latitude), which are transposed into one longitude
+     and one latitude vector */
+  static_assert(sizeof(GeoPoint) == 2 * sizeof(double), "Wrong GeoPoint size");
+
+  const __m128d origin_longitude =
+    _mm_set1_pd(geo_location.longitude.Native());
+  const __m128d origin_latitude = _mm_set1_pd(geo_location.latitude.Native());
+  const __m128d half_circle = _mm_set1_pd(Angle::HalfCircle().Native());
+  const __m128d minus_half_circle =
+    _mm_set1_pd(-Angle::HalfCircle().Native());
+  const __m128d full_circle = _mm_set1_pd(Angle::FullCircle().Native());
+  const __m128d quarter_circle = _mm_set1_pd(Angle::QuarterCircle().Native());
+  const __m128d minus_quarter_circle =
+    _mm_set1_pd(-Angle::QuarterCircle().Native());
+  const __m128d int_angle_mult = _mm_set1_pd(INT_ANGLE_MULT);
+  const __m128i cos_offset = _mm_set1_epi32(1024);
+  const __m128i int_angle_mask = _mm_set1_epi32(0xfff);
+  const __m128d scale = _mm_set1_pd(draw_scale);
+
+  const __m128d cost = _mm_set1_pd(screen_rotation.GetCosine());
+  const __m128d sint = _mm_set1_pd(screen_rotation.GetSine());
+  /* the ">> 10" in FastIntegerRotation::Rotate() rounds towards
+     negative infinity; adding this bias makes the value positive, so
+     _mm_cvttpd_epi32() does the same, as long as the scalar code
+     doesn't overflow */
+  constexpr int rotation_bias = 1 << 23;
+  const __m128d rotation_round = _mm_set1_pd(512. + 1024. * rotation_bias);
+  const __m128d rotation_shift = _mm_set1_pd(1. / 1024);
+  const __m128i origin_x = _mm_set1_epi32(screen_origin.x + rotation_bias);
+  const __m128i origin_y = _mm_set1_epi32(screen_origin.y - rotation_bias);
+
+  for (; i + 2 <= n; i += 2) {
+    const __m128d a = _mm_loadu_pd((const double *)&src[i]);
+    const __m128d b = _mm_loadu_pd((const double *)&src[i + 1]);
+    const __m128d longitude = _mm_unpacklo_pd(a, b);
+    const __m128d latitude = _mm_unpackhi_pd(a, b);
+
+    /* geo_location - g, normalised like GeoPoint::operator-(); one
+       correction step is enough for normalised GeoPoints, others are
+       left to the scalar code */
+    __m128d dx = _mm_sub_pd(origin_longitude, longitude);
+    dx = _mm_add_pd(dx, _mm_and_pd(_mm_cmple_pd(dx, minus_half_circle),
+                                   full_circle));
+    dx = _mm_sub_pd(dx, _mm_and_pd(_mm_cmpgt_pd(dx, half_circle),
+                                   full_circle));
+    const __m128d out_of_range =
+      _mm_or_pd(_mm_cmple_pd(dx, minus_half_circle),
+                _mm_cmpgt_pd(dx, half_circle));
+    if (gcc_unlikely(_mm_movemask_pd(out_of_range) != 0)) {
+      dest[i] = GeoToScreen(src[i]);
+      dest[i + 1] = GeoToScreen(src[i + 1]);
+      continue;
+    }
+
+    __m128d dy = _mm_sub_pd(origin_latitude, latitude);
+    dy = _mm_min_pd(_mm_max_pd(dy, minus_quarter_circle), quarter_circle);
+
+    /* fastcosine() of the latitude; SSE2 can't gather, so the table
+       lookup is scalar */
+    const __m128i index =
+      _mm_and_si128(_mm_add_epi32(RoundToInt(_mm_mul_pd(int_angle_mult,
+                                                        latitude)),
+                                  cos_offset),
+                    int_angle_mask);
+    const __m128d cosine =
+      _mm_set_pd(SINETABLE[_mm_cvtsi128_si32(_mm_srli_si128(index, 4))],
+                 SINETABLE[_mm_cvtsi128_si32(index)]);
+
+    /* the int casts in the scalar GeoToScreen() */
+    const __m128d x =
+      _mm_cvtepi32_pd(_mm_cvttpd_epi32(_mm_mul_pd(cosine,
+                                                  _mm_mul_pd(dx, scale))));
+    const __m128d y =
+      _mm_cvtepi32_pd(_mm_cvttpd_epi32(_mm_mul_pd(dy, scale)));
+
+    /* FastIntegerRotation::Rotate(); the products fit into the
+       mantissa, so this is exact */
+    const __m128i px =
+      _mm_cvttpd_epi32(_mm_mul_pd(_mm_add_pd(_mm_sub_pd(_mm_mul_pd(x, cost),
+                                                        _mm_mul_pd(y, sint)),
+                                             rotation_round),
+                                  rotation_shift));
+    const __m128i py =
+      _mm_cvttpd_epi32(_mm_mul_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(y, cost),
+                                                        _mm_mul_pd(x, sint)),
+                                             rotation_round),
+                                  rotation_shift));
+
+    const __m128i sx = _mm_sub_epi32(origin_x, px);
+    const __m128i sy = _mm_add_epi32(origin_y, py);
+
+    dest[i].x = _mm_cvtsi128_si32(sx);
+    dest[i].y = _mm_cvtsi128_si32(sy);
+    dest[i + 1].x = _mm_cvtsi128_si32(_mm_srli_si128(sx, 4));
+    dest[i + 1].y = _mm_cvtsi128_si32(_mm_srli_si128(sy, 4));
+  }
+#endif
+
+  for (; i < n; ++i)
+    dest[i] = GeoToScreen(src[i]);
+}
+
 void 
 Projection::SetScale(const fixed _scale)
 {
@@ -150,6 +150,16 @@ public:
   gcc_pure
   RasterPoint GeoToScreen(const GeoPoint &g) const;
 
+  /**
+   * Converts an array of GeoPoints to screen coordinates.  The
+   * results are the same as calling GeoToScreen() for each point, but
+   * this is much faster for long polylines and polygons.
+   *
+   * @param src the GeoPoints to convert
+   * @param dest the destination array, with room for #n points
+   */
+  void GeoToScreen(const GeoPoint *src, RasterPoint *dest, unsigned n) const;
+
   /**
    * Returns the origin/rotation center in screen coordinates
    * @return The origin/rotation center in screen coordinates
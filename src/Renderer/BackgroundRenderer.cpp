@@ -23,6 +23,8 @@ Copyright_License {
 
 #include "BackgroundRenderer.hpp"
 #include "Terrain/WeatherTerrainRenderer.hpp"
+#include "Terrain/RasterWeatherCache.hpp"
+#include "Terrain/RenderThread.hpp"
 #include "Projection/WindowProjection.hpp"
 #include "Screen/Canvas.hpp"
 #include "NMEA/Derived.hpp"
@@ -33,6 +35,7 @@ BackgroundRenderer::BackgroundRenderer()
   :terrain(nullptr),
    weather(nullptr),
    renderer(nullptr),
+   thread(nullptr),
    shading_angle(DEFAULT_SHADING_ANGLE)
 {
 }
@@ -42,6 +45,12 @@ BackgroundRenderer::Reset()
 {
   delete renderer;
   renderer = nullptr;
+
+  if (thread != nullptr) {
+    thread->LockStop();
+    delete thread;
+    thread = nullptr;
+  }
 }
 
 void
@@ -49,6 +58,9 @@ BackgroundRenderer::Flush()
 {
   if (renderer != nullptr)
     renderer->Flush();
+
+  if (thread != nullptr)
+    thread->Flush();
 }
 
 void
@@ -81,6 +93,18 @@ BackgroundRenderer::Draw(Canvas& canvas,
     return;
   }
 
+  if (async_callback && (weather == nullptr || weather->IsTerrain())) {
+    if (thread == nullptr)
+      thread = new TerrainRenderThread(*terrain,
+                                       std::function<void()>(async_callback));
+
+    thread->Trigger(proj, shading_angle, terrain_settings);
+    if (!thread->Draw(canvas, proj))
+      /* the first image is not ready yet */
+      canvas.ClearWhite();
+    return;
+  }
+
   if (!renderer) {
     // defer creation until first draw because
     // the buffer size, smoothing etc is set by the
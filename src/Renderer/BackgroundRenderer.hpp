@@ -26,10 +26,13 @@ Copyright_License {
 
 #include "Math/Angle.hpp"
 
+#include <functional>
+
 class Canvas;
 class WindowProjection;
 struct TerrainRendererSettings;
 class TerrainRenderer;
+class TerrainRenderThread;
 class RasterTerrain;
 class RasterWeatherCache;
 struct DerivedInfo;
@@ -41,6 +44,15 @@ class BackgroundRenderer {
   const RasterTerrain *terrain;
   const RasterWeatherCache *weather;
   TerrainRenderer *renderer;
+
+  /**
+   * Generates the terrain image in background.  Only used if
+   * EnableAsync() has been called.
+   */
+  TerrainRenderThread *thread;
+
+  std::function<void()> async_callback;
+
   Angle shading_angle;
 
 public:
@@ -50,6 +62,18 @@ public:
     Reset();
   }
 
+  /**
+   * Generate the terrain image in a separate thread, and let Draw()
+   * show the most recent image instead of waiting for it.  Weather
+   * maps are still rendered synchronously.
+   *
+   * @param callback invoked by the render thread when a new image is
+   * ready; it should schedule a redraw
+   */
+  void EnableAsync(std::function<void()> &&callback) {
+    async_callback = std::move(callback);
+  }
+
   /**
    * Flush all caches.
    */
@@ -42,9 +42,9 @@ RenderFAISector(Canvas &canvas, const WindowProjection &projection,
     GeoClip(projection.GetScreenBounds().Scale(fixed(1.1)))
     .ClipPolygon(clipped, geo_points, geo_end - geo_points);
 
-  RasterPoint points[FAI_TRIANGLE_SECTOR_MAX], *p = points;
-  for (GeoPoint *geo_i = clipped; geo_i != clipped_end;)
-    *p++ = projection.GeoToScreen(*geo_i++);
+  const unsigned n = clipped_end - clipped;
+  RasterPoint points[FAI_TRIANGLE_SECTOR_MAX * 3];
+  projection.GeoToScreen(clipped, points, n);
 
-  canvas.DrawPolygon(points, p - points);
+  canvas.DrawPolygon(points, n);
 }
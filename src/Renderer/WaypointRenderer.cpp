@@ -105,9 +105,16 @@ struct VisibleWaypoint {
   }
 
   void CalculateReachability(const RoutePlannerGlue &route_planner,
+                             const ReachabilityTable *table,
                              const TaskBehaviour &task_behaviour)
   {
-    CalculateRouteArrival(route_planner, task_behaviour);
+    const ReachResult *cached = table != nullptr
+      ? table->Find(waypoint->id)
+      : nullptr;
+    if (cached != nullptr)
+      reach = *cached;
+    else
+      CalculateRouteArrival(route_planner, task_behaviour);
 
     if (!reach.IsReachableDirect())
       reachable = WaypointRenderer::Unreachable;
@@ -380,14 +387,20 @@ public:
     task_valid = true;
   }
 
-  void CalculateRoute(const ProtectedRoutePlanner &route_planner) {
+  void CalculateRoute(const ProtectedRoutePlanner &route_planner,
+                      Serial waypoints_serial) {
     const ProtectedRoutePlanner::Lease lease(route_planner);
 
+    /* most results have been calculated by the calculation thread
+       already */
+    const ReachabilityTable *table =
+      lease->GetReachability(waypoints_serial);
+
     for (VisibleWaypoint &vwp : waypoints) {
       const Waypoint &way_point = *vwp.waypoint;
 
       if (way_point.IsLandable() || way_point.flags.watched)
-        vwp.CalculateReachability(lease, task_behaviour);
+        vwp.CalculateReachability(lease, table, task_behaviour);
     }
   }
 
@@ -413,11 +426,12 @@ public:
   }
 
   void Calculate(const ProtectedRoutePlanner *route_planner,
+                 Serial waypoints_serial,
                  const PolarSettings &polar_settings,
                  const TaskBehaviour &task_behaviour,
                  const DerivedInfo &calculated) {
     if (route_planner != nullptr && !route_planner->IsReachEmpty())
-      CalculateRoute(*route_planner);
+      CalculateRoute(*route_planner, waypoints_serial);
     else
       CalculateDirect(polar_settings, task_behaviour, calculated);
   }
@@ -477,7 +491,8 @@ WaypointRenderer::render(Canvas &canvas, LabelBlock &label_block,
   way_points->VisitWithinRange(projection.GetGeoScreenCenter(),
                                  projection.GetScreenDistanceMeters(), v);
 
-  v.Calculate(route_planner, polar_settings, task_behaviour, calculated);
+  v.Calculate(route_planner, way_points->GetSerial(),
+              polar_settings, task_behaviour, calculated);
 
   v.Draw(canvas);
 
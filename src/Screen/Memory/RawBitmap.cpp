@@ -50,13 +50,13 @@ RawBitmap::~RawBitmap()
 
 void
 RawBitmap::StretchTo(unsigned width, unsigned height,
-                     Canvas &dest_canvas,
+                     Canvas &dest_canvas, int dest_x, int dest_y,
                      unsigned dest_width, unsigned dest_height) const
 {
   ConstImageBuffer<ActivePixelTraits> src(ActivePixelTraits::const_pointer_type(buffer),
                                           corrected_width * sizeof(*buffer),
                                           width, height);
 
-  dest_canvas.Stretch(0, 0, dest_width, dest_height,
+  dest_canvas.Stretch(dest_x, dest_y, dest_width, dest_height,
                       src, 0, 0, width, height);
 }
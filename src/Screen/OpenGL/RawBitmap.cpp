@@ -48,22 +48,19 @@ CorrectedWidth(unsigned nWidth)
 RawBitmap::RawBitmap(unsigned nWidth, unsigned nHeight)
   :width(nWidth), height(nHeight),
    corrected_width(CorrectedWidth(nWidth)),
-   texture(new GLTexture(CorrectedWidth(nWidth), nHeight)),
-   dirty(true)
+   texture(nullptr),
+   dirty(true), surface_listener(false)
 {
   assert(nWidth > 0);
   assert(nHeight > 0);
 
-  texture->EnableInterpolation();
-
-  AddSurfaceListener(*this);
-
   buffer = new BGRColor[corrected_width * height];
 }
 
 RawBitmap::~RawBitmap()
 {
-  RemoveSurfaceListener(*this);
+  if (surface_listener)
+    RemoveSurfaceListener(*this);
 
   delete texture;
   delete[] buffer;
@@ -72,10 +69,8 @@ RawBitmap::~RawBitmap()
 void
 RawBitmap::SurfaceCreated()
 {
-  if (texture == nullptr) {
-    texture = new GLTexture(corrected_width, height);
-    texture->EnableInterpolation();
-  }
+  /* the texture will be created by the next BindAndGetTexture()
+     call */
 }
 
 void
@@ -90,6 +85,17 @@ RawBitmap::SurfaceDestroyed()
 GLTexture &
 RawBitmap::BindAndGetTexture() const
 {
+  if (texture == nullptr) {
+    if (!surface_listener) {
+      AddSurfaceListener(const_cast<RawBitmap &>(*this));
+      surface_listener = true;
+    }
+
+    texture = new GLTexture(corrected_width, height);
+    texture->EnableInterpolation();
+    dirty = true;
+  }
+
   texture->Bind();
 
   if (dirty) {
@@ -111,7 +117,7 @@ RawBitmap::BindAndGetTexture() const
 
 void
 RawBitmap::StretchTo(unsigned width, unsigned height,
-                     Canvas &dest_canvas,
+                     Canvas &dest_canvas, int dest_x, int dest_y,
                      unsigned dest_width, unsigned dest_height) const
 {
   GLTexture &texture = BindAndGetTexture();
@@ -123,5 +129,6 @@ RawBitmap::StretchTo(unsigned width, unsigned height,
   OpenGL::glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
 #endif
 
-  texture.Draw(0, 0, dest_width, dest_height, 0, 0, width, height);
+  texture.Draw(dest_x, dest_y, dest_width, dest_height,
+               0, 0, width, height);
 }
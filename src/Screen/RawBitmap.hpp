@@ -104,13 +104,23 @@ protected:
   BGRColor *buffer;
 
 #ifdef ENABLE_OPENGL
-  GLTexture *texture;
+  /**
+   * The texture is created by BindAndGetTexture().  Until then, no
+   * OpenGL call is made, which allows constructing and filling the
+   * RawBitmap in a thread other than the main thread.
+   */
+  mutable GLTexture *texture;
 
   /**
    * Has the buffer been modified, and needs to be copied into the
    * texture?
    */
   mutable bool dirty;
+
+  /**
+   * Has this object been registered with AddSurfaceListener()?
+   */
+  mutable bool surface_listener;
 #elif defined(USE_GDI)
   BITMAPINFO bi;
 #ifdef _WIN32_WCE
@@ -161,6 +171,10 @@ public:
 #endif
   }
 
+  const BGRColor *GetTopRow() const {
+    return const_cast<RawBitmap *>(this)->GetTopRow();
+  }
+
   /**
    * Returns a pointer to the row below the current one.
    */
@@ -172,6 +186,10 @@ public:
 #endif
   }
 
+  const BGRColor *GetNextRow(const BGRColor *row) const {
+    return const_cast<RawBitmap *>(this)->GetNextRow(const_cast<BGRColor *>(row));
+  }
+
   void SetDirty() {
 #ifdef ENABLE_OPENGL
     dirty = true;
@@ -214,6 +232,7 @@ public:
 #endif
 
   void StretchTo(unsigned width, unsigned height, Canvas &dest_canvas,
+                 int dest_x, int dest_y,
                  unsigned dest_width, unsigned dest_height) const;
 
 #ifdef ENABLE_OPENGL
@@ -85,6 +85,8 @@ Copyright_License {
 #include "Task/ProtectedTaskManager.hpp"
 #include "Engine/Task/Ordered/OrderedTask.hpp"
 #include "Operation/VerboseOperationEnvironment.hpp"
+#include "Job/Job.hpp"
+#include "Job/Parallel.hpp"
 #include "PageActions.hpp"
 #include "Weather/Features.hpp"
 #include "Weather/NOAAGlue.hpp"
@@ -166,6 +168,89 @@ AfterStartup()
   ForceCalculation();
 }
 
+/**
+ * A #Job which calls a function object.
+ */
+template<typename F>
+class FunctionJob final : public Job {
+  F f;
+
+public:
+  explicit FunctionJob(F &&_f):f(std::move(_f)) {}
+
+  void Run(OperationEnvironment &env) override {
+    f(env);
+  }
+};
+
+template<typename F>
+static FunctionJob<F>
+MakeFunctionJob(F &&f)
+{
+  return FunctionJob<F>(std::forward<F>(f));
+}
+
+/**
+ * The number of threads which load the data files.
+ */
+static constexpr unsigned LOAD_THREADS = 3;
+
+/**
+ * Load terrain, topography, waypoints, airspace and the weather
+ * forecast in parallel.  Waypoints need the terrain for the
+ * elevation of waypoints which have none in the file; airspace only
+ * needs it for filling in the ground levels at the end.
+ */
+static void
+LoadFiles(const AtmosphericPressure &pressure, const GeoPoint &location,
+          OperationEnvironment &operation)
+{
+  auto terrain_job = MakeFunctionJob([](OperationEnvironment &env){
+      env.SetText(_("Loading Terrain File..."));
+      LogFormat("OpenTerrain");
+      terrain = RasterTerrain::OpenTerrain(file_cache, env);
+    });
+
+  auto topography_job = MakeFunctionJob([](OperationEnvironment &env){
+      topography = new TopographyStore();
+      LoadConfiguredTopography(*topography, file_cache, env);
+    });
+
+  auto waypoints_job = MakeFunctionJob([](OperationEnvironment &env){
+      WaypointGlue::LoadWaypoints(way_points, terrain, file_cache, env);
+    });
+
+  auto waypoint_details_job = MakeFunctionJob([](OperationEnvironment &env){
+      WaypointDetails::ReadFileFromProfile(way_points, env);
+    });
+
+  auto rasp_job = MakeFunctionJob([&location](OperationEnvironment &env){
+      LogFormat("RASP load");
+      rasp = new RasterWeatherStore();
+      rasp->ScanAll(location, env);
+    });
+
+  auto airspace_job = MakeFunctionJob([&pressure](OperationEnvironment &env){
+      ReadAirspace(airspace_database, nullptr, file_cache, pressure, env);
+    });
+
+  auto airspace_terrain_job = MakeFunctionJob([](OperationEnvironment &){
+      if (terrain != nullptr)
+        airspace_database.SetGroundLevels(*terrain);
+    });
+
+  ParallelJobRunner runner;
+  const unsigned terrain_id = runner.Add(terrain_job);
+  runner.Add(topography_job);
+  const unsigned waypoints_id = runner.Add(waypoints_job, {terrain_id});
+  runner.Add(waypoint_details_job, {waypoints_id});
+  runner.Add(rasp_job);
+  const unsigned airspace_id = runner.Add(airspace_job);
+  runner.Add(airspace_terrain_job, {terrain_id, airspace_id});
+
+  runner.Run(operation, LOAD_THREADS);
+}
+
 /**
  * "Boots" up XCSoar
  * @param hInstance Instance handle
@@ -315,10 +400,9 @@ Startup()
   protected_task_manager =
     new ProtectedTaskManager(*task_manager, computer_settings.task);
 
-  // Read the terrain file
-  operation.SetText(_("Loading Terrain File..."));
-  LogFormat("OpenTerrain");
-  terrain = RasterTerrain::OpenTerrain(file_cache, operation);
+  // Read the terrain, topography, waypoint, weather and airspace files
+  LoadFiles(computer_settings.pressure, CommonInterface::Basic().location,
+            operation);
 
   logger = new Logger();
 
@@ -348,16 +432,6 @@ Startup()
                          CommonInterface::SetComputerSettings(), gp);
   task_manager->SetGlidePolar(gp);
 
-  // Read the topography file(s)
-  topography = new TopographyStore();
-  LoadConfiguredTopography(*topography, operation);
-
-  // Read the waypoint files
-  WaypointGlue::LoadWaypoints(way_points, terrain, operation);
-
-  // Read and parse the airfield info file
-  WaypointDetails::ReadFileFromProfile(way_points, operation);
-
   // Set the home waypoint
   WaypointGlue::SetHome(way_points, terrain,
                         CommonInterface::SetComputerSettings().poi,
@@ -368,15 +442,6 @@ Startup()
   device_blackboard->Merge();
   CommonInterface::ReadBlackboardBasic(device_blackboard->Basic());
 
-  // Scan for weather forecast
-  LogFormat("RASP load");
-  rasp = new RasterWeatherStore();
-  rasp->ScanAll(CommonInterface::Basic().location, operation);
-
-  // Reads the airspace files
-  ReadAirspace(airspace_database, terrain, computer_settings.pressure,
-               operation);
-
   {
     const AircraftState aircraft_state =
       ToAircraftState(device_blackboard->Basic(),
@@ -84,6 +84,11 @@ public:
 
   void AcceptInRange(const GeoBounds &bounds,
                      TriangleFanVisitor &visitor) const;
+
+  void SetReachability(ReachabilityTable &&table) {
+    ExclusiveLease lease(*this);
+    lease->SetReachability(std::move(table));
+  }
 };
 
 #endif
@@ -0,0 +1,105 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "ReachabilityTable.hpp"
+#include "RoutePlannerGlue.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Waypoint/WaypointVisitor.hpp"
+
+#include <algorithm>
+
+bool
+ReachabilityParameters::IsCloseTo(const ReachabilityParameters &other) const
+{
+  const fixed wind_x = wind.norm * wind.bearing.sin()
+    - other.wind.norm * other.wind.bearing.sin();
+  const fixed wind_y = wind.norm * wind.bearing.cos()
+    - other.wind.norm * other.wind.bearing.cos();
+
+  return fabs(mc - other.mc) < fixed(0.1) &&
+    fabs(bugs - other.bugs) < fixed(0.01) &&
+    fabs(ballast - other.ballast) < fixed(0.01) &&
+    SmallHypot(wind_x, wind_y) < fixed(1) &&
+    safety_height_arrival == other.safety_height_arrival;
+}
+
+class ReachabilityTable::Filler final : public WaypointVisitor {
+  std::vector<Item> &items;
+  const RoutePlannerGlue &route_planner;
+  const fixed safety_height_arrival;
+
+public:
+  Filler(std::vector<Item> &_items, const RoutePlannerGlue &_route_planner,
+         fixed _safety_height_arrival)
+    :items(_items), route_planner(_route_planner),
+     safety_height_arrival(_safety_height_arrival) {}
+
+  void Visit(const Waypoint &wp) override {
+    if (!wp.IsLandable() && !wp.flags.watched)
+      return;
+
+    const RoughAltitude elevation(wp.elevation + safety_height_arrival);
+    const AGeoPoint destination(wp.location, elevation);
+
+    ReachResult reach;
+    reach.Clear();
+    if (route_planner.FindPositiveArrival(destination, reach))
+      reach.Subtract(elevation);
+
+    items.emplace_back(wp.id, reach);
+  }
+};
+
+void
+ReachabilityTable::Calculate(const RoutePlannerGlue &route_planner,
+                             const Waypoints &waypoints,
+                             const AGeoPoint &origin,
+                             const fixed safety_height_arrival)
+{
+  items.clear();
+  reach_serial = route_planner.GetReachSerial();
+  waypoints_serial = waypoints.GetSerial();
+
+  /* nothing beyond a straight glide down to MSL can be reached, and
+     outside of the reach fan, RoutePlannerGlue::FindPositiveArrival()
+     is cheap enough to be left to the caller */
+  const fixed range = route_planner.GetMaxReachDistance(origin.altitude);
+  if (!positive(range))
+    return;
+
+  Filler filler(items, route_planner, safety_height_arrival);
+  waypoints.VisitWithinRange(origin, range, filler);
+
+  std::sort(items.begin(), items.end());
+}
+
+const ReachResult *
+ReachabilityTable::Find(unsigned waypoint_id) const
+{
+  auto i = std::lower_bound(items.begin(), items.end(), waypoint_id,
+                            [](const Item &item, unsigned id){
+                              return item.waypoint_id < id;
+                            });
+  return i != items.end() && i->waypoint_id == waypoint_id
+    ? &i->reach
+    : nullptr;
+}
@@ -0,0 +1,132 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_REACHABILITY_TABLE_HPP
+#define XCSOAR_REACHABILITY_TABLE_HPP
+
+#include "Engine/Route/ReachResult.hpp"
+#include "Geo/SpeedVector.hpp"
+#include "Util/Serial.hpp"
+#include "Math/fixed.hpp"
+#include "Compiler.h"
+
+#include <vector>
+
+struct AGeoPoint;
+class Waypoints;
+class RoutePlannerGlue;
+
+/**
+ * The glide parameters a #ReachabilityTable was calculated with.
+ */
+struct ReachabilityParameters {
+  fixed mc, bugs, ballast;
+  SpeedVector wind;
+  fixed safety_height_arrival;
+
+  /**
+   * Are the differences too small to require a recalculation?  The
+   * thresholds are 0.1 m/s MacCready, 1% bugs and ballast and 1 m/s
+   * wind (the difference of both wind vectors); the arrival safety
+   * height must be the same.
+   */
+  gcc_pure
+  bool IsCloseTo(const ReachabilityParameters &other) const;
+};
+
+/**
+ * The reach of all landable and watched waypoints around the aircraft.
+ * It is calculated by the calculation thread after the reach fan has
+ * been solved, so the map renderer can look up the results instead
+ * of calling RoutePlannerGlue::FindPositiveArrival() for each
+ * visible waypoint on each frame.
+ */
+class ReachabilityTable {
+  struct Item {
+    unsigned waypoint_id;
+
+    /**
+     * The arrival altitudes above the waypoint's elevation, with the
+     * arrival safety height already subtracted.
+     */
+    ReachResult reach;
+
+    Item(unsigned _waypoint_id, const ReachResult &_reach)
+      :waypoint_id(_waypoint_id), reach(_reach) {}
+
+    bool operator<(const Item &other) const {
+      return waypoint_id < other.waypoint_id;
+    }
+  };
+
+  class Filler;
+
+  /**
+   * Sorted by waypoint id.
+   */
+  std::vector<Item> items;
+
+  /**
+   * The RoutePlannerGlue::GetReachSerial() value this table was
+   * calculated for.
+   */
+  Serial reach_serial;
+
+  /**
+   * The Waypoints::GetSerial() value this table was calculated for.
+   */
+  Serial waypoints_serial;
+
+public:
+  /**
+   * Was this table calculated for the specified reach fan and
+   * waypoint database?
+   */
+  bool IsValid(Serial _reach_serial, Serial _waypoints_serial) const {
+    return _reach_serial == reach_serial &&
+      _waypoints_serial == waypoints_serial;
+  }
+
+  /**
+   * Calculate the reach of all landable and watched waypoints which
+   * may be reachable from the origin of the current reach fan.
+   *
+   * @param origin the location and altitude the reach fan was
+   * solved for
+   * @param safety_height_arrival the arrival safety height (m)
+   */
+  void Calculate(const RoutePlannerGlue &route_planner,
+                 const Waypoints &waypoints,
+                 const AGeoPoint &origin, fixed safety_height_arrival);
+
+  /**
+   * Look up the result for the specified waypoint.
+   *
+   * @return the result or nullptr if the waypoint is not in the
+   * table (because it is too far away); the caller must calculate
+   * it then
+   */
+  gcc_pure
+  const ReachResult *Find(unsigned waypoint_id) const;
+};
+
+#endif
@@ -36,6 +36,8 @@ RoutePlannerGlue::SetTerrain(const RasterTerrain *_terrain)
     planner.Reset();
     planner.SetTerrain(NULL);
   }
+
+  ++reach_serial;
 }
 
 void
@@ -71,6 +73,8 @@ RoutePlannerGlue::SolveReach(const AGeoPoint &origin,
   } else {
     planner.SolveReach(origin, config, h_ceiling, do_solve);
   }
+
+  ++reach_serial;
 }
 
 bool
@@ -24,6 +24,10 @@
 #define ROUTE_PLANNER_GLUE_HPP
 
 #include "Route/AirspaceRoute.hpp"
+#include "ReachabilityTable.hpp"
+#include "Util/Serial.hpp"
+
+#include <utility>
 
 struct GlideSettings;
 class RoughAltitude;
@@ -34,6 +38,13 @@ class RoutePlannerGlue {
   const RasterTerrain *terrain;
   AirspaceRoute planner;
 
+  /**
+   * Incremented each time the reach fan is solved or cleared.
+   */
+  Serial reach_serial;
+
+  ReachabilityTable reachability;
+
 public:
   RoutePlannerGlue():terrain(nullptr) {}
 
@@ -57,10 +68,12 @@ public:
 
   void ClearReach() {
     planner.ClearReach();
+    ++reach_serial;
   }
 
   void Reset() {
     planner.Reset();
+    ++reach_serial;
   }
 
   bool Solve(const AGeoPoint &origin, const AGeoPoint &destination,
@@ -82,6 +95,39 @@ public:
                     GeoPoint &intx) const;
 
   RoughAltitude GetTerrainBase() const;
+
+  Serial GetReachSerial() const {
+    return reach_serial;
+  }
+
+  gcc_pure
+  fixed GetMaxReachDistance(RoughAltitude altitude) const {
+    return planner.GetMaxReachDistance(altitude);
+  }
+
+  /**
+   * Returns the #ReachabilityTable, or nullptr if it was not
+   * calculated for the current reach fan and the specified waypoint
+   * database.
+   */
+  gcc_pure
+  const ReachabilityTable *GetReachability(Serial waypoints_serial) const {
+    return reachability.IsValid(reach_serial, waypoints_serial)
+      ? &reachability
+      : nullptr;
+  }
+
+  /**
+   * Returns the #ReachabilityTable, even if it is stale.  Only the
+   * calculation thread may call this without a lock.
+   */
+  const ReachabilityTable &GetReachability() const {
+    return reachability;
+  }
+
+  void SetReachability(ReachabilityTable &&table) {
+    reachability = std::move(table);
+  }
 };
 
 #endif
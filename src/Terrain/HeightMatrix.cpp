@@ -30,7 +30,11 @@ Copyright_License {
 #include "Projection/WindowProjection.hpp"
 #endif
 
+#include <algorithm>
+
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
 
 void
 HeightMatrix::SetSize(size_t _size)
@@ -57,6 +61,45 @@ HeightMatrix::SetSize(unsigned width, unsigned height,
           (height + quantisation_pixels - 1) / quantisation_pixels);
 }
 
+/**
+ * The number of cells scanned by one RasterMap::ScanLine() call.
+ * RasterMap::ScanLine() interpolates linearly between the end points,
+ * so the value of a cell depends on them; the blocks are therefore
+ * aligned to the cell offset, not to the rectangle being filled.
+ */
+static constexpr int SCAN_BLOCK = 64;
+
+/**
+ * Scan the cells [x0, x1) of a row.  The #to_geo function returns
+ * the location of the cell with the specified offset.
+ */
+template<typename F>
+static void
+ScanRow(const RasterMap &map, short *row, int offset_x,
+        unsigned x0, unsigned x1, bool interpolate, F &&to_geo)
+{
+  short buffer[SCAN_BLOCK];
+
+  for (unsigned x = x0; x < x1;) {
+    const int cell = offset_x + int(x);
+    int skip = cell % SCAN_BLOCK;
+    if (skip < 0)
+      skip += SCAN_BLOCK;
+
+    const int start = cell - skip;
+    const unsigned n = std::min(x1 - x, unsigned(SCAN_BLOCK - skip));
+
+    /* scan directly into the row if the whole block is needed */
+    short *const dest = n == unsigned(SCAN_BLOCK) ? row + x : buffer;
+    map.ScanLine(to_geo(start), to_geo(start + SCAN_BLOCK - 1),
+                 dest, SCAN_BLOCK, interpolate);
+    if (dest == buffer)
+      std::copy_n(buffer + skip, n, row + x);
+
+    x += n;
+  }
+}
+
 #ifdef ENABLE_OPENGL
 
 void
@@ -65,35 +108,99 @@ HeightMatrix::Fill(const RasterMap &map, const GeoBounds &bounds,
 {
   SetSize(width, height);
 
+  FillRect(map, bounds, 0, 0, 0, 0, width, height, interpolate);
+}
+
+void
+HeightMatrix::FillRect(const RasterMap &map, const GeoBounds &bounds,
+                       int offset_x, int offset_y,
+                       unsigned x0, unsigned y0, unsigned x1, unsigned y1,
+                       bool interpolate)
+{
+  assert(x0 < x1 && x1 <= width);
+  assert(y0 < y1 && y1 <= height);
+
+  const Angle west = bounds.GetWest(), north = bounds.GetNorth();
+  const Angle delta_x = bounds.GetWidth() / width;
   const Angle delta_y = bounds.GetHeight() / height;
-  Angle latitude = bounds.GetNorth();
-  for (short *p = data.begin(), *const end = p + width * height;
-       p != end; p += width, latitude -= delta_y) {
-    map.ScanLine(GeoPoint(bounds.GetWest(), latitude),
-                 GeoPoint(bounds.GetEast(), latitude),
-                 p, width, interpolate);
+
+  short *p = data.begin() + y0 * width;
+  for (unsigned y = y0; y < y1; ++y, p += width) {
+    const Angle latitude = north - delta_y * (offset_y + int(y));
+    ScanRow(map, p, offset_x, x0, x1, interpolate,
+            [west, delta_x, latitude](int x){
+              return GeoPoint(west + delta_x * x, latitude);
+            });
   }
 }
 
 #else
 
+void
+HeightMatrix::SetScreenSize(unsigned screen_width, unsigned screen_height,
+                            unsigned quantisation_pixels)
+{
+  SetSize((screen_width + quantisation_pixels - 1) / quantisation_pixels + 1,
+          (screen_height + quantisation_pixels - 1) / quantisation_pixels + 1);
+}
+
 void
 HeightMatrix::Fill(const RasterMap &map, const WindowProjection &projection,
                    unsigned quantisation_pixels, bool interpolate)
 {
-  const unsigned screen_width = projection.GetScreenWidth();
-  const unsigned screen_height = projection.GetScreenHeight();
-
-  SetSize((screen_width + quantisation_pixels - 1) / quantisation_pixels,
-          (screen_height + quantisation_pixels - 1) / quantisation_pixels);
-
-  short *p = data.begin();
-  for (unsigned y = 0; y < screen_height;
-       y += quantisation_pixels, p += width) {
-    map.ScanLine(projection.ScreenToGeo(0, y),
-                 projection.ScreenToGeo(screen_width, y),
-                 p, width, interpolate);
+  SetScreenSize(projection.GetScreenWidth(), projection.GetScreenHeight(),
+                quantisation_pixels);
+
+  FillRect(map, projection, quantisation_pixels, 0, 0,
+           0, 0, width, height, interpolate);
+}
+
+void
+HeightMatrix::FillRect(const RasterMap &map,
+                       const WindowProjection &projection,
+                       unsigned quantisation_pixels,
+                       int offset_x, int offset_y,
+                       unsigned x0, unsigned y0, unsigned x1, unsigned y1,
+                       bool interpolate)
+{
+  assert(x0 < x1 && x1 <= width);
+  assert(y0 < y1 && y1 <= height);
+
+  const int q = quantisation_pixels;
+
+  short *p = data.begin() + y0 * width;
+  for (unsigned y = y0; y < y1; ++y, p += width) {
+    const int screen_y = (offset_y + int(y)) * q;
+    ScanRow(map, p, offset_x, x0, x1, interpolate,
+            [&projection, q, screen_y](int x){
+              return projection.ScreenToGeo(x * q, screen_y);
+            });
   }
 }
 
 #endif
+
+void
+HeightMatrix::Scroll(int dx, int dy)
+{
+  assert(unsigned(abs(dx)) < width);
+  assert(unsigned(abs(dy)) < height);
+
+  const unsigned n = width - abs(dx);
+  const unsigned dest_x = std::max(-dx, 0), src_x = std::max(dx, 0);
+  const unsigned n_rows = height - abs(dy);
+
+  /* copy in the direction which doesn't overwrite rows which are
+     still needed */
+  if (dy >= 0) {
+    for (unsigned y = 0; y < n_rows; ++y)
+      memmove(data.begin() + y * width + dest_x,
+              data.begin() + (y + dy) * width + src_x,
+              n * sizeof(data[0]));
+  } else {
+    for (unsigned y = height; y-- > unsigned(-dy);)
+      memmove(data.begin() + y * width + dest_x,
+              data.begin() + (y + dy) * width + src_x,
+              n * sizeof(data[0]));
+  }
+}
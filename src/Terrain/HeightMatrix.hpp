@@ -52,17 +52,67 @@ public:
 #ifdef ENABLE_OPENGL
   /**
    * Copy values from the #RasterMap to the buffer, north-up only.
+   * Cell (x,y) is located at (west+x*delta_x, north-y*delta_y), with
+   * delta_x=width/_width and delta_y=height/_height of the bounds.
    */
   void Fill(const RasterMap &map, const GeoBounds &bounds,
             unsigned _width, unsigned _height, bool interpolate);
+
+  /**
+   * Copy values from the #RasterMap to a rectangle of the buffer.
+   * The size of the buffer is not changed.  #bounds is the one
+   * passed to the last Fill() call, and cell (x,y) is located where
+   * Fill() would have put cell (offset_x+x, offset_y+y).
+   */
+  void FillRect(const RasterMap &map, const GeoBounds &bounds,
+                int offset_x, int offset_y,
+                unsigned x0, unsigned y0, unsigned x1, unsigned y1,
+                bool interpolate);
 #else
   /**
+   * Allocate a buffer which covers the whole screen, see Fill().
+   */
+  void SetScreenSize(unsigned screen_width, unsigned screen_height,
+                     unsigned quantisation_pixels);
+
+  /**
+   * Copy values from the #RasterMap to the buffer.  Cell (x,y) is
+   * located at the screen position (x*quantisation_pixels,
+   * y*quantisation_pixels).  There is one spare row and column,
+   * which allows RasterRenderer to display the buffer with a small
+   * offset after Scroll().
+   *
    * @param interpolate true enables interpolation of sub-pixel values
    */
   void Fill(const RasterMap &map, const WindowProjection &map_projection,
             unsigned quantisation_pixels, bool interpolate);
+
+  /**
+   * Copy values from the #RasterMap to a rectangle of the buffer.
+   * The size of the buffer is not changed.  Cell (x,y) is located at
+   * the screen position ((offset_x+x)*quantisation_pixels,
+   * (offset_y+y)*quantisation_pixels).
+   */
+  void FillRect(const RasterMap &map, const WindowProjection &map_projection,
+                unsigned quantisation_pixels, int offset_x, int offset_y,
+                unsigned x0, unsigned y0, unsigned x1, unsigned y1,
+                bool interpolate);
 #endif
 
+  /**
+   * Move the contents of the buffer by whole cells: the old cell
+   * (x+dx, y+dy) becomes the new cell (x, y).  The cells which are
+   * exposed by this are undefined afterwards; the caller must fill
+   * them with FillRect().
+   *
+   * Each row is scanned in blocks which are aligned to the cell
+   * offset, so a cell gets the same value no matter which rectangle
+   * it was filled with.  Scrolling and filling the exposed strips
+   * therefore gives the same result as filling the whole buffer
+   * with the new offset.
+   */
+  void Scroll(int dx, int dy);
+
   unsigned GetWidth() const {
     return width;
   }
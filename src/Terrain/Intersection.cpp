@@ -83,6 +83,8 @@ RasterTileCache::FirstIntersection(const int x0, const int y0,
   const int step_fine = std::max(1, max_steps >> INTERSECT_BITS);
   // number of steps for update to the overview map
   const int step_coarse = std::max(1<< OVERVIEW_BITS, step_fine);
+  // pyramid level which matches the fine step size
+  const unsigned level = SelectLevel(step_fine);
 
   // number of steps to be cleared after climbing over obstruction
   const int intersect_steps = 32;
@@ -126,7 +128,7 @@ RasterTileCache::FirstIntersection(const int x0, const int y0,
       if (!IsInside(location))
         break; // outside bounds
 
-      const auto field_direct = GetFieldDirect(location.x, location.y);
+      const auto field_direct = GetFieldAtLevel(location.x, location.y, level);
       if (RasterBuffer::IsInvalid(field_direct.first))
         break;
 
@@ -262,6 +264,22 @@ RasterTileCache::GetFieldDirect(const unsigned px, const unsigned py) const
   return std::make_pair(overview.Get(x_overview, y_overview), false);
 }
 
+inline std::pair<short, bool>
+RasterTileCache::GetFieldAtLevel(const unsigned px, const unsigned py,
+                                 const unsigned level) const
+{
+  if (level == 0)
+    return GetFieldDirect(px, py);
+
+  const RasterBuffer &buffer = GetLevelBuffer(level);
+
+  // the level might not cover the whole map; see GetFieldDirect()
+  const unsigned x = std::min(px >> level, buffer.GetWidth() - 1);
+  const unsigned y = std::min(py >> level, buffer.GetHeight() - 1);
+
+  return std::make_pair(buffer.Get(x, y), true);
+}
+
 SignedRasterLocation
 RasterTileCache::Intersection(const int x0, const int y0,
                               const int x1, const int y1,
@@ -292,6 +310,8 @@ RasterTileCache::Intersection(const int x0, const int y0,
   const int step_fine = std::max(1, refine_step);
   // number of steps for update to the overview map
   const int step_coarse = std::max(1<< OVERVIEW_BITS, step_fine);
+  // pyramid level which matches the fine step size
+  const unsigned level = SelectLevel(step_fine);
 
   // counter for steps to reach next position to be checked on the field.
   unsigned step_counter = 0;
@@ -314,7 +334,7 @@ RasterTileCache::Intersection(const int x0, const int y0,
       if (!IsInside(location))
         break; // outside bounds
 
-      const auto field_direct = GetFieldDirect(location.x, location.y);
+      const auto field_direct = GetFieldAtLevel(location.x, location.y, level);
       if (RasterBuffer::IsInvalid(field_direct.first))
         break;
 
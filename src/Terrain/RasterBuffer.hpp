@@ -25,10 +25,14 @@ Copyright_License {
 #define XCSOAR_RASTER_BUFFER_HPP
 
 #include "Util/NonCopyable.hpp"
-#include "Util/AllocatedGrid.hpp"
+#include "Util/AllocatedArray.hpp"
 #include "Compiler.h"
 
 #include <cstddef>
+#include <utility>
+
+#include <assert.h>
+#include <stdint.h>
 
 class RasterBuffer : private NonCopyable {
 public:
@@ -67,23 +71,55 @@ public:
   }
 
 private:
-  AllocatedGrid<short> data;
+  /**
+   * The memory allocated by Resize().  It is empty if this object
+   * refers to external memory, see SetExternal().
+   */
+  AllocatedArray<short> allocation;
+
+  /**
+   * Pointer to the first height value.  This points either into
+   * #allocation or to read-only memory owned by somebody else
+   * (e.g. a file mapping).
+   */
+  const short *data;
+
+  unsigned width, height;
 
 public:
-  RasterBuffer() = default;
+  RasterBuffer():data(nullptr), width(0), height(0) {}
   RasterBuffer(unsigned _width, unsigned _height)
-    :data(_width, _height) {}
+    :allocation(_width * _height), data(allocation.begin()),
+     width(_width), height(_height) {}
+
+  /**
+   * Exchange the contents of the two objects.
+   */
+  RasterBuffer &operator=(RasterBuffer &&other) {
+    allocation = std::move(other.allocation);
+    std::swap(data, other.data);
+    std::swap(width, other.width);
+    std::swap(height, other.height);
+    return *this;
+  }
 
   bool IsDefined() const {
-    return data.IsDefined();
+    return data != nullptr;
+  }
+
+  /**
+   * Does this object refer to memory it doesn't own?
+   */
+  bool IsExternal() const {
+    return data != nullptr && allocation.size() == 0;
   }
 
   unsigned GetWidth() const {
-    return data.GetWidth();
+    return width;
   }
 
   unsigned GetHeight() const {
-    return data.GetHeight();
+    return height;
   }
 
   unsigned GetFineWidth() const {
@@ -94,24 +130,50 @@ public:
     return GetHeight() << 8;
   }
 
+  /**
+   * Returns a writable pointer to the buffer.  Must not be called
+   * when the buffer refers to external memory.
+   */
   short *GetData() {
-    return data.begin();
+    assert(!IsExternal());
+
+    return allocation.begin();
   }
 
   const short *GetData() const {
-    return data.begin();
+    return data;
   }
 
   const short *GetDataAt(unsigned x, unsigned y) const {
-    return data.GetPointerAt(x, y);
+    assert(x < width);
+    assert(y < height);
+
+    return data + y * width + x;
   }
 
   void Reset() {
-    data.Reset();
+    allocation.ResizeDiscard(0);
+    data = nullptr;
+    width = height = 0;
   }
 
   void Resize(unsigned _width, unsigned _height);
 
+  /**
+   * Let this object refer to the specified external memory instead
+   * of allocating its own buffer.  The caller is responsible for
+   * keeping the memory valid until Reset() is called.
+   */
+  void SetExternal(const short *_data, unsigned _width, unsigned _height) {
+    assert(_data != nullptr);
+    assert(_width > 0 && _height > 0);
+
+    allocation.ResizeDiscard(0);
+    data = _data;
+    width = _width;
+    height = _height;
+  }
+
   gcc_pure
   short GetInterpolated(unsigned lx, unsigned ly,
                         unsigned ix, unsigned iy) const;
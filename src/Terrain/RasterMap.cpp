@@ -44,34 +44,53 @@ ToNarrowPath(const TCHAR *src)
   return WideToACPConverter(src).StealDup();
 }
 
+bool
+RasterMap::LoadCache(FileCache &cache, const TCHAR *_path)
+{
+  FILE *file = cache.Load(terrain_cache_name, _path);
+  if (file == NULL)
+    return false;
+
+  TCHAR cache_path[cache.PathBufferSize(terrain_cache_name)];
+  cache.MakeCachePath(cache_path, terrain_cache_name);
+
+  bool success = raster_tile_cache.LoadCache(file, cache_path);
+  fclose(file);
+  return success;
+}
+
+bool
+RasterMap::SaveCache(FileCache &cache, const TCHAR *_path,
+                     OperationEnvironment &operation)
+{
+  FILE *file = cache.Save(terrain_cache_name, _path);
+  if (file == NULL)
+    return false;
+
+  if (!raster_tile_cache.SaveCache(file, path, operation)) {
+    cache.Cancel(terrain_cache_name, file);
+    return false;
+  }
+
+  return cache.Commit(terrain_cache_name, file);
+}
+
 RasterMap::RasterMap(const TCHAR *_path, const TCHAR *world_file,
                      FileCache *cache, OperationEnvironment &operation)
   :path(ToNarrowPath(_path))
 {
-  bool cache_loaded = false;
-  if (cache != NULL) {
-    /* load the cache file */
-    FILE *file = cache->Load(terrain_cache_name, _path);
-    if (file != NULL) {
-      cache_loaded = raster_tile_cache.LoadCache(file);
-      fclose(file);
-    }
-  }
+  bool cache_loaded = cache != NULL && LoadCache(*cache, _path);
 
   if (!cache_loaded) {
     if (!raster_tile_cache.LoadOverview(path, world_file, operation))
       return;
 
-    if (cache != NULL) {
-      /* save the cache file */
-      FILE *file = cache->Save(terrain_cache_name, _path);
-      if (file != NULL) {
-        if (raster_tile_cache.SaveCache(file))
-          cache->Commit(terrain_cache_name, file);
-        else
-          cache->Cancel(terrain_cache_name, file);
-      }
-    }
+    if (cache != NULL && SaveCache(*cache, _path, operation) &&
+        !LoadCache(*cache, _path) &&
+        /* mapping the new cache file has failed; fall back to
+           decoding the JPEG2000 file */
+        !raster_tile_cache.LoadOverview(path, world_file, operation))
+      return;
   }
 
   projection.Set(GetBounds(),
@@ -89,11 +108,11 @@ AngleToPixel(Angle value, Angle start, Angle end, unsigned width)
   return unsigned((value - start).Native() * width / (end - start).Native());
 }
 
-void
-RasterMap::SetViewCenter(const GeoPoint &location, fixed radius)
+bool
+RasterMap::PrepareTiles(const GeoPoint &location, fixed radius)
 {
   if (!raster_tile_cache.GetInitialised())
-    return;
+    return false;
 
   const GeoBounds &bounds = GetBounds();
 
@@ -103,8 +122,30 @@ RasterMap::SetViewCenter(const GeoPoint &location, fixed radius)
   int y = AngleToPixel(location.latitude, bounds.GetNorth(), bounds.GetSouth(),
                        raster_tile_cache.GetHeight());
 
-  raster_tile_cache.UpdateTiles(path, x, y,
-                                projection.DistancePixelsCoarse(radius));
+  return raster_tile_cache.PrepareTiles(x, y,
+                                        projection.DistancePixelsCoarse(radius));
+}
+
+void
+RasterMap::DecodeTiles()
+{
+  raster_tile_cache.DecodeTiles(path);
+}
+
+void
+RasterMap::CommitTiles()
+{
+  raster_tile_cache.CommitTiles();
+}
+
+void
+RasterMap::SetViewCenter(const GeoPoint &location, fixed radius)
+{
+  if (!PrepareTiles(location, radius))
+    return;
+
+  DecodeTiles();
+  CommitTiles();
 }
 
 short
@@ -121,6 +162,51 @@ RasterMap::GetInterpolatedHeight(const GeoPoint &location) const
   return raster_tile_cache.GetInterpolatedHeight(pt.x, pt.y);
 }
 
+/**
+ * The number of locations projected at a time by GetHeights() and
+ * GetInterpolatedHeights().
+ */
+static constexpr unsigned HEIGHTS_CHUNK = 64;
+
+void
+RasterMap::GetHeights(const GeoPoint *locations, short *heights,
+                      unsigned n) const
+{
+  SignedRasterLocation buffer[HEIGHTS_CHUNK];
+
+  while (n > 0) {
+    const unsigned chunk = std::min(n, HEIGHTS_CHUNK);
+
+    projection.ProjectFine(locations, buffer, chunk);
+    for (unsigned i = 0; i < chunk; ++i)
+      buffer[i] = buffer[i] >> RasterTileCache::SUBPIXEL_BITS;
+
+    raster_tile_cache.GetHeights(buffer, heights, chunk);
+
+    locations += chunk;
+    heights += chunk;
+    n -= chunk;
+  }
+}
+
+void
+RasterMap::GetInterpolatedHeights(const GeoPoint *locations, short *heights,
+                                  unsigned n) const
+{
+  SignedRasterLocation buffer[HEIGHTS_CHUNK];
+
+  while (n > 0) {
+    const unsigned chunk = std::min(n, HEIGHTS_CHUNK);
+
+    projection.ProjectFine(locations, buffer, chunk);
+    raster_tile_cache.GetInterpolatedHeights(buffer, heights, chunk);
+
+    locations += chunk;
+    heights += chunk;
+    n -= chunk;
+  }
+}
+
 void
 RasterMap::ScanLine(const GeoPoint &start, const GeoPoint &end,
                     short *buffer, unsigned size, bool interpolate) const
@@ -45,6 +45,22 @@ public:
             OperationEnvironment &operation);
   ~RasterMap();
 
+private:
+  /**
+   * Load the tile cache from the #FileCache, mapping all decoded
+   * tiles into memory.
+   */
+  bool LoadCache(FileCache &cache, const TCHAR *path);
+
+  /**
+   * Convert the JPEG2000 file to a tiled cache file which can be
+   * loaded by LoadCache().
+   */
+  bool SaveCache(FileCache &cache, const TCHAR *path,
+                 OperationEnvironment &operation);
+
+public:
+
   bool IsDefined() const {
     return raster_tile_cache.GetInitialised();
   }
@@ -63,8 +79,42 @@ public:
     return GetBounds().GetCenter();
   }
 
+  /**
+   * Load the tiles around the specified location.  This is a
+   * shortcut for PrepareTiles(), DecodeTiles() and CommitTiles().
+   */
   void SetViewCenter(const GeoPoint &location, fixed radius);
 
+  /**
+   * Determine which tiles are needed around the specified location.
+   * Caller must hold an exclusive lock.
+   *
+   * @return true if DecodeTiles() and CommitTiles() shall be called
+   */
+  bool PrepareTiles(const GeoPoint &location, fixed radius);
+
+  /**
+   * Decode the tiles requested by PrepareTiles().  This may be called
+   * while other threads hold a shared lock, but not concurrently
+   * with other non-const methods.
+   */
+  void DecodeTiles();
+
+  /**
+   * Publish the tiles decoded by DecodeTiles().  Caller must hold an
+   * exclusive lock.
+   */
+  void CommitTiles();
+
+  /**
+   * Is the terrain mapped from a cache file?  In that case, this
+   * object is immutable, and it may be read from any thread without
+   * locking.  See RasterTileCache::IsMapped().
+   */
+  bool IsMapped() const {
+    return raster_tile_cache.IsMapped();
+  }
+
   /**
    * Determines if SetViewCenter() should be called again to continue
    * loading.
@@ -101,6 +151,21 @@ public:
   gcc_pure
   short GetInterpolatedHeight(const GeoPoint &location) const;
 
+  /**
+   * Determine the non-interpolated heights at many locations at
+   * once.  The result is the same as calling GetHeight() for each of
+   * them, but cheaper.
+   */
+  void GetHeights(const GeoPoint *locations, short *heights,
+                  unsigned n) const;
+
+  /**
+   * Determine the interpolated heights at many locations at once.
+   * See GetHeights().
+   */
+  void GetInterpolatedHeights(const GeoPoint *locations, short *heights,
+                              unsigned n) const;
+
   /**
    * Scan a straight line and fill the buffer with the specified
    * number of samples along the line.
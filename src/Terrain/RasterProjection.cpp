@@ -27,6 +27,10 @@ Copyright_License {
 
 #include <algorithm>
 
+#if defined(__SSE2__) && !defined(FIXED_MATH)
+#include <emmintrin.h>
+#endif
+
 void
 RasterProjection::Set(const GeoBounds &bounds,
                       unsigned width, unsigned height)
@@ -38,6 +42,45 @@ RasterProjection::Set(const GeoBounds &bounds,
   top = int(bounds.GetNorth().Native() * y_scale);
 }
 
+void
+RasterProjection::ProjectFine(const GeoPoint *locations,
+                               SignedRasterLocation *dest, unsigned n) const
+{
+#if defined(__SSE2__) && !defined(FIXED_MATH)
+  /* each GeoPoint consists of two doubles (longitude, latitude); two
+     of them are projected per iteration, and the four resulting
+     integers are stored as two SignedRasterLocation objects at once */
+  static_assert(sizeof(GeoPoint) == 2 * sizeof(double), "Wrong GeoPoint size");
+  static_assert(sizeof(SignedRasterLocation) == 2 * sizeof(int32_t),
+                "Wrong SignedRasterLocation size");
+
+  const __m128d scale = _mm_set_pd(y_scale, x_scale);
+  /* for negating the latitude lanes */
+  const __m128i negate = _mm_set_epi32(-1, 0, -1, 0);
+  const __m128i offset = _mm_set_epi32(top, -left, top, -left);
+
+  unsigned i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const __m128d a = _mm_loadu_pd((const double *)&locations[i]);
+    const __m128d b = _mm_loadu_pd((const double *)&locations[i + 1]);
+
+    /* truncate like the int cast in ProjectFine() */
+    __m128i v = _mm_unpacklo_epi64(_mm_cvttpd_epi32(_mm_mul_pd(a, scale)),
+                                   _mm_cvttpd_epi32(_mm_mul_pd(b, scale)));
+    v = _mm_sub_epi32(_mm_xor_si128(v, negate), negate);
+    v = _mm_add_epi32(v, offset);
+
+    _mm_storeu_si128((__m128i *)&dest[i], v);
+  }
+
+  if (i < n)
+    dest[i] = ProjectFine(locations[i]);
+#else
+  for (unsigned i = 0; i < n; ++i)
+    dest[i] = ProjectFine(locations[i]);
+#endif
+}
+
 fixed
 RasterProjection::FinePixelDistance(const GeoPoint &location,
                                     unsigned pixels) const
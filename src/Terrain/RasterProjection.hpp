@@ -77,6 +77,14 @@ public:
     return {x, y};
   }
 
+  /**
+   * Project many locations at once.  The result is the same as
+   * calling ProjectFine() for each of them, but this method uses
+   * SIMD instructions if available.
+   */
+  void ProjectFine(const GeoPoint *locations, SignedRasterLocation *dest,
+                   unsigned n) const;
+
   gcc_pure
   GeoPoint
   UnprojectFine(SignedRasterLocation coords) const {
@@ -23,7 +23,7 @@ Copyright_License {
 
 #include "Terrain/RasterRenderer.hpp"
 #include "Terrain/RasterMap.hpp"
-#include "Math/FastMath.h"
+#include "Terrain/SlopeShading.hpp"
 #include "Util/Clamp.hpp"
 #include "Screen/Ramp.hpp"
 #include "Screen/Layout.hpp"
@@ -34,6 +34,8 @@ Copyright_License {
 
 #include <assert.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 /**
  * Interpolate between x and y with i/128, i.e. i/(1 << 7).
@@ -94,8 +96,11 @@ RasterRenderer::RasterRenderer()
   :quantisation_pixels(2),
 #ifdef ENABLE_OPENGL
    last_quantisation_pixels(-1),
-   bounds(GeoBounds::Invalid()),
+   bounds(GeoBounds::Invalid()), scan_bounds(GeoBounds::Invalid()),
 #endif
+   last_map(nullptr),
+   scroll_x(0), scroll_y(0),
+   image_valid(false),
    image(NULL),
    contour_column_base(NULL)
 {
@@ -177,18 +182,216 @@ RasterRenderer::ScanMap(const RasterMap &map, const WindowProjection &projection
     quantisation_effective = 0;
 
 #ifdef ENABLE_OPENGL
-  bounds = projection.GetScreenBounds().Scale(fixed(1.5));
-  height_matrix.Fill(map, bounds,
-                     projection.GetScreenWidth() / quantisation_pixels,
-                     projection.GetScreenHeight() / quantisation_pixels,
-                     true);
+  const unsigned width = projection.GetScreenWidth() / quantisation_pixels;
+  const unsigned height = projection.GetScreenHeight() / quantisation_pixels;
+
+  if (!ScrollMap(map, projection.GetScreenBounds(), width, height)) {
+    bounds = scan_bounds = projection.GetScreenBounds().Scale(fixed(1.5));
+    scroll_offset.x = scroll_offset.y = 0;
+    height_matrix.Fill(map, bounds, width, height, true);
+    image_valid = false;
+  }
 
   last_quantisation_pixels = quantisation_pixels;
 #else
-  height_matrix.Fill(map, projection, quantisation_pixels, true);
+  if (!ScrollMap(map, projection)) {
+    scan_projection = projection;
+    scroll_offset.x = scroll_offset.y = 0;
+    image_offset.x = image_offset.y = 0;
+    height_matrix.Fill(map, projection, quantisation_pixels, true);
+    image_valid = false;
+  }
 #endif
+
+  last_map = &map;
+}
+
+/**
+ * Fill the strips of the #HeightMatrix which were exposed by
+ * HeightMatrix::Scroll().  The #fill function is invoked with the
+ * rectangle (x0, y0, x1, y1).
+ */
+template<typename F>
+static void
+FillExposed(unsigned width, unsigned height, int dx, int dy, F &&fill)
+{
+  unsigned y0 = 0, y1 = height;
+
+  if (dy > 0) {
+    y1 = height - dy;
+    fill(0, y1, width, height);
+  } else if (dy < 0) {
+    y0 = -dy;
+    fill(0, 0, width, y0);
+  }
+
+  if (dx > 0)
+    fill(width - dx, y0, width, y1);
+  else if (dx < 0)
+    fill(0, y0, -dx, y1);
+}
+
+#ifdef ENABLE_OPENGL
+
+/**
+ * Is the new extent close enough to the old one, so the grid of the
+ * #HeightMatrix can be reused without a visible loss of resolution?
+ */
+gcc_const
+static bool
+IsSimilarSize(Angle a, Angle b)
+{
+  const fixed delta = fabs(a.Native() - b.Native());
+  return delta * 16 <= a.Native();
+}
+
+bool
+RasterRenderer::ScrollMap(const RasterMap &map, const GeoBounds &screen_bounds,
+                          unsigned width, unsigned height)
+{
+  if (&map != last_map || !bounds.IsValid() ||
+      quantisation_pixels != last_quantisation_pixels ||
+      width != height_matrix.GetWidth() || height != height_matrix.GetHeight())
+    return false;
+
+  /* a zoom changes the size of the bounds, a translation does not */
+  const GeoBounds new_bounds = screen_bounds.Scale(fixed(1.5));
+  if (!IsSimilarSize(bounds.GetWidth(), new_bounds.GetWidth()) ||
+      !IsSimilarSize(bounds.GetHeight(), new_bounds.GetHeight()))
+    return false;
+
+  /* move by whole cells, so the old cells remain valid */
+  const Angle delta_x = scan_bounds.GetWidth() / width;
+  const Angle delta_y = scan_bounds.GetHeight() / height;
+  const RasterPoint new_offset = {
+    iround((new_bounds.GetWest() - scan_bounds.GetWest())
+           .AsDelta().Native() / delta_x.Native()),
+    iround((scan_bounds.GetNorth() - new_bounds.GetNorth())
+           .Native() / delta_y.Native()),
+  };
+
+  const int dx = new_offset.x - scroll_offset.x;
+  const int dy = new_offset.y - scroll_offset.y;
+  if (unsigned(abs(dx)) >= width || unsigned(abs(dy)) >= height)
+    return false;
+
+  const GeoPoint north_west(scan_bounds.GetWest() + delta_x * new_offset.x,
+                            scan_bounds.GetNorth() - delta_y * new_offset.y);
+  const GeoPoint south_east(north_west.longitude + scan_bounds.GetWidth(),
+                            north_west.latitude - scan_bounds.GetHeight());
+  const GeoBounds scrolled_bounds(north_west, south_east);
+  if (!scrolled_bounds.IsInside(screen_bounds))
+    return false;
+
+  bounds = scrolled_bounds;
+  scroll_offset = new_offset;
+
+  if (dx != 0 || dy != 0) {
+    height_matrix.Scroll(dx, dy);
+    FillExposed(width, height, dx, dy,
+                [this, &map](unsigned x0, unsigned y0,
+                             unsigned x1, unsigned y1){
+                  height_matrix.FillRect(map, scan_bounds,
+                                         scroll_offset.x, scroll_offset.y,
+                                         x0, y0, x1, y1, true);
+                });
+
+    scroll_x += dx;
+    scroll_y += dy;
+  }
+
+  return true;
+}
+
+#else
+
+/**
+ * Integer division which rounds towards negative infinity.
+ */
+gcc_const
+static int
+FloorDivide(int a, int b)
+{
+  assert(b > 0);
+
+  return a >= 0 ? a / b : -((b - 1 - a) / b);
 }
 
+bool
+RasterRenderer::ScrollMap(const RasterMap &map,
+                          const WindowProjection &projection)
+{
+  if (&map != last_map ||
+      projection.GetScreenWidth() != scan_projection.GetScreenWidth() ||
+      projection.GetScreenHeight() != scan_projection.GetScreenHeight() ||
+      projection.GetScale() != scan_projection.GetScale() ||
+      projection.GetScreenAngle() != scan_projection.GetScreenAngle())
+    return false;
+
+  /* where is the origin of the scanned grid now? */
+  const RasterPoint origin =
+    projection.GeoToScreen(scan_projection.ScreenToGeo(0, 0));
+
+  /* the projection is not linear: check whether the screen corners
+     have moved by the same amount (within one cell, because
+     Projection::GeoToScreen() rounds and uses approximated
+     trigonometry); if not, the view has moved too far since the last
+     full scan */
+  const int q = quantisation_pixels;
+  const int screen_width = projection.GetScreenWidth();
+  const int screen_height = projection.GetScreenHeight();
+  const RasterPoint corners[] = {
+    { screen_width, 0 },
+    { 0, screen_height },
+    { screen_width, screen_height },
+  };
+
+  for (const RasterPoint &corner : corners) {
+    const RasterPoint p =
+      projection.GeoToScreen(scan_projection.ScreenToGeo(corner));
+    if (abs(p.x - corner.x - origin.x) > q ||
+        abs(p.y - corner.y - origin.y) > q)
+      return false;
+  }
+
+  /* choose the cell offset so that the image starts at most one cell
+     left/above the screen origin */
+  const RasterPoint new_offset = {
+    FloorDivide(-origin.x, q),
+    FloorDivide(-origin.y, q),
+  };
+
+  const int dx = new_offset.x - scroll_offset.x;
+  const int dy = new_offset.y - scroll_offset.y;
+  const unsigned width = height_matrix.GetWidth();
+  const unsigned height = height_matrix.GetHeight();
+  if (unsigned(abs(dx)) >= width || unsigned(abs(dy)) >= height)
+    return false;
+
+  scroll_offset = new_offset;
+  image_offset.x = origin.x + new_offset.x * q;
+  image_offset.y = origin.y + new_offset.y * q;
+
+  if (dx != 0 || dy != 0) {
+    height_matrix.Scroll(dx, dy);
+    FillExposed(width, height, dx, dy,
+                [this, &map](unsigned x0, unsigned y0,
+                             unsigned x1, unsigned y1){
+                  height_matrix.FillRect(map, scan_projection,
+                                         quantisation_pixels,
+                                         scroll_offset.x, scroll_offset.y,
+                                         x0, y0, x1, y1, true);
+                });
+
+    scroll_x += dx;
+    scroll_y += dy;
+  }
+
+  return true;
+}
+
+#endif
+
 void
 RasterRenderer::GenerateImage(bool do_shading,
                               unsigned height_scale,
@@ -204,42 +407,152 @@ RasterRenderer::GenerateImage(bool do_shading,
 
     delete[] contour_column_base;
     contour_column_base = new unsigned char[height_matrix.GetWidth()];
+
+    image_valid = false;
   }
 
+  shading_buffer.GrowDiscard(height_matrix.GetWidth());
+
   if (quantisation_effective == 0) {
     do_shading = false;
     do_contour = false;
   }
 
-  const unsigned contour_height_scale = do_contour? height_scale * 2 : 16;
+  const ImageParameters p = {
+    do_shading, height_scale, contrast, brightness, sunazimuth,
+    do_contour ? height_scale * 2 : 16,
+    quantisation_effective,
+    do_shading ? (unsigned)pixel_size : 0,
+  };
+
+  /* contour lines depend on the pixels above and left of them, which
+     cannot be redrawn partially */
+  if (image_valid && p == last_image_parameters && !do_contour) {
+    ScrollImage(p);
+  } else {
+    GenerateImage(PixelRect(0, 0,
+                            height_matrix.GetWidth(),
+                            height_matrix.GetHeight()), p);
+
+    last_image_parameters = p;
+    image_valid = true;
+  }
+
+  scroll_x = scroll_y = 0;
+  image->SetDirty();
+}
 
-  ContourStart(contour_height_scale);
+void
+RasterRenderer::GenerateImage(const PixelRect &rc, const ImageParameters &p)
+{
+  ContourStart(p.contour_height_scale);
 
-  if (do_shading)
-    GenerateSlopeImage(height_scale, contrast, brightness,
-                       sunazimuth, contour_height_scale);
+  if (p.do_shading)
+    GenerateSlopeImage(rc, p.height_scale, p.contrast, p.brightness,
+                       p.sunazimuth, p.contour_height_scale);
   else
-    GenerateUnshadedImage(height_scale, contour_height_scale);
+    GenerateUnshadedImage(rc, p.height_scale, p.contour_height_scale);
+}
 
-  image->SetDirty();
+/**
+ * Move the rows of a #RawBitmap like HeightMatrix::Scroll().
+ */
+static void
+ScrollBitmap(RawBitmap &bitmap, unsigned width, unsigned height,
+             int dx, int dy)
+{
+  BGRColor *const top = bitmap.GetTopRow();
+  const ptrdiff_t stride = bitmap.GetNextRow(top) - top;
+
+  const unsigned n = width - abs(dx);
+  const unsigned dest_x = std::max(-dx, 0), src_x = std::max(dx, 0);
+  const unsigned n_rows = height - abs(dy);
+
+  if (dy >= 0) {
+    for (unsigned y = 0; y < n_rows; ++y)
+      memmove(top + y * stride + dest_x, top + (y + dy) * stride + src_x,
+              n * sizeof(*top));
+  } else {
+    for (unsigned y = height; y-- > unsigned(-dy);)
+      memmove(top + y * stride + dest_x, top + (y + dy) * stride + src_x,
+              n * sizeof(*top));
+  }
+}
+
+void
+RasterRenderer::GenerateImageClipped(PixelRect rc, const ImageParameters &p)
+{
+  rc.left = std::max(rc.left, 0);
+  rc.top = std::max(rc.top, 0);
+  rc.right = std::min(rc.right, int(height_matrix.GetWidth()));
+  rc.bottom = std::min(rc.bottom, int(height_matrix.GetHeight()));
+
+  if (rc.left < rc.right && rc.top < rc.bottom)
+    GenerateImage(rc, p);
+}
+
+void
+RasterRenderer::ScrollImage(const ImageParameters &p)
+{
+  if (scroll_x == 0 && scroll_y == 0)
+    return;
+
+  const int width = height_matrix.GetWidth();
+  const int height = height_matrix.GetHeight();
+
+  if (abs(scroll_x) >= width || abs(scroll_y) >= height) {
+    GenerateImage(PixelRect(0, 0, width, height), p);
+    return;
+  }
+
+  ScrollBitmap(*image, width, height, scroll_x, scroll_y);
+
+  /* the slope of a pixel depends on its neighbours up to
+     #quantisation_effective cells away, and pixels at the edge are
+     calculated differently; therefore the bands along the exposed
+     strips and along all edges are redrawn as well */
+  const int margin = p.quantisation_effective;
+
+  if (scroll_y > 0) {
+    GenerateImageClipped(PixelRect(0, 0, width, margin), p);
+    GenerateImageClipped(PixelRect(0, height - scroll_y - margin,
+                                   width, height), p);
+  } else if (scroll_y < 0) {
+    GenerateImageClipped(PixelRect(0, 0, width, -scroll_y + margin), p);
+    GenerateImageClipped(PixelRect(0, height - margin,
+                                   width, height), p);
+  }
+
+  if (scroll_x > 0) {
+    GenerateImageClipped(PixelRect(0, 0, margin, height), p);
+    GenerateImageClipped(PixelRect(width - scroll_x - margin, 0,
+                                   width, height), p);
+  } else if (scroll_x < 0) {
+    GenerateImageClipped(PixelRect(0, 0, -scroll_x + margin, height), p);
+    GenerateImageClipped(PixelRect(width - margin, 0,
+                                   width, height), p);
+  }
 }
 
 void
-RasterRenderer::GenerateUnshadedImage(unsigned height_scale,
+RasterRenderer::GenerateUnshadedImage(const PixelRect &rc,
+                                      unsigned height_scale,
                                       const unsigned contour_height_scale)
 {
-  const short *src = height_matrix.GetData();
   const BGRColor *oColorBuf = color_table + 64 * 256;
   BGRColor *dest = image->GetTopRow();
+  for (int y = 0; y < rc.top; ++y)
+    dest = image->GetNextRow(dest);
 
-  for (unsigned y = height_matrix.GetHeight(); y > 0; --y) {
-    BGRColor *p = dest;
+  for (int y = rc.top; y < rc.bottom; ++y) {
+    const short *src = height_matrix.GetRow(y) + rc.left;
+    BGRColor *p = dest + rc.left;
     dest = image->GetNextRow(dest);
 
     unsigned contour_row_base = ContourInterval(*src, contour_height_scale);
-    unsigned char *contour_this_column_base = contour_column_base;
+    unsigned char *contour_this_column_base = contour_column_base + rc.left;
 
-    for (unsigned x = height_matrix.GetWidth(); x > 0; --x) {
+    for (int x = rc.left; x < rc.right; ++x) {
       int h = *src++;
       if (gcc_likely(!RasterBuffer::IsSpecial(h))) {
         if (h < 0)
@@ -270,26 +583,14 @@ RasterRenderer::GenerateUnshadedImage(unsigned height_scale,
   }
 }
 
-/**
- * Clip the difference between two adjacent terrain height values to
- * sane bounds.  This works around integer overflows in the
- * GenerateSlopeImage() formula when the map file is broken, avoiding
- * the sqrt() call with a negative argument.
- */
-gcc_const
-static int
-ClipHeightDelta(int d)
-{
-  return Clamp(d, -512, 512);
-}
-
 // JMW: if zoomed right in (e.g. one unit is larger than terrain
 // grid), then increase the step size to be equal to the terrain
 // grid for purposes of calculating slope, to avoid shading problems
 // (gridding of display) This is why quantisation_effective is used instead of 1
 // previously.  for large zoom levels, quantisation_effective=1
 void
-RasterRenderer::GenerateSlopeImage(unsigned height_scale,
+RasterRenderer::GenerateSlopeImage(const PixelRect &rc,
+                                   unsigned height_scale,
                                    int contrast,
                                    const int sx, const int sy, const int sz,
                                    const unsigned contour_height_scale)
@@ -309,12 +610,19 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
              square will not overflow */
           8192u / (quantisation_effective * quantisation_effective));
 
-  const short *src = height_matrix.GetData();
   const BGRColor *oColorBuf = color_table + 64 * 256;
 
   BGRColor *dest = image->GetTopRow();
+  for (int y = 0; y < rc.top; ++y)
+    dest = image->GetNextRow(dest);
+
+  /* the part of the rectangle which can be shaded by
+     SlopeShadingRow() */
+  const int interior_left = std::max(rc.left, border.left);
+  const int interior_right = std::min(rc.right, border.right);
 
-  for (unsigned y = 0; y < height_matrix.GetHeight(); ++y) {
+  for (unsigned y = rc.top; y < (unsigned)rc.bottom; ++y) {
+    const short *src = height_matrix.GetRow(y) + rc.left;
     const unsigned row_plus_index = y < (unsigned)border.bottom
       ? quantisation_effective
       : height_matrix.GetHeight() - 1 - y;
@@ -324,15 +632,29 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
       ? quantisation_effective : y;
     const unsigned row_minus_offset = height_matrix.GetWidth() * row_minus_index;
 
-    const unsigned p31 = row_plus_index + row_minus_index;
-
-    BGRColor *p = dest;
+    const SlopeShadingParameters params = {
+      sx, sy, sz, contrast, height_slope_factor,
+      row_plus_index + row_minus_index,
+    };
+
+    /* calculate the illumination of all pixels whose left and right
+       neighbours are both quantisation_effective away in one pass;
+       the border columns are calculated below */
+    int *const shading_row = shading_buffer.begin();
+    if (interior_right > interior_left)
+      SlopeShadingRow(src + (interior_left - rc.left),
+                      interior_right - interior_left,
+                      quantisation_effective,
+                      row_minus_offset, row_plus_offset,
+                      params, shading_row + interior_left);
+
+    BGRColor *p = dest + rc.left;
     dest = image->GetNextRow(dest);
 
     unsigned contour_row_base = ContourInterval(*src, contour_height_scale);
-    unsigned char *contour_this_column_base = contour_column_base;
+    unsigned char *contour_this_column_base = contour_column_base + rc.left;
 
-    for (unsigned x = 0; x < height_matrix.GetWidth(); ++x, ++src) {
+    for (unsigned x = rc.left; x < (unsigned)rc.right; ++x, ++src) {
       int h = *src;
       if (gcc_likely(!RasterBuffer::IsSpecial(h))) {
         if (h < 0)
@@ -388,29 +710,13 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
           continue;
         }
 
-        const int p32 = ClipHeightDelta(h_above - h_below);
-        const int p22 = ClipHeightDelta(h_right - h_left);
-
-        const unsigned p20 = column_plus_index + column_minus_index;
-
-        const int dd0 = p22 * int(p31);
-        const int dd1 = int(p20) * p32;
-        const unsigned dd2 = p20 * p31 * height_slope_factor;
-        const int num = (int(dd2) * sz + dd0 * sx + dd1 * sy);
-        const unsigned square_mag = dd0 * dd0 + dd1 * dd1 + dd2 * dd2;
-#ifdef FIXED_MATH
-        const unsigned mag = isqrt4(square_mag);
-#else
-        const unsigned mag = (unsigned)sqrt((fixed)square_mag);
-#endif
-        /* this is a workaround for a SIGFPE (division by zero)
-           observed by our users on some Android devices (e.g. Nexus
-           7), even though we did our best to make sure that the
-           integer arithmetics above can't overflow */
-        /* TODO: debug this problem and replace this workaround */
-        const int sval = num / int(mag|1);
-        const int sindex = (sval - sz) * contrast / 128;
-        *p++ = oColorBuf[h + 256 * Clamp(sindex, -63, 63)];
+        const int sindex = x >= (unsigned)border.left &&
+          x < (unsigned)border.right
+          ? shading_row[x]
+          : SlopeShadingIndex(h_above, h_below, h_left, h_right,
+                              column_plus_index + column_minus_index,
+                              params);
+        *p++ = oColorBuf[h + 256 * sindex];
       } else if (RasterBuffer::IsWater(h)) {
         // we're in the water, so look up the color for water
         *p++ = oColorBuf[255];
@@ -425,7 +731,7 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
 }
 
 void
-RasterRenderer::GenerateSlopeImage(unsigned height_scale,
+RasterRenderer::GenerateSlopeImage(const PixelRect &rc, unsigned height_scale,
                                    int contrast, int brightness,
                                    const Angle sunazimuth,
                                    const unsigned contour_height_scale)
@@ -437,7 +743,7 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
   const int sy = (int)(255 * fudgeelevation.fastcosine() * -sunazimuth.fastcosine());
   const int sz = (int)(255 * fudgeelevation.fastsine());
 
-  GenerateSlopeImage(height_scale, contrast,
+  GenerateSlopeImage(rc, height_scale, contrast,
                      sx, sy, sz, contour_height_scale);
 }
 
@@ -445,6 +751,8 @@ void
 RasterRenderer::PrepareColorTable(const ColorRamp *color_ramp, bool do_water,
                                   unsigned height_scale, int interp_levels)
 {
+  image_valid = false;
+
   for (int i = 0; i < 256; i++) {
     for (int mag = -64; mag < 64; mag++) {
       BGRColor color;
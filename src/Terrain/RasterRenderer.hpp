@@ -28,18 +28,23 @@ Copyright_License {
 #include "Screen/RawBitmap.hpp"
 #include "Math/fixed.hpp"
 #include "Util/NonCopyable.hpp"
+#include "Util/AllocatedArray.hpp"
+#include "Math/Angle.hpp"
+#include "Screen/Point.hpp"
 
 #ifdef ENABLE_OPENGL
 #include "Geo/GeoBounds.hpp"
+#else
+#include "Projection/WindowProjection.hpp"
 #endif
 
 #define NUM_COLOR_RAMP_LEVELS 13
 
-class Angle;
 class Canvas;
 class RasterMap;
 class WindowProjection;
 struct ColorRamp;
+struct PixelRect;
 
 class RasterRenderer : private NonCopyable {
   /** screen dimensions in coarse pixels */
@@ -66,13 +71,94 @@ class RasterRenderer : private NonCopyable {
    * texture has to be redrawn.
    */
   GeoBounds bounds;
+
+  /**
+   * The bounds which were used by the last full scan.  After
+   * scrolling, the #HeightMatrix is still aligned to its grid, see
+   * #scroll_offset.
+   */
+  GeoBounds scan_bounds;
+#else
+  /**
+   * The projection which was used by the last full scan.  After
+   * scrolling, the #HeightMatrix is still aligned to its pixel grid,
+   * see #scroll_offset.
+   */
+  WindowProjection scan_projection;
 #endif
 
+  /**
+   * The position of the #HeightMatrix origin in the grid of the last
+   * full scan, in cells.
+   */
+  RasterPoint scroll_offset;
+
+#ifndef ENABLE_OPENGL
+  /**
+   * The screen position where the #image has to be drawn.  This is
+   * at most one cell left/above the screen origin.
+   */
+  RasterPoint image_offset;
+#endif
+
+  /**
+   * The map which was scanned by the last ScanMap() call.  The
+   * #HeightMatrix can only be scrolled if this does not change.
+   * nullptr means the #HeightMatrix is invalid.
+   */
+  const RasterMap *last_map;
+
+  /**
+   * The number of cells the #HeightMatrix has been scrolled since the
+   * last GenerateImage() call.  Only the exposed strips have to be
+   * redrawn.
+   */
+  int scroll_x, scroll_y;
+
+  /**
+   * The parameters of a GenerateImage() call.  If they have not
+   * changed, the #image can be scrolled together with the
+   * #HeightMatrix.
+   */
+  struct ImageParameters {
+    bool do_shading;
+    unsigned height_scale;
+    int contrast, brightness;
+    Angle sunazimuth;
+    unsigned contour_height_scale;
+    unsigned quantisation_effective;
+    unsigned pixel_size;
+
+    bool operator==(const ImageParameters &other) const {
+      return do_shading == other.do_shading &&
+        height_scale == other.height_scale &&
+        contrast == other.contrast && brightness == other.brightness &&
+        sunazimuth == other.sunazimuth &&
+        contour_height_scale == other.contour_height_scale &&
+        quantisation_effective == other.quantisation_effective &&
+        pixel_size == other.pixel_size;
+    }
+  };
+
+  ImageParameters last_image_parameters;
+
+  /**
+   * Does the #image contain the #HeightMatrix (before scrolling it by
+   * #scroll_x and #scroll_y), rendered with #last_image_parameters?
+   */
+  bool image_valid;
+
   HeightMatrix height_matrix;
   RawBitmap *image;
 
   unsigned char *contour_column_base;
 
+  /**
+   * The illumination index of each pixel in the current row, see
+   * SlopeShadingRow().
+   */
+  AllocatedArray<int> shading_buffer;
+
   fixed pixel_size;
 
   BGRColor color_table[256 * 128];
@@ -93,11 +179,20 @@ public:
     return height_matrix.GetHeight();
   }
 
-#ifdef ENABLE_OPENGL
+  /**
+   * Discard the #HeightMatrix, so the next ScanMap() call scans the
+   * whole map.  This must be called when the contents of the
+   * #RasterMap change.
+   */
   void Invalidate() {
+#ifdef ENABLE_OPENGL
     bounds.SetInvalid();
+#endif
+    last_map = nullptr;
   }
 
+#ifdef ENABLE_OPENGL
+
   /**
    * Calculate a new #quantisation_pixels value.
    *
@@ -109,9 +204,18 @@ public:
   const GeoBounds &GetBounds() const {
     return bounds;
   }
+#else
+  unsigned GetQuantisationPixels() const {
+    return quantisation_pixels;
+  }
 
-  const GLTexture &BindAndGetTexture() const {
-    return image->BindAndGetTexture();
+  /**
+   * Returns the screen position of the top left corner of the image.
+   * Each cell of the #HeightMatrix covers #quantisation_pixels
+   * screen pixels.
+   */
+  RasterPoint GetImageOffset() const {
+    return image_offset;
   }
 #endif
 
@@ -124,7 +228,9 @@ public:
                          unsigned height_scale, int interp_levels);
 
   /**
-   * Scan the map and fill the height matrix.
+   * Scan the map and fill the height matrix.  If the projection has
+   * only moved since the last call, the height matrix is scrolled,
+   * and only the exposed strips are scanned.
    */
   void ScanMap(const RasterMap &map, const WindowProjection &projection);
 
@@ -142,27 +248,60 @@ public:
 
 protected:
   /**
-   * Convert the height matrix into the image, without shading.
+   * Convert a rectangle of the height matrix into the image, without
+   * shading.
    */
-  void GenerateUnshadedImage(unsigned height_scale,
+  void GenerateUnshadedImage(const PixelRect &rc, unsigned height_scale,
                              const unsigned contour_height_scale);
 
   /**
-   * Convert the height matrix into the image, with slope shading.
+   * Convert a rectangle of the height matrix into the image, with
+   * slope shading.
    */
-  void GenerateSlopeImage(unsigned height_scale, int contrast,
+  void GenerateSlopeImage(const PixelRect &rc,
+                          unsigned height_scale, int contrast,
                           const int sx, const int sy, const int sz,
                           const unsigned contour_height_scale);
 
   /**
-   * Convert the height matrix into the image, with slope shading.
+   * Convert a rectangle of the height matrix into the image, with
+   * slope shading.
    */
-  void GenerateSlopeImage(unsigned height_scale,
+  void GenerateSlopeImage(const PixelRect &rc, unsigned height_scale,
                           int contrast, int brightness,
                           const Angle sunazimuth,
                           const unsigned contour_height_scale);
 
+  /**
+   * Convert a rectangle of the height matrix into the image.
+   */
+  void GenerateImage(const PixelRect &rc, const ImageParameters &p);
+
+  /**
+   * Like GenerateImage(), but clip the rectangle to the
+   * #HeightMatrix first.
+   */
+  void GenerateImageClipped(PixelRect rc, const ImageParameters &p);
+
 private:
+  /**
+   * Attempt to reuse the current #HeightMatrix for the given view by
+   * scrolling it.  Returns false if the view is not a translation of
+   * the previous one; the caller must scan the whole map then.
+   */
+#ifdef ENABLE_OPENGL
+  bool ScrollMap(const RasterMap &map, const GeoBounds &screen_bounds,
+                 unsigned width, unsigned height);
+#else
+  bool ScrollMap(const RasterMap &map, const WindowProjection &projection);
+#endif
+
+  /**
+   * Redraw the parts of the #image which are affected by scrolling
+   * the #HeightMatrix by #scroll_x and #scroll_y.
+   */
+  void ScrollImage(const ImageParameters &p);
+
 
   void ContourStart(const unsigned contour_height_scale);
 };
@@ -55,3 +55,26 @@ RasterTerrain::OpenTerrain(FileCache *cache, OperationEnvironment &operation)
 
   return rt;
 }
+
+bool
+RasterTerrain::UpdateTiles(const GeoPoint &location, fixed radius)
+{
+  if (map.IsMapped())
+    /* all tiles are already loaded, and locking would only
+       disturb the readers */
+    return false;
+
+  {
+    ExclusiveLease lease(*this);
+    if (!lease->PrepareTiles(location, radius))
+      return lease->IsDirty();
+  }
+
+  /* the expensive part: other threads may read the map meanwhile,
+     because DecodeTiles() does not modify anything they see */
+  map.DecodeTiles();
+
+  ExclusiveLease lease(*this);
+  lease->CommitTiles();
+  return lease->IsDirty();
+}
@@ -27,6 +27,7 @@ Copyright_License {
 #include "RasterMap.hpp"
 #include "Geo/GeoPoint.hpp"
 #include "Thread/Guard.hpp"
+#include "Util/tstring.hpp"
 #include "Compiler.h"
 
 #include <tchar.h>
@@ -49,17 +50,66 @@ public:
   static constexpr short TERRAIN_INVALID = RasterBuffer::TERRAIN_INVALID;
 
 protected:
+  /**
+   * The path of the JPEG2000 file.
+   */
+  const tstring path;
+
   RasterMap map;
 
 public:
+  /**
+   * A read-only lease on the #RasterMap.  Unlike Guard::Lease, this
+   * does not lock if the map is mapped from the cache file: then all
+   * tiles are loaded at startup and the map never changes, so
+   * concurrent readers do not need to be serialised with the loader.
+   */
+  class Lease {
+    const RasterTerrain &terrain;
+
+    /**
+     * Was the read lock obtained?  This is decided once in the
+     * constructor; RasterMap::IsMapped() does not change after
+     * construction.
+     */
+    const bool locked;
+
+  public:
+    explicit Lease(const RasterTerrain &_terrain)
+      :terrain(_terrain), locked(!_terrain.map.IsMapped()) {
+      if (locked)
+        terrain.mutex.readLock();
+    }
+
+    ~Lease() {
+      if (locked)
+        terrain.mutex.unlock();
+    }
+
+    Lease(const Lease &) = delete;
+    Lease &operator=(const Lease &) = delete;
+
+    operator const RasterMap&() const {
+      return terrain.map;
+    }
+
+    const RasterMap *operator->() const {
+      return &terrain.map;
+    }
+  };
 
 /** 
  * Constructor.  Returns uninitialised object. 
  * 
  */
-  RasterTerrain(const TCHAR *path, const TCHAR *world_file, FileCache *cache,
-                OperationEnvironment &operation)
-    :Guard<RasterMap>(map), map(path, world_file, cache, operation) {}
+  RasterTerrain(const TCHAR *_path, const TCHAR *world_file,
+                FileCache *cache, OperationEnvironment &operation)
+    :Guard<RasterMap>(map), path(_path),
+     map(_path, world_file, cache, operation) {}
+
+  const TCHAR *GetPath() const {
+    return path.c_str();
+  }
 
   const Serial &GetSerial() const {
     return map.GetSerial();
@@ -72,12 +122,33 @@ public:
   static RasterTerrain *OpenTerrain(FileCache *cache,
                                     OperationEnvironment &operation);
 
+  /**
+   * Load the tiles around the specified location.  The tiles are
+   * decoded without holding the lock, so readers are blocked only
+   * briefly.  This method must not be called by more than one thread
+   * at a time.
+   *
+   * @return true if there are more tiles to be loaded, and this
+   * method should be called again soon
+   */
+  bool UpdateTiles(const GeoPoint &location, fixed radius);
+
   gcc_pure
   short GetTerrainHeight(const GeoPoint location) const {
     Lease lease(*this);
     return lease->GetHeight(location);
   }
 
+  /**
+   * Determine the terrain heights at many locations at once, with
+   * only one lease.  See RasterMap::GetHeights().
+   */
+  void GetTerrainHeights(const GeoPoint *locations, short *heights,
+                         unsigned n) const {
+    Lease lease(*this);
+    lease->GetHeights(locations, heights, n);
+  }
+
   /**
    * Wrapper for GetTerrainHeight() that replaces "special" values
    * with 0.  This is used when we need some "valid" value (and not
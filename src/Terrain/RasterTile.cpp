@@ -50,14 +50,25 @@ RasterTile::LoadCache(FILE *file)
   return true;
 }
 
-void
-RasterTile::Enable()
+short *
+RasterTile::AllocateDecodeBuffer()
 {
-  if (!width || !height) {
-    Disable();
-  } else {
-    buffer.Resize(width, height);
-  }
+  if (!IsDefined())
+    return nullptr;
+
+  decode_buffer.Resize(width, height);
+  return decode_buffer.GetData();
+}
+
+bool
+RasterTile::CommitDecodeBuffer()
+{
+  if (!decode_buffer.IsDefined())
+    return false;
+
+  buffer = std::move(decode_buffer);
+  decode_buffer.Reset();
+  return true;
 }
 
 short
@@ -27,6 +27,7 @@ Copyright_License {
 #include "Terrain/RasterBuffer.hpp"
 #include "Util/NonCopyable.hpp"
 
+#include <assert.h>
 #include <stdio.h>
 
 class RasterTile : private NonCopyable {
@@ -48,6 +49,13 @@ public:
 
   RasterBuffer buffer;
 
+  /**
+   * The buffer which is being filled by the decoder.  It is moved to
+   * #buffer by CommitDecodeBuffer(), which allows decoding without
+   * holding a lock that blocks readers.
+   */
+  RasterBuffer decode_buffer;
+
 public:
   RasterTile()
     :xstart(0), ystart(0), xend(0), yend(0),
@@ -100,7 +108,33 @@ public:
     buffer.Reset();
   }
 
-  void Enable();
+  /**
+   * Allocate #decode_buffer, to be filled by the decoder.
+   *
+   * @return a pointer to the buffer or nullptr if this tile has no
+   * data
+   */
+  short *AllocateDecodeBuffer();
+
+  /**
+   * Make the decoded data visible to readers.
+   *
+   * @return true if the tile has been enabled, false if there was no
+   * decoded data
+   */
+  bool CommitDecodeBuffer();
+
+  /**
+   * Enable this tile without allocating a buffer; it will refer to
+   * the specified (already decoded) height values instead, e.g. in
+   * a mapped cache file.  The caller is responsible for keeping the
+   * memory valid until Disable() is called.
+   */
+  void EnableExternal(const short *data) {
+    assert(IsDefined());
+
+    buffer.SetExternal(data, width, height);
+  }
   bool IsEnabled() const {
     return buffer.IsDefined();
   }
@@ -131,10 +165,6 @@ public:
   short GetInterpolatedHeight(unsigned x, unsigned y,
                               unsigned ix, unsigned iy) const;
 
-  inline short* GetImageBuffer() {
-    return buffer.GetData();
-  }
-
   bool VisibilityChanged(int view_x, int view_y, unsigned view_radius);
 
   void ScanLine(unsigned ax, unsigned ay, unsigned bx, unsigned by,
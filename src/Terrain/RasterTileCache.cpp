@@ -27,24 +27,38 @@ Copyright_License {
 #include "Math/Angle.hpp"
 #include "IO/ZipLineReader.hpp"
 #include "Operation/Operation.hpp"
+#include "OS/FileMapping.hpp"
+#include "Thread/Mutex.hpp"
+#include "Util/AllocatedArray.hpp"
 #include "Math/FastMath.h"
 
 #include <string.h>
 #include <algorithm>
 
+RasterTileCache::~RasterTileCache()
+{
+  delete mapping;
+}
+
 short*
 RasterTileCache::GetImageBuffer(unsigned index)
 {
-  if (TileRequest(index))
-    return tiles.GetLinear(index).GetImageBuffer();
+  RasterTile &tile = tiles.GetLinear(index);
+  if (!tile.IsRequested())
+    return NULL;
 
-  return NULL;
+  return tile.AllocateDecodeBuffer();
 }
 
 void
 RasterTileCache::SetTile(unsigned index,
                          int xstart, int ystart, int xend, int yend)
 {
+  if (!scan_overview)
+    /* the tile layout is already known; don't modify it while
+       DecodeTiles() runs concurrently with readers */
+    return;
+
   if (!segments.empty() && !segments.last().IsTileSegment())
     /* link current marker segment with this tile */
     segments.last().tile = index;
@@ -68,7 +82,8 @@ struct RTDistanceSort {
 bool
 RasterTileCache::PollTiles(int x, int y, unsigned radius)
 {
-  if (scan_overview)
+  if (scan_overview || IsMapped())
+    /* mapped tiles are always enabled; nothing to load */
     return false;
 
   /* tiles are usually 256 pixels wide; with a radius smaller than
@@ -93,13 +108,13 @@ RasterTileCache::PollTiles(int x, int y, unsigned radius)
     if (tiles.GetLinear(i).VisibilityChanged(x, y, radius))
       request_tiles.append(i);
 
+  /* sort by distance, to load the nearest tiles first */
+  const RTDistanceSort sort(*this);
+  std::sort(request_tiles.begin(), request_tiles.end(), sort);
+
   /* reduce if there are too many */
 
   if (request_tiles.size() > MAX_ACTIVE_TILES) {
-    /* sort by distance */
-    const RTDistanceSort sort(*this);
-    std::sort(request_tiles.begin(), request_tiles.end(), sort);
-
     /* dispose all tiles which are out of range */
     for (unsigned i = MAX_ACTIVE_TILES; i < request_tiles.size(); ++i) {
       RasterTile &tile = tiles.GetLinear(request_tiles[i]);
@@ -130,16 +145,17 @@ RasterTileCache::PollTiles(int x, int y, unsigned radius)
   return num_activate > 0;
 }
 
-bool
-RasterTileCache::TileRequest(unsigned index)
+unsigned
+RasterTileCache::SelectLevel(unsigned spacing) const
 {
-  RasterTile &tile = tiles.GetLinear(index);
+  if (!HasPyramid())
+    return 0;
 
-  if (!tile.IsRequested())
-    return false;
+  unsigned level = 0;
+  while (level < OVERVIEW_BITS && (2u << level) <= spacing)
+    ++level;
 
-  tile.Enable();
-  return true; // want to load this one!
+  return level;
 }
 
 short
@@ -178,11 +194,76 @@ RasterTileCache::GetInterpolatedHeight(unsigned int lx, unsigned int ly) const
                                    ly >> OVERVIEW_BITS);
 }
 
+/**
+ * Is the given pixel inside the tile?
+ */
+gcc_pure
+static inline bool
+IsInsideTile(const RasterTile &tile, unsigned px, unsigned py)
+{
+  return px - tile.xstart < tile.width && py - tile.ystart < tile.height;
+}
+
+void
+RasterTileCache::GetHeights(const SignedRasterLocation *locations,
+                            short *heights, unsigned n) const
+{
+  /* remember the most recent tile; it usually contains the next
+     location, too, which saves the tile lookup */
+  const RasterTile *tile = nullptr;
+
+  for (unsigned i = 0; i < n; ++i) {
+    const unsigned px = locations[i].x, py = locations[i].y;
+    if (px >= width || py >= height) {
+      heights[i] = RasterBuffer::TERRAIN_INVALID;
+      continue;
+    }
+
+    if (tile == nullptr || !IsInsideTile(*tile, px, py))
+      tile = &tiles.Get(px / tile_width, py / tile_height);
+
+    heights[i] = tile->IsEnabled()
+      ? tile->GetHeight(px, py)
+      : overview.GetInterpolated(px << (SUBPIXEL_BITS - OVERVIEW_BITS),
+                                 py << (SUBPIXEL_BITS - OVERVIEW_BITS));
+  }
+}
+
+void
+RasterTileCache::GetInterpolatedHeights(const SignedRasterLocation *locations,
+                                        short *heights, unsigned n) const
+{
+  const RasterTile *tile = nullptr;
+
+  for (unsigned i = 0; i < n; ++i) {
+    const unsigned lx = locations[i].x, ly = locations[i].y;
+    if (lx >= overview_width_fine || ly >= overview_height_fine) {
+      heights[i] = RasterBuffer::TERRAIN_INVALID;
+      continue;
+    }
+
+    const unsigned px = lx >> SUBPIXEL_BITS, py = ly >> SUBPIXEL_BITS;
+    const unsigned ix = lx & ((1 << SUBPIXEL_BITS) - 1);
+    const unsigned iy = ly & ((1 << SUBPIXEL_BITS) - 1);
+
+    if (tile == nullptr || !IsInsideTile(*tile, px, py))
+      tile = &tiles.Get(px / tile_width, py / tile_height);
+
+    heights[i] = tile->IsEnabled()
+      ? tile->GetInterpolatedHeight(px, py, ix, iy)
+      : overview.GetInterpolated(lx >> OVERVIEW_BITS, ly >> OVERVIEW_BITS);
+  }
+}
+
 void
 RasterTileCache::SetSize(unsigned _width, unsigned _height,
                          unsigned _tile_width, unsigned _tile_height,
                          unsigned tile_columns, unsigned tile_rows)
 {
+  if (!scan_overview)
+    /* the size is already known; see SetTile() */
+    return;
+
   width = _width;
   height = _height;
   tile_width = _tile_width;
@@ -223,8 +304,14 @@ RasterTileCache::Reset()
 
   overview.Reset();
 
+  for (auto &i : pyramid)
+    i.Reset();
+
   for (auto it = tiles.begin(), end = tiles.end(); it != end; ++it)
     it->Disable();
+
+  delete mapping;
+  mapping = nullptr;
 }
 
 gcc_pure
@@ -324,24 +411,32 @@ RasterTileCache::MarkerSegment(long file_offset, unsigned id)
 
 extern RasterTileCache *raster_tile_current;
 
-void
+/**
+ * Protects #raster_tile_current, which is used by the libjasper
+ * callbacks.  Terrain and weather maps may be decoded by different
+ * threads.
+ */
+static Mutex jasper_mutex;
+
+bool
 RasterTileCache::LoadJPG2000(const char *jp2_filename)
 {
+  const ScopeLock protect(jasper_mutex);
+
   jas_stream_t *in;
 
   raster_tile_current = this;
 
   in = jas_stream_fopen(jp2_filename, "rb");
-  if (!in) {
-    Reset();
-    return;
-  }
+  if (!in)
+    return false;
 
   if (operation != NULL)
     operation->SetProgressRange(jas_stream_length(in) / 65536);
 
   jp2_decode(in, scan_overview ? "xcsoar=2" : "xcsoar=1");
   jas_stream_close(in);
+  return true;
 }
 
 bool
@@ -413,7 +508,8 @@ RasterTileCache::LoadOverview(const char *path, const TCHAR *world_file,
 
   Reset();
 
-  LoadJPG2000(path);
+  if (!LoadJPG2000(path))
+    initialised = false;
   scan_overview = false;
 
   if (initialised && world_file != NULL)
@@ -429,36 +525,185 @@ RasterTileCache::LoadOverview(const char *path, const TCHAR *world_file,
   return initialised;
 }
 
+bool
+RasterTileCache::PrepareTiles(int x, int y, unsigned radius)
+{
+  return PollTiles(x, y, radius);
+}
+
 void
-RasterTileCache::UpdateTiles(const char *path, int x, int y, unsigned radius)
+RasterTileCache::DecodeTiles(const char *path)
 {
-  if (!PollTiles(x, y, radius))
-    return;
+  assert(!IsMapped());
 
   remaining_segments = 0;
 
   LoadJPG2000(path);
+}
 
-  /* permanently disable the requested tiles which are still not
-     loaded, to prevent trying to reload them over and over in a busy
-     loop */
+void
+RasterTileCache::CommitTiles()
+{
   for (auto it = request_tiles.begin(), end = request_tiles.end();
       it != end; ++it) {
     RasterTile &tile = tiles.GetLinear(*it);
-    if (tile.IsRequested() && !tile.IsEnabled())
+    if (!tile.IsRequested())
+      continue;
+
+    if (!tile.CommitDecodeBuffer())
+      /* permanently disable the requested tiles which are still not
+         loaded, to prevent trying to reload them over and over in a
+         busy loop */
       tile.Clear();
+
+    tile.ClearRequest();
   }
 
   ++serial;
 }
 
+void
+RasterTileCache::UpdateTiles(const char *path, int x, int y, unsigned radius)
+{
+  if (!PrepareTiles(x, y, radius))
+    return;
+
+  DecodeTiles(path);
+  CommitTiles();
+}
+
+/**
+ * Calculate the number of bytes occupied by the decoded tiles in the
+ * cache file.
+ */
+gcc_pure
+static size_t
+TileDataSize(const AllocatedGrid<RasterTile> &tiles)
+{
+  size_t size = 0;
+  for (auto it = tiles.begin(), end = tiles.end(); it != end; ++it)
+    if (it->IsDefined())
+      size += it->width * it->height * sizeof(short);
+  return size;
+}
+
+/**
+ * Calculate the number of bytes occupied by the pyramid levels in the
+ * cache file.
+ */
+gcc_const
+static size_t
+PyramidDataSize(unsigned width, unsigned height, unsigned levels)
+{
+  size_t size = 0;
+  for (unsigned level = 1; level <= levels; ++level)
+    size += (width >> level) * (height >> level) * sizeof(short);
+  return size;
+}
+
+/**
+ * Calculate the mean of four samples, ignoring "special" values
+ * (water, invalid).  If all of them are special, the first one is
+ * returned.
+ */
+gcc_const
+static short
+MeanHeight(short a, short b, short c, short d)
+{
+  int sum = 0;
+  unsigned n = 0;
+
+  for (const short h : {a, b, c, d}) {
+    if (!RasterBuffer::IsSpecial(h)) {
+      sum += h;
+      ++n;
+    }
+  }
+
+  return n > 0 ? short(sum / (int)n) : a;
+}
+
+/**
+ * Reduce the resolution of a grid by 2 in both directions.
+ *
+ * @param width the width of the destination grid
+ * @param height the height of the destination grid
+ */
+static void
+HalveGrid(short *dest, const short *src, unsigned src_width,
+          unsigned width, unsigned height)
+{
+  for (unsigned y = 0; y < height; ++y) {
+    const short *a = src + 2 * y * src_width, *b = a + src_width;
+    for (unsigned x = 0; x < width; ++x, a += 2, b += 2)
+      *dest++ = MeanHeight(a[0], a[1], b[0], b[1]);
+  }
+}
+
+bool
+RasterTileCache::CanBuildPyramid() const
+{
+  constexpr unsigned block = 1u << PYRAMID_LEVELS;
+
+  if (tile_width % block != 0 || tile_height % block != 0)
+    return false;
+
+  for (auto it = tiles.begin(), end = tiles.end(); it != end; ++it)
+    if (!it->IsDefined() ||
+        it->xstart % block != 0 || it->ystart % block != 0)
+      return false;
+
+  return true;
+}
+
+bool
+RasterTileCache::SavePyramidTile(FILE *file, const RasterTile &tile,
+                                 const long *level_offsets) const
+{
+  const unsigned buffer_size = (tile.width / 2) * (tile.height / 2);
+  AllocatedArray<short> buffer(buffer_size), previous(buffer_size);
+
+  const short *src = tile.buffer.GetData();
+  unsigned src_width = tile.width;
+
+  for (unsigned level = 1; level <= PYRAMID_LEVELS; ++level) {
+    const unsigned level_width = tile.width >> level;
+    const unsigned level_height = tile.height >> level;
+    if (level_width == 0 || level_height == 0)
+      break;
+
+    HalveGrid(buffer.begin(), src, src_width, level_width, level_height);
+
+    /* copy each row to its position within the level */
+    const unsigned map_width = width >> level;
+    const unsigned x = tile.xstart >> level, y = tile.ystart >> level;
+    for (unsigned row = 0; row < level_height; ++row) {
+      const long offset = level_offsets[level - 1] +
+        long((y + row) * map_width + x) * sizeof(short);
+      if (fseek(file, offset, SEEK_SET) != 0 ||
+          fwrite(buffer.begin() + row * level_width, sizeof(short),
+                 level_width, file) != level_width)
+        return false;
+    }
+
+    /* the next level is calculated from this one */
+    previous = std::move(buffer);
+    src = previous.begin();
+    src_width = level_width;
+  }
+
+  return true;
+}
+
 bool
-RasterTileCache::SaveCache(FILE *file) const
+RasterTileCache::SaveCache(FILE *file, const char *path,
+                           OperationEnvironment &_operation)
 {
   if (!initialised)
     return false;
 
   assert(bounds_initialised);
+  assert(!IsMapped());
 
   /* save metadata */
   CacheHeader header;
@@ -474,6 +719,7 @@ RasterTileCache::SaveCache(FILE *file) const
   header.tile_columns = tiles.GetWidth();
   header.tile_rows = tiles.GetHeight();
   header.num_marker_segments = segments.size();
+  header.pyramid_levels = CanBuildPyramid() ? PYRAMID_LEVELS : 0;
   header.bounds = bounds;
 
   if (fwrite(&header, sizeof(header), 1, file) != 1 ||
@@ -499,12 +745,73 @@ RasterTileCache::SaveCache(FILE *file) const
              overview_size, file) != overview_size)
     return false;
 
+  /* decode all tiles and append them to the file, in batches of
+     MAX_ACTIVE_TILES to limit the memory usage; each tile also
+     contributes to the pyramid levels, which follow the tiles */
+
+  long tile_offset = ftell(file);
+  if (tile_offset < 0)
+    return false;
+
+  long level_offsets[PYRAMID_LEVELS];
+  long level_offset = tile_offset + TileDataSize(tiles);
+  for (unsigned level = 1; level <= header.pyramid_levels; ++level) {
+    level_offsets[level - 1] = level_offset;
+    level_offset += (width >> level) * (height >> level) * sizeof(short);
+  }
+
+  const unsigned n_tiles = tiles.GetSize();
+
+  _operation.SetProgressRange(n_tiles);
+
+  for (unsigned start = 0; start < n_tiles;) {
+    _operation.SetProgressPosition(start);
+
+    for (auto it = tiles.begin(), end = tiles.end(); it != end; ++it)
+      it->ClearRequest();
+
+    unsigned end = start, n_requested = 0;
+    for (; end < n_tiles && n_requested < MAX_ACTIVE_TILES; ++end) {
+      RasterTile &tile = tiles.GetLinear(end);
+      if (tile.IsDefined()) {
+        tile.SetRequest();
+        ++n_requested;
+      }
+    }
+
+    remaining_segments = 0;
+    if (!LoadJPG2000(path))
+      return false;
+
+    bool success = true;
+    for (; start < end; ++start) {
+      RasterTile &tile = tiles.GetLinear(start);
+      if (!tile.IsDefined())
+        continue;
+
+      const size_t tile_size = tile.width * tile.height;
+      success = success && tile.CommitDecodeBuffer() &&
+        fseek(file, tile_offset, SEEK_SET) == 0 &&
+        fwrite(tile.buffer.GetData(), sizeof(short), tile_size,
+               file) == tile_size &&
+        (header.pyramid_levels == 0 ||
+         SavePyramidTile(file, tile, level_offsets));
+      tile_offset += tile_size * sizeof(short);
+
+      tile.Disable();
+      tile.ClearRequest();
+    }
+
+    if (!success)
+      return false;
+  }
+
   /* done */
   return true;
 }
 
 bool
-RasterTileCache::LoadCache(FILE *file)
+RasterTileCache::LoadCache(FILE *file, const TCHAR *cache_path)
 {
   Reset();
 
@@ -516,6 +823,8 @@ RasterTileCache::LoadCache(FILE *file)
       header.height < 1024 || header.height > 1024 * 1024 ||
       header.num_marker_segments < 4 ||
       header.num_marker_segments > segments.capacity() ||
+      (header.pyramid_levels != 0 &&
+       header.pyramid_levels != PYRAMID_LEVELS) ||
       header.bounds.IsEmpty())
     return false;
 
@@ -554,6 +863,37 @@ RasterTileCache::LoadCache(FILE *file)
             overview_size, file) != overview_size)
     return false;
 
+  /* map the decoded tiles, which follow the overview, and the
+     pyramid levels, which follow the tiles */
+  const long tile_data_offset = ftell(file);
+  if (tile_data_offset < 0 || tile_data_offset % sizeof(short) != 0)
+    return false;
+
+  mapping = new FileMapping(cache_path);
+  if (mapping->error() ||
+      mapping->size() != tile_data_offset + TileDataSize(tiles) +
+      PyramidDataSize(width, height, header.pyramid_levels)) {
+    Reset();
+    return false;
+  }
+
+  /* enable all tiles permanently; from now on, this object is
+     immutable */
+  const short *p = (const short *)mapping->at(tile_data_offset);
+  for (auto it = tiles.begin(), end = tiles.end(); it != end; ++it) {
+    if (it->IsDefined()) {
+      it->EnableExternal(p);
+      p += it->width * it->height;
+    }
+  }
+
+  for (unsigned level = 1; level <= header.pyramid_levels; ++level) {
+    const unsigned level_width = width >> level;
+    const unsigned level_height = height >> level;
+    pyramid[level - 1].SetExternal(p, level_width, level_height);
+    p += level_width * level_height;
+  }
+
   initialised = true;
   scan_overview = false;
   return true;
@@ -29,6 +29,7 @@ Copyright_License {
 #include "Geo/GeoBounds.hpp"
 #include "Util/NonCopyable.hpp"
 #include "Util/StaticArray.hpp"
+#include "Util/AllocatedGrid.hpp"
 #include "Util/Serial.hpp"
 
 #include <assert.h>
@@ -41,6 +42,7 @@ Copyright_License {
 
 struct GridLocation;
 class OperationEnvironment;
+class FileMapping;
 
 class RasterTileCache : private NonCopyable {
   static constexpr unsigned MAX_RTC_TILES = 4096;
@@ -68,6 +70,13 @@ class RasterTileCache : private NonCopyable {
    */
   static constexpr unsigned OVERVIEW_BITS = 4;
 
+  /**
+   * The number of reduced-resolution levels stored in the cache file
+   * between the full resolution and the overview: 1/2, 1/4 and 1/8.
+   * The overview serves as the 1/16 level.
+   */
+  static constexpr unsigned PYRAMID_LEVELS = OVERVIEW_BITS - 1;
+
   /**
    * Target number of steps in intersection searches; total distance
    * is shifted by this number of bits
@@ -116,9 +125,9 @@ protected:
 
   struct CacheHeader {
 #ifdef FIXED_MATH
-    static constexpr unsigned VERSION = 0xa;
+    static constexpr unsigned VERSION = 0xe;
 #else
-    static constexpr unsigned VERSION = 0xb;
+    static constexpr unsigned VERSION = 0xf;
 #endif
 
     unsigned version;
@@ -126,6 +135,13 @@ protected:
     unsigned short tile_width, tile_height;
     unsigned tile_columns, tile_rows;
     unsigned num_marker_segments;
+
+    /**
+     * The number of pyramid levels following the decoded tiles;
+     * either 0 or #PYRAMID_LEVELS.
+     */
+    unsigned pyramid_levels;
+
     GeoBounds bounds;
   };
 
@@ -171,11 +187,30 @@ protected:
    */
   OperationEnvironment *operation;
 
+  /**
+   * The cache file mapped into memory by LoadCache().  It contains
+   * all tiles in decoded form; they are all enabled and point into
+   * the mapping, and the JPEG2000 decoder is not needed.  nullptr if
+   * the tiles must be decoded from the original file.
+   */
+  FileMapping *mapping;
+
+  /**
+   * The reduced-resolution copies of the whole map, mapped from the
+   * cache file.  Element i has 1/2^(i+1) of the full resolution;
+   * each sample is the mean of the corresponding block of full
+   * resolution samples.  Undefined if the cache file has no
+   * pyramid.
+   */
+  RasterBuffer pyramid[PYRAMID_LEVELS];
+
 public:
-  RasterTileCache():operation(NULL) {
+  RasterTileCache():operation(NULL), mapping(nullptr) {
     Reset();
   }
 
+  ~RasterTileCache();
+
 protected:
   void ScanTileLine(GridLocation start, GridLocation end,
                     short *buffer, unsigned size, bool interpolate) const;
@@ -202,9 +237,27 @@ public:
   short GetInterpolatedHeight(unsigned int lx,
                               unsigned int ly) const;
 
+  /**
+   * Determine the non-interpolated heights at many pixel locations
+   * at once.  The result is the same as calling GetHeight() for each
+   * of them, but consecutive locations in the same tile are cheaper.
+   */
+  void GetHeights(const SignedRasterLocation *locations, short *heights,
+                  unsigned n) const;
+
+  /**
+   * Determine the interpolated heights at many sub-pixel locations
+   * at once.  See GetHeights().
+   */
+  void GetInterpolatedHeights(const SignedRasterLocation *locations,
+                              short *heights, unsigned n) const;
+
   /**
    * Scan a straight line and fill the buffer with the specified
-   * number of samples along the line.
+   * number of samples along the line.  If the samples are spaced
+   * wider than one pixel and the cache file provides a pyramid, the
+   * matching reduced-resolution level is scanned instead of the
+   * tiles.
    *
    * @param start the sub-pixel start location
    * @param end the sub-pixel end location
@@ -227,7 +280,13 @@ public:
                int h_origin, const int slope_fact) const;
 
 protected:
-  void LoadJPG2000(const char *path);
+  /**
+   * Decode the JPEG2000 file: either scan the overview, or decode
+   * the requested tiles.
+   *
+   * @return false if the file could not be opened
+   */
+  bool LoadJPG2000(const char *path);
 
   /**
    * Load a world file (*.tfw or *.j2w).
@@ -246,15 +305,128 @@ private:
   gcc_pure
   std::pair<short, bool> GetFieldDirect(unsigned px, unsigned py) const;
 
+  /**
+   * Like GetFieldDirect(), but read from the specified pyramid level
+   * if that is not zero.  Values from a pyramid level are considered
+   * "fine".
+   */
+  gcc_pure
+  std::pair<short, bool> GetFieldAtLevel(unsigned px, unsigned py,
+                                         unsigned level) const;
+
+  /**
+   * Is there a pyramid of reduced-resolution levels?
+   */
+  bool HasPyramid() const {
+    return pyramid[0].IsDefined();
+  }
+
+  /**
+   * Determine the coarsest level whose sample size does not exceed
+   * the given sample spacing.  Level 0 is the full resolution,
+   * #OVERVIEW_BITS is the overview.  Returns 0 if there is no
+   * pyramid.
+   *
+   * @param spacing the distance between two samples in pixels
+   */
+  gcc_pure
+  unsigned SelectLevel(unsigned spacing) const;
+
+  /**
+   * Returns the buffer of the given level (1 to #OVERVIEW_BITS).
+   */
+  gcc_pure
+  const RasterBuffer &GetLevelBuffer(unsigned level) const {
+    assert(level > 0 && level <= OVERVIEW_BITS);
+
+    return level == OVERVIEW_BITS ? overview : pyramid[level - 1];
+  }
+
+  /**
+   * Can SaveCache() build a pyramid for this map?  This requires that
+   * all tiles are defined and aligned to the block size of the
+   * coarsest pyramid level, so each pyramid sample can be calculated
+   * from one tile.
+   */
+  gcc_pure
+  bool CanBuildPyramid() const;
+
+  /**
+   * Calculate the pyramid levels of one decoded tile and write them
+   * to the cache file.
+   *
+   * @param level_offsets the file offset of each pyramid level
+   */
+  bool SavePyramidTile(FILE *file, const RasterTile &tile,
+                       const long *level_offsets) const;
+
 public:
   bool LoadOverview(const char *path, const TCHAR *world_file,
                     OperationEnvironment &operation);
 
-  bool SaveCache(FILE *file) const;
-  bool LoadCache(FILE *file);
+  /**
+   * Write the cache file.  Apart from the metadata, this decodes all
+   * tiles from the specified JPEG2000 file and stores them
+   * uncompressed, followed by the pyramid levels, to be mapped into
+   * memory by LoadCache().  This is expensive, but needs to be done
+   * only once.
+   */
+  bool SaveCache(FILE *file, const char *path,
+                 OperationEnvironment &operation);
 
+  /**
+   * Load a cache file written by SaveCache().
+   *
+   * @param cache_path the path of the cache file, used to map the
+   * decoded tiles into memory
+   */
+  bool LoadCache(FILE *file, const TCHAR *cache_path);
+
+  /**
+   * Are the tiles mapped from a cache file (and do not need to be
+   * decoded)?  In that case, all tiles are enabled, and the object
+   * does not change anymore after LoadCache(); readers may access
+   * it from any thread without locking.
+   */
+  bool IsMapped() const {
+    return mapping != nullptr;
+  }
+
+  /**
+   * Load all tiles which are needed for the given view.  This is a
+   * shortcut for PrepareTiles(), DecodeTiles() and CommitTiles().
+   */
   void UpdateTiles(const char *path, int x, int y, unsigned radius);
 
+  /**
+   * Determine which tiles are needed for the given view, discard
+   * tiles which are out of range and request new ones, nearest
+   * first.  This is the first step of UpdateTiles().
+   *
+   * Caller must hold an exclusive lock.
+   *
+   * @return true if DecodeTiles() and CommitTiles() shall be called
+   */
+  bool PrepareTiles(int x, int y, unsigned radius);
+
+  /**
+   * Decode the tiles which were requested by PrepareTiles() into
+   * private buffers which are not yet visible to readers.  This is
+   * the expensive part of UpdateTiles(), and it does not modify any
+   * state used by readers; therefore, it may be called while other
+   * threads hold a shared lock, but not concurrently with any other
+   * non-const method.
+   */
+  void DecodeTiles(const char *path);
+
+  /**
+   * Publish the tiles decoded by DecodeTiles() and update the
+   * #serial.
+   *
+   * Caller must hold an exclusive lock.
+   */
+  void CommitTiles();
+
   /**
    * Determines if there are still tiles scheduled to be loaded.  Call
    * this after UpdateTiles() to determine if UpdateTiles() should be
@@ -291,8 +463,6 @@ public:
   long SkipMarkerSegment(long file_offset) const;
   void MarkerSegment(long file_offset, unsigned id);
 
-  bool TileRequest(unsigned index);
-
   short *GetOverview() {
     return overview.GetData();
   }
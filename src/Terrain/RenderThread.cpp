@@ -0,0 +1,166 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "RenderThread.hpp"
+#include "Screen/RawBitmap.hpp"
+
+#include <algorithm>
+
+TerrainRenderThread::TerrainRenderThread(const RasterTerrain &terrain,
+                                         std::function<void()> &&_callback)
+  :StandbyThread("TerrainRender"),
+   renderer(terrain),
+   callback(_callback),
+   flush(false),
+   image(nullptr), discarded(nullptr),
+   width(0), height(0) {}
+
+TerrainRenderThread::~TerrainRenderThread()
+{
+  delete image;
+  delete discarded;
+}
+
+void
+TerrainRenderThread::Flush()
+{
+  const ScopeLock protect(mutex);
+  flush = true;
+}
+
+void
+TerrainRenderThread::Trigger(const WindowProjection &projection,
+                             Angle sun_azimuth,
+                             const TerrainRendererSettings &settings)
+{
+  const ScopeLock protect(mutex);
+
+  next_projection = projection;
+  next_sun_azimuth = sun_azimuth;
+  next_settings = settings;
+  StandbyThread::Trigger();
+}
+
+bool
+TerrainRenderThread::Draw(Canvas &canvas, const WindowProjection &projection)
+{
+  const ScopeLock protect(mutex);
+
+  delete discarded;
+  discarded = nullptr;
+
+  if (image == nullptr)
+    return false;
+
+#ifdef ENABLE_OPENGL
+  DrawTerrainImage(projection, *image, width, height, bounds);
+#else
+  /* if the map has moved since the image was generated, draw it at
+     its geographic location until the new one is ready */
+  const RasterPoint offset = image_projection.Compare(projection)
+    ? image_offset
+    : projection.GeoToScreen(image_origin);
+
+  DrawTerrainImage(canvas, *image, width, height,
+                   offset, quantisation_pixels);
+#endif
+  return true;
+}
+
+void
+TerrainRenderThread::PublishImage(const WindowProjection &projection)
+{
+  const RasterRenderer &raster_renderer = renderer.GetRasterRenderer();
+  const RawBitmap &src = raster_renderer.GetImage();
+  width = raster_renderer.GetWidth();
+  height = raster_renderer.GetHeight();
+
+  if (image == nullptr ||
+      image->GetWidth() < width || image->GetHeight() < height) {
+    if (discarded == nullptr)
+      /* the old image may have been drawn already, and only Draw()
+         may free its texture */
+      discarded = image;
+    else
+      /* Draw() has not been called since "image" was allocated; it
+         has no texture yet */
+      delete image;
+
+    image = new RawBitmap(src.GetWidth(), src.GetHeight());
+  }
+
+  const BGRColor *src_row = src.GetTopRow();
+  BGRColor *dest_row = image->GetTopRow();
+  for (unsigned y = 0; y < height; ++y) {
+    std::copy_n(src_row, width, dest_row);
+    src_row = src.GetNextRow(src_row);
+    dest_row = image->GetNextRow(dest_row);
+  }
+
+  image->SetDirty();
+
+#ifdef ENABLE_OPENGL
+  (void)projection;
+  bounds = raster_renderer.GetBounds();
+#else
+  image_projection = CompareProjection(projection);
+  image_offset = raster_renderer.GetImageOffset();
+  image_origin = projection.ScreenToGeo(image_offset.x, image_offset.y);
+  quantisation_pixels = raster_renderer.GetQuantisationPixels();
+#endif
+}
+
+void
+TerrainRenderThread::OnStart()
+{
+  SetLowPriority();
+}
+
+void
+TerrainRenderThread::Tick()
+{
+  const WindowProjection projection = next_projection;
+  const Angle sun_azimuth = next_sun_azimuth;
+  renderer.SetSettings(next_settings);
+
+  if (flush) {
+    flush = false;
+    renderer.Flush();
+  }
+
+  mutex.Unlock();
+  const bool modified = renderer.Generate(projection, sun_azimuth);
+  mutex.Lock();
+
+  if (!modified)
+    return;
+
+  PublishImage(projection);
+
+  /* notify the client that a new image is ready */
+  if (callback) {
+    mutex.Unlock();
+    callback();
+    mutex.Lock();
+  }
+}
@@ -0,0 +1,147 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_RENDER_THREAD_HPP
+#define XCSOAR_TERRAIN_RENDER_THREAD_HPP
+
+#include "Thread/StandbyThread.hpp"
+#include "TerrainRenderer.hpp"
+#include "Projection/WindowProjection.hpp"
+
+#ifdef ENABLE_OPENGL
+#include "Geo/GeoBounds.hpp"
+#endif
+
+#include <functional>
+
+class RawBitmap;
+
+/**
+ * A thread that generates the terrain image in background, so the
+ * thread which draws the map does not have to wait for it.  The
+ * finished image is copied into a separate #RawBitmap, which is then
+ * drawn by Draw() until the next one is ready.  While the map is
+ * being moved, Draw() keeps showing the previous image at its
+ * geographic location.
+ *
+ * On OpenGL, all texture operations are done by the thread which
+ * calls Draw(); the render thread only touches the pixel buffer.
+ */
+class TerrainRenderThread final : private StandbyThread {
+  /**
+   * Only accessed by the render thread (or while it is stopped).
+   */
+  TerrainRenderer renderer;
+
+  const std::function<void()> callback;
+
+  /**
+   * The parameters requested by Trigger().  Protected by the mutex.
+   */
+  WindowProjection next_projection;
+  Angle next_sun_azimuth;
+  TerrainRendererSettings next_settings;
+
+  /**
+   * Shall the #TerrainRenderer cache be flushed before generating
+   * the next image?  Protected by the mutex.
+   */
+  bool flush;
+
+  /**
+   * The most recent finished image, or nullptr if there is none yet.
+   * It may be larger than #width and #height.  Protected by the
+   * mutex.
+   */
+  RawBitmap *image;
+
+  /**
+   * A previous #image which was replaced by a larger one.  It may
+   * own an OpenGL texture, therefore it is deleted by the next
+   * Draw() call.  Protected by the mutex.
+   */
+  RawBitmap *discarded;
+
+  /**
+   * The portion of #image which contains the terrain.
+   */
+  unsigned width, height;
+
+#ifdef ENABLE_OPENGL
+  /**
+   * The area covered by #image.
+   */
+  GeoBounds bounds;
+#else
+  /**
+   * The projection #image was rendered for.  If it is still the
+   * current one, #image_offset is used as-is; else #image_origin is
+   * projected again.
+   */
+  CompareProjection image_projection;
+
+  RasterPoint image_offset;
+  GeoPoint image_origin;
+  unsigned quantisation_pixels;
+#endif
+
+public:
+  TerrainRenderThread(const RasterTerrain &terrain,
+                      std::function<void()> &&_callback);
+  ~TerrainRenderThread();
+
+  using StandbyThread::LockStop;
+
+  /**
+   * Flush the cache before the next image is generated.
+   */
+  void Flush();
+
+  /**
+   * Request a new image for the given parameters.  If nothing has
+   * changed, the render thread will return quickly without invoking
+   * the callback.
+   */
+  void Trigger(const WindowProjection &projection, Angle sun_azimuth,
+               const TerrainRendererSettings &settings);
+
+  /**
+   * Draw the most recent image.
+   *
+   * @return false if no image is available yet
+   */
+  bool Draw(Canvas &canvas, const WindowProjection &projection);
+
+private:
+  /**
+   * Copy the image of the #TerrainRenderer into #image.  Caller must
+   * lock the mutex.
+   */
+  void PublishImage(const WindowProjection &projection);
+
+  /* virtual methods from class StandbyThread*/
+  void OnStart() override;
+  void Tick() override;
+};
+
+#endif
@@ -25,6 +25,7 @@ Copyright_License {
 #include "Terrain/RasterLocation.hpp"
 
 #include <stdlib.h>
+#include <algorithm>
 
 struct GridLocation : public RasterLocation {
   unsigned short tile_x, tile_y;
@@ -323,6 +324,22 @@ RasterTileCache::ScanLine(const RasterLocation _start,
   assert(_end.y < GetFineHeight());
   assert(size >= 2);
 
+  /* if the samples are further apart than one pixel, scan the
+     reduced-resolution level which matches their spacing; it covers
+     the whole map and needs no tiles to be loaded */
+  const unsigned spacing =
+    (std::max(abs((int)_end.x - (int)_start.x),
+              abs((int)_end.y - (int)_start.y)) / (size - 1))
+    >> SUBPIXEL_BITS;
+  const unsigned level = SelectLevel(spacing);
+  if (level > 0) {
+    GetLevelBuffer(level).ScanLineChecked(_start.x >> level,
+                                          _start.y >> level,
+                                          _end.x >> level, _end.y >> level,
+                                          buffer, size, interpolate);
+    return;
+  }
+
   const GridRay ray(GetFineTileWidth(), GetFineTileHeight(),
                     _start, _end, size);
   assert(ray.size == size);
@@ -0,0 +1,183 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "SlopeShading.hpp"
+
+#if defined(__SSE2__) && !defined(FIXED_MATH)
+#include <emmintrin.h>
+#define HAVE_SSE2_SLOPE_SHADING
+#endif
+
+void
+SlopeShadingRowPortable(const short *src, unsigned n, unsigned column_offset,
+                        unsigned row_minus_offset, unsigned row_plus_offset,
+                        const SlopeShadingParameters &params, int *dest)
+{
+  const unsigned column_distance = 2 * column_offset;
+
+  for (unsigned i = 0; i < n; ++i, ++src)
+    dest[i] = SlopeShadingIndex(src[-(int)row_minus_offset],
+                                src[row_plus_offset],
+                                src[-(int)column_offset],
+                                src[column_offset],
+                                column_distance, params);
+}
+
+#ifdef HAVE_SSE2_SLOPE_SHADING
+
+/**
+ * The SSE2 implementation of SlopeShadingRow().  The gradients are
+ * calculated with 16 bit integers for 8 pixels at a time, which is
+ * exact because ClipHeightDelta() and the limited
+ * #quantisation_effective keep them small.  The square root and the
+ * divisions use double precision (2 pixels per instruction), which
+ * gives the same truncated results as the integer formula.
+ */
+class SSE2SlopeShading {
+  __m128i clip_min, clip_max;
+  __m128i row_distance, column_distance;
+  __m128i sun_xy;
+  __m128i dd2_sz, sz, one;
+  __m128d dd2_square, contrast, index_min, index_max;
+
+public:
+  SSE2SlopeShading(unsigned _column_distance,
+                   const SlopeShadingParameters &params) {
+    const unsigned dd2 = _column_distance * params.row_distance *
+      params.height_slope_factor;
+
+    clip_min = _mm_set1_epi16(-512);
+    clip_max = _mm_set1_epi16(512);
+    row_distance = _mm_set1_epi16(params.row_distance);
+    column_distance = _mm_set1_epi16(_column_distance);
+    sun_xy = _mm_setr_epi16(params.sx, params.sy, params.sx, params.sy,
+                            params.sx, params.sy, params.sx, params.sy);
+    dd2_sz = _mm_set1_epi32(int(dd2) * params.sz);
+    sz = _mm_set1_epi32(params.sz);
+    one = _mm_set1_epi32(1);
+    dd2_square = _mm_set1_pd(dd2 * dd2);
+    contrast = _mm_set1_pd(params.contrast / 128.);
+    index_min = _mm_set1_pd(-63);
+    index_max = _mm_set1_pd(63);
+  }
+
+  gcc_always_inline
+  __m128i ClipHeightDelta(__m128i a, __m128i b) const {
+    /* saturate first, because the difference may exceed 16 bit */
+    return _mm_min_epi16(_mm_max_epi16(_mm_subs_epi16(a, b), clip_min),
+                         clip_max);
+  }
+
+  /**
+   * Calculate the index of the two pixels in the lower half of the
+   * given 32 bit vectors.
+   */
+  gcc_always_inline
+  __m128i Index2(__m128i num, __m128i square_mag) const {
+    /* dd0*dd0 + dd1*dd1 fits in a signed 32 bit integer, but adding
+       dd2*dd2 may not; that is why it is added as double */
+    const __m128d mag =
+      _mm_sqrt_pd(_mm_add_pd(_mm_cvtepi32_pd(square_mag), dd2_square));
+
+    const __m128i divisor = _mm_or_si128(_mm_cvttpd_epi32(mag), one);
+    const __m128i sval =
+      _mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(num),
+                                  _mm_cvtepi32_pd(divisor)));
+
+    /* the multiplication with contrast/128 is exact, and clamping
+       before truncation is equivalent to clamping afterwards */
+    __m128d sindex = _mm_mul_pd(_mm_cvtepi32_pd(_mm_sub_epi32(sval, sz)),
+                                contrast);
+    sindex = _mm_min_pd(_mm_max_pd(sindex, index_min), index_max);
+    return _mm_cvttpd_epi32(sindex);
+  }
+
+  /**
+   * Calculate the index of four pixels, given the interleaved dd0
+   * and dd1 values.
+   */
+  gcc_always_inline
+  __m128i Index4(__m128i dd01) const {
+    const __m128i num = _mm_add_epi32(_mm_madd_epi16(dd01, sun_xy), dd2_sz);
+    const __m128i square_mag = _mm_madd_epi16(dd01, dd01);
+
+    const __m128i lo = Index2(num, square_mag);
+    const __m128i hi = Index2(_mm_srli_si128(num, 8),
+                              _mm_srli_si128(square_mag, 8));
+    return _mm_unpacklo_epi64(lo, hi);
+  }
+
+  gcc_always_inline
+  void Index8(const short *src, unsigned column_offset,
+              unsigned row_minus_offset, unsigned row_plus_offset,
+              int *dest) const {
+    const __m128i above =
+      _mm_loadu_si128((const __m128i *)(src - row_minus_offset));
+    const __m128i below =
+      _mm_loadu_si128((const __m128i *)(src + row_plus_offset));
+    const __m128i left =
+      _mm_loadu_si128((const __m128i *)(src - column_offset));
+    const __m128i right =
+      _mm_loadu_si128((const __m128i *)(src + column_offset));
+
+    const __m128i p32 = ClipHeightDelta(above, below);
+    const __m128i p22 = ClipHeightDelta(right, left);
+
+    /* these products fit in 16 bit */
+    const __m128i dd0 = _mm_mullo_epi16(p22, row_distance);
+    const __m128i dd1 = _mm_mullo_epi16(column_distance, p32);
+
+    _mm_storeu_si128((__m128i *)dest, Index4(_mm_unpacklo_epi16(dd0, dd1)));
+    _mm_storeu_si128((__m128i *)(dest + 4),
+                     Index4(_mm_unpackhi_epi16(dd0, dd1)));
+  }
+};
+
+#endif
+
+void
+SlopeShadingRow(const short *src, unsigned n, unsigned column_offset,
+                unsigned row_minus_offset, unsigned row_plus_offset,
+                const SlopeShadingParameters &params, int *dest)
+{
+#ifdef HAVE_SSE2_SLOPE_SHADING
+  /* the 16 bit products in SSE2SlopeShading::Index8() are only exact
+     if the distances are small, and SSE2SlopeShading::Index2() does
+     not emulate the 32 bit overflow of "square_mag"; RasterRenderer
+     guarantees both */
+  const unsigned column_distance = 2 * column_offset;
+  if (column_distance < 64 && params.row_distance < 64 &&
+      column_distance * params.row_distance * params.height_slope_factor
+      <= 32768) {
+    const SSE2SlopeShading sse2(column_distance, params);
+
+    for (; n >= 8; n -= 8, src += 8, dest += 8)
+      sse2.Index8(src, column_offset, row_minus_offset, row_plus_offset,
+                  dest);
+  }
+#endif
+
+  SlopeShadingRowPortable(src, n, column_offset,
+                          row_minus_offset, row_plus_offset,
+                          params, dest);
+}
@@ -0,0 +1,139 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_SLOPE_SHADING_HPP
+#define XCSOAR_TERRAIN_SLOPE_SHADING_HPP
+
+#include "Util/Clamp.hpp"
+#include "Compiler.h"
+
+#ifdef FIXED_MATH
+#include "Math/FastMath.h"
+#else
+#include <math.h>
+#endif
+
+/**
+ * Parameters for the slope shading calculation which are constant
+ * for one row of the image.
+ */
+struct SlopeShadingParameters {
+  /**
+   * The sun vector, scaled to 255.
+   */
+  int sx, sy, sz;
+
+  int contrast;
+
+  /**
+   * The height scale factor, derived from the pixel size.
+   */
+  unsigned height_slope_factor;
+
+  /**
+   * The distance between the upper and the lower neighbour.
+   */
+  unsigned row_distance;
+};
+
+/**
+ * Clip the difference between two adjacent terrain height values to
+ * sane bounds.  This works around integer overflows in the
+ * SlopeShadingIndex() formula when the map file is broken, avoiding
+ * the sqrt() call with a negative argument.
+ */
+gcc_const
+static inline int
+ClipHeightDelta(int d)
+{
+  return Clamp(d, -512, 512);
+}
+
+/**
+ * Calculate the illumination of one pixel from its neighbours.
+ *
+ * @param column_distance the distance between the left and the right
+ * neighbour
+ * @return the illumination index (-63..63)
+ */
+gcc_const
+static inline int
+SlopeShadingIndex(int h_above, int h_below, int h_left, int h_right,
+                  unsigned column_distance,
+                  const SlopeShadingParameters &params)
+{
+  const unsigned p20 = column_distance;
+  const unsigned p31 = params.row_distance;
+
+  const int p32 = ClipHeightDelta(h_above - h_below);
+  const int p22 = ClipHeightDelta(h_right - h_left);
+
+  const int dd0 = p22 * int(p31);
+  const int dd1 = int(p20) * p32;
+  const unsigned dd2 = p20 * p31 * params.height_slope_factor;
+  const int num = (int(dd2) * params.sz + dd0 * params.sx + dd1 * params.sy);
+  const unsigned square_mag = dd0 * dd0 + dd1 * dd1 + dd2 * dd2;
+#ifdef FIXED_MATH
+  const unsigned mag = isqrt4(square_mag);
+#else
+  const unsigned mag = (unsigned)sqrt((double)square_mag);
+#endif
+  /* this is a workaround for a SIGFPE (division by zero)
+     observed by our users on some Android devices (e.g. Nexus
+     7), even though we did our best to make sure that the
+     integer arithmetics above can't overflow */
+  /* TODO: debug this problem and replace this workaround */
+  const int sval = num / int(mag|1);
+  const int sindex = (sval - params.sz) * params.contrast / 128;
+  return Clamp(sindex, -63, 63);
+}
+
+/**
+ * Calculate the illumination index of a run of pixels within one
+ * row, whose left and right neighbours are both #column_offset
+ * pixels away.  This is equivalent to calling SlopeShadingIndex()
+ * for each pixel, but uses SIMD instructions if available.  The
+ * result for pixels which are "special" or have "special" neighbours
+ * is undefined.
+ *
+ * @param src the first pixel of the run in the height matrix
+ * @param n the number of pixels
+ * @param row_minus_offset the offset of the upper neighbours
+ * @param row_plus_offset the offset of the lower neighbours
+ * @param dest the destination array (-63..63)
+ */
+void
+SlopeShadingRow(const short *src, unsigned n, unsigned column_offset,
+                unsigned row_minus_offset, unsigned row_plus_offset,
+                const SlopeShadingParameters &params, int *dest);
+
+/**
+ * The portable implementation of SlopeShadingRow().  This is only
+ * exported for the unit test.
+ */
+void
+SlopeShadingRowPortable(const short *src, unsigned n, unsigned column_offset,
+                        unsigned row_minus_offset, unsigned row_plus_offset,
+                        const SlopeShadingParameters &params, int *dest);
+
+#endif
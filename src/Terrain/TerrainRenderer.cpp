@@ -295,15 +295,28 @@ TerrainRenderer::TerrainRenderer(const RasterTerrain &_terrain)
   settings.SetDefaults();
 }
 
+#ifndef ENABLE_OPENGL
+
 void
-TerrainRenderer::CopyTo(Canvas &canvas, unsigned width, unsigned height) const
+DrawTerrainImage(Canvas &canvas,
+                 const RawBitmap &image, unsigned width, unsigned height,
+                 RasterPoint offset, unsigned quantisation_pixels)
 {
-  raster_renderer.GetImage().StretchTo(raster_renderer.GetWidth(),
-                                        raster_renderer.GetHeight(), canvas,
-                                        width, height);
+  image.StretchTo(width, height, canvas, offset.x, offset.y,
+                  width * quantisation_pixels, height * quantisation_pixels);
 }
 
-#ifdef ENABLE_OPENGL
+void
+TerrainRenderer::CopyTo(Canvas &canvas) const
+{
+  DrawTerrainImage(canvas, raster_renderer.GetImage(),
+                   raster_renderer.GetWidth(), raster_renderer.GetHeight(),
+                   raster_renderer.GetImageOffset(),
+                   raster_renderer.GetQuantisationPixels());
+}
+
+#else
+
 /**
  * Checks if the size difference of any dimension is more than a
  * factor of two.  This is used to check whether the terrain has to be
@@ -320,7 +333,7 @@ IsLargeSizeDifference(const GeoBounds &a, const GeoBounds &b)
 }
 #endif
 
-void
+bool
 TerrainRenderer::Generate(const WindowProjection &map_projection,
                           const Angle sunazimuth)
 {
@@ -335,19 +348,24 @@ TerrainRenderer::Generate(const WindowProjection &map_projection,
       sunazimuth.CompareRoughly(last_sun_azimuth) &&
       !raster_renderer.UpdateQuantisation())
     /* no change since previous frame */
-    return;
+    return false;
 
 #else
   if (compare_projection.Compare(map_projection) &&
       terrain_serial == terrain.GetSerial() &&
       sunazimuth.CompareRoughly(last_sun_azimuth))
     /* no change since previous frame */
-    return;
+    return false;
 
   compare_projection = CompareProjection(map_projection);
 #endif
 
-  terrain_serial = terrain.GetSerial();
+  if (terrain_serial != terrain.GetSerial()) {
+    /* tiles have been loaded or discarded: the height matrix cannot
+       be scrolled, it must be scanned again */
+    raster_renderer.Invalidate();
+    terrain_serial = terrain.GetSerial();
+  }
 
   last_sun_azimuth = sunazimuth;
 
@@ -376,20 +394,16 @@ TerrainRenderer::Generate(const WindowProjection &map_projection,
                                 settings.contrast, settings.brightness,
                                 sunazimuth,
                                 do_contour);
+  return true;
 }
 
-/**
- * Draws the terrain to the given canvas
- * @param canvas The drawing canvas
- * @param map_projection The Projection
- * @param sunazimuth Azimuth of the sun (for terrain shading)
- */
+#ifdef ENABLE_OPENGL
+
 void
-TerrainRenderer::Draw(Canvas &canvas,
-                      const WindowProjection &map_projection) const
+DrawTerrainImage(const WindowProjection &map_projection,
+                 const RawBitmap &image, unsigned width, unsigned height,
+                 const GeoBounds &bounds)
 {
-#ifdef ENABLE_OPENGL
-  const GeoBounds &bounds = raster_renderer.GetBounds();
   assert(bounds.IsValid());
 
   const RasterPoint vertices[] = {
@@ -401,11 +415,10 @@ TerrainRenderer::Draw(Canvas &canvas,
 
   const ScopeVertexPointer vp(vertices);
 
-  const GLTexture &texture = raster_renderer.BindAndGetTexture();
+  const GLTexture &texture = image.BindAndGetTexture();
   const PixelSize allocated = texture.GetAllocatedSize();
 
-  const int src_x = 0, src_y = 0, src_width = raster_renderer.GetWidth(),
-    src_height = raster_renderer.GetHeight();
+  const int src_x = 0, src_y = 0, src_width = width, src_height = height;
 
   GLfloat x0 = (GLfloat)src_x / allocated.cx;
   GLfloat y0 = (GLfloat)src_y / allocated.cy;
@@ -440,9 +453,25 @@ TerrainRenderer::Draw(Canvas &canvas,
 #else
   glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 #endif
+}
 
+#endif
+
+/**
+ * Draws the terrain to the given canvas
+ * @param canvas The drawing canvas
+ * @param map_projection The Projection
+ * @param sunazimuth Azimuth of the sun (for terrain shading)
+ */
+void
+TerrainRenderer::Draw(Canvas &canvas,
+                      const WindowProjection &map_projection) const
+{
+#ifdef ENABLE_OPENGL
+  DrawTerrainImage(map_projection, raster_renderer.GetImage(),
+                   raster_renderer.GetWidth(), raster_renderer.GetHeight(),
+                   raster_renderer.GetBounds());
 #else
-  CopyTo(canvas, map_projection.GetScreenWidth(),
-         map_projection.GetScreenHeight());
+  CopyTo(canvas);
 #endif
 }
@@ -64,15 +64,16 @@ public:
    * Flush the cache.
    */
   void Flush() {
-#ifdef ENABLE_OPENGL
     raster_renderer.Invalidate();
-#else
+#ifndef ENABLE_OPENGL
     compare_projection.Clear();
 #endif
   }
 
 protected:
-  void CopyTo(Canvas &canvas, unsigned width, unsigned height) const;
+#ifndef ENABLE_OPENGL
+  void CopyTo(Canvas &canvas) const;
+#endif
 
 public:
   const TerrainRendererSettings &GetSettings() const {
@@ -83,10 +84,46 @@ public:
     settings = _settings;
   }
 
-  virtual void Generate(const WindowProjection &map_projection,
+  const RasterRenderer &GetRasterRenderer() const {
+    return raster_renderer;
+  }
+
+  /**
+   * @return true if a new image has been generated, false if the
+   * previous one is still up to date
+   */
+  virtual bool Generate(const WindowProjection &map_projection,
                         const Angle sunazimuth);
 
   void Draw(Canvas &canvas, const WindowProjection &map_projection) const;
 };
 
+#ifdef ENABLE_OPENGL
+/**
+ * Draw a terrain image generated by #RasterRenderer.
+ *
+ * @param width the number of image columns which are used
+ * @param height the number of image rows which are used
+ * @param bounds the area covered by the image
+ */
+void
+DrawTerrainImage(const WindowProjection &map_projection,
+                 const RawBitmap &image, unsigned width, unsigned height,
+                 const GeoBounds &bounds);
+#else
+/**
+ * Draw a terrain image generated by #RasterRenderer.
+ *
+ * @param width the number of image columns which are used
+ * @param height the number of image rows which are used
+ * @param offset the screen position of the top left corner
+ * @param quantisation_pixels the number of screen pixels covered by
+ * one image pixel
+ */
+void
+DrawTerrainImage(Canvas &canvas,
+                 const RawBitmap &image, unsigned width, unsigned height,
+                 RasterPoint offset, unsigned quantisation_pixels);
+#endif
+
 #endif
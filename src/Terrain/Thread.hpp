@@ -0,0 +1,72 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_THREAD_HPP
+#define XCSOAR_TERRAIN_THREAD_HPP
+
+#include "Thread/StandbyThread.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Math/fixed.hpp"
+
+#include <functional>
+
+class RasterTerrain;
+
+/**
+ * A thread that loads terrain tiles asynchronously.  The expensive
+ * decoding is done without holding the #RasterTerrain lock, so other
+ * threads can continue to read terrain heights meanwhile (falling
+ * back to the overview where no tile has been loaded yet).
+ */
+class TerrainThread final : private StandbyThread {
+  RasterTerrain &terrain;
+
+  const std::function<void()> callback;
+
+  /**
+   * The view requested by Trigger().  Protected by the mutex.
+   */
+  GeoPoint next_center;
+  fixed next_radius;
+
+  /**
+   * The view which was loaded completely last time.  If the new view
+   * is close enough, no update is needed.  Protected by the mutex.
+   */
+  GeoPoint last_center;
+  fixed last_radius;
+
+public:
+  TerrainThread(RasterTerrain &_terrain, std::function<void()> &&_callback);
+
+  using StandbyThread::LockStop;
+
+  void Trigger(const GeoPoint &center, fixed radius);
+
+private:
+  /* virtual methods from class StandbyThread*/
+  void OnStart() override;
+  void Tick() override;
+};
+
+#endif
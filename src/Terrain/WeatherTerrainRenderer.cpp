@@ -164,20 +164,18 @@ WeatherTerrainRenderer::WeatherTerrainRenderer(const RasterTerrain &_terrain,
 {
 }
 
-void
+bool
 WeatherTerrainRenderer::Generate(const WindowProjection &projection,
                                  const Angle sunazimuth)
 {
   if (weather.IsTerrain()) {
-    TerrainRenderer::Generate(projection, sunazimuth);
-    return;
+    return TerrainRenderer::Generate(projection, sunazimuth);
   }
 
   const WeatherTerrainStyle *style = LookupWeatherTerrainStyle(weather.GetMapName());
   if (style == nullptr) {
     /* unknown map name */
-    TerrainRenderer::Generate(projection, sunazimuth);
-    return;
+    return TerrainRenderer::Generate(projection, sunazimuth);
   }
 
   const bool do_water = style->do_water;
@@ -189,8 +187,7 @@ WeatherTerrainRenderer::Generate(const WindowProjection &projection,
 
   const RasterMap *map = weather.GetMap();
   if (map == nullptr) {
-    TerrainRenderer::Generate(projection, sunazimuth);
-    return;
+    return TerrainRenderer::Generate(projection, sunazimuth);
   }
 
   if (color_ramp != last_color_ramp) {
@@ -199,9 +196,13 @@ WeatherTerrainRenderer::Generate(const WindowProjection &projection,
     last_color_ramp = color_ramp;
   }
 
+  /* the weather map may have been reloaded; don't attempt to reuse
+     the previous height matrix */
+  raster_renderer.Invalidate();
   raster_renderer.ScanMap(*map, projection);
 
   raster_renderer.GenerateImage(do_shading, height_scale,
                                 settings.contrast, settings.brightness,
                                 sunazimuth, false);
+  return true;
 }
@@ -35,7 +35,7 @@ public:
   WeatherTerrainRenderer(const RasterTerrain &_terrain,
                          const RasterWeatherCache &_weather);
 
-  virtual void Generate(const WindowProjection &map_projection,
+  virtual bool Generate(const WindowProjection &map_projection,
                         const Angle sunazimuth);
 };
 
@@ -104,6 +104,8 @@ StandbyThread::Run()
   assert(!mutex.IsLockedByCurrent());
   assert(!busy);
 
+  OnStart();
+
   mutex.Lock();
   alive = true;
 
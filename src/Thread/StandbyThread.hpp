@@ -149,6 +149,20 @@ protected:
     return pending || busy;
   }
 
+  /**
+   * Has Trigger() been called since the current Tick() began?  A
+   * Tick() implementation which works in small steps can use this to
+   * return early and handle the new request first.
+   *
+   * Caller must lock the mutex.
+   */
+  gcc_pure
+  bool IsPending() const {
+    assert(mutex.IsLockedByCurrent());
+
+    return pending;
+  }
+
   /**
    * Was the thread asked to stop?  The Tick() implementation should
    * use this to check whether to cancel the operation.
@@ -210,6 +224,12 @@ protected:
     Stop();
   }
 
+  /**
+   * Called once in the new thread before the first Tick(), e.g. to
+   * set its priority.  The mutex is not locked.
+   */
+  virtual void OnStart() {}
+
   /**
    * Implement this to do the actual work.  The mutex will be locked,
    * but you should unlock it while doing real work (and re-lock it
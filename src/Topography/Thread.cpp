@@ -62,24 +62,51 @@ TopographyThread::Trigger(const WindowProjection &_projection)
 }
 
 void
-TopographyThread::Tick()
+TopographyThread::OnStart()
 {
-  // TODO: call only once
   SetIdlePriority();
+}
 
-  bool again = true;
-  while (next_projection.IsValid() && again && !IsStopped()) {
-    const WindowProjection projection = next_projection;
+bool
+TopographyThread::ConvertCache()
+{
+  /* the number of shapes converted between two checks for a new
+     request */
+  static constexpr unsigned CONVERT_SHAPES = 256;
 
+  while (!IsStopped() && !IsPending() && store.HasPendingCache()) {
     mutex.Unlock();
-    again = store.ScanVisibility(projection, 1) > 0;
+    const bool converted = store.ConvertCache(CONVERT_SHAPES);
     mutex.Lock();
-  }
 
-  /* notify the client that we have updated the topography cache */
-  if (callback) {
-    mutex.Unlock();
-    callback();
-    mutex.Lock();
+    if (converted)
+      return true;
   }
+
+  return false;
+}
+
+void
+TopographyThread::Tick()
+{
+  do {
+    bool again = true;
+    while (next_projection.IsValid() && again && !IsStopped()) {
+      const WindowProjection projection = next_projection;
+
+      mutex.Unlock();
+      again = store.ScanVisibility(projection, 1) > 0;
+      mutex.Lock();
+    }
+
+    /* notify the client that we have updated the topography cache */
+    if (callback) {
+      mutex.Unlock();
+      callback();
+      mutex.Lock();
+    }
+
+    /* with the visible shapes up to date, use the idle time to
+       convert layers; a converted layer needs to be scanned again */
+  } while (ConvertCache());
 }
@@ -54,7 +54,19 @@ public:
   void Trigger(const WindowProjection &_projection);
 
 private:
+  /**
+   * Convert layers without a pre-processed copy, a few shapes at a
+   * time, until a layer switches to its copy or until there is a
+   * new request.
+   *
+   * Caller must lock the mutex.
+   *
+   * @return true if a layer has switched to its copy
+   */
+  bool ConvertCache();
+
   /* virtual methods from class StandbyThread*/
+  void OnStart() override;
   void Tick() override;
 };
 
@@ -0,0 +1,475 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "TopographyCache.hpp"
+#include "IO/FileCache.hpp"
+#include "IO/CacheWriter.hpp"
+#include "IO/CacheReader.hpp"
+#include "OS/FileMapping.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include <math.h>
+#include <string.h>
+
+/**
+ * The format version passed to FileCache::SaveMapped().
+ */
+static constexpr unsigned VERSION = 2;
+
+struct TopographyCacheHeader {
+  /**
+   * Catch builds with a different #XShape point type.
+   */
+  uint32_t point_size;
+
+  TopographyCache::Key key;
+
+  GeoPoint center;
+  GeoBounds bounds;
+
+  uint32_t tile_columns, tile_rows;
+
+  uint32_t n_shapes, n_tile_shapes, n_lines, n_points, n_indices, n_labels;
+};
+
+/**
+ * The arrays used in place are aligned to this.
+ */
+static constexpr size_t ALIGNMENT = 8;
+
+/**
+ * The average number of shapes per tile the grid is sized for.
+ */
+static constexpr unsigned SHAPES_PER_TILE = 16;
+
+static constexpr unsigned MAX_TILE_COLUMNS = 256;
+
+bool
+TopographyCache::Key::operator==(const Key &other) const
+{
+#ifdef ENABLE_OPENGL
+  if (!std::equal(thinning_distance,
+                  thinning_distance + XShape::THINNING_LEVELS,
+                  other.thinning_distance))
+    return false;
+#endif
+
+  return label_field == other.label_field;
+}
+
+/**
+ * Map a position within the grid's extent to a tile column or row,
+ * clipping outside positions to the border.
+ */
+gcc_const
+static unsigned
+ToTile(fixed offset, fixed size, unsigned n)
+{
+  if (!positive(size) || !positive(offset))
+    return 0;
+
+  const fixed tile = offset * n / size;
+  return tile < fixed(n) ? unsigned(tile) : n - 1;
+}
+
+gcc_pure
+static unsigned
+GetColumn(const GeoBounds &bounds, unsigned n, Angle longitude)
+{
+  return ToTile((longitude - bounds.GetWest()).AsDelta().Native(),
+                bounds.GetWidth().Native(), n);
+}
+
+gcc_pure
+static unsigned
+GetRow(const GeoBounds &bounds, unsigned n, Angle latitude)
+{
+  return ToTile((latitude - bounds.GetSouth()).Native(),
+                bounds.GetHeight().Native(), n);
+}
+
+/**
+ * Invoke the visitor for each tile of the grid which the area
+ * overlaps.
+ */
+template<typename V>
+static void
+VisitTiles(const GeoBounds &bounds, unsigned n_columns, unsigned n_rows,
+           const GeoBounds &area, V &&visitor)
+{
+  const unsigned west = GetColumn(bounds, n_columns, area.GetWest());
+  const unsigned east = GetColumn(bounds, n_columns, area.GetEast());
+  const unsigned south = GetRow(bounds, n_rows, area.GetSouth());
+  const unsigned north = GetRow(bounds, n_rows, area.GetNorth());
+
+  for (unsigned row = south; row <= north; ++row)
+    for (unsigned column = west; column <= east; ++column)
+      visitor(row * n_columns + column);
+}
+
+TopographyCache::TopographyCache() = default;
+TopographyCache::~TopographyCache() = default;
+
+template<typename T>
+static bool
+ReadArray(CacheReader &reader, size_t n, ConstBuffer<T> &dest)
+{
+  const void *p = reader.ReadArray(n, sizeof(T));
+  if (p == nullptr || !reader.Align(ALIGNMENT))
+    return false;
+
+  dest = ConstBuffer<T>((const T *)p, n);
+  return true;
+}
+
+gcc_const
+static bool
+IsSupportedType(unsigned type)
+{
+  return type == MS_SHAPE_NULL || type == MS_SHAPE_POINT ||
+    type == MS_SHAPE_LINE || type == MS_SHAPE_POLYGON;
+}
+
+/**
+ * Check the offsets of a shape record, so LoadShape() will not
+ * point outside of the arrays.  The index values themselves are not
+ * checked, just like the other cached data.
+ */
+static bool
+IsValidShape(const TopographyCache::Shape &shape,
+             ConstBuffer<unsigned short> lines, size_t n_points,
+             ConstBuffer<unsigned short> indices, size_t n_labels)
+{
+  if (!IsSupportedType(shape.type) || shape.num_lines > XShape::MAX_LINES ||
+      shape.first_line > lines.size ||
+      shape.num_lines > lines.size - shape.first_line ||
+      (shape.label != TopographyCache::ABSENT && shape.label >= n_labels))
+    return false;
+
+  size_t shape_points = 0;
+  for (unsigned i = 0; i < shape.num_lines; ++i)
+    shape_points += lines[shape.first_line + i];
+
+  if (shape.first_point > n_points ||
+      shape_points > n_points - shape.first_point)
+    return false;
+
+#ifdef ENABLE_OPENGL
+  const unsigned n_counts = shape.type == MS_SHAPE_LINE
+    ? shape.num_lines
+    : 1;
+
+  for (const uint32_t offset : shape.index_count) {
+    if (offset == TopographyCache::ABSENT)
+      continue;
+
+    if (offset > indices.size || n_counts > indices.size - offset)
+      return false;
+
+    size_t n_indices = 0;
+    for (unsigned i = 0; i < n_counts; ++i)
+      n_indices += indices[offset + i];
+
+    if (n_indices > indices.size - offset - n_counts)
+      return false;
+  }
+#endif
+
+  return true;
+}
+
+bool
+TopographyCache::Load(FileCache &cache, const TCHAR *name, const TCHAR *path,
+                      const Key &key)
+{
+  mapping.reset();
+  shapes = nullptr;
+
+  size_t offset;
+  std::unique_ptr<FileMapping> new_mapping =
+    cache.LoadMapped(name, path, VERSION, offset);
+  if (!new_mapping)
+    return false;
+
+  CacheReader reader(new_mapping->at(offset), new_mapping->end());
+
+  TopographyCacheHeader header;
+  if (!reader.Read(header) ||
+      header.point_size != sizeof(Point) ||
+      !(header.key == key) ||
+      !reader.Align(ALIGNMENT))
+    return false;
+
+  if (header.tile_columns == 0 || header.tile_columns > MAX_TILE_COLUMNS ||
+      header.tile_rows == 0 || header.tile_rows > MAX_TILE_COLUMNS)
+    return false;
+
+  const unsigned n_tiles = header.tile_columns * header.tile_rows;
+
+  ConstBuffer<Shape> new_shapes;
+  ConstBuffer<uint32_t> new_tile_start, new_tile_shapes;
+  ConstBuffer<unsigned short> new_lines, new_indices;
+  ConstBuffer<Point> new_points;
+  ConstBuffer<TCHAR> new_labels;
+  if (!ReadArray(reader, header.n_shapes, new_shapes) ||
+      !ReadArray(reader, n_tiles + 1, new_tile_start) ||
+      !ReadArray(reader, header.n_tile_shapes, new_tile_shapes) ||
+      !ReadArray(reader, header.n_lines, new_lines) ||
+      !ReadArray(reader, header.n_points, new_points) ||
+      !ReadArray(reader, header.n_indices, new_indices) ||
+      !ReadArray(reader, header.n_labels, new_labels))
+    return false;
+
+  /* validate everything which is used as an offset */
+
+  if (new_tile_start.front() != 0 ||
+      new_tile_start.back() != header.n_tile_shapes ||
+      !std::is_sorted(new_tile_start.begin(), new_tile_start.end()))
+    return false;
+
+  for (const uint32_t i : new_tile_shapes)
+    if (i >= header.n_shapes)
+      return false;
+
+  if (!new_labels.IsEmpty() && new_labels.back() != 0)
+    return false;
+
+  for (const Shape &shape : new_shapes)
+    if (!IsValidShape(shape, new_lines, new_points.size, new_indices,
+                      new_labels.size))
+      return false;
+
+  mapping = std::move(new_mapping);
+  center = header.center;
+  bounds = header.bounds;
+  tile_columns = header.tile_columns;
+  tile_rows = header.tile_rows;
+  shapes = new_shapes;
+  tile_start = new_tile_start;
+  tile_shapes = new_tile_shapes;
+  lines = new_lines;
+  points = new_points;
+  indices = new_indices;
+  labels = new_labels;
+  return true;
+}
+
+bool
+TopographyCache::FindShapes(const GeoBounds &area, ms_bitarray status) const
+{
+  if (!bounds.Overlaps(area))
+    return false;
+
+  VisitTiles(bounds, tile_columns, tile_rows, area,
+             [this, &area, status](unsigned tile){
+               for (unsigned j = tile_start[tile], end = tile_start[tile + 1];
+                    j < end; ++j) {
+                 const unsigned i = tile_shapes[j];
+                 if (!msGetBit(status, i) &&
+                     area.Overlaps(shapes[i].bounds))
+                   msSetBit(status, i, 1);
+               }
+             });
+
+  return true;
+}
+
+XShape *
+TopographyCache::LoadShape(unsigned i) const
+{
+  const Shape &shape = shapes[i];
+
+#ifdef ENABLE_OPENGL
+  const unsigned short *index_count[XShape::THINNING_LEVELS];
+  for (unsigned level = 0; level < XShape::THINNING_LEVELS; ++level)
+    index_count[level] = shape.index_count[level] != ABSENT
+      ? indices.data + shape.index_count[level]
+      : nullptr;
+#endif
+
+  return new XShape(shape.bounds, MS_SHAPE_TYPE(shape.type),
+                    { lines.data + shape.first_line, shape.num_lines },
+                    points.data + shape.first_point,
+                    shape.label != ABSENT ? labels.data + shape.label : nullptr
+#ifdef ENABLE_OPENGL
+                    , index_count
+#endif
+                    );
+}
+
+#ifdef ENABLE_OPENGL
+
+uint32_t
+TopographyCache::Builder::AddIndices(const XShape &shape, unsigned level)
+{
+  const auto shape_lines = shape.GetLines();
+  const uint32_t offset = indices.size();
+
+  if (shape.get_type() == MS_SHAPE_POLYGON && shape_lines.IsEmpty()) {
+    /* an empty polygon; BuildIndices() can't handle that */
+    indices.push_back(0);
+    return offset;
+  }
+
+  const unsigned short *count;
+  const unsigned short *src =
+    shape.get_indices(level, key.thinning_distance[level], count);
+  if (src == nullptr)
+    return ABSENT;
+
+  const unsigned n_counts = shape.get_type() == MS_SHAPE_LINE
+    ? shape_lines.size
+    : 1;
+  const unsigned n = std::accumulate(count, count + n_counts, 0u);
+
+  indices.insert(indices.end(), count, count + n_counts);
+  indices.insert(indices.end(), src, src + n);
+  return offset;
+}
+
+#endif
+
+void
+TopographyCache::Builder::Add(const XShape &shape)
+{
+  Shape s;
+
+  /* zero-fill all implicit padding bytes */
+  memset(&s, 0, sizeof(s));
+
+  s.bounds = shape.get_bounds();
+  s.type = shape.get_type();
+
+  const auto shape_lines = shape.GetLines();
+  s.num_lines = shape_lines.size;
+  s.first_line = lines.size();
+  lines.insert(lines.end(), shape_lines.begin(), shape_lines.end());
+
+  const unsigned n_points = std::accumulate(shape_lines.begin(),
+                                            shape_lines.end(), 0u);
+  s.first_point = points.size();
+  points.insert(points.end(),
+                shape.get_points(), shape.get_points() + n_points);
+
+  const TCHAR *label = shape.get_label();
+  if (label != nullptr) {
+    s.label = labels.size();
+    labels.insert(labels.end(), label, label + _tcslen(label) + 1);
+  } else
+    s.label = ABSENT;
+
+#ifdef ENABLE_OPENGL
+  for (auto &i : s.index_count)
+    i = ABSENT;
+
+  if (shape.get_type() == MS_SHAPE_POLYGON) {
+    for (unsigned level = 0; level < XShape::THINNING_LEVELS; ++level)
+      s.index_count[level] = AddIndices(shape, level);
+  } else if (shape.get_type() == MS_SHAPE_LINE) {
+    /* lines are drawn without indices on level 0 */
+    for (unsigned level = 1; level < XShape::THINNING_LEVELS; ++level)
+      s.index_count[level] = AddIndices(shape, level);
+  }
+#endif
+
+  shapes.push_back(s);
+}
+
+template<typename T>
+static void
+WriteArray(CacheWriter &writer, const std::vector<T> &v)
+{
+  writer.Write(v.data(), v.size() * sizeof(T));
+  writer.Align(ALIGNMENT);
+}
+
+bool
+TopographyCache::Builder::Save(FileCache &cache, const TCHAR *name,
+                               const TCHAR *path) const
+{
+  /* sort the shapes into a grid of tiles; a shape is listed in each
+     tile which its bounds overlap */
+
+  const unsigned n_columns =
+    std::max(1u, std::min(unsigned(sqrt(shapes.size() / SHAPES_PER_TILE)),
+                          MAX_TILE_COLUMNS));
+  const unsigned n_tiles = n_columns * n_columns;
+
+  std::vector<uint32_t> tile_start(n_tiles + 1, 0);
+  for (const Shape &shape : shapes)
+    VisitTiles(bounds, n_columns, n_columns, shape.bounds,
+               [&tile_start](unsigned tile){
+                 ++tile_start[tile + 1];
+               });
+
+  std::partial_sum(tile_start.begin(), tile_start.end(), tile_start.begin());
+
+  std::vector<uint32_t> tile_shapes(tile_start.back());
+  std::vector<uint32_t> tile_end(tile_start.begin(), tile_start.end() - 1);
+  for (unsigned i = 0; i < shapes.size(); ++i)
+    VisitTiles(bounds, n_columns, n_columns, shapes[i].bounds,
+               [&tile_shapes, &tile_end, i](unsigned tile){
+                 tile_shapes[tile_end[tile]++] = i;
+               });
+
+  FILE *file = cache.SaveMapped(name, path, VERSION);
+  if (file == nullptr)
+    return false;
+
+  TopographyCacheHeader header;
+
+  /* zero-fill all implicit padding bytes */
+  memset(&header, 0, sizeof(header));
+
+  header.point_size = sizeof(Point);
+  header.key = key;
+  header.center = center;
+  header.bounds = bounds;
+  header.tile_columns = header.tile_rows = n_columns;
+  header.n_shapes = shapes.size();
+  header.n_tile_shapes = tile_shapes.size();
+  header.n_lines = lines.size();
+  header.n_points = points.size();
+  header.n_indices = indices.size();
+  header.n_labels = labels.size();
+
+  CacheWriter writer(file);
+  writer.Write(header);
+  writer.Align(ALIGNMENT);
+  WriteArray(writer, shapes);
+  WriteArray(writer, tile_start);
+  WriteArray(writer, tile_shapes);
+  WriteArray(writer, lines);
+  WriteArray(writer, points);
+  WriteArray(writer, indices);
+  WriteArray(writer, labels);
+
+  if (writer.HasError()) {
+    cache.Cancel(name, file);
+    return false;
+  }
+
+  return cache.Commit(name, file);
+}
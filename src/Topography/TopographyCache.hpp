@@ -0,0 +1,206 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TOPOGRAPHY_CACHE_HPP
+#define XCSOAR_TOPOGRAPHY_CACHE_HPP
+
+#include "XShape.hpp"
+#include "Geo/GeoBounds.hpp"
+#include "Util/ConstBuffer.hxx"
+#include "Compiler.h"
+
+#include <memory>
+#include <vector>
+
+#include <stdint.h>
+#include <tchar.h>
+
+class FileCache;
+class FileMapping;
+
+/**
+ * A pre-processed copy of one topography layer, stored in the
+ * #FileCache.  The points are already converted to the type used by
+ * #XShape, the thinned indices of all levels have been built, and
+ * the shapes are sorted into a grid of tiles.  The file is memory
+ * mapped and the #XShape objects refer to it directly, so scanning
+ * the visible shapes never touches the shapefile.
+ */
+class TopographyCache {
+public:
+  typedef XShape::Point Point;
+
+  /**
+   * Marks a missing label or index array in #Shape.
+   */
+  static constexpr uint32_t ABSENT = ~uint32_t(0);
+
+  /**
+   * The #TopographyFile parameters which affect the data.  A snapshot
+   * made with different ones is rejected.
+   */
+  struct Key {
+    int32_t label_field;
+
+#ifdef ENABLE_OPENGL
+    /**
+     * The minimum point distance of each thinning level.
+     *
+     * @see TopographyFile::GetThinningDistance()
+     */
+    ShapeScalar thinning_distance[XShape::THINNING_LEVELS];
+#endif
+
+    gcc_pure
+    bool operator==(const Key &other) const;
+  };
+
+  /**
+   * The record of one shape.  All offsets are array indices.
+   */
+  struct Shape {
+    GeoBounds bounds;
+
+    uint32_t first_point, first_line;
+
+    /**
+     * Offset of the null-terminated label, or #ABSENT.
+     */
+    uint32_t label;
+
+#ifdef ENABLE_OPENGL
+    /**
+     * Offset of the XShape::index_count array of each thinning
+     * level, or #ABSENT.
+     */
+    uint32_t index_count[XShape::THINNING_LEVELS];
+#endif
+
+    uint8_t type, num_lines;
+  };
+
+  class Builder;
+
+private:
+  std::unique_ptr<FileMapping> mapping;
+
+  GeoPoint center;
+  GeoBounds bounds;
+
+  unsigned tile_columns, tile_rows;
+
+  ConstBuffer<Shape> shapes;
+
+  /**
+   * For each tile, the start of its list in #tile_shapes, plus the
+   * end of the last list.
+   */
+  ConstBuffer<uint32_t> tile_start;
+
+  /**
+   * The ids of the shapes which overlap each tile, in ascending
+   * order.
+   */
+  ConstBuffer<uint32_t> tile_shapes;
+
+  ConstBuffer<unsigned short> lines;
+  ConstBuffer<Point> points;
+  ConstBuffer<unsigned short> indices;
+  ConstBuffer<TCHAR> labels;
+
+public:
+  TopographyCache();
+  ~TopographyCache();
+
+  TopographyCache(const TopographyCache &) = delete;
+  TopographyCache &operator=(const TopographyCache &) = delete;
+
+  /**
+   * Map the snapshot of a topography layer.
+   *
+   * @param path the file the layer was loaded from (the map file)
+   * @return true on success, false if there is no valid snapshot
+   */
+  bool Load(FileCache &cache, const TCHAR *name, const TCHAR *path,
+            const Key &key);
+
+  unsigned size() const {
+    return shapes.size;
+  }
+
+  const GeoPoint &GetCenter() const {
+    return center;
+  }
+
+  const GeoBounds &GetBounds() const {
+    return bounds;
+  }
+
+  /**
+   * Set the bit of each shape which overlaps the specified area.
+   * Other bits are not modified.
+   *
+   * @return false if the area does not overlap this layer
+   */
+  bool FindShapes(const GeoBounds &area, ms_bitarray status) const;
+
+  /**
+   * Create an #XShape which refers to the mapped data.  It must be
+   * deleted before this object.
+   */
+  XShape *LoadShape(unsigned i) const;
+};
+
+/**
+ * Collects the shapes of a topography layer and writes them as a
+ * #TopographyCache snapshot.
+ */
+class TopographyCache::Builder {
+  const Key key;
+  const GeoPoint center;
+  const GeoBounds bounds;
+
+  std::vector<Shape> shapes;
+  std::vector<unsigned short> lines;
+  std::vector<Point> points;
+  std::vector<unsigned short> indices;
+  std::vector<TCHAR> labels;
+
+public:
+  Builder(const Key &_key, const GeoPoint &_center, const GeoBounds &_bounds)
+    :key(_key), center(_center), bounds(_bounds) {}
+
+  /**
+   * Append a shape.  This builds its thinned indices.
+   */
+  void Add(const XShape &shape);
+
+  bool Save(FileCache &cache, const TCHAR *name, const TCHAR *path) const;
+
+private:
+#ifdef ENABLE_OPENGL
+  uint32_t AddIndices(const XShape &shape, unsigned level);
+#endif
+};
+
+#endif
@@ -22,14 +22,61 @@ Copyright_License {
 */
 
 #include "Topography/TopographyFile.hpp"
+#include "Topography/TopographyCache.hpp"
 #include "Topography/XShape.hpp"
 #include "Convert.hpp"
 #include "Projection/WindowProjection.hpp"
+#include "Util/tstring.hpp"
 
 #include <zzip/lib.h>
 
 #include <algorithm>
 #include <stdlib.h>
+#include <string.h>
+
+static TopographyCache::Key
+MakeCacheKey(const TopographyFile &file, int label_field,
+             unsigned pixel_scale)
+{
+  TopographyCache::Key key;
+
+  /* zero-fill all implicit padding bytes */
+  memset(&key, 0, sizeof(key));
+
+  key.label_field = label_field;
+
+#ifdef ENABLE_OPENGL
+  for (unsigned i = 0; i < XShape::THINNING_LEVELS; ++i)
+    key.thinning_distance[i] = file.GetThinningDistance(i, pixel_scale);
+#else
+  (void)file;
+  (void)pixel_scale;
+#endif
+
+  return key;
+}
+
+struct TopographyFile::PendingCache {
+  FileCache &file_cache;
+  const tstring name, path;
+  const unsigned pixel_scale;
+
+  TopographyCache::Builder builder;
+
+  /**
+   * The next shape to be passed to the #builder.
+   */
+  int next_shape;
+
+  PendingCache(const CacheParameters &parameters,
+               const TopographyCache::Key &key,
+               const GeoPoint &center, const GeoBounds &bounds)
+    :file_cache(parameters.file_cache),
+     name(parameters.name), path(parameters.path),
+     pixel_scale(parameters.pixel_scale),
+     builder(key, center, bounds),
+     next_shape(0) {}
+};
 
 TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
                                fixed _threshold,
@@ -38,7 +85,8 @@ TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
                                const Color _color,
                                int _label_field,
                                ResourceId _icon, ResourceId _big_icon,
-                               unsigned _pen_width)
+                               unsigned _pen_width,
+                               const CacheParameters *cache_parameters)
   :dir(_dir), first(nullptr),
    label_field(_label_field), icon(_icon), big_icon(_big_icon),
    pen_width(_pen_width),
@@ -47,6 +95,17 @@ TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
    important_label_threshold(_important_label_threshold),
    cache_bounds(GeoBounds::Invalid())
 {
+  if (cache_parameters != nullptr) {
+    auto new_cache = LoadCache(cache_parameters->file_cache,
+                               cache_parameters->name,
+                               cache_parameters->path,
+                               cache_parameters->pixel_scale);
+    if (new_cache) {
+      SetCache(std::move(new_cache));
+      return;
+    }
+  }
+
   if (msShapefileOpen(&file, "rb", dir, filename, 0) == -1)
     return;
 
@@ -57,6 +116,15 @@ TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
 
   center = ImportRect(file.bounds).GetCenter();
 
+  if (cache_parameters != nullptr) {
+    /* converting takes long; use the shapefile until
+       ConvertCache() is done */
+    const auto key = MakeCacheKey(*this, label_field,
+                                  cache_parameters->pixel_scale);
+    pending_cache.reset(new PendingCache(*cache_parameters, key, center,
+                                         ImportRect(file.bounds)));
+  }
+
   shapes.ResizeDiscard(file.numshapes);
   std::fill(shapes.begin(), shapes.end(), ShapeList(nullptr));
 
@@ -72,6 +140,10 @@ TopographyFile::~TopographyFile()
     return;
 
   ClearCache();
+
+  if (cache != nullptr)
+    return;
+
   msShapefileClose(&file);
 
   if (dir != nullptr) {
@@ -91,11 +163,93 @@ TopographyFile::ClearCache()
   first = nullptr;
 }
 
-static XShape *
-LoadShape(shapefileObj *file, const GeoPoint &center, int i,
-          int label_field)
+std::unique_ptr<TopographyCache>
+TopographyFile::LoadCache(FileCache &file_cache, const TCHAR *name,
+                          const TCHAR *path, unsigned pixel_scale) const
+{
+  std::unique_ptr<TopographyCache> new_cache(new TopographyCache());
+  if (!new_cache->Load(file_cache, name, path,
+                       MakeCacheKey(*this, label_field, pixel_scale)) ||
+      new_cache->size() == 0)
+    new_cache.reset();
+
+  return new_cache;
+}
+
+void
+TopographyFile::SetCache(std::unique_ptr<TopographyCache> &&new_cache)
+{
+  cache = std::move(new_cache);
+  center = cache->GetCenter();
+
+  shapes.ResizeDiscard(cache->size());
+  std::fill(shapes.begin(), shapes.end(), ShapeList(nullptr));
+
+  cache_status.ResizeDiscard(msGetBitArraySize(cache->size()));
+
+  ++serial;
+}
+
+bool
+TopographyFile::ConvertCache(unsigned max_shapes)
+{
+  assert(pending_cache != nullptr);
+  assert(cache == nullptr);
+
+  PendingCache &p = *pending_cache;
+
+  for (const int end = std::min(p.next_shape + int(max_shapes),
+                                file.numshapes);
+       p.next_shape < end; ++p.next_shape) {
+    const XShape shape(&file, center, p.next_shape, label_field);
+    p.builder.Add(shape);
+  }
+
+  if (p.next_shape < file.numshapes)
+    return false;
+
+  std::unique_ptr<TopographyCache> new_cache;
+  if (p.builder.Save(p.file_cache, p.name.c_str(), p.path.c_str()))
+    new_cache = LoadCache(p.file_cache, p.name.c_str(), p.path.c_str(),
+                          p.pixel_scale);
+
+  /* whether that worked or not, don't try again */
+  pending_cache.reset();
+
+  if (!new_cache)
+    return false;
+
+  /* unlink the shapes loaded from the shapefile; the renderer
+     reaches them only through this list */
+  mutex.Lock();
+  first = nullptr;
+  mutex.Unlock();
+
+  ClearCache();
+
+  msShapefileClose(&file);
+
+  if (dir != nullptr) {
+    --dir->refcount;
+    zzip_dir_free(dir);
+  }
+
+  mutex.Lock();
+  SetCache(std::move(new_cache));
+  mutex.Unlock();
+
+  /* load the visible shapes again on the next Update() */
+  cache_bounds = GeoBounds::Invalid();
+  return true;
+}
+
+XShape *
+TopographyFile::LoadShape(int i)
 {
-  return new XShape(file, center, i, label_field);
+  if (cache != nullptr)
+    return cache->LoadShape(i);
+
+  return new XShape(&file, center, i, label_field);
 }
 
 bool
@@ -116,30 +270,43 @@ TopographyFile::Update(const WindowProjection &map_projection)
 
   cache_bounds = screenRect.Scale(fixed(2));
 
-  rectObj deg_bounds = ConvertRect(cache_bounds);
-
-  // Test which shapes are inside the given bounds and save the
-  // status to file.status
-  switch (msShapefileWhichShapes(&file, dir, deg_bounds, 0)) {
-  case MS_FAILURE:
-    ClearCache();
-    return false;
-
-  case MS_DONE:
-    /* screen is outside of map bounds */
-    return false;
+  ms_const_bitarray status;
+  if (cache != nullptr) {
+    /* the pre-processed copy has a tile index; this only reads the
+       tiles which overlap the new bounds */
+    std::fill(cache_status.begin(), cache_status.end(), 0);
+    if (!cache->FindShapes(cache_bounds, cache_status.begin()))
+      /* screen is outside of map bounds */
+      return false;
+
+    status = cache_status.begin();
+  } else {
+    rectObj deg_bounds = ConvertRect(cache_bounds);
+
+    // Test which shapes are inside the given bounds and save the
+    // status to file.status
+    switch (msShapefileWhichShapes(&file, dir, deg_bounds, 0)) {
+    case MS_FAILURE:
+      ClearCache();
+      return false;
+
+    case MS_DONE:
+      /* screen is outside of map bounds */
+      return false;
+
+    case MS_SUCCESS:
+      break;
+    }
 
-  case MS_SUCCESS:
-    break;
+    assert(file.status != nullptr);
+    status = file.status;
   }
 
-  assert(file.status != nullptr);
-
   // Iterate through the shapefile entries
   const ShapeList **current = &first;
   auto it = shapes.begin();
-  for (int i = 0; i < file.numshapes; ++i, ++it) {
-    if (!msGetBit(file.status, i)) {
+  for (int i = 0, n = shapes.size(); i < n; ++i, ++it) {
+    if (!msGetBit(status, i)) {
       // If the shape is outside the bounds
       // delete the shape from the cache
       if (it->shape != nullptr) {
@@ -161,7 +328,7 @@ TopographyFile::Update(const WindowProjection &map_projection)
         assert(*current != it);
 
         // shape isn't cached yet -> cache the shape
-        it->shape = LoadShape(&file, center, i, label_field);
+        it->shape = LoadShape(i);
         it->next = *current;
 
         /* insert into linked list (protected) */
@@ -189,10 +356,10 @@ TopographyFile::LoadAll()
   // Iterate through the shapefile entries
   const ShapeList **current = &first;
   auto it = shapes.begin();
-  for (int i = 0; i < file.numshapes; ++i, ++it) {
+  for (int i = 0, n = shapes.size(); i < n; ++i, ++it) {
     if (it->shape == nullptr)
       // shape isn't cached yet -> cache the shape
-      it->shape = LoadShape(&file, center, i, label_field);
+      it->shape = LoadShape(i);
     // update list pointer
     *current = it;
     current = &it->next;
@@ -36,14 +36,19 @@ Copyright_License {
 
 #ifdef ENABLE_OPENGL
 #include "XShapePoint.hpp"
+#include "Geo/FAISphere.hpp"
 #endif
 
 #include <forward_list>
+#include <memory>
 
 #include <assert.h>
+#include <tchar.h>
 
 class WindowProjection;
 class XShape;
+class TopographyCache;
+class FileCache;
 struct zzip_dir;
 
 class TopographyFile {
@@ -65,6 +70,26 @@ class TopographyFile {
 
   shapefileObj file;
 
+  /**
+   * The pre-processed copy of the shapefile.  If this is set, then
+   * #file is closed, and all shapes are loaded from here.
+   */
+  std::unique_ptr<TopographyCache> cache;
+
+  struct PendingCache;
+
+  /**
+   * The state of the conversion to a pre-processed copy, which is
+   * done by ConvertCache() while the shapes are loaded from #file.
+   */
+  std::unique_ptr<PendingCache> pending_cache;
+
+  /**
+   * The shapes found by TopographyCache::FindShapes(), with the
+   * layout of shapefileObj::status.
+   */
+  AllocatedArray<ms_uint32> cache_status;
+
   /**
    * The center of shapefileObj::bounds.
    */
@@ -151,6 +176,31 @@ public:
   };
 
 public:
+  /**
+   * Where to keep the pre-processed copy of a layer.
+   *
+   * @see TopographyCache
+   */
+  struct CacheParameters {
+    FileCache &file_cache;
+
+    /**
+     * The name of the cache file.
+     */
+    const TCHAR *name;
+
+    /**
+     * The file which contains the shapefile (the map file).  Changing
+     * it invalidates the copy.
+     */
+    const TCHAR *path;
+
+    /**
+     * The Layout::Scale(1) value the thinned indices are built for.
+     */
+    unsigned pixel_scale;
+  };
+
   /**
    * The constructor opens the given shapefile and clears the cache
    * @param shpname The shapefile to open (*.shp)
@@ -163,6 +213,9 @@ public:
    * @param label_threshold the zoom threshold for label rendering
    * @param important_label_threshold labels below this zoom threshold will
    * be rendered in default style
+   * @param cache_parameters if not nullptr, then the shapes are
+   * loaded from a pre-processed copy; if it does not exist yet, the
+   * shapefile is used until ConvertCache() has created it
    * @return
    */
   TopographyFile(zzip_dir *dir, const char *shpname,
@@ -172,7 +225,8 @@ public:
                  int label_field=-1,
                  ResourceId icon=ResourceId::Null(),
                  ResourceId big_icon=ResourceId::Null(),
-                 unsigned pen_width=1);
+                 unsigned pen_width=1,
+                 const CacheParameters *cache_parameters=nullptr);
 
   TopographyFile(const TopographyFile &) = delete;
 
@@ -274,10 +328,20 @@ public:
   unsigned GetThinningLevel(fixed map_scale) const;
 
   /**
-   * @return minimum distance between points in ShapePoint coordinates
+   * @return minimum distance between points in metres per pixel scale
    */
   gcc_pure
   unsigned GetMinimumPointDistance(unsigned level) const;
+
+  /**
+   * @param pixel_scale the value of Layout::Scale(1)
+   * @return minimum distance between points in ShapePoint coordinates
+   */
+  gcc_pure
+  ShapeScalar GetThinningDistance(unsigned level, unsigned pixel_scale) const {
+    return ShapeScalar(GetMinimumPointDistance(level))
+      / (pixel_scale * FAISphere::REARTH);
+  }
 #endif
 
   /**
@@ -290,8 +354,45 @@ public:
    */
   void LoadAll();
 
+  /**
+   * Does this layer wait for ConvertCache()?
+   */
+  bool HasPendingCache() const {
+    return pending_cache != nullptr;
+  }
+
+  /**
+   * Continue creating the pre-processed copy: convert up to
+   * #max_shapes shapes, and after the last one, save the copy and
+   * switch to it.  This must be called by the thread which calls
+   * Update().
+   *
+   * @return true if the layer has switched to the new copy; its
+   * shapes need to be loaded again with Update()
+   */
+  bool ConvertCache(unsigned max_shapes);
+
 protected:
   void ClearCache();
+
+private:
+  XShape *LoadShape(int i);
+
+  /**
+   * Load the pre-processed copy of the shapefile.
+   *
+   * @return the copy or nullptr if there is no valid one
+   */
+  std::unique_ptr<TopographyCache> LoadCache(FileCache &file_cache,
+                                             const TCHAR *name,
+                                             const TCHAR *path,
+                                             unsigned pixel_scale) const;
+
+  /**
+   * Switch to the pre-processed copy of the shapefile.  The caller
+   * must have closed #file or never opened it.
+   */
+  void SetCache(std::unique_ptr<TopographyCache> &&new_cache);
 };
 
 #endif
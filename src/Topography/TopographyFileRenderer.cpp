@@ -34,7 +34,6 @@ Copyright_License {
 #include "Util/AllocatedArray.hpp"
 #include "Util/tstring.hpp"
 #include "Geo/GeoClip.hpp"
-#include "Geo/FAISphere.hpp"
 
 #ifdef ENABLE_OPENGL
 #include "Screen/OpenGL/VertexPointer.hpp"
@@ -237,8 +236,7 @@ TopographyFileRenderer::Paint(Canvas &canvas,
 #ifdef ENABLE_OPENGL
   const unsigned level = file.GetThinningLevel(map_scale);
   const ShapeScalar min_distance =
-    ShapeScalar(file.GetMinimumPointDistance(level))
-    / (Layout::Scale(1) * FAISphere::REARTH);
+    file.GetThinningDistance(level, Layout::Scale(1));
 
 #ifdef HAVE_GLES
   const float *const opengl_matrix = nullptr;
@@ -257,6 +255,7 @@ TopographyFileRenderer::Paint(Canvas &canvas,
 #else // !ENABLE_OPENGL
   const GeoClip clip(projection.GetScreenBounds().Scale(fixed(1.1)));
   AllocatedArray<GeoPoint> geo_points;
+  AllocatedArray<RasterPoint> screen_points;
 
   int iskip = file.GetSkipSteps(map_scale);
 #endif
@@ -325,14 +324,20 @@ TopographyFileRenderer::Paint(Canvas &canvas,
         }
 #else // !ENABLE_OPENGL
         for (unsigned msize : lines) {
+        if (msize == 0)
+          continue;
+
         shape_renderer.Begin(msize);
 
-        const GeoPoint *end = points + msize - 1;
-        for (; points < end; ++points)
-          shape_renderer.AddPointIfDistant(projection.GeoToScreen(*points));
+        screen_points.GrowDiscard(msize);
+        projection.GeoToScreen(points, screen_points.begin(), msize);
+        points += msize;
+
+        for (unsigned i = 0; i < msize - 1; ++i)
+          shape_renderer.AddPointIfDistant(screen_points[i]);
 
         // make sure we always draw the last point
-        shape_renderer.AddPoint(projection.GeoToScreen(*points));
+        shape_renderer.AddPoint(screen_points[msize - 1]);
 
         shape_renderer.FinishPolyline(canvas);
       }
@@ -387,10 +392,11 @@ TopographyFileRenderer::Paint(Canvas &canvas,
 
           shape_renderer.Begin(msize);
 
-          for (unsigned i = 0; i < msize; ++i) {
-            GeoPoint g = geo_points[i];
-            shape_renderer.AddPointIfDistant(projection.GeoToScreen(g));
-          }
+          screen_points.GrowDiscard(msize);
+          projection.GeoToScreen(geo_points.begin(), screen_points.begin(),
+                                 msize);
+          for (unsigned i = 0; i < msize; ++i)
+            shape_renderer.AddPointIfDistant(screen_points[i]);
 
           shape_renderer.FinishPolygon(canvas);
 
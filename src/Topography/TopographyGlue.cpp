@@ -27,6 +27,7 @@ Copyright_License {
 #include "Profile/Profile.hpp"
 #include "LogFile.hpp"
 #include "Operation/Operation.hpp"
+#include "Screen/Layout.hpp"
 #include "IO/ZipLineReader.hpp"
 #include "Util/ConvertString.hpp"
 
@@ -39,7 +40,7 @@ Copyright_License {
  * the same ZIP file.
  */
 static bool
-LoadConfiguredTopographyZip(TopographyStore &store,
+LoadConfiguredTopographyZip(TopographyStore &store, FileCache *file_cache,
                             OperationEnvironment &operation)
 {
   TCHAR path[MAX_PATH];
@@ -58,17 +59,18 @@ LoadConfiguredTopographyZip(TopographyStore &store,
     return false;
   }
 
-  store.Load(operation, reader, nullptr, dir);
+  store.Load(operation, reader, nullptr, dir,
+             file_cache, path, Layout::Scale(1));
   zzip_dir_close(dir);
   return true;
 }
 
 bool
-LoadConfiguredTopography(TopographyStore &store,
+LoadConfiguredTopography(TopographyStore &store, FileCache *file_cache,
                          OperationEnvironment &operation)
 {
   LogFormat("Loading Topography File...");
   operation.SetText(_("Loading Topography File..."));
 
-  return LoadConfiguredTopographyZip(store, operation);
+  return LoadConfiguredTopographyZip(store, file_cache, operation);
 }
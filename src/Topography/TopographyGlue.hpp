@@ -25,10 +25,15 @@ Copyright_License {
 #define TOPOGRAPHY_GLUE_H
 
 class TopographyStore;
+class FileCache;
 class OperationEnvironment;
 
+/**
+ * @param file_cache if not nullptr, then a pre-processed copy of
+ * each layer is kept there
+ */
 bool
-LoadConfiguredTopography(TopographyStore &store,
+LoadConfiguredTopography(TopographyStore &store, FileCache *file_cache,
                          OperationEnvironment &operation);
 
 #endif
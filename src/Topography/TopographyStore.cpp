@@ -26,6 +26,7 @@ Copyright_License {
 #include "Util/StringAPI.hpp"
 #include "Util/StringUtil.hpp"
 #include "Util/ConvertString.hpp"
+#include "Util/tstring.hpp"
 #include "IO/LineReader.hpp"
 #include "OS/PathName.hpp"
 #include "Operation/Operation.hpp"
@@ -34,6 +35,7 @@ Copyright_License {
 #include "Resources.hpp"
 
 #include <stdint.h>
+#include <assert.h>
 #include <windef.h> // for MAX_PATH
 
 static bool
@@ -137,6 +139,32 @@ TopographyStore::LoadAll()
   }
 }
 
+bool
+TopographyStore::HasPendingCache() const
+{
+  for (const auto *file : files)
+    if (file->HasPendingCache())
+      return true;
+
+  return false;
+}
+
+bool
+TopographyStore::ConvertCache(unsigned max_shapes)
+{
+  for (auto *file : files) {
+    if (file->HasPendingCache()) {
+      if (!file->ConvertCache(max_shapes))
+        return false;
+
+      ++serial;
+      return true;
+    }
+  }
+
+  return false;
+}
+
 TopographyStore::~TopographyStore()
 {
   Reset();
@@ -144,8 +172,12 @@ TopographyStore::~TopographyStore()
 
 void
 TopographyStore::Load(OperationEnvironment &operation, NLineReader &reader,
-                      const TCHAR *directory, struct zzip_dir *zdir)
+                      const TCHAR *directory, struct zzip_dir *zdir,
+                      FileCache *file_cache, const TCHAR *cache_path,
+                      unsigned pixel_scale)
 {
+  assert(file_cache == nullptr || cache_path != nullptr);
+
   Reset();
 
   // Create buffer for the shape filenames
@@ -281,16 +313,35 @@ TopographyStore::Load(OperationEnvironment &operation, NLineReader &reader,
     }
 
     // Create TopographyFile instance from parsed line
-    TopographyFile *file = new TopographyFile(zdir, shape_filename,
-                                              shape_range, label_range,
-                                              labelImportantRange,
+    auto create = [&](const TopographyFile::CacheParameters *cache_parameters){
+      return new TopographyFile(zdir, shape_filename,
+                                shape_range, label_range,
+                                labelImportantRange,
 #ifdef ENABLE_OPENGL
-                                              Color(red, green, blue, alpha),
+                                Color(red, green, blue, alpha),
 #else
-                                              Color(red, green, blue),
+                                Color(red, green, blue),
 #endif
-                                              shape_field, icon, big_icon,
-                                              pen_width);
+                                shape_field, icon, big_icon,
+                                pen_width, cache_parameters);
+    };
+
+    TopographyFile *file;
+    const ACPToWideConverter layer_name(shape_filename_end);
+    if (file_cache != nullptr && layer_name.IsValid()) {
+      // Name the pre-processed copy after the shapefile (without
+      // the ".shp" suffix)
+      tstring cache_name(_T("topography-"));
+      cache_name.append(layer_name, _tcslen(layer_name) - 4);
+
+      const TopographyFile::CacheParameters cache_parameters = {
+        *file_cache, cache_name.c_str(), cache_path, pixel_scale,
+      };
+
+      file = create(&cache_parameters);
+    } else
+      file = create(nullptr);
+
     if (file->IsEmpty())
       // If the shape file could not be read -> skip this line/file
       delete file;
@@ -35,6 +35,7 @@ class WindowProjection;
 class TopographyFile;
 class NLineReader;
 class OperationEnvironment;
+class FileCache;
 struct zzip_dir;
 
 /**
@@ -93,8 +94,34 @@ public:
    */
   void LoadAll();
 
+  /**
+   * Is there a layer which still needs ConvertCache()?
+   */
+  gcc_pure
+  bool HasPendingCache() const;
+
+  /**
+   * Continue creating the pre-processed copy of the next layer which
+   * has none (see TopographyFile::ConvertCache()).  This must be
+   * called by the thread which calls ScanVisibility().
+   *
+   * @param max_shapes the maximum number of shapes converted in this
+   * call
+   * @return true if a layer has switched to its new copy
+   */
+  bool ConvertCache(unsigned max_shapes);
+
+  /**
+   * @param file_cache if not nullptr, then keep a pre-processed copy
+   * of each layer there (see #TopographyCache)
+   * @param cache_path the file which contains the layers (the map
+   * file); required if #file_cache is set
+   * @param pixel_scale the value of Layout::Scale(1)
+   */
   void Load(OperationEnvironment &operation, NLineReader &reader,
-            const TCHAR *directory, struct zzip_dir *zdir = nullptr);
+            const TCHAR *directory, struct zzip_dir *zdir = nullptr,
+            FileCache *file_cache = nullptr,
+            const TCHAR *cache_path = nullptr, unsigned pixel_scale = 1);
   void Reset();
 };
 
@@ -36,6 +36,7 @@ Copyright_License {
 #include <tchar.h>
 #include <string.h>
 #include <stdio.h>
+#include <assert.h>
 
 #ifdef _UNICODE
 #include <windows.h>
@@ -96,7 +97,11 @@ min_points_for_type(int shapelib_type)
 
 XShape::XShape(shapefileObj *shpfile, const GeoPoint &file_center, int i,
                int label_field)
-  :label(nullptr)
+  :mapped(false),
+#ifdef ENABLE_OPENGL
+   owned_indices(0),
+#endif
+   label(nullptr)
 {
 #ifdef ENABLE_OPENGL
   std::fill_n(index_count, THINNING_LEVELS, nullptr);
@@ -138,14 +143,13 @@ XShape::XShape(shapefileObj *shpfile, const GeoPoint &file_center, int i,
   /* OpenGL: convert GeoPoints to ShapePoints, make them relative to
      the map's boundary center */
 
-  points = new ShapePoint[num_points];
-  ShapePoint *p = points;
+  ShapePoint *p = new ShapePoint[num_points];
 #else // !ENABLE_OPENGL
   /* convert all points of all lines to GeoPoints */
 
-  points = new GeoPoint[num_points];
-  GeoPoint *p = points;
+  GeoPoint *p = new GeoPoint[num_points];
 #endif
+  points = p;
   for (unsigned l = 0; l < num_lines; ++l) {
     const pointObj *src = shape.line[l].point;
     num_points = lines[l];
@@ -171,14 +175,49 @@ XShape::XShape(shapefileObj *shpfile, const GeoPoint &file_center, int i,
   msFreeShape(&shape);
 }
 
+XShape::XShape(const GeoBounds &_bounds, MS_SHAPE_TYPE _type,
+               ConstBuffer<unsigned short> _lines, const Point *_points,
+               const TCHAR *_label
+#ifdef ENABLE_OPENGL
+               , const unsigned short *const _index_count[THINNING_LEVELS]
+#endif
+               )
+  :bounds(_bounds), type(_type), num_lines(_lines.size),
+   mapped(true), points(_points),
+#ifdef ENABLE_OPENGL
+   owned_indices(0),
+#endif
+   label(_label)
+{
+  assert(_lines.size <= MAX_LINES);
+
+  std::copy(_lines.begin(), _lines.end(), lines);
+
+#ifdef ENABLE_OPENGL
+  /* the indices follow the line counts (lines) or the total count
+     (polygons), see BuildIndices() */
+  const unsigned n_counts = type == MS_SHAPE_LINE ? num_lines : 1;
+  for (unsigned i = 0; i < THINNING_LEVELS; ++i) {
+    index_count[i] = _index_count[i];
+    indices[i] = _index_count[i] != nullptr
+      ? _index_count[i] + n_counts
+      : nullptr;
+  }
+#endif
+}
+
 XShape::~XShape()
 {
-  free(label);
-  delete[] points;
+  if (!mapped) {
+    free(const_cast<TCHAR *>(label));
+    delete[] points;
+  }
+
 #ifdef ENABLE_OPENGL
   // Note: index_count and indices share one buffer
   for (unsigned i = 0; i < THINNING_LEVELS; i++)
-    delete[] index_count[i];
+    if (owned_indices & (1u << i))
+      delete[] index_count[i];
 #endif
 }
 
@@ -201,6 +240,7 @@ XShape::BuildIndices(unsigned thinning_level, ShapeScalar min_distance)
     index_count[thinning_level] = idx_count =
       new GLushort[num_lines + num_points];
     indices[thinning_level] = idx = idx_count + num_lines;
+    owned_indices |= 1u << thinning_level;
 
     const unsigned short *end_l = lines + num_lines;
     const ShapePoint *p = points;
@@ -231,6 +271,7 @@ XShape::BuildIndices(unsigned thinning_level, ShapeScalar min_distance)
     index_count[thinning_level] = idx_count =
       new GLushort[1 + 3*(num_points-2) + 2*(num_lines-1)];
     indices[thinning_level] = idx = idx_count + 1;
+    owned_indices |= 1u << thinning_level;
 
     *idx_count = 0;
     const ShapePoint *pt = points;
@@ -38,11 +38,17 @@ Copyright_License {
 struct GeoPoint;
 
 class XShape {
+public:
   static constexpr unsigned MAX_LINES = 32;
 #ifdef ENABLE_OPENGL
   static constexpr unsigned THINNING_LEVELS = 4;
+
+  typedef ShapePoint Point;
+#else
+  typedef GeoPoint Point;
 #endif
 
+private:
   GeoBounds bounds;
 
   unsigned char type;
@@ -59,16 +65,29 @@ class XShape {
    */
   unsigned short lines[MAX_LINES];
 
+  /**
+   * If true, then #points, #label and the initial #indices point into
+   * a #TopographyCache file mapping, and are not owned by this
+   * object.
+   */
+  bool mapped;
+
   /**
    * All points of all lines.
    */
 #ifdef ENABLE_OPENGL
-  ShapePoint *points;
+  const ShapePoint *points;
+
+  /**
+   * A bit mask of the thinning levels whose #index_count buffer was
+   * allocated by BuildIndices().
+   */
+  unsigned char owned_indices;
 
   /**
    * Indices of polygon triangles or lines with reduced number of vertices.
    */
-  unsigned short *indices[THINNING_LEVELS];
+  const unsigned short *indices[THINNING_LEVELS];
 
   /**
    * For polygons this will contain the total number of triangle vertices
@@ -76,7 +95,7 @@ class XShape {
    * For lines there will be an array of size num_lines for each thinning
    * level, which contains the number of points for each line.
    */
-  unsigned short *index_count[THINNING_LEVELS];
+  const unsigned short *index_count[THINNING_LEVELS];
 
   /**
    * The start offset in the #GLArrayBuffer (vertex buffer object).
@@ -84,15 +103,31 @@ class XShape {
    */
   mutable unsigned offset;
 #else // !ENABLE_OPENGL
-  GeoPoint *points;
+  const GeoPoint *points;
 #endif
 
-  TCHAR *label;
+  const TCHAR *label;
 
 public:
   XShape(shapefileObj *shpfile, const GeoPoint &file_center, int i,
          int label_field=-1);
 
+  /**
+   * Construct a shape from pre-processed data, which is not copied.
+   * It must remain valid until this object is destroyed.
+   *
+   * @param _index_count the #index_count array of each thinning
+   * level, laid out like BuildIndices() does; nullptr if it shall be
+   * built on demand
+   */
+  XShape(const GeoBounds &_bounds, MS_SHAPE_TYPE _type,
+         ConstBuffer<unsigned short> _lines, const Point *_points,
+         const TCHAR *_label
+#ifdef ENABLE_OPENGL
+         , const unsigned short *const _index_count[THINNING_LEVELS]
+#endif
+         );
+
   XShape(const XShape &) = delete;
 
   ~XShape();
@@ -127,11 +162,7 @@ public:
     return { lines, num_lines };
   }
 
-#ifdef ENABLE_OPENGL
-  const ShapePoint *get_points() const {
-#else
-  const GeoPoint *get_points() const {
-#endif
+  const Point *get_points() const {
     return points;
   }
 
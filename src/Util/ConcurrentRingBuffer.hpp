@@ -0,0 +1,148 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CONCURRENT_RING_BUFFER_HPP
+#define XCSOAR_CONCURRENT_RING_BUFFER_HPP
+
+#include "AllocatedArray.hpp"
+
+#include <atomic>
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A bounded first-in-first-out queue which may be filled by any
+ * number of threads, and is emptied by one consumer thread.  It does
+ * not use locks: Push() and Pop() never block, they fail when the
+ * queue is full or empty.
+ *
+ * Each slot has a sequence number which tells whether it is ready to
+ * be filled or ready to be consumed in the current round (the
+ * algorithm of Dmitry Vyukov's bounded queue).  A producer which has
+ * claimed a slot but not finished filling it hides all following
+ * slots from the consumer until it is done.
+ */
+template<typename T>
+class ConcurrentRingBuffer {
+  struct Slot {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  AllocatedArray<Slot> slots;
+  const size_t mask;
+
+  /**
+   * The position of the next slot to be filled, shared by all
+   * producers.
+   */
+  std::atomic<size_t> push_position;
+
+  /**
+   * The position of the next slot to be consumed; owned by the
+   * consumer thread.
+   */
+  size_t pop_position;
+
+public:
+  /**
+   * @param capacity the number of slots; must be a power of two
+   */
+  explicit ConcurrentRingBuffer(size_t capacity)
+    :slots(capacity), mask(capacity - 1),
+     push_position(0), pop_position(0) {
+    assert(capacity >= 2);
+    assert((capacity & mask) == 0);
+
+    for (size_t i = 0; i < capacity; ++i)
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  ConcurrentRingBuffer(const ConcurrentRingBuffer &) = delete;
+  ConcurrentRingBuffer &operator=(const ConcurrentRingBuffer &) = delete;
+
+  size_t GetCapacity() const {
+    return mask + 1;
+  }
+
+  /**
+   * Claim a slot, let the function fill it and publish it.  May be
+   * called by any thread.
+   *
+   * @param f a function object receiving a reference to the slot's
+   * value
+   * @return false if the queue is full
+   */
+  template<typename F>
+  bool Push(F &&f) {
+    size_t position = push_position.load(std::memory_order_relaxed);
+    Slot *slot;
+
+    while (true) {
+      slot = &slots[position & mask];
+      const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const intptr_t difference = intptr_t(sequence) - intptr_t(position);
+
+      if (difference == 0) {
+        /* the slot is free in this round; try to claim it */
+        if (push_position.compare_exchange_weak(position, position + 1,
+                                                std::memory_order_relaxed))
+          break;
+      } else if (difference < 0)
+        /* the slot still holds a value of the previous round */
+        return false;
+      else
+        /* another producer was faster */
+        position = push_position.load(std::memory_order_relaxed);
+    }
+
+    f(slot->value);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Pass the oldest value to the function and release its slot.
+   * Must only be called by the consumer thread.
+   *
+   * @param f a function object receiving a reference to the slot's
+   * value
+   * @return false if the queue is empty
+   */
+  template<typename F>
+  bool Pop(F &&f) {
+    Slot &slot = slots[pop_position & mask];
+    const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != pop_position + 1)
+      return false;
+
+    f(slot.value);
+    slot.sequence.store(pop_position + mask + 1, std::memory_order_release);
+    ++pop_position;
+    return true;
+  }
+};
+
+#endif
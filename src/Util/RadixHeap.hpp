@@ -0,0 +1,202 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#ifndef XCSOAR_RADIX_HEAP_HPP
+#define XCSOAR_RADIX_HEAP_HPP
+
+#include "Compiler.h"
+
+#include <array>
+#include <vector>
+#include <algorithm>
+
+#include <assert.h>
+
+/**
+ * A priority queue for unsigned integer keys, lowest key first.  It
+ * is optimised for "monotone" use, where no key is pushed which is
+ * lower than the last one popped (e.g. Dijkstra's algorithm): each
+ * element is moved between buckets at most 32 times, and comparisons
+ * are replaced by bit operations.
+ *
+ * Pushing a lower key is allowed, but it redistributes all elements.
+ *
+ * Elements with the same key are popped in the order they were
+ * pushed.  (std::priority_queue leaves this order unspecified.)
+ *
+ * The bucket vectors keep their capacity across clear(), therefore
+ * a long-lived instance does not allocate memory after warming up.
+ *
+ * @param KeyFunction a function object which returns the unsigned
+ * key of a #T
+ */
+template<typename T, typename KeyFunction>
+class RadixHeap {
+  static constexpr unsigned N_BUCKETS = 33;
+
+  /**
+   * Bucket 0 contains the elements whose key equals #last.  Bucket i
+   * contains the elements whose key differs from #last first in bit
+   * i-1 (counting from the least significant bit).
+   */
+  std::array<std::vector<T>, N_BUCKETS> buckets;
+
+  /**
+   * The position of the next element to be popped from bucket 0.
+   */
+  unsigned head = 0;
+
+  /**
+   * The lower bound of all keys in the heap.
+   */
+  unsigned last = 0;
+
+  unsigned n = 0;
+
+  KeyFunction get_key;
+
+public:
+  gcc_pure
+  bool empty() const {
+    return n == 0;
+  }
+
+  gcc_pure
+  unsigned size() const {
+    return n;
+  }
+
+  void clear() {
+    for (auto &bucket : buckets)
+      bucket.clear();
+
+    head = 0;
+    last = 0;
+    n = 0;
+  }
+
+  /**
+   * Returns one of the elements with the lowest key.
+   */
+  const T &top() {
+    assert(!empty());
+
+    if (head == buckets[0].size())
+      Refill();
+
+    return buckets[0][head];
+  }
+
+  void pop() {
+    assert(!empty());
+
+    if (head == buckets[0].size())
+      Refill();
+
+    ++head;
+    --n;
+  }
+
+  void push(const T &value) {
+    const unsigned key = get_key(value);
+    if (gcc_unlikely(key < last))
+      Rebase(key);
+
+    buckets[GetBucket(key)].push_back(value);
+    ++n;
+  }
+
+private:
+  gcc_pure
+  unsigned GetBucket(unsigned key) const {
+    assert(key >= last);
+
+    return key == last
+      ? 0
+      : sizeof(unsigned) * 8 - __builtin_clz(key ^ last);
+  }
+
+  /**
+   * Bucket 0 has been consumed: find the lowest key in the first non-empty
+   * bucket, make it the new #last, and move that bucket's elements
+   * into the lower buckets.
+   */
+  void Refill() {
+    assert(head == buckets[0].size());
+
+    buckets[0].clear();
+    head = 0;
+
+    unsigned i = 1;
+    while (buckets[i].empty()) {
+      ++i;
+      assert(i < N_BUCKETS);
+    }
+
+    auto &bucket = buckets[i];
+    last = get_key(*std::min_element(bucket.begin(), bucket.end(),
+                                     [this](const T &a, const T &b){
+                                       return get_key(a) < get_key(b);
+                                     }));
+
+    for (const T &value : bucket) {
+      const unsigned b = GetBucket(get_key(value));
+      assert(b < i);
+      buckets[b].push_back(value);
+    }
+
+    bucket.clear();
+  }
+
+  /**
+   * Lower #last to the specified key, and move all elements to their
+   * new buckets.  Since #last decreases, elements can only move to a
+   * higher bucket, which has already been visited.
+   */
+  void Rebase(unsigned key) {
+    assert(key < last);
+
+    last = key;
+
+    auto &first = buckets[0];
+    first.erase(first.begin(), first.begin() + head);
+    head = 0;
+
+    for (unsigned i = N_BUCKETS; i-- > 0;) {
+      auto &bucket = buckets[i];
+      auto dest = bucket.begin();
+      for (const T &value : bucket) {
+        const unsigned b = GetBucket(get_key(value));
+        assert(b >= i);
+        if (b == i)
+          *dest++ = value;
+        else
+          buckets[b].push_back(value);
+      }
+
+      bucket.erase(dest, bucket.end());
+    }
+  }
+};
+
+#endif
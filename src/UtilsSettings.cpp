@@ -136,7 +136,7 @@ SettingsLeave(const UISettings &old_ui_settings)
 
   if (WaypointFileChanged || AirfieldFileChanged) {
     // re-load waypoints
-    WaypointGlue::LoadWaypoints(way_points, terrain, operation);
+    WaypointGlue::LoadWaypoints(way_points, terrain, file_cache, operation);
     WaypointDetails::ReadFileFromProfile(way_points, operation);
   }
 
@@ -169,7 +169,7 @@ SettingsLeave(const UISettings &old_ui_settings)
   if (TopographyFileChanged) {
     main_window.SetTopography(NULL);
     topography->Reset();
-    LoadConfiguredTopography(*topography, operation);
+    LoadConfiguredTopography(*topography, file_cache, operation);
     main_window.SetTopography(topography);
   }
 
@@ -181,7 +181,7 @@ SettingsLeave(const UISettings &old_ui_settings)
       glide_computer->ClearAirspaces();
 
     airspace_database.Clear();
-    ReadAirspace(airspace_database, terrain,
+    ReadAirspace(airspace_database, terrain, file_cache,
                  CommonInterface::GetComputerSettings().pressure,
                  operation);
   }
@@ -0,0 +1,264 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "WaypointCache.hpp"
+#include "Waypoint/Waypoints.hpp"
+#include "Terrain/RasterTerrain.hpp"
+#include "IO/FileCache.hpp"
+#include "IO/CacheWriter.hpp"
+#include "IO/CacheReader.hpp"
+#include "OS/FileMapping.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+/**
+ * The format version passed to FileCache::SaveMapped().
+ */
+static constexpr unsigned VERSION = 3;
+
+struct WaypointCacheHeader {
+  /**
+   * Catch builds with a different #fixed implementation.
+   */
+  unsigned fixed_size;
+
+  unsigned n_waypoints;
+
+  /**
+   * The bounds of the terrain which was used to look up missing
+   * elevations.  Empty if there was no terrain.
+   */
+  GeoBounds terrain_bounds;
+
+  /**
+   * The version of the terrain file, to notice when it is replaced
+   * by another one covering the same area.  Zero if there was no
+   * terrain.  The header is followed by the path of the terrain
+   * file.
+   */
+  FileCache::Identity terrain_identity;
+};
+
+gcc_pure
+static GeoBounds
+GetTerrainBounds(const RasterTerrain *terrain)
+{
+  if (terrain == nullptr)
+    return GeoBounds::Invalid();
+
+  RasterTerrain::Lease lease(*terrain);
+  return lease->GetBounds();
+}
+
+/**
+ * Determine the path and the #FileCache::Identity of the terrain
+ * file.
+ *
+ * @return false if the terrain file cannot be identified; the cache
+ * must not be used then
+ */
+static bool
+GetTerrainIdentity(const RasterTerrain *terrain, tstring &path,
+                   FileCache::Identity &identity)
+{
+  if (terrain == nullptr) {
+    path.clear();
+    identity = FileCache::Identity{0, 0};
+    return true;
+  }
+
+  path = terrain->GetPath();
+  return FileCache::GetIdentity(path.c_str(), identity);
+}
+
+static bool
+IsSameBounds(const GeoBounds &a, const GeoBounds &b)
+{
+  if (!a.IsValid() || !b.IsValid())
+    return a.IsValid() == b.IsValid();
+
+  return a.GetNorthWest() == b.GetNorthWest() &&
+    a.GetSouthEast() == b.GetSouthEast();
+}
+
+static void
+WriteStringList(CacheWriter &writer, const std::forward_list<tstring> &list)
+{
+  const uint32_t n = std::distance(list.begin(), list.end());
+  writer.Write(n);
+  for (const auto &i : list)
+    writer.WriteString(i);
+}
+
+static bool
+ReadStringList(CacheReader &reader, std::forward_list<tstring> &list)
+{
+  uint32_t n;
+  if (!reader.Read(n))
+    return false;
+
+  auto i = list.before_begin();
+  for (unsigned j = 0; j < n; ++j) {
+    i = list.emplace_after(i);
+    if (!reader.ReadString(*i))
+      return false;
+  }
+
+  return true;
+}
+
+static void
+WriteWaypoint(CacheWriter &writer, const Waypoint &wp)
+{
+  writer.Write(wp.original_id);
+  writer.Write(wp.location);
+  writer.Write(wp.elevation);
+  writer.Write(wp.runway);
+  writer.Write(wp.radio_frequency);
+  writer.Write(wp.type);
+  writer.Write(wp.flags);
+  writer.WriteString(wp.name);
+  writer.WriteString(wp.comment);
+  writer.WriteString(wp.details);
+  WriteStringList(writer, wp.files_embed);
+#ifdef HAVE_RUN_FILE
+  WriteStringList(writer, wp.files_external);
+#endif
+}
+
+static bool
+ReadWaypoint(CacheReader &reader, Waypoint &wp)
+{
+  return reader.Read(wp.original_id) &&
+    reader.Read(wp.location) &&
+    reader.Read(wp.elevation) &&
+    reader.Read(wp.runway) &&
+    reader.Read(wp.radio_frequency) &&
+    reader.Read(wp.type) &&
+    reader.Read(wp.flags) &&
+    reader.ReadString(wp.name) &&
+    reader.ReadString(wp.comment) &&
+    reader.ReadString(wp.details) &&
+    ReadStringList(reader, wp.files_embed)
+#ifdef HAVE_RUN_FILE
+    && ReadStringList(reader, wp.files_external)
+#endif
+    ;
+}
+
+bool
+WaypointCache::Load(FileCache &cache, const TCHAR *name, const TCHAR *path,
+                    int file_num, const RasterTerrain *terrain,
+                    Waypoints &waypoints)
+{
+  size_t offset;
+  const std::unique_ptr<FileMapping> mapping =
+    cache.LoadMapped(name, path, VERSION, offset);
+  if (!mapping)
+    return false;
+
+  tstring terrain_path;
+  FileCache::Identity terrain_identity;
+  if (!GetTerrainIdentity(terrain, terrain_path, terrain_identity))
+    return false;
+
+  CacheReader reader(mapping->at(offset), mapping->end());
+
+  WaypointCacheHeader header;
+  tstring header_terrain_path;
+  if (!reader.Read(header) ||
+      header.fixed_size != sizeof(fixed) ||
+      /* each waypoint takes at least as much as its location */
+      header.n_waypoints > mapping->size() / sizeof(GeoPoint) ||
+      !IsSameBounds(header.terrain_bounds, GetTerrainBounds(terrain)) ||
+      header.terrain_identity != terrain_identity ||
+      !reader.ReadString(header_terrain_path) ||
+      header_terrain_path != terrain_path)
+    return false;
+
+  /* decode everything before adding the first waypoint, to be able
+     to fall back to parsing the file cleanly */
+  std::vector<Waypoint> result(header.n_waypoints);
+  for (auto &wp : result) {
+    if (!ReadWaypoint(reader, wp))
+      return false;
+
+    wp.file_num = file_num;
+  }
+
+  if (!reader.IsEnd())
+    return false;
+
+  for (auto &wp : result)
+    waypoints.Append(std::move(wp));
+
+  return true;
+}
+
+bool
+WaypointCache::Save(FileCache &cache, const TCHAR *name, const TCHAR *path,
+                    const RasterTerrain *terrain, const Waypoints &waypoints)
+{
+  /* preserve the order of the file */
+  std::vector<const Waypoint *> sorted;
+  sorted.reserve(waypoints.size());
+  for (const auto &wp : waypoints)
+    sorted.push_back(&wp);
+
+  std::sort(sorted.begin(), sorted.end(),
+            [](const Waypoint *a, const Waypoint *b) {
+              return a->id < b->id;
+            });
+
+  tstring terrain_path;
+  FileCache::Identity terrain_identity;
+  if (!GetTerrainIdentity(terrain, terrain_path, terrain_identity))
+    return false;
+
+  FILE *file = cache.SaveMapped(name, path, VERSION);
+  if (file == nullptr)
+    return false;
+
+  WaypointCacheHeader header;
+  header.fixed_size = sizeof(fixed);
+  header.n_waypoints = sorted.size();
+  header.terrain_bounds = GetTerrainBounds(terrain);
+  header.terrain_identity = terrain_identity;
+
+  CacheWriter writer(file);
+  writer.Write(header);
+  writer.WriteString(terrain_path);
+
+  for (const Waypoint *wp : sorted)
+    WriteWaypoint(writer, *wp);
+
+  if (writer.HasError()) {
+    cache.Cancel(name, file);
+    return false;
+  }
+
+  return cache.Commit(name, file);
+}
@@ -32,6 +32,11 @@ Copyright_License {
 #include "Waypoint/WaypointWriter.hpp"
 #include "Operation/Operation.hpp"
 #include "WaypointFileType.hpp"
+#include "WaypointCache.hpp"
+#include "IO/FileCache.hpp"
+
+#include <algorithm>
+#include <vector>
 
 #include <windef.h> /* for MAX_PATH */
 
@@ -81,8 +86,8 @@ WaypointGlue::IsWritable()
 }
 
 static bool
-LoadWaypointFile(Waypoints &waypoints, const TCHAR *path, int file_num,
-                 const RasterTerrain *terrain, OperationEnvironment &operation)
+ParseWaypointFile(Waypoints &waypoints, const TCHAR *path, int file_num,
+                  const RasterTerrain *terrain, OperationEnvironment &operation)
 {
   WaypointReader reader(path, file_num);
   if (reader.Error()) {
@@ -100,9 +105,57 @@ LoadWaypointFile(Waypoints &waypoints, const TCHAR *path, int file_num,
   return true;
 }
 
+/**
+ * Load a waypoint file, preferring its snapshot in the #FileCache.
+ *
+ * @param cache_name the name of the snapshot; each file slot has its
+ * own
+ */
+static bool
+LoadWaypointFile(Waypoints &waypoints, const TCHAR *path, int file_num,
+                 const RasterTerrain *terrain,
+                 FileCache *cache, const TCHAR *cache_name,
+                 OperationEnvironment &operation)
+{
+  if (cache == nullptr || !FileCache::IsCacheable(path))
+    return ParseWaypointFile(waypoints, path, file_num, terrain, operation);
+
+  if (WaypointCache::Load(*cache, cache_name, path, file_num, terrain,
+                          waypoints))
+    return true;
+
+  /* parse into a separate object, which can then be saved as a
+     whole */
+  Waypoints parsed;
+  const bool success = ParseWaypointFile(parsed, path, file_num, terrain,
+                                         operation);
+  if (success &&
+      !WaypointCache::Save(*cache, cache_name, path, terrain, parsed))
+    LogFormat(_T("Failed to save waypoint cache: %s"), cache_name);
+
+  /* copy in file order; this also keeps the waypoints parsed before
+     an error, as without a cache */
+  std::vector<const Waypoint *> sorted;
+  for (const auto &wp : parsed)
+    sorted.push_back(&wp);
+
+  std::sort(sorted.begin(), sorted.end(),
+            [](const Waypoint *a, const Waypoint *b) {
+              return a->id < b->id;
+            });
+
+  for (const Waypoint *wp : sorted) {
+    Waypoint copy(*wp);
+    waypoints.Append(std::move(copy));
+  }
+
+  return success;
+}
+
 bool
 WaypointGlue::LoadWaypoints(Waypoints &way_points,
                             const RasterTerrain *terrain,
+                            FileCache *cache,
                             OperationEnvironment &operation)
 {
   LogFormat("ReadWaypoints");
@@ -117,15 +170,18 @@ WaypointGlue::LoadWaypoints(Waypoints &way_points,
 
   // ### FIRST FILE ###
   if (Profile::GetPath(ProfileKeys::WaypointFile, path))
-    found |= LoadWaypointFile(way_points, path, 1, terrain, operation);
+    found |= LoadWaypointFile(way_points, path, 1, terrain,
+                              cache, _T("waypoints1"), operation);
 
   // ### SECOND FILE ###
   if (Profile::GetPath(ProfileKeys::AdditionalWaypointFile, path))
-    found |= LoadWaypointFile(way_points, path, 2, terrain, operation);
+    found |= LoadWaypointFile(way_points, path, 2, terrain,
+                              cache, _T("waypoints2"), operation);
 
   // ### WATCHED WAYPOINT/THIRD FILE ###
   if (Profile::GetPath(ProfileKeys::WatchedWaypointFile, path))
-    found |= LoadWaypointFile(way_points, path, 3, terrain, operation);
+    found |= LoadWaypointFile(way_points, path, 3, terrain,
+                              cache, _T("waypoints3"), operation);
 
   // ### MAP/FOURTH FILE ###
 
@@ -134,10 +190,12 @@ WaypointGlue::LoadWaypoints(Waypoints &way_points,
     TCHAR *tail = path + _tcslen(path);
 
     _tcscpy(tail, _T("/waypoints.xcw"));
-    found |= LoadWaypointFile(way_points, path, 0, terrain, operation);
+    found |= LoadWaypointFile(way_points, path, 0, terrain,
+                              cache, _T("waypoints0xcw"), operation);
 
     _tcscpy(tail, _T("/waypoints.cup"));
-    found |= LoadWaypointFile(way_points, path, 0, terrain, operation);
+    found |= LoadWaypointFile(way_points, path, 0, terrain,
+                              cache, _T("waypoints0cup"), operation);
   }
 
   // Optimise the waypoint list after attaching new waypoints
@@ -0,0 +1,130 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+/*
+ * Measures AbortTask::Update() with 5000 landables around the
+ * aircraft: once gliding straight through the field, and once
+ * circling slowly, where consecutive fixes are close to each other.
+ */
+
+#include "harness_waypoints.hpp"
+#include "Engine/Task/Unordered/AbortTask.hpp"
+#include "Engine/Task/TaskBehaviour.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
+#include "Geo/GeoVector.hpp"
+#include "OS/Clock.hpp"
+
+#include <algorithm>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * The number of landables in the waypoint database.
+ */
+static constexpr unsigned N_LANDABLES = 5000;
+
+/**
+ * The number of updates per run.
+ */
+static constexpr unsigned N_UPDATES = 1000;
+
+class TestAbortTask : public AbortTask {
+public:
+  TestAbortTask(const TaskBehaviour &tb, const Waypoints &wps)
+    :AbortTask(tb, wps) {}
+};
+
+/**
+ * @param speed the ground speed [m/s]
+ * @param turn_rate the heading change per update
+ * @param sink the altitude loss per update [m]
+ */
+static uint64_t
+Run(const Waypoints &waypoints, const TaskBehaviour &task_behaviour,
+    fixed speed, Angle turn_rate, fixed sink, unsigned &n_alternates)
+{
+  const GlidePolar glide_polar(fixed(1));
+
+  TestAbortTask task(task_behaviour, waypoints);
+  task.SetActive(true);
+
+  AircraftState state;
+  state.Reset();
+  state.location = GeoPoint(Angle::Degrees(-0.3), Angle::Degrees(-0.2));
+  state.altitude = fixed(1500);
+  state.flying = true;
+  state.track = Angle::Degrees(40);
+  state.ground_speed = speed;
+  state.wind = SpeedVector(Angle::Degrees(270), fixed(5));
+
+  AircraftState state_last = state;
+
+  n_alternates = 0;
+
+  const uint64_t start = MonotonicClockUS();
+
+  for (unsigned i = 0; i < N_UPDATES; ++i) {
+    state_last = state;
+    state.time += fixed(1);
+    state.location = GeoVector(speed, state.track).EndPoint(state.location);
+    state.track = (state.track + turn_rate).AsBearing();
+    state.altitude -= sink;
+
+    task.Update(state, state_last, glide_polar);
+    n_alternates += task.TaskSize();
+  }
+
+  return MonotonicClockUS() - start;
+}
+
+static void
+Print(const char *name, uint64_t duration, unsigned n_alternates)
+{
+  printf("%-8s %8llu us %6llu us/update %6u alternates\n", name,
+         (unsigned long long)duration,
+         (unsigned long long)(duration / N_UPDATES),
+         n_alternates);
+}
+
+int main(int argc, char **argv)
+{
+  Waypoints waypoints;
+  SetupLandables(waypoints, N_LANDABLES);
+
+  TaskBehaviour task_behaviour;
+  task_behaviour.SetDefaults();
+
+  unsigned n_alternates;
+  uint64_t duration = Run(waypoints, task_behaviour, fixed(30),
+                          Angle::Zero(), fixed(1), n_alternates);
+  Print("glide", duration, n_alternates);
+
+  /* a very slow circle: 1 m/s (hovering in ridge lift or a 5 Hz GPS
+     in a thermal) */
+  duration = Run(waypoints, task_behaviour, fixed(1),
+                 Angle::Degrees(2), fixed(0.1), n_alternates);
+  Print("slow", duration, n_alternates);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,288 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Loads an airspace file and compares the packed R-tree which indexes
+ * the #Airspaces database with the kd-tree which was used before, on
+ * random range, "inside" and nearest queries.  Then it measures the
+ * exact inside and intersection tests of the #Airspaces class.
+ */
+
+#include "Airspace/AirspaceParser.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "Engine/Airspace/AirspaceVisitor.hpp"
+#include "Engine/Airspace/AirspaceIntersectionVisitor.hpp"
+#include "Geo/Flat/PackedRTree.hpp"
+#include "Geo/Flat/BoundingBoxDistance.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Time/PeriodClock.hpp"
+#include "OS/Args.hpp"
+#include "IO/FileLineReader.hpp"
+#include "Operation/Operation.hpp"
+
+#include <kdtree++/kdtree.hpp>
+
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * The kd-tree configuration which was used by #AirspacesInterface.
+ */
+struct kd_get_bounds {
+  typedef int result_type;
+
+  int operator()(const FlatBoundingBox &d, const unsigned k) const {
+    switch(k) {
+    case 0:
+      return d.GetLowerLeft().longitude;
+    case 1:
+      return d.GetLowerLeft().latitude;
+    case 2:
+      return d.GetUpperRight().longitude;
+    case 3:
+      return d.GetUpperRight().latitude;
+    default:
+      assert(false);
+      gcc_unreachable();
+    };
+  };
+};
+
+struct kd_distance {
+  typedef BBDist distance_type;
+
+  distance_type operator()(const int a, const int b, const size_t dim) const {
+    return BBDist(dim, std::max((dim < 2) ? (b - a) : (a - b), 0));
+  }
+};
+
+typedef KDTree::KDTree<4, Airspace, kd_get_bounds, kd_distance> KDAirspaceTree;
+
+typedef PackedRTree<Airspace> RAirspaceTree;
+
+static constexpr unsigned N_QUERIES = 10000;
+
+static constexpr fixed RANGE = fixed(20000);
+
+struct AlwaysTrue {
+  bool operator()(const Airspace &) const {
+    return true;
+  }
+};
+
+struct Counter {
+  unsigned n = 0;
+
+  void operator()(const Airspace &) {
+    ++n;
+  }
+};
+
+class CountingAirspaceVisitor final : public AirspaceIntersectionVisitor {
+public:
+  unsigned n = 0;
+
+  void Visit(const AbstractAirspace &) override {
+    ++n;
+  }
+};
+
+struct Query {
+  GeoPoint location;
+  Airspace target;
+  int range;
+};
+
+static unsigned
+VisitWithinRange(const KDAirspaceTree &tree, const std::vector<Query> &queries)
+{
+  Counter counter;
+  for (const auto &q : queries)
+    tree.visit_within_range(q.target, -q.range, counter);
+  return counter.n;
+}
+
+static unsigned
+VisitWithinRange(const RAirspaceTree &tree, const std::vector<Query> &queries)
+{
+  Counter counter;
+  for (const auto &q : queries)
+    tree.VisitWithinRange(q.target, q.range, counter);
+  return counter.n;
+}
+
+static unsigned
+VisitInside(const KDAirspaceTree &tree, const std::vector<Query> &queries)
+{
+  Counter counter;
+  for (const auto &q : queries)
+    tree.visit_within_range(q.target, 0, counter);
+  return counter.n;
+}
+
+static unsigned
+VisitInside(const RAirspaceTree &tree, const std::vector<Query> &queries)
+{
+  Counter counter;
+  for (const auto &q : queries)
+    tree.VisitWithinRange(q.target, 0, counter);
+  return counter.n;
+}
+
+static unsigned
+FindNearest(const KDAirspaceTree &tree, const std::vector<Query> &queries)
+{
+  unsigned n = 0;
+  for (const auto &q : queries)
+    if (tree.find_nearest_if(q.target, BBDist(0, q.range),
+                             AlwaysTrue()).first != tree.end())
+      ++n;
+  return n;
+}
+
+static unsigned
+FindNearest(const RAirspaceTree &tree, const std::vector<Query> &queries)
+{
+  unsigned n = 0;
+  for (const auto &q : queries)
+    if (tree.FindNearestIf(q.target, q.range,
+                           AlwaysTrue()).first != tree.end())
+      ++n;
+  return n;
+}
+
+template<typename F>
+static void
+Measure(const char *name, F &&f)
+{
+  PeriodClock clock;
+  clock.Update();
+  const unsigned n = f();
+  printf("  %-14s %6d ms %8u results\n", name, clock.Elapsed(), n);
+}
+
+template<typename Tree>
+static void
+RunQueries(const Tree &tree, const std::vector<Query> &queries)
+{
+  Measure("within range", [&tree, &queries](){
+      return VisitWithinRange(tree, queries);
+    });
+  Measure("inside", [&tree, &queries](){
+      return VisitInside(tree, queries);
+    });
+  Measure("nearest", [&tree, &queries](){
+      return FindNearest(tree, queries);
+    });
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "PATH");
+  const char *path = args.ExpectNext();
+  args.ExpectEnd();
+
+  FileLineReader reader(path, Charset::AUTO);
+  if (reader.error()) {
+    fprintf(stderr, "Failed to open input file\n");
+    return EXIT_FAILURE;
+  }
+
+  Airspaces airspaces;
+  AirspaceParser parser(airspaces);
+
+  NullOperationEnvironment operation;
+  if (!parser.Parse(reader, operation)) {
+    fprintf(stderr, "Failed to parse input file\n");
+    return EXIT_FAILURE;
+  }
+
+  airspaces.Optimise();
+
+  const std::vector<Airspace> envelopes(airspaces.begin(), airspaces.end());
+  if (envelopes.empty()) {
+    fprintf(stderr, "No airspaces\n");
+    return EXIT_FAILURE;
+  }
+
+  printf("%u airspaces\n", (unsigned)envelopes.size());
+
+  /* query points scattered around the airspaces */
+  const FlatProjection &projection = airspaces.GetProjection();
+  std::vector<Query> queries;
+  queries.reserve(N_QUERIES);
+  srand(42);
+  for (unsigned i = 0; i < N_QUERIES; ++i) {
+    const AbstractAirspace &airspace =
+      envelopes[rand() % envelopes.size()].GetAirspace();
+    GeoPoint location = airspace.GetReferenceLocation();
+    location.longitude += Angle::Degrees((rand() % 1000 - 500) * 0.0005);
+    location.latitude += Angle::Degrees((rand() % 1000 - 500) * 0.0005);
+
+    queries.push_back({location, Airspace(location, projection),
+          projection.ProjectRangeInteger(location, RANGE)});
+  }
+
+  KDAirspaceTree kd_tree;
+  RAirspaceTree r_tree;
+
+  printf("kd-tree\n");
+  Measure("build", [&kd_tree, &envelopes](){
+      for (const auto &i : envelopes)
+        kd_tree.insert(i);
+      kd_tree.optimise();
+      return (unsigned)kd_tree.size();
+    });
+  RunQueries(kd_tree, queries);
+
+  printf("packed R-tree\n");
+  Measure("build", [&r_tree, &envelopes](){
+      for (const auto &i : envelopes)
+        r_tree.insert(i);
+      r_tree.Optimise();
+      return r_tree.size();
+    });
+  RunQueries(r_tree, queries);
+
+  printf("Airspaces\n");
+  Measure("inside", [&airspaces, &queries](){
+      CountingAirspaceVisitor visitor;
+      for (const auto &q : queries)
+        airspaces.VisitInside(q.location, visitor);
+      return visitor.n;
+    });
+  Measure("intersecting", [&airspaces, &queries](){
+      CountingAirspaceVisitor visitor;
+      for (const auto &q : queries)
+        airspaces.VisitIntersecting(q.location,
+                                    GeoVector(RANGE, Angle::Degrees(30))
+                                    .EndPoint(q.location),
+                                    visitor);
+      return visitor.n;
+    });
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,168 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Replays a flight and reports the wall time of each contest solver
+ * (exhaustive search), first one after another, then with the
+ * solvers of each contest running concurrently.
+ */
+
+#include "Engine/Trace/Trace.hpp"
+#include "Contest/ContestManager.hpp"
+#include "Computer/ContestSolverThread.hpp"
+#include "Time/PeriodClock.hpp"
+#include "OS/Args.hpp"
+#include "DebugReplay.hpp"
+
+#include <stdio.h>
+
+static Trace full_trace(0, Trace::null_time, 1024);
+static Trace triangle_trace(0, Trace::null_time, 256);
+static Trace sprint_trace(0, 9000, 128);
+
+static constexpr struct {
+  Contest contest;
+  const char *name;
+} contests[] = {
+  { Contest::OLC_SPRINT, "olc_sprint" },
+  { Contest::OLC_FAI, "olc_fai" },
+  { Contest::OLC_CLASSIC, "olc_classic" },
+  { Contest::OLC_LEAGUE, "olc_league" },
+  { Contest::OLC_PLUS, "olc_plus" },
+  { Contest::DMST, "dmst" },
+  { Contest::XCONTEST, "xcontest" },
+  { Contest::DHV_XC, "dhv_xc" },
+  { Contest::SIS_AT, "sis_at" },
+  { Contest::NET_COUPE, "net_coupe" },
+};
+
+static void
+Replay(DebugReplay &replay)
+{
+  bool released = false;
+
+  while (replay.Next()) {
+    const MoreData &basic = replay.Basic();
+    if (!basic.time_available || !basic.location_available ||
+        !basic.NavAltitudeAvailable())
+      continue;
+
+    if (!released && !negative(replay.Calculated().flight.release_time)) {
+      released = true;
+
+      triangle_trace.EraseEarlierThan(replay.Calculated().flight.release_time);
+      full_trace.EraseEarlierThan(replay.Calculated().flight.release_time);
+      sprint_trace.EraseEarlierThan(replay.Calculated().flight.release_time);
+    }
+
+    const TracePoint point(basic);
+    triangle_trace.push_back(point);
+    full_trace.push_back(point);
+    sprint_trace.push_back(point);
+  }
+}
+
+static unsigned
+SolveSequential(ContestManager &manager)
+{
+  ContestManager::SolverJob jobs[ContestManager::MAX_SOLVERS];
+  SolverResult results[ContestManager::MAX_SOLVERS];
+  const unsigned n = manager.GetSolvers(jobs);
+
+  unsigned total = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    PeriodClock clock;
+    clock.Update();
+    results[i] = jobs[i].solver->Solve(true);
+
+    const unsigned elapsed = clock.Elapsed();
+    printf("  result[%u]: %u ms\n", jobs[i].index, elapsed);
+    total += elapsed;
+  }
+
+  manager.Merge(jobs, results, n, true);
+  return total;
+}
+
+static unsigned
+SolveParallel(ContestManager &manager, ContestSolverThread *threads)
+{
+  PeriodClock clock;
+  clock.Update();
+
+  ContestManager::SolverJob jobs[ContestManager::MAX_SOLVERS];
+  SolverResult results[ContestManager::MAX_SOLVERS];
+  const unsigned n = manager.GetSolvers(jobs);
+
+  for (unsigned i = 0; i < n; ++i)
+    threads[i].Start(*jobs[i].solver, true);
+
+  for (unsigned i = 0; i < n; ++i)
+    results[i] = threads[i].Wait();
+
+  manager.Merge(jobs, results, n, true);
+  return clock.Elapsed();
+}
+
+int
+main(int argc, char **argv)
+{
+  Args args(argc, argv, "DRIVER FILE");
+  DebugReplay *replay = CreateDebugReplay(args);
+  if (replay == NULL)
+    return EXIT_FAILURE;
+
+  args.ExpectEnd();
+
+  Replay(*replay);
+  delete replay;
+
+  printf("trace: %u full, %u triangle, %u sprint points\n",
+         full_trace.size(), triangle_trace.size(), sprint_trace.size());
+
+  ContestSolverThread threads[ContestManager::MAX_SOLVERS];
+
+  unsigned sequential_total = 0, parallel_total = 0;
+  for (const auto &i : contests) {
+    ContestManager manager(i.contest,
+                           full_trace, triangle_trace, sprint_trace);
+
+    printf("%s\n", i.name);
+    const unsigned sequential = SolveSequential(manager);
+
+    manager.Reset();
+    const unsigned parallel = SolveParallel(manager, threads);
+
+    printf("  total: %u ms sequential, %u ms parallel\n",
+           sequential, parallel);
+    sequential_total += sequential;
+    parallel_total += parallel;
+  }
+
+  printf("all contests: %u ms sequential, %u ms parallel\n",
+         sequential_total, parallel_total);
+
+  for (auto &thread : threads)
+    thread.LockStop();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,324 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Opens several DeviceDescriptor objects on ports whose receive
+ * threads deliver NMEA sentences as fast as possible, while another
+ * thread calls DeviceBlackboard::Merge() like the MergeThread, and
+ * measures the time from receiving a sentence until it has been
+ * merged.
+ */
+
+#include "Device/Descriptor.hpp"
+#include "Device/Config.hpp"
+#include "Device/Port/Port.hpp"
+#include "Device/Port/ConfiguredPort.hpp"
+#include "Blackboard/DeviceBlackboard.hpp"
+#include "Components.hpp"
+#include "Protection.hpp"
+#include "Input/InputQueue.hpp"
+#include "Event/Notify.hpp"
+#include "Job/Async.hpp"
+#include "Operation/Operation.hpp"
+#include "IO/DataHandler.hpp"
+#include "NMEA/Checksum.hpp"
+#include "Thread/Thread.hpp"
+#include "Thread/Mutex.hpp"
+#include "Thread/Cond.hpp"
+#include "OS/Clock.hpp"
+#include "OS/Sleep.h"
+#include "OS/Args.hpp"
+
+#include <algorithm>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static constexpr unsigned MAX_DEVICES = NUMDEV;
+
+/**
+ * How long the benchmark runs [ms].
+ */
+static constexpr unsigned DURATION = 2000;
+
+/**
+ * One update burst of a FLARM with GPS and barometer.
+ */
+static const char *const SENTENCES[] = {
+  "$GPRMC,082310,A,5103.5403,N,00741.5742,E,055.3,022.4,230610,000.3,W",
+  "$GPGGA,082310,5103.5403,N,00741.5742,E,1,08,0.9,420.0,M,48.0,M,,",
+  "$PGRMZ,1403,F,2",
+  "$PFLAU,3,1,2,1,1,-30,2,-32,755",
+  "$PFLAA,0,-1234,1234,220,2,DD8F12,180,,30,-1.4,1",
+  "$PFLAA,1,3021,-1024,-312,2,DD8F13,45,,28,2.1,1",
+  "$PFLAA,0,512,-4400,86,2,DD8F14,270,,33,0.3,1",
+};
+
+static constexpr unsigned N_SENTENCES = sizeof(SENTENCES) / sizeof(SENTENCES[0]);
+
+/**
+ * The burst as it arrives on the port.
+ */
+static char burst[N_SENTENCES * 128];
+static size_t burst_length;
+
+DeviceBlackboard *device_blackboard;
+
+bool InputEvents::processGlideComputer(unsigned) { return false; }
+
+/* there is no event loop; these are only used by
+   DeviceDescriptor::Open(), which this program doesn't call */
+Notify::Notify():pending(false) {}
+void Notify::SendNotification() {}
+void Notify::ClearNotification() {}
+void AsyncJobRunner::Start(Job *, OperationEnvironment &, Notify *) {}
+void AsyncJobRunner::Cancel() {}
+Job *AsyncJobRunner::Wait() { return nullptr; }
+void AsyncJobRunner::Run() {}
+
+/**
+ * Replaces the MergeThread, which would also run the calculations.
+ */
+static struct {
+  Mutex mutex;
+  Cond cond;
+
+  /**
+   * The time [us] of the oldest TriggerMergeThread() call which was
+   * not yet followed by a merge; 0 if there is none.
+   */
+  uint64_t pending_since;
+
+  bool stop;
+
+  uint64_t latency_sum, latency_max;
+  unsigned n_latencies, n_merges;
+} merge;
+
+void
+TriggerMergeThread()
+{
+  ScopeLock protect(merge.mutex);
+  if (merge.pending_since == 0) {
+    merge.pending_since = MonotonicClockUS();
+    merge.cond.Signal();
+  }
+}
+
+class MergeThread final : public Thread {
+protected:
+  void Run() override {
+    ScopeLock protect(merge.mutex);
+
+    while (true) {
+      while (merge.pending_since == 0 && !merge.stop)
+        merge.cond.Wait(merge.mutex);
+
+      if (merge.stop)
+        break;
+
+      const uint64_t since = merge.pending_since;
+      merge.pending_since = 0;
+      merge.mutex.Unlock();
+
+      device_blackboard->mutex.Lock();
+      device_blackboard->Merge();
+      device_blackboard->mutex.Unlock();
+
+      const uint64_t latency = MonotonicClockUS() - since;
+
+      /* the real MergeThread runs the (slower) Process() and
+         notifies the CalculationThread */
+      Sleep(0);
+
+      merge.mutex.Lock();
+      merge.latency_sum += latency;
+      merge.latency_max = std::max(merge.latency_max, latency);
+      ++merge.n_latencies;
+      ++merge.n_merges;
+    }
+  }
+};
+
+/**
+ * A #Port whose receive thread delivers the #burst repeatedly for
+ * #DURATION.
+ */
+class BenchmarkPort final : public Port, Thread {
+  DataHandler &handler;
+
+public:
+  unsigned n_lines;
+
+  BenchmarkPort(DataHandler &_handler)
+    :Port(nullptr, _handler), handler(_handler), n_lines(0) {}
+
+  /* virtual methods from class Port */
+  PortState GetState() const override {
+    return PortState::READY;
+  }
+
+  size_t Write(const void *data, size_t length) override {
+    return length;
+  }
+
+  bool Drain() override {
+    return true;
+  }
+
+  void Flush() override {}
+
+  bool SetBaudrate(unsigned baud_rate) override {
+    return true;
+  }
+
+  unsigned GetBaudrate() const override {
+    return 0;
+  }
+
+  bool StopRxThread() override {
+    if (IsDefined())
+      Join();
+    return true;
+  }
+
+  bool StartRxThread() override {
+    return IsDefined() || Start();
+  }
+
+  int Read(void *buffer, size_t size) override {
+    return -1;
+  }
+
+  WaitResult WaitRead(unsigned timeout_ms) override {
+    return WaitResult::FAILED;
+  }
+
+protected:
+  /* virtual methods from class Thread */
+  void Run() override {
+    const uint64_t end = MonotonicClockUS() + DURATION * 1000;
+
+    do {
+      handler.DataReceived(burst, burst_length);
+      n_lines += N_SENTENCES;
+    } while (MonotonicClockUS() < end);
+  }
+};
+
+static BenchmarkPort *ports[MAX_DEVICES];
+static unsigned n_ports;
+
+Port *
+OpenPort(const DeviceConfig &config, PortListener *listener,
+         DataHandler &handler)
+{
+  BenchmarkPort *port = new BenchmarkPort(handler);
+  ports[n_ports++] = port;
+  return port;
+}
+
+int
+main(int argc, char **argv)
+{
+  Args args(argc, argv, "[N_DEVICES]");
+  const char *p = args.PeekNext();
+  const unsigned n_devices = p != nullptr
+    ? std::min(unsigned(strtoul(args.ExpectNext(), nullptr, 10)),
+               MAX_DEVICES)
+    : 4;
+  args.ExpectEnd();
+
+  char *q = burst;
+  for (const char *sentence : SENTENCES) {
+    char *const line = q;
+    q = stpcpy(q, sentence);
+    AppendNMEAChecksum(line);
+    q += strlen(q);
+    q = stpcpy(q, "\r\n");
+  }
+  burst_length = q - burst;
+
+  DeviceBlackboard blackboard;
+  device_blackboard = &blackboard;
+
+  MergeThread merge_thread;
+  merge_thread.Start();
+
+  DeviceConfig config;
+  config.Clear();
+  config.port_type = DeviceConfig::PortType::SERIAL;
+  config.driver_name = _T("Generic");
+
+  NullOperationEnvironment env;
+
+  DeviceDescriptor *devices[MAX_DEVICES];
+  for (unsigned i = 0; i < n_devices; ++i) {
+    devices[i] = new DeviceDescriptor(i, nullptr);
+    devices[i]->SetConfig(config);
+
+    /* like OpenDeviceJob, but synchronously */
+    if (!devices[i]->DoOpen(env)) {
+      fprintf(stderr, "Failed to open device %u\n", i);
+      return EXIT_FAILURE;
+    }
+  }
+
+  unsigned n_lines = 0;
+  for (unsigned i = 0; i < n_ports; ++i) {
+    ports[i]->StopRxThread();
+    n_lines += ports[i]->n_lines;
+  }
+
+  merge.mutex.Lock();
+  merge.stop = true;
+  merge.cond.Signal();
+  merge.mutex.Unlock();
+  merge_thread.Join();
+
+  unsigned n_traffic;
+  {
+    ScopeLock protect(blackboard.mutex);
+    blackboard.Merge();
+    n_traffic = blackboard.RealState().flarm.traffic.GetActiveTrafficCount();
+  }
+
+  for (unsigned i = 0; i < n_devices; ++i) {
+    devices[i]->Close();
+    delete devices[i];
+  }
+
+  printf("%u devices: %8u lines/s, %6u merges/s, "
+         "latency avg %4u us max %6u us, %u traffic\n",
+         n_devices,
+         unsigned(n_lines * 1000ull / DURATION),
+         unsigned(merge.n_merges * 1000ull / DURATION),
+         merge.n_latencies > 0
+         ? unsigned(merge.latency_sum / merge.n_latencies)
+         : 0u,
+         unsigned(merge.latency_max),
+         n_traffic);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Measures the Dijkstra path solvers (OLC Classic and the task
+ * maximum/minimum distance scans) on synthetic input of 100 to 1000
+ * points.
+ */
+
+#include "Engine/Trace/Trace.hpp"
+#include "Engine/Contest/Solvers/OLCClassic.hpp"
+#include "Engine/Task/PathSolvers/TaskDijkstraMax.hpp"
+#include "Engine/Task/PathSolvers/TaskDijkstraMin.hpp"
+#include "Geo/SearchPointVector.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Time/PeriodClock.hpp"
+#include "Compiler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static constexpr unsigned sizes[] = { 100, 250, 500, 750, 1000 };
+
+/**
+ * The number of task points for the task scans.
+ */
+static constexpr unsigned TASK_SIZE = 5;
+
+static const GeoPoint origin(Angle::Degrees(7.7), Angle::Degrees(51.0));
+
+/**
+ * Generate a random walk which resembles a cross-country flight with
+ * 20 seconds between fixes.
+ */
+static void
+FillTrace(Trace &trace, unsigned n)
+{
+  srand(42);
+
+  GeoPoint location = origin;
+  int altitude = 1500;
+  for (unsigned i = 0; i < n; ++i) {
+    location.longitude += Angle::Degrees((rand() % 200 - 60) * 0.00002);
+    location.latitude += Angle::Degrees((rand() % 200 - 100) * 0.00002);
+    altitude += rand() % 41 - 20;
+
+    trace.push_back(TracePoint(location, 36000 + i * 20, altitude, 0, 0));
+  }
+}
+
+/**
+ * Generate the task point boundaries: polygons around points on a
+ * circle with 50 km radius.
+ */
+static void
+FillBoundaries(SearchPointVector *boundaries, unsigned n)
+{
+  const unsigned points_per_stage = n / TASK_SIZE;
+
+  for (unsigned stage = 0; stage < TASK_SIZE; ++stage) {
+    const Angle bearing = Angle::FullCircle() * stage / TASK_SIZE;
+    const GeoPoint center =
+      GeoVector(fixed(50000), bearing).EndPoint(origin);
+
+    boundaries[stage].clear();
+    for (unsigned i = 0; i < points_per_stage; ++i) {
+      const Angle a = Angle::FullCircle() * i / points_per_stage;
+      boundaries[stage].push_back(GeoVector(fixed(3000), a).EndPoint(center));
+    }
+  }
+}
+
+template<typename F>
+static double
+Measure(unsigned runs, F &&f)
+{
+  PeriodClock clock;
+  clock.Update();
+
+  for (unsigned i = 0; i < runs; ++i)
+    f();
+
+  return double(clock.Elapsed()) / runs;
+}
+
+int
+main(gcc_unused int argc, gcc_unused char **argv)
+{
+  printf("points  olc_classic  task_max  task_min\n");
+
+  for (const unsigned n : sizes) {
+    Trace trace(0, Trace::null_time, n);
+    FillTrace(trace, n);
+
+    OLCClassic classic(trace);
+    const double classic_ms = Measure(10, [&classic](){
+        classic.Reset();
+        classic.Solve(true);
+      });
+
+    SearchPointVector boundaries[TASK_SIZE];
+    FillBoundaries(boundaries, n);
+
+    TaskDijkstraMax dijkstra_max;
+    TaskDijkstraMin dijkstra_min;
+    dijkstra_max.SetTaskSize(TASK_SIZE);
+    dijkstra_min.SetTaskSize(TASK_SIZE);
+    for (unsigned i = 0; i < TASK_SIZE; ++i) {
+      dijkstra_max.SetBoundary(i, boundaries[i]);
+      dijkstra_min.SetBoundary(i, boundaries[i]);
+    }
+
+    const double max_ms = Measure(10, [&dijkstra_max](){
+        dijkstra_max.DistanceMax();
+      });
+
+    const SearchPoint start(origin);
+    const double min_ms = Measure(10, [&dijkstra_min, &start](){
+        dijkstra_min.DistanceMin(start);
+      });
+
+    printf("%6u  %8.1f ms  %5.1f ms  %5.1f ms\n",
+           n, classic_ms, max_ms, min_ms);
+  }
+
+  return EXIT_SUCCESS;
+}
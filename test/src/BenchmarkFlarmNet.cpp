@@ -0,0 +1,202 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Measures loading the FlarmNet.org file (parsed and from its
+ * snapshot in the #FileCache) and the lookups by id and callsign.
+ *
+ * Without a FILE argument, a synthetic file with 30000 records is
+ * generated in CACHEDIR.
+ */
+
+#include "FLARM/FlarmNetDatabase.hpp"
+#include "FLARM/FlarmNetReader.hpp"
+#include "FLARM/FlarmNetCache.hpp"
+#include "FLARM/FlarmId.hpp"
+#include "IO/FileCache.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/ConvertPathName.hpp"
+
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static constexpr unsigned N_RECORDS = 30000;
+static constexpr unsigned N_RUNS = 10;
+static constexpr unsigned N_LOOKUPS = 100000;
+
+static const TCHAR *const CACHE_NAME = _T("flarmnet");
+
+/**
+ * The lookup results are counted in a global variable, to keep the
+ * compiler from moving the (pure) lookups out of the measurement.
+ */
+static unsigned n_found;
+
+/**
+ * Write a field as hex-encoded Latin-1, padded with blanks.
+ */
+static void
+WriteField(FILE *file, const char *value, unsigned length)
+{
+  for (unsigned i = 0; i < length; ++i)
+    fprintf(file, "%02X",
+            (unsigned char)(*value != 0 ? *value++ : ' '));
+}
+
+static bool
+GenerateFile(const char *path)
+{
+  FILE *file = fopen(path, "w");
+  if (file == nullptr)
+    return false;
+
+  static const char *const types[] = {
+    "ASG 29", "Discus 2", "LS 8", "Ventus 2", "DG 800", "Duo Discus",
+  };
+
+  static const char *const airfields[] = {
+    "AACHEN", "UNTERWOESSEN", "LASHAM", "AUXERRE", "BENALLA",
+  };
+
+  fprintf(file, "000000\n");
+  for (unsigned i = 0; i < N_RECORDS; ++i) {
+    char id[8], pilot[24], registration[8], callsign[4], frequency[8];
+    snprintf(id, sizeof(id), "%06X", 0xD00000 + i * 7);
+    snprintf(pilot, sizeof(pilot), "Pilot %u", i);
+    snprintf(registration, sizeof(registration), "D-%04u", i % 10000);
+    snprintf(callsign, sizeof(callsign), "%c%c",
+             'A' + i % 26, 'A' + (i / 26) % 26);
+    snprintf(frequency, sizeof(frequency), "1%02u.%03u",
+             22 + i % 8, i % 40 * 25);
+
+    WriteField(file, id, 6);
+    WriteField(file, pilot, 21);
+    WriteField(file, airfields[i % 5], 21);
+    WriteField(file, types[i % 6], 21);
+    WriteField(file, registration, 7);
+    WriteField(file, callsign, 3);
+    WriteField(file, frequency, 7);
+    fputc('\n', file);
+  }
+
+  return fclose(file) == 0;
+}
+
+/**
+ * @return the mean duration of one call [us]
+ */
+template<typename F>
+static double
+Measure(unsigned n, F &&f)
+{
+  const uint64_t start = MonotonicClockUS();
+  for (unsigned i = 0; i < n; ++i)
+    f(i);
+
+  return double(MonotonicClockUS() - start) / n;
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "CACHEDIR [FILE]");
+  const tstring cache_dir = args.ExpectNextT();
+  tstring path;
+  if (args.IsEmpty()) {
+    Directory::Create(cache_dir.c_str());
+    path = cache_dir + _T("/synthetic.fln");
+    if (!GenerateFile(NarrowPathName(path.c_str()))) {
+      fprintf(stderr, "Failed to generate the file\n");
+      return EXIT_FAILURE;
+    }
+  } else
+    path = args.ExpectNextT();
+  args.ExpectEnd();
+
+  FileCache cache(cache_dir.c_str());
+  cache.Flush(CACHE_NAME);
+
+  FlarmNetDatabase parsed;
+  const unsigned n = FlarmNetReader::LoadFile(path.c_str(), parsed);
+  if (n == 0) {
+    fprintf(stderr, "Failed to parse the file\n");
+    return EXIT_FAILURE;
+  }
+
+  if (!FlarmNetCache::Save(cache, CACHE_NAME, path.c_str(), parsed)) {
+    fprintf(stderr, "Failed to save the cache\n");
+    return EXIT_FAILURE;
+  }
+
+  FlarmNetDatabase cached;
+  if (!FlarmNetCache::Load(cache, CACHE_NAME, path.c_str(), cached)) {
+    fprintf(stderr, "Failed to load the cache\n");
+    return EXIT_FAILURE;
+  }
+
+  std::vector<FlarmId> ids;
+  std::vector<tstring> callsigns;
+  for (const FlarmNetRecord &record : parsed) {
+    ids.push_back(record.GetId());
+    callsigns.emplace_back(record.callsign.c_str());
+
+    const FlarmNetRecord *other = cached.FindRecordById(ids.back());
+    if (other == nullptr ||
+        _tcscmp(other->pilot, record.pilot) != 0 ||
+        _tcscmp(other->callsign, record.callsign) != 0) {
+      fprintf(stderr, "Cache differs from the file\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  printf("%u records\n", n);
+  printf("  parse          %8.0f us\n",
+         Measure(N_RUNS, [&path](unsigned){
+             FlarmNetDatabase db;
+             FlarmNetReader::LoadFile(path.c_str(), db);
+           }));
+  printf("  cached         %8.0f us\n",
+         Measure(N_RUNS, [&cache, &path](unsigned){
+             FlarmNetDatabase db;
+             FlarmNetCache::Load(cache, CACHE_NAME, path.c_str(), db);
+           }));
+
+  const double find_id = Measure(N_LOOKUPS, [&](unsigned i){
+      if (cached.FindRecordById(ids[i * 7919 % ids.size()]) != nullptr)
+        ++n_found;
+    });
+  printf("  find id        %8.3f us\n", find_id);
+
+  const double find_callsign = Measure(N_LOOKUPS, [&](unsigned i){
+      FlarmId result[64];
+      const tstring &cn = callsigns[i * 7919 % callsigns.size()];
+      n_found += cached.FindIdsByCallSign(cn.c_str(), result, 64);
+    });
+  printf("  find callsign  %8.3f us\n", find_callsign);
+
+  return n_found > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,168 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * This program compares the performance of RasterMap::GetHeights()
+ * and RasterProjection::ProjectFine() with looking up each location
+ * one by one, and verifies that both return the same values.
+ */
+
+#include "Terrain/RasterMap.hpp"
+#include "IO/FileCache.hpp"
+#include "Time/PeriodClock.hpp"
+#include "Util/AllocatedArray.hpp"
+#include "OS/Args.hpp"
+#include "OS/ConvertPathName.hpp"
+#include "Compatibility/path.h"
+#include "Operation/Operation.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <tchar.h>
+
+static constexpr unsigned N_LOCATIONS = 1024 * 1024;
+
+/**
+ * How often the projection of all locations is repeated.
+ */
+static constexpr unsigned N_PROJECT_LOOPS = 16;
+
+static void
+Report(const char *name, unsigned single, unsigned batch)
+{
+  printf("%s: %u ms single, %u ms batch\n", name, single, batch);
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "PATH [CACHE]");
+  const char *map_path = args.ExpectNext();
+  const char *cache_path = args.IsEmpty() ? nullptr : args.GetNext();
+  args.ExpectEnd();
+
+  TCHAR jp2_path[4096];
+  _tcscpy(jp2_path, PathName(map_path));
+  _tcscat(jp2_path, _T(DIR_SEPARATOR_S) _T("terrain.jp2"));
+
+  TCHAR j2w_path[4096];
+  _tcscpy(j2w_path, PathName(map_path));
+  _tcscat(j2w_path, _T(DIR_SEPARATOR_S) _T("terrain.j2w"));
+
+  FileCache *cache = cache_path != nullptr
+    ? new FileCache(PathName(cache_path))
+    : nullptr;
+
+  NullOperationEnvironment operation;
+  RasterMap map(jp2_path, j2w_path, cache, operation);
+  delete cache;
+
+  if (!map.IsDefined()) {
+    fprintf(stderr, "Failed to load terrain\n");
+    return EXIT_FAILURE;
+  }
+
+  do {
+    map.SetViewCenter(map.GetMapCenter(), fixed(100000));
+  } while (map.IsDirty());
+
+  /* a random walk over the map (and a bit beyond its bounds), the
+     way a route or airspace search would query it */
+  const GeoBounds bounds = map.GetBounds();
+  const Angle width = bounds.GetWidth(), height = bounds.GetHeight();
+
+  AllocatedArray<GeoPoint> locations(N_LOCATIONS);
+  unsigned seed = 1;
+  GeoPoint location = map.GetMapCenter();
+  for (auto &i : locations) {
+    seed = seed * 1103515245 + 12345;
+    location.longitude += width * (fixed((int)((seed >> 8) & 0xff) - 127)
+                                   / 16384);
+    location.latitude += height * (fixed((int)((seed >> 20) & 0xff) - 127)
+                                   / 16384);
+    if (!bounds.IsInside(location))
+      location = map.GetMapCenter();
+    i = location;
+  }
+
+  PeriodClock clock;
+
+  /* the projection alone, repeated to get measurable durations; the
+     raster size does not matter here */
+  RasterProjection projection;
+  projection.Set(bounds, 16384 << RasterTileCache::SUBPIXEL_BITS,
+                 16384 << RasterTileCache::SUBPIXEL_BITS);
+
+  AllocatedArray<SignedRasterLocation> single_projected(N_LOCATIONS),
+    batch_projected(N_LOCATIONS);
+
+  clock.Update();
+  for (unsigned j = 0; j < N_PROJECT_LOOPS; ++j)
+    for (unsigned i = 0; i < N_LOCATIONS; ++i)
+      single_projected[i] = projection.ProjectFine(locations[i]);
+  const unsigned single_project_ms = clock.ElapsedUpdate();
+
+  for (unsigned j = 0; j < N_PROJECT_LOOPS; ++j)
+    projection.ProjectFine(locations.begin(), batch_projected.begin(),
+                           N_LOCATIONS);
+  const unsigned batch_project_ms = clock.ElapsedUpdate();
+
+  Report("ProjectFine", single_project_ms, batch_project_ms);
+
+  bool success = std::equal(single_projected.begin(), single_projected.end(),
+                            batch_projected.begin());
+
+  AllocatedArray<short> single(N_LOCATIONS), batch(N_LOCATIONS);
+
+  clock.Update();
+  for (unsigned i = 0; i < N_LOCATIONS; ++i)
+    single[i] = map.GetHeight(locations[i]);
+  const unsigned single_ms = clock.ElapsedUpdate();
+
+  map.GetHeights(locations.begin(), batch.begin(), N_LOCATIONS);
+  const unsigned batch_ms = clock.ElapsedUpdate();
+
+  Report("GetHeight", single_ms, batch_ms);
+
+  success = success &&
+    std::equal(single.begin(), single.end(), batch.begin());
+
+  for (unsigned i = 0; i < N_LOCATIONS; ++i)
+    single[i] = map.GetInterpolatedHeight(locations[i]);
+  const unsigned single_interpolated_ms = clock.ElapsedUpdate();
+
+  map.GetInterpolatedHeights(locations.begin(), batch.begin(), N_LOCATIONS);
+  const unsigned batch_interpolated_ms = clock.ElapsedUpdate();
+
+  Report("GetInterpolatedHeight",
+         single_interpolated_ms, batch_interpolated_ms);
+
+  success = success &&
+    std::equal(single.begin(), single.end(), batch.begin());
+
+  if (!success) {
+    fprintf(stderr, "Batch results differ\n");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
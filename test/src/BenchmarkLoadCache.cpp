@@ -0,0 +1,270 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compares the startup cost of parsing a waypoint file and an airspace
+ * file with loading their binary snapshots from the #FileCache, and
+ * verifies that both yield the same data.
+ */
+
+#include "Waypoint/WaypointReader.hpp"
+#include "Waypoint/WaypointCache.hpp"
+#include "Waypoint/Waypoints.hpp"
+#include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceCache.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "Engine/Airspace/AirspaceVisitor.hpp"
+#include "IO/FileCache.hpp"
+#include "IO/FileLineReader.hpp"
+#include "Time/PeriodClock.hpp"
+#include "OS/Args.hpp"
+#include "Operation/Operation.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static constexpr unsigned N_RUNS = 10;
+
+static const TCHAR *const WAYPOINT_CACHE = _T("waypoints1");
+static const TCHAR *const AIRSPACE_CACHE = _T("airspace1");
+
+static bool
+ParseWaypoints(const TCHAR *path, Waypoints &waypoints)
+{
+  WaypointReader reader(path, 1);
+  if (reader.Error())
+    return false;
+
+  NullOperationEnvironment operation;
+  if (!reader.Parse(waypoints, operation))
+    return false;
+
+  waypoints.Optimise();
+  return true;
+}
+
+static bool
+ParseAirspaces(const TCHAR *path, Airspaces &airspaces)
+{
+  FileLineReader reader(path, Charset::AUTO);
+  if (reader.error())
+    return false;
+
+  AirspaceParser parser(airspaces);
+  NullOperationEnvironment operation;
+  if (!parser.Parse(reader, operation))
+    return false;
+
+  airspaces.Optimise();
+  return true;
+}
+
+static bool
+IsSameWaypoint(const Waypoint &a, const Waypoint &b)
+{
+  return a.original_id == b.original_id && a.location == b.location &&
+    a.elevation == b.elevation && a.type == b.type &&
+    a.name == b.name && a.comment == b.comment && a.details == b.details &&
+    memcmp(&a.runway, &b.runway, sizeof(a.runway)) == 0 &&
+    memcmp(&a.radio_frequency, &b.radio_frequency,
+           sizeof(a.radio_frequency)) == 0 &&
+    a.flags.turn_point == b.flags.turn_point &&
+    a.flags.home == b.flags.home &&
+    a.files_embed == b.files_embed;
+}
+
+static bool
+IsSameWaypoints(const Waypoints &a, const Waypoints &b)
+{
+  if (a.size() != b.size())
+    return false;
+
+  for (const auto &wp : a) {
+    const Waypoint *other = b.LookupId(wp.id);
+    if (other == nullptr || !IsSameWaypoint(wp, *other))
+      return false;
+  }
+
+  return true;
+}
+
+class CountingAirspaceVisitor final : public AirspaceVisitor {
+public:
+  unsigned n = 0;
+
+  void Visit(const AbstractAirspace &) override {
+    ++n;
+  }
+};
+
+/**
+ * Compare what does not depend on the order of the airspace tree,
+ * and the result of inside tests at the center of each airspace,
+ * which use the loaded polygon index.
+ */
+static bool
+IsSameAirspaces(const Airspaces &a, const Airspaces &b)
+{
+  if (a.GetSize() != b.GetSize())
+    return false;
+
+  CountingAirspaceVisitor inside_a, inside_b;
+  for (const auto &i : a) {
+    const GeoPoint center = i.GetAirspace().GetCenter();
+    a.VisitInside(center, inside_a);
+    b.VisitInside(center, inside_b);
+  }
+
+  if (inside_a.n != inside_b.n)
+    return false;
+
+  unsigned n_points_a = 0, n_points_b = 0;
+  fixed sum_a(0), sum_b(0);
+  for (const auto &i : a) {
+    const AbstractAirspace &as = i.GetAirspace();
+    n_points_a += as.GetPoints().size();
+    sum_a += as.GetBase().altitude + as.GetTop().flight_level;
+  }
+
+  for (const auto &i : b) {
+    const AbstractAirspace &as = i.GetAirspace();
+    n_points_b += as.GetPoints().size();
+    sum_b += as.GetBase().altitude + as.GetTop().flight_level;
+  }
+
+  return n_points_a == n_points_b && sum_a == sum_b;
+}
+
+template<typename F>
+static int
+Measure(F &&f)
+{
+  PeriodClock clock;
+  clock.Update();
+  for (unsigned i = 0; i < N_RUNS; ++i)
+    if (!f())
+      return -1;
+
+  return clock.Elapsed() / N_RUNS;
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "CACHEDIR WAYPOINTS AIRSPACES");
+  const tstring cache_dir = args.ExpectNextT();
+  const tstring waypoint_path = args.ExpectNextT();
+  const tstring airspace_path = args.ExpectNextT();
+  args.ExpectEnd();
+
+  FileCache cache(cache_dir.c_str());
+  cache.Flush(WAYPOINT_CACHE);
+  cache.Flush(AIRSPACE_CACHE);
+
+  /* waypoints */
+
+  Waypoints parsed_waypoints;
+  if (!ParseWaypoints(waypoint_path.c_str(), parsed_waypoints)) {
+    fprintf(stderr, "Failed to parse the waypoint file\n");
+    return EXIT_FAILURE;
+  }
+
+  if (!WaypointCache::Save(cache, WAYPOINT_CACHE, waypoint_path.c_str(),
+                           nullptr, parsed_waypoints)) {
+    fprintf(stderr, "Failed to save the waypoint cache\n");
+    return EXIT_FAILURE;
+  }
+
+  Waypoints cached_waypoints;
+  if (!WaypointCache::Load(cache, WAYPOINT_CACHE, waypoint_path.c_str(), 1,
+                           nullptr, cached_waypoints)) {
+    fprintf(stderr, "Failed to load the waypoint cache\n");
+    return EXIT_FAILURE;
+  }
+
+  cached_waypoints.Optimise();
+  if (!IsSameWaypoints(parsed_waypoints, cached_waypoints)) {
+    fprintf(stderr, "Waypoint cache differs from the file\n");
+    return EXIT_FAILURE;
+  }
+
+  printf("%u waypoints\n", parsed_waypoints.size());
+  printf("  parse  %6d ms\n", Measure([&waypoint_path](){
+        Waypoints waypoints;
+        return ParseWaypoints(waypoint_path.c_str(), waypoints);
+      }));
+  printf("  cached %6d ms\n", Measure([&cache, &waypoint_path](){
+        Waypoints waypoints;
+        if (!WaypointCache::Load(cache, WAYPOINT_CACHE, waypoint_path.c_str(),
+                                 1, nullptr, waypoints))
+          return false;
+
+        waypoints.Optimise();
+        return true;
+      }));
+
+  /* airspaces */
+
+  Airspaces parsed_airspaces;
+  if (!ParseAirspaces(airspace_path.c_str(), parsed_airspaces)) {
+    fprintf(stderr, "Failed to parse the airspace file\n");
+    return EXIT_FAILURE;
+  }
+
+  if (!AirspaceCache::Save(cache, AIRSPACE_CACHE, airspace_path.c_str(),
+                           parsed_airspaces)) {
+    fprintf(stderr, "Failed to save the airspace cache\n");
+    return EXIT_FAILURE;
+  }
+
+  Airspaces cached_airspaces;
+  if (!AirspaceCache::Load(cache, AIRSPACE_CACHE, airspace_path.c_str(),
+                           cached_airspaces)) {
+    fprintf(stderr, "Failed to load the airspace cache\n");
+    return EXIT_FAILURE;
+  }
+
+  cached_airspaces.Optimise();
+  if (!IsSameAirspaces(parsed_airspaces, cached_airspaces)) {
+    fprintf(stderr, "Airspace cache differs from the file\n");
+    return EXIT_FAILURE;
+  }
+
+  printf("%u airspaces\n", parsed_airspaces.GetSize());
+  printf("  parse  %6d ms\n", Measure([&airspace_path](){
+        Airspaces airspaces;
+        return ParseAirspaces(airspace_path.c_str(), airspaces);
+      }));
+  printf("  cached %6d ms\n", Measure([&cache, &airspace_path](){
+        Airspaces airspaces;
+        if (!AirspaceCache::Load(cache, AIRSPACE_CACHE, airspace_path.c_str(),
+                                 airspaces))
+          return false;
+
+        airspaces.Optimise();
+        return true;
+      }));
+
+  return EXIT_SUCCESS;
+}
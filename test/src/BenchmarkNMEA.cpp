@@ -0,0 +1,213 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+
+/*
+ * Measures the throughput of the NMEA parsers: each line is passed
+ * to the driver's ParseNMEA() method first and then to
+ * NMEAParser::ParseLine(), like DeviceDescriptor::ParseNMEA() does.
+ *
+ * Without arguments, a built-in sample of several typical devices is
+ * used.  Otherwise, each DRIVER FILE pair names a driver (or "-" for
+ * a plain GPS) and a recorded NMEA log.
+ */
+
+#include "NMEA/Info.hpp"
+#include "NMEA/Checksum.hpp"
+#include "Device/Port/NullPort.hpp"
+#include "Device/Driver.hpp"
+#include "Device/Register.hpp"
+#include "Device/Parser.hpp"
+#include "Device/Config.hpp"
+#include "IO/FileLineReader.hpp"
+#include "OS/Clock.hpp"
+#include "OS/Args.hpp"
+#include "Util/StringUtil.hpp"
+
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The number of lines parsed for each device.
+ */
+static constexpr unsigned N_LINES = 1000000;
+
+struct Sample {
+  const TCHAR *driver;
+  const char *const *lines;
+};
+
+static const char *const GPS_LINES[] = {
+  "$GPRMC,082311,A,5103.5403,N,00741.5742,E,055.3,022.4,230610,000.3,W",
+  "$GPGGA,082311,5103.5403,N,00741.5742,E,1,08,0.9,420.0,M,48.0,M,,",
+  "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1",
+  "$PGRMZ,1403,F,2",
+  nullptr
+};
+
+static const char *const FLARM_LINES[] = {
+  "$GPRMC,082311,A,5103.5403,N,00741.5742,E,055.3,022.4,230610,000.3,W",
+  "$GPGGA,082311,5103.5403,N,00741.5742,E,1,08,0.9,420.0,M,48.0,M,,",
+  "$PGRMZ,1403,F,2",
+  "$PFLAU,3,1,2,1,1,-30,2,-32,755",
+  "$PFLAA,0,-1234,1234,220,2,DD8F12,180,,30,-1.4,1",
+  "$PFLAA,1,3021,-1024,-312,2,DD8F13,45,,28,2.1,1",
+  "$PFLAA,0,512,-4400,86,2,DD8F14,270,,33,0.3,1",
+  nullptr
+};
+
+static const char *const LX_LINES[] = {
+  "$GPRMC,082311,A,5103.5403,N,00741.5742,E,055.3,022.4,230610,000.3,W",
+  "$GPGGA,082311,5103.5403,N,00741.5742,E,1,08,0.9,420.0,M,48.0,M,,",
+  "$LXWP0,Y,222.3,1665.5,1.71,,,,,,239,174,10.1",
+  "$LXWP2,1.1,1.00,1.00,2.14,-3.87,2.38",
+  "$PLXVF,,1.00,0.87,-0.12,-0.25,90.2,244.3,",
+  "$PLXVS,23.1,0,12.3,",
+  nullptr
+};
+
+static const char *const VEGA_LINES[] = {
+  "$GPRMC,082311,A,5103.5403,N,00741.5742,E,055.3,022.4,230610,000.3,W",
+  "$GPGGA,082311,5103.5403,N,00741.5742,E,1,08,0.9,420.0,M,48.0,M,,",
+  "$PDVDV,1,0,1062,762,9252,0",
+  "$PDVDS,-0.04,0.26,0,23,0,-7,-5,0,0",
+  nullptr
+};
+
+static const Sample SAMPLES[] = {
+  { nullptr, GPS_LINES },
+  { _T("FLARM"), FLARM_LINES },
+  { _T("LX"), LX_LINES },
+  { _T("Vega"), VEGA_LINES },
+};
+
+static std::vector<std::string>
+MakeSampleLines(const char *const *src)
+{
+  std::vector<std::string> lines;
+  for (; *src != nullptr; ++src) {
+    char buffer[256];
+    strcpy(buffer, *src);
+    AppendNMEAChecksum(buffer);
+    lines.emplace_back(buffer);
+  }
+
+  return lines;
+}
+
+static std::vector<std::string>
+LoadLines(const char *path)
+{
+  std::vector<std::string> lines;
+
+  FileLineReaderA reader(path);
+  if (reader.error()) {
+    fprintf(stderr, "Failed to open %s\n", path);
+    exit(EXIT_FAILURE);
+  }
+
+  char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    StripRight(line);
+    if (*line != '\0')
+      lines.emplace_back(line);
+  }
+
+  return lines;
+}
+
+static void
+Run(const TCHAR *driver_name, const std::vector<std::string> &lines)
+{
+  if (lines.empty())
+    return;
+
+  const DeviceRegister *driver = nullptr;
+  if (driver_name != nullptr) {
+    driver = FindDriverByName(driver_name);
+    if (driver == nullptr) {
+      _ftprintf(stderr, _T("No such driver: %s\n"), driver_name);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  DeviceConfig config;
+  config.Clear();
+
+  NullPort port;
+  Device *device = driver != nullptr && driver->CreateOnPort != nullptr
+    ? driver->CreateOnPort(config, port)
+    : nullptr;
+
+  NMEAParser parser;
+  parser.SetReal(true);
+
+  NMEAInfo data;
+  data.Reset();
+
+  unsigned n_parsed = 0;
+
+  const uint64_t start = MonotonicClockUS();
+
+  for (unsigned i = 0, j = 0; i < N_LINES; ++i) {
+    const char *line = lines[j].c_str();
+    if (++j == lines.size())
+      j = 0;
+
+    data.UpdateClock();
+    if ((device != nullptr && device->ParseNMEA(line, data)) ||
+        parser.ParseLine(line, data))
+      ++n_parsed;
+  }
+
+  const uint64_t duration = std::max(MonotonicClockUS() - start, uint64_t(1));
+
+  _tprintf(_T("%-8s %8u lines/s (%u%% parsed)\n"),
+           driver_name != nullptr ? driver_name : _T("-"),
+           unsigned(N_LINES * 1000000ull / duration),
+           n_parsed * 100 / N_LINES);
+
+  delete device;
+}
+
+int
+main(int argc, char **argv)
+{
+  Args args(argc, argv, "[DRIVER FILE ...]");
+
+  if (args.IsEmpty()) {
+    for (const auto &sample : SAMPLES)
+      Run(sample.driver, MakeSampleLines(sample.lines));
+  } else {
+    while (!args.IsEmpty()) {
+      const tstring driver_name = args.ExpectNextT();
+      const char *path = args.ExpectNext();
+      Run(driver_name == _T("-") ? nullptr : driver_name.c_str(),
+          LoadLines(path));
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -21,35 +21,112 @@ Copyright_License {
 }
 */
 
+/*
+ * Compares the throughput of the scalar and the batch
+ * Projection::GeoToScreen(), and verifies that both give the same
+ * results.
+ */
+
 #include "Projection/Projection.hpp"
 #include "Screen/Layout.hpp"
+#include "OS/Clock.hpp"
+
+#include <algorithm>
+
+#include <stdio.h>
+#include <stdlib.h>
 
 unsigned Layout::scale_1024 = 1024;
 
+/**
+ * The number of points in one polyline.
+ */
+static constexpr unsigned N_POINTS = 1024;
+
+/**
+ * How often the polyline is projected.
+ */
+static constexpr unsigned N_ITERATIONS = 64 * 1024;
+
 class TestProjection : public Projection {
 public:
   TestProjection() {
-    SetScreenOrigin(0, 0);
-    SetScale(fixed(640) / (fixed(100) * 2));
+    SetScreenOrigin(320, 240);
+    SetScale(fixed(640) / (fixed(100000) * 2));
     SetGeoLocation(GeoPoint(Angle::Degrees(7.7061111111111114),
                             Angle::Degrees(51.051944444444445)));
+    SetScreenAngle(Angle::Degrees(37));
   }
 };
 
+static GeoPoint points[N_POINTS];
+static RasterPoint scalar_result[N_POINTS], batch_result[N_POINTS];
+
+/**
+ * A spiral around the screen origin, crossing the edges of the
+ * screen.
+ */
+static void
+MakePoints(const GeoPoint &center)
+{
+  for (unsigned i = 0; i < N_POINTS; ++i) {
+    const Angle angle = Angle::Degrees(i * 7.3);
+    const fixed radius = fixed(0.002) * i;
+    points[i] = GeoPoint(center.longitude + Angle::Degrees(radius * angle.cos()),
+                         center.latitude + Angle::Degrees(radius * angle.sin()));
+  }
+}
+
+static uint64_t
+RunScalar(const Projection &projection)
+{
+  const uint64_t start = MonotonicClockUS();
+
+  for (unsigned j = 0; j < N_ITERATIONS; ++j)
+    for (unsigned i = 0; i < N_POINTS; ++i)
+      scalar_result[i] = projection.GeoToScreen(points[i]);
+
+  return MonotonicClockUS() - start;
+}
+
+static uint64_t
+RunBatch(const Projection &projection)
+{
+  const uint64_t start = MonotonicClockUS();
+
+  for (unsigned j = 0; j < N_ITERATIONS; ++j)
+    projection.GeoToScreen(points, batch_result, N_POINTS);
+
+  return MonotonicClockUS() - start;
+}
+
+static void
+Print(const char *name, uint64_t duration)
+{
+  printf("%-8s %8llu us %10llu points/s\n", name,
+         (unsigned long long)duration,
+         (unsigned long long)(uint64_t(N_POINTS) * N_ITERATIONS *
+                              1000000 / std::max(duration, uint64_t(1))));
+}
+
 int main(int argc, char **argv)
 {
   TestProjection projection;
+  MakePoints(projection.GetGeoLocation());
+
+  Print("scalar", RunScalar(projection));
+  Print("batch", RunBatch(projection));
 
-  GeoPoint gp = GeoPoint(Angle::Degrees(7.7061111111111114),
-                         Angle::Degrees(51.051944444444445));
-  long x = 0, y = 0;
-  for (unsigned i = 64 * 1024 * 1024; i-- > 0;) {
-    RasterPoint rp = projection.GeoToScreen(gp);
+  unsigned n_mismatch = 0;
+  for (unsigned i = 0; i < N_POINTS; ++i)
+    if (scalar_result[i].x != batch_result[i].x ||
+        scalar_result[i].y != batch_result[i].y)
+      ++n_mismatch;
 
-    /* prevent gcc from optimizing this loop away */
-    x += rp.x;
-    y += rp.y;
+  if (n_mismatch > 0) {
+    fprintf(stderr, "%u points differ\n", n_mismatch);
+    return EXIT_FAILURE;
   }
 
-  return x + y;
+  return EXIT_SUCCESS;
 }
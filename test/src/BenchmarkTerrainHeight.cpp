@@ -0,0 +1,154 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * This program queries terrain heights from several threads at the
+ * same time, to measure the lock contention in RasterTerrain.  If a
+ * cache directory is given, the terrain is mapped from the cache
+ * file, and the readers do not lock.
+ */
+
+#include "Terrain/RasterTerrain.hpp"
+#include "IO/FileCache.hpp"
+#include "Thread/Thread.hpp"
+#include "Time/PeriodClock.hpp"
+#include "OS/Args.hpp"
+#include "OS/ConvertPathName.hpp"
+#include "Compatibility/path.h"
+#include "Operation/Operation.hpp"
+
+#include <stdio.h>
+#include <tchar.h>
+
+static constexpr unsigned MAX_THREADS = 8;
+static constexpr unsigned N_QUERIES = 4 * 1024 * 1024;
+
+class QueryThread final : public Thread {
+  const RasterTerrain &terrain;
+  GeoBounds bounds;
+
+  unsigned seed;
+
+public:
+  long sum;
+
+  QueryThread(const RasterTerrain &_terrain, unsigned _seed)
+    :terrain(_terrain),
+     bounds(RasterTerrain::Lease(terrain)->GetBounds()),
+     seed(_seed), sum(0) {}
+
+protected:
+  void Run() override {
+    const Angle width = bounds.GetWidth(), height = bounds.GetHeight();
+
+    for (unsigned i = 0; i < N_QUERIES; ++i) {
+      /* a cheap pseudo random walk over the map */
+      seed = seed * 1103515245 + 12345;
+      const unsigned x = (seed >> 8) & 0xfff;
+      const unsigned y = (seed >> 20) & 0xfff;
+
+      const GeoPoint location(bounds.GetWest() + width * (fixed(x) / 4096),
+                              bounds.GetSouth() + height * (fixed(y) / 4096));
+
+      /* prevent gcc from optimizing this loop away */
+      sum += terrain.GetTerrainHeight(location);
+    }
+  }
+};
+
+static void
+Run(const RasterTerrain &terrain, unsigned n_threads)
+{
+  QueryThread *threads[MAX_THREADS];
+  for (unsigned i = 0; i < n_threads; ++i)
+    threads[i] = new QueryThread(terrain, i);
+
+  PeriodClock clock;
+  clock.Update();
+
+  for (unsigned i = 0; i < n_threads; ++i)
+    threads[i]->Start();
+
+  long sum = 0;
+  for (unsigned i = 0; i < n_threads; ++i) {
+    threads[i]->Join();
+    sum += threads[i]->sum;
+    delete threads[i];
+  }
+
+  const unsigned elapsed = std::max(clock.Elapsed(), 1);
+  printf("%u threads: %u ms, %lu queries/s (checksum %ld)\n",
+         n_threads, elapsed,
+         (unsigned long)n_threads * N_QUERIES / elapsed * 1000, sum);
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "PATH [CACHE]");
+  const char *map_path = args.ExpectNext();
+  const char *cache_path = args.IsEmpty() ? nullptr : args.GetNext();
+  args.ExpectEnd();
+
+  TCHAR jp2_path[4096];
+  _tcscpy(jp2_path, PathName(map_path));
+  _tcscat(jp2_path, _T(DIR_SEPARATOR_S) _T("terrain.jp2"));
+
+  TCHAR j2w_path[4096];
+  _tcscpy(j2w_path, PathName(map_path));
+  _tcscat(j2w_path, _T(DIR_SEPARATOR_S) _T("terrain.j2w"));
+
+  FileCache *cache = cache_path != nullptr
+    ? new FileCache(PathName(cache_path))
+    : nullptr;
+
+  NullOperationEnvironment operation;
+  RasterTerrain terrain(jp2_path, j2w_path, cache, operation);
+  delete cache;
+
+  bool mapped;
+
+  {
+    RasterTerrain::Lease map(terrain);
+    if (!map->IsDefined()) {
+      fprintf(stderr, "Failed to load terrain\n");
+      return EXIT_FAILURE;
+    }
+
+    mapped = map->IsMapped();
+  }
+
+  printf("mapped = %d\n", mapped);
+
+  if (!mapped) {
+    /* load all tiles which fit into memory */
+    RasterTerrain::ExclusiveLease map(terrain);
+    do {
+      map->SetViewCenter(terrain.GetTerrainCenter(), fixed(100000));
+    } while (map->IsDirty());
+  }
+
+  for (unsigned n = 1; n <= MAX_THREADS; n *= 2)
+    Run(terrain, n);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,297 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Loads the topography of a map file from the shapefiles and from
+ * the #TopographyCache, checks that both yield the same shapes while
+ * panning across the map, and measures loading and panning.
+ */
+
+#include "Topography/TopographyStore.hpp"
+#include "Topography/TopographyFile.hpp"
+#include "Topography/XShape.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "IO/ZipLineReader.hpp"
+#include "IO/FileCache.hpp"
+#include "Operation/Operation.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+
+#include <zzip/zzip.h>
+
+#include <algorithm>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static constexpr unsigned N_STEPS = 200;
+
+/**
+ * The number of shapes is summed up in a global variable, to keep
+ * the compiler from moving the measured code.
+ */
+static unsigned n_shapes;
+
+static bool
+LoadTopography(TopographyStore &store, const char *path,
+               FileCache *cache, const TCHAR *cache_path)
+{
+  ZZIP_DIR *dir = zzip_dir_open(path, nullptr);
+  if (dir == nullptr)
+    return false;
+
+  ZipLineReaderA reader(dir, "topology.tpl");
+  if (reader.error()) {
+    zzip_dir_close(dir);
+    return false;
+  }
+
+  NullOperationEnvironment operation;
+  store.Load(operation, reader, nullptr, dir, cache, cache_path);
+  zzip_dir_close(dir);
+  return store.size() > 0;
+}
+
+/**
+ * Obtain the shapes which would be drawn, including their thinned
+ * indices, just like #TopographyFileRenderer does.
+ */
+static void
+Prepare(const TopographyStore &store, const WindowProjection &projection)
+{
+  const fixed map_scale = projection.GetMapScale();
+
+  for (unsigned i = 0; i < store.size(); ++i) {
+    const TopographyFile &file = store[i];
+    if (!file.IsVisible(map_scale))
+      continue;
+
+    const ScopeLock protect(file.mutex);
+
+#ifdef ENABLE_OPENGL
+    const unsigned level = file.GetThinningLevel(map_scale);
+    const ShapeScalar min_distance = file.GetThinningDistance(level, 1);
+#endif
+
+    for (const XShape &shape : file) {
+      ++n_shapes;
+
+#ifdef ENABLE_OPENGL
+      const unsigned short *count;
+      if ((shape.get_type() == MS_SHAPE_LINE && level > 0) ||
+          shape.get_type() == MS_SHAPE_POLYGON)
+        shape.get_indices(level, min_distance, count);
+#endif
+    }
+  }
+}
+
+#ifdef ENABLE_OPENGL
+
+static bool
+EqualIndices(const XShape &a, const XShape &b, unsigned level,
+             ShapeScalar min_distance)
+{
+  const unsigned short *a_count, *b_count;
+  const unsigned short *a_indices = a.get_indices(level, min_distance,
+                                                  a_count);
+  const unsigned short *b_indices = b.get_indices(level, min_distance,
+                                                  b_count);
+  if (a_indices == nullptr || b_indices == nullptr)
+    return a_indices == b_indices;
+
+  const unsigned n_counts = a.get_type() == MS_SHAPE_LINE
+    ? a.GetLines().size
+    : 1;
+  unsigned n = 0;
+  for (unsigned i = 0; i < n_counts; ++i) {
+    if (a_count[i] != b_count[i])
+      return false;
+    n += a_count[i];
+  }
+
+  return std::equal(a_indices, a_indices + n, b_indices);
+}
+
+#endif
+
+static bool
+EqualShapes(const XShape &a, const XShape &b)
+{
+  const auto a_lines = a.GetLines(), b_lines = b.GetLines();
+  if (a.get_type() != b.get_type() || a_lines.size != b_lines.size ||
+      !std::equal(a_lines.begin(), a_lines.end(), b_lines.begin()))
+    return false;
+
+  unsigned n = 0;
+  for (unsigned i : a_lines)
+    n += i;
+
+  if (memcmp(a.get_points(), b.get_points(), n * sizeof(XShape::Point)) != 0)
+    return false;
+
+  if (a.get_label() == nullptr || b.get_label() == nullptr)
+    return a.get_label() == b.get_label();
+
+  return _tcscmp(a.get_label(), b.get_label()) == 0;
+}
+
+/**
+ * Do both stores have the same shapes loaded?
+ */
+static bool
+Compare(const TopographyStore &a, const TopographyStore &b)
+{
+  if (a.size() != b.size())
+    return false;
+
+  for (unsigned i = 0; i < a.size(); ++i) {
+    const TopographyFile &a_file = a[i], &b_file = b[i];
+    const ScopeLock a_protect(a_file.mutex), b_protect(b_file.mutex);
+
+    auto a_it = a_file.begin(), b_it = b_file.begin();
+    for (; a_it != a_file.end() && b_it != b_file.end(); ++a_it, ++b_it) {
+      if (!EqualShapes(*a_it, *b_it))
+        return false;
+
+#ifdef ENABLE_OPENGL
+      for (unsigned level = 1; level < XShape::THINNING_LEVELS; ++level)
+        if (!EqualIndices(*a_it, *b_it, level,
+                          a_file.GetThinningDistance(level, 1)))
+          return false;
+#endif
+    }
+
+    if (a_it != a_file.end() || b_it != b_file.end())
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Move the projection from west to east across the map.
+ */
+static void
+SetStep(WindowProjection &projection, const GeoPoint &center, unsigned step)
+{
+  const Angle offset = Angle::Degrees(fixed(3) * step / N_STEPS - fixed(1.5));
+  projection.SetGeoLocation(GeoPoint(center.longitude + offset,
+                                     center.latitude));
+  projection.UpdateScreenBounds();
+}
+
+/**
+ * @return the mean duration of one step [us]
+ */
+static double
+Pan(TopographyStore &store, WindowProjection &projection,
+    const GeoPoint &center)
+{
+  const uint64_t start = MonotonicClockUS();
+  for (unsigned step = 0; step <= N_STEPS; ++step) {
+    SetStep(projection, center, step);
+    store.ScanVisibility(projection);
+    Prepare(store, projection);
+  }
+
+  return double(MonotonicClockUS() - start) / (N_STEPS + 1);
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "MAPFILE CACHEDIR");
+  const char *map_path = args.PeekNext();
+  const tstring map_path_t = args.ExpectNextT();
+  const tstring cache_dir = args.ExpectNextT();
+  args.ExpectEnd();
+
+  FileCache cache(cache_dir.c_str());
+
+  uint64_t start = MonotonicClockUS();
+  TopographyStore shapefile;
+  if (!LoadTopography(shapefile, map_path, nullptr, nullptr)) {
+    fprintf(stderr, "Failed to load %s\n", map_path);
+    return EXIT_FAILURE;
+  }
+  const uint64_t load_shapefile = MonotonicClockUS() - start;
+
+  WindowProjection projection;
+  projection.SetScreenSize({640, 480});
+  projection.SetScreenOrigin(320, 240);
+  projection.SetScaleFromRadius(fixed(20000));
+
+  const GeoPoint center = shapefile[0].GetCenter();
+
+  /* the first load with a cache opens the shapefiles (unless a
+     previous run has already converted the layers); the conversion
+     is done afterwards, like #TopographyThread does, while some
+     shapes are loaded */
+  start = MonotonicClockUS();
+  TopographyStore converted;
+  LoadTopography(converted, map_path, &cache, map_path_t.c_str());
+  const uint64_t load_first = MonotonicClockUS() - start;
+
+  SetStep(projection, center, 0);
+  converted.ScanVisibility(projection);
+
+  start = MonotonicClockUS();
+  while (converted.HasPendingCache())
+    converted.ConvertCache(256);
+  const uint64_t convert = MonotonicClockUS() - start;
+
+  start = MonotonicClockUS();
+  TopographyStore cached;
+  LoadTopography(cached, map_path, &cache, map_path_t.c_str());
+  const uint64_t load_cached = MonotonicClockUS() - start;
+
+  const double pan_shapefile = Pan(shapefile, projection, center);
+  const double pan_cached = Pan(cached, projection, center);
+
+  /* give the converted store the same history, because that decides
+     which shapes are loaded */
+  Pan(converted, projection, center);
+
+  /* pan back and compare the shapes of both stores */
+  for (unsigned step = N_STEPS; step-- > 0;) {
+    SetStep(projection, center, step);
+    shapefile.ScanVisibility(projection);
+    converted.ScanVisibility(projection);
+    cached.ScanVisibility(projection);
+
+    if (!Compare(shapefile, converted) || !Compare(shapefile, cached)) {
+      fprintf(stderr, "Cache differs from the shapefiles\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  printf("%u layers\n", shapefile.size());
+  printf("  load shapefiles %10.1f ms\n", load_shapefile / 1000.);
+  printf("  first load      %10.1f ms\n", load_first / 1000.);
+  printf("  convert         %10.1f ms\n", convert / 1000.);
+  printf("  load cached     %10.1f ms\n", load_cached / 1000.);
+  printf("  pan shapefiles  %10.1f us/step\n", pan_shapefile);
+  printf("  pan cached      %10.1f us/step\n", pan_cached);
+
+  return n_shapes > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,155 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Replays a flight and measures how long it takes to feed its fixes
+ * into a #Trace.  The fixes are repeated with increasing time stamps
+ * until they cover 12 hours, to simulate a long flight.
+ *
+ * Only the public #Trace interface is used, so this program can be
+ * built against older implementations.  The checksum printed at the
+ * end describes the final traces; it must not depend on the
+ * implementation.
+ */
+
+#include "Engine/Trace/Trace.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "DebugReplay.hpp"
+
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * The duration covered by the repeated fixes [s].
+ */
+static constexpr unsigned FLIGHT_DURATION = 12 * 3600;
+
+/**
+ * The number of times the whole flight is fed.
+ */
+static constexpr unsigned N_RUNS = 5;
+
+struct Fix {
+  GeoPoint location;
+  unsigned time;
+  fixed altitude, vario;
+};
+
+static std::vector<Fix>
+LoadFixes(DebugReplay &replay)
+{
+  std::vector<Fix> fixes;
+
+  while (replay.Next()) {
+    const MoreData &basic = replay.Basic();
+    if (!basic.time_available || !basic.location_available ||
+        !basic.NavAltitudeAvailable())
+      continue;
+
+    const unsigned time = (unsigned)basic.time;
+    if (!fixes.empty() && time <= fixes.back().time)
+      continue;
+
+    fixes.push_back({basic.location, time,
+                     basic.nav_altitude, basic.netto_vario});
+  }
+
+  return fixes;
+}
+
+/**
+ * Repeat the fixes with increasing time stamps until they cover
+ * #FLIGHT_DURATION.
+ */
+static std::vector<TracePoint>
+MakeFlight(const std::vector<Fix> &fixes)
+{
+  const unsigned start = fixes.front().time;
+  const unsigned period = fixes.back().time - start + 1;
+
+  std::vector<TracePoint> points;
+  for (unsigned offset = 0; offset < FLIGHT_DURATION; offset += period)
+    for (const Fix &fix : fixes)
+      points.emplace_back(fix.location, fix.time - start + offset,
+                          fix.altitude, fix.vario, 0u);
+
+  return points;
+}
+
+static unsigned
+Checksum(const Trace &trace)
+{
+  unsigned result = trace.size();
+  for (const TracePoint &point : trace)
+    result = result * 31 + point.GetTime();
+
+  return result;
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "DRIVER FILE");
+  DebugReplay *replay = CreateDebugReplay(args);
+  if (replay == NULL)
+    return EXIT_FAILURE;
+
+  args.ExpectEnd();
+
+  const std::vector<Fix> fixes = LoadFixes(*replay);
+  delete replay;
+
+  if (fixes.size() < 2) {
+    fprintf(stderr, "Not enough fixes\n");
+    return EXIT_FAILURE;
+  }
+
+  const std::vector<TracePoint> points = MakeFlight(fixes);
+
+  unsigned checksum = 0;
+
+  const uint64_t start = MonotonicClockUS();
+  for (unsigned run = 0; run < N_RUNS; ++run) {
+    /* like the full trace and the sprint trace of the contest
+       calculations */
+    Trace full_trace(600, Trace::null_time, 1024);
+    Trace sprint_trace(0, Trace::null_time, 128);
+
+    for (const TracePoint &point : points) {
+      full_trace.push_back(point);
+      sprint_trace.push_back(point);
+    }
+
+    checksum = Checksum(full_trace) * 17 + Checksum(sprint_trace);
+  }
+  const uint64_t duration = MonotonicClockUS() - start;
+
+  printf("%u fixes per flight, %u runs\n",
+         unsigned(points.size()), N_RUNS);
+  printf("  total %10.1f ms\n", duration / 1000.);
+  printf("  checksum %08x\n", checksum);
+
+  return EXIT_SUCCESS;
+}
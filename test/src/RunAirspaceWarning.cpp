@@ -0,0 +1,129 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Replays a flight against an airspace file, prints each change of
+ * the airspace warnings and the AirspaceWarningManager statistics.
+ */
+
+#include "OS/Args.hpp"
+#include "DebugReplay.hpp"
+#include "Airspace/AirspaceParser.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "Engine/Airspace/AirspaceWarningManager.hpp"
+#include "Engine/GlideSolvers/GlidePolar.hpp"
+#include "Engine/Task/Stats/TaskStats.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
+#include "NMEA/Aircraft.hpp"
+#include "Formatter/TimeFormatter.hpp"
+#include "IO/FileLineReader.hpp"
+#include "Operation/Operation.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static bool
+LoadAirspaces(const char *path, Airspaces &airspaces)
+{
+  FileLineReader reader(path, Charset::AUTO);
+  if (reader.error()) {
+    fprintf(stderr, "Failed to open %s\n", path);
+    return false;
+  }
+
+  AirspaceParser parser(airspaces);
+  NullOperationEnvironment operation;
+  if (!parser.Parse(reader, operation)) {
+    fprintf(stderr, "Failed to parse %s\n", path);
+    return false;
+  }
+
+  airspaces.Optimise();
+  airspaces.SetFlightLevels(AtmosphericPressure::Standard());
+  return true;
+}
+
+static void
+PrintWarnings(const AirspaceWarningManager &warnings, fixed time)
+{
+  TCHAR time_buffer[32];
+  FormatTime(time_buffer, time);
+
+  for (const auto &w : warnings)
+    _tprintf(_T("%s %u %s\n"), time_buffer, (unsigned)w.GetWarningState(),
+             w.GetAirspace().GetName());
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "AIRSPACES DRIVER FILE");
+  const char *airspace_path = args.ExpectNext();
+  DebugReplay *replay = CreateDebugReplay(args);
+  if (replay == NULL)
+    return EXIT_FAILURE;
+
+  args.ExpectEnd();
+
+  Airspaces airspaces;
+  if (!LoadAirspaces(airspace_path, airspaces))
+    return EXIT_FAILURE;
+
+  AirspaceWarningConfig config;
+  config.SetDefaults();
+
+  AirspaceWarningManager warnings(airspaces);
+  warnings.SetConfig(config);
+
+  const GlidePolar glide_polar(fixed(1));
+  TaskStats task_stats;
+  task_stats.reset();
+
+  bool reset = true;
+
+  while (replay->Next()) {
+    const MoreData &basic = replay->Basic();
+    if (!basic.location_available)
+      continue;
+
+    const DerivedInfo &calculated = replay->Calculated();
+    const AircraftState state = ToAircraftState(basic, calculated);
+
+    if (reset) {
+      warnings.Reset(state);
+      reset = false;
+    }
+
+    if (warnings.Update(state, glide_polar, task_stats,
+                        calculated.circling, 1))
+      PrintWarnings(warnings, basic.time);
+  }
+
+  delete replay;
+
+  const auto &statistics = warnings.GetStatistics();
+  printf("evaluated %u skipped %u queries %u\n",
+         statistics.evaluated, statistics.skipped, statistics.queries);
+
+  return EXIT_SUCCESS;
+}
@@ -53,9 +53,14 @@ int main(int argc, char **argv)
 
   GPSClock log_clock;
   while (replay->Next())
-    if (log_clock.CheckAdvance(replay->Basic().time, fixed(1)))
+    if (log_clock.CheckAdvance(replay->Basic().time, fixed(1))) {
       writer.LogPoint(replay->Basic());
 
+      /* the replay is much faster than real time; wait for each B
+         record to be written, or the queue would overflow */
+      writer.Flush();
+    }
+
   writer.Flush();
 
   delete replay;
@@ -30,6 +30,7 @@ Copyright_License {
 #include "Main.hpp"
 #include "MapWindow/MapWindow.hpp"
 #include "Terrain/RasterTerrain.hpp"
+#include "Terrain/Thread.hpp"
 #include "Profile/ProfileKeys.hpp"
 #include "Profile/ComputerProfile.hpp"
 #include "Profile/MapProfile.hpp"
@@ -83,6 +84,16 @@ public:
 };
 
 class TestMapWindow final : public MapWindow {
+  enum class Command {
+    INVALIDATE,
+  };
+
+  /**
+   * Loads terrain tiles in the background, just like in
+   * #GlueMapWindow.
+   */
+  TerrainThread *terrain_thread;
+
 public:
 #ifndef ENABLE_OPENGL
   bool initialised;
@@ -90,14 +101,63 @@ public:
 
   TestMapWindow(const MapLook &map_look,
              const TrafficLook &traffic_look)
-    :MapWindow(map_look, traffic_look)
+    :MapWindow(map_look, traffic_look),
+     terrain_thread(nullptr)
 #ifndef ENABLE_OPENGL
     , initialised(false)
 #endif
   {
   }
 
+  void SetTerrain(RasterTerrain *_terrain) {
+    if (terrain_thread != nullptr) {
+      terrain_thread->LockStop();
+      delete terrain_thread;
+      terrain_thread = nullptr;
+    }
+
+    MapWindow::SetTerrain(_terrain);
+
+    if (_terrain != nullptr)
+      terrain_thread =
+        new TerrainThread(*_terrain,
+                          [this](){
+                            SendUser(unsigned(Command::INVALIDATE));
+                          });
+  }
+
+  void UpdateScreenBounds() {
+    MapWindow::UpdateScreenBounds();
+
+    if (terrain_thread != nullptr)
+      terrain_thread->Trigger(visible_projection.GetGeoScreenCenter(),
+                              visible_projection.GetScreenWidthMeters() / 2);
+  }
+
   /* virtual methods from class Window */
+  void OnDestroy() override {
+    /* stop the TerrainThread */
+    SetTerrain(nullptr);
+
+    MapWindow::OnDestroy();
+  }
+
+  bool OnUser(unsigned id) override {
+    switch (Command(id)) {
+    case Command::INVALIDATE:
+#ifdef ENABLE_OPENGL
+      Invalidate();
+#else
+      if (initialised)
+        DrawThread::Draw(*this);
+#endif
+      return true;
+
+    default:
+      return MapWindow::OnUser(id);
+    }
+  }
+
   void OnResize(PixelSize new_size) override {
     MapWindow::OnResize(new_size);
 
@@ -115,11 +175,11 @@ LoadFiles(PlacesOfInterestSettings &poi_settings,
   NullOperationEnvironment operation;
 
   topography = new TopographyStore();
-  LoadConfiguredTopography(*topography, operation);
+  LoadConfiguredTopography(*topography, nullptr, operation);
 
   terrain = RasterTerrain::OpenTerrain(NULL, operation);
 
-  WaypointGlue::LoadWaypoints(way_points, terrain, operation);
+  WaypointGlue::LoadWaypoints(way_points, terrain, nullptr, operation);
   WaypointGlue::SetHome(way_points, terrain, poi_settings, team_code_settings,
                         NULL, false);
 
@@ -133,7 +193,7 @@ LoadFiles(PlacesOfInterestSettings &poi_settings,
 }
 
 static void
-GenerateBlackboard(MapWindow &map, const ComputerSettings &settings_computer,
+GenerateBlackboard(TestMapWindow &map, const ComputerSettings &settings_computer,
                    const MapSettings &settings_map)
 {
   MoreData nmea_info;
@@ -162,13 +222,6 @@ GenerateBlackboard(MapWindow &map, const ComputerSettings &settings_computer,
   derived_info.Reset();
   derived_info.terrain_valid = true;
 
-  if (terrain != NULL) {
-    RasterTerrain::UnprotectedLease lease(*terrain);
-    do {
-      lease->SetViewCenter(nmea_info.location, fixed(50000));
-    } while (lease->IsDirty());
-  }
-
   map.ReadBlackboard(nmea_info, derived_info, settings_computer,
                      settings_map);
   map.SetLocation(nmea_info.location);
@@ -97,13 +97,43 @@ Test2()
   ok1(!line.ReadChecked(temp_int) && temp_int == 42);
 }
 
+static void
+TestNumbers()
+{
+  CSVLine line("-12.25,+7,.5,1.,1e3,-,-40,DD8F12,0x1F,1234567890123,z");
+
+  double temp_double;
+  ok1(line.ReadChecked(temp_double) && temp_double == -12.25);
+  ok1(line.ReadChecked(temp_double) && temp_double == 7);
+  ok1(line.ReadChecked(temp_double) && temp_double == 0.5);
+  ok1(line.ReadChecked(temp_double) && temp_double == 1);
+
+  // exponents are left to strtod()
+  ok1(line.ReadChecked(temp_double) && temp_double == 1000);
+
+  ok1(!line.ReadChecked(temp_double) && temp_double == 1000);
+
+  int temp_int;
+  ok1(line.ReadChecked(temp_int) && temp_int == -40);
+
+  unsigned temp_unsigned;
+  ok1(line.ReadHexChecked(temp_unsigned) && temp_unsigned == 0xdd8f12);
+  ok1(line.ReadHexChecked(temp_unsigned) && temp_unsigned == 0x1f);
+
+  // too many digits for the fast path
+  ok1(line.ReadChecked(temp_double) && temp_double == 1234567890123.);
+
+  ok1(!line.ReadChecked(temp_int) && temp_int == -40);
+}
+
 int
 main(int argc, char **argv)
 {
-  plan_tests(19);
+  plan_tests(30);
 
   Test1();
   Test2();
+  TestNumbers();
 
   return exit_status();
 }
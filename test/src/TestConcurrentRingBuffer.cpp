@@ -0,0 +1,125 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Util/ConcurrentRingBuffer.hpp"
+#include "Thread/Thread.hpp"
+#include "OS/Sleep.h"
+#include "TestUtil.hpp"
+
+static constexpr unsigned N_PRODUCERS = 4;
+static constexpr unsigned N_VALUES = 10000;
+
+class Producer final : public Thread {
+  ConcurrentRingBuffer<unsigned> &queue;
+  const unsigned id;
+
+public:
+  Producer(ConcurrentRingBuffer<unsigned> &_queue, unsigned _id)
+    :queue(_queue), id(_id) {}
+
+protected:
+  void Run() override {
+    for (unsigned i = 0; i < N_VALUES; ++i) {
+      const unsigned value = i * N_PRODUCERS + id;
+      while (!queue.Push([value](unsigned &slot){ slot = value; }))
+        /* full: let the consumer run */
+        Sleep(0);
+    }
+  }
+};
+
+static void
+TestSingleThread()
+{
+  ConcurrentRingBuffer<unsigned> queue(4);
+  ok1(queue.GetCapacity() == 4);
+
+  unsigned value;
+  ok1(!queue.Pop([&value](unsigned &slot){ value = slot; }));
+
+  for (unsigned i = 1; i <= 4; ++i)
+    queue.Push([i](unsigned &slot){ slot = i; });
+  ok1(!queue.Push([](unsigned &slot){ slot = 5; }));
+
+  ok1(queue.Pop([&value](unsigned &slot){ value = slot; }));
+  ok1(value == 1);
+
+  /* wrap around */
+  ok1(queue.Push([](unsigned &slot){ slot = 5; }));
+  ok1(!queue.Push([](unsigned &slot){ slot = 6; }));
+
+  bool sorted = true;
+  for (unsigned i = 2; i <= 5; ++i)
+    sorted = queue.Pop([&value](unsigned &slot){ value = slot; }) &&
+      value == i && sorted;
+  ok1(sorted);
+  ok1(!queue.Pop([&value](unsigned &slot){ value = slot; }));
+}
+
+static void
+TestProducers()
+{
+  ConcurrentRingBuffer<unsigned> queue(64);
+
+  Producer *producers[N_PRODUCERS];
+  for (unsigned i = 0; i < N_PRODUCERS; ++i) {
+    producers[i] = new Producer(queue, i);
+    producers[i]->Start();
+  }
+
+  /* each producer's values must arrive complete and in order */
+  unsigned next[N_PRODUCERS] = {};
+  bool ordered = true;
+  for (unsigned n = 0; n < N_PRODUCERS * N_VALUES;) {
+    unsigned value;
+    if (!queue.Pop([&value](unsigned &slot){ value = slot; })) {
+      Sleep(0);
+      continue;
+    }
+
+    const unsigned id = value % N_PRODUCERS;
+    if (value / N_PRODUCERS != next[id])
+      ordered = false;
+    ++next[id];
+    ++n;
+  }
+
+  for (unsigned i = 0; i < N_PRODUCERS; ++i) {
+    producers[i]->Join();
+    delete producers[i];
+  }
+
+  ok1(ordered);
+
+  unsigned value;
+  ok1(!queue.Pop([&value](unsigned &slot){ value = slot; }));
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(11);
+
+  TestSingleThread();
+  TestProducers();
+
+  return exit_status();
+}
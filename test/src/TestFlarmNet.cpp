@@ -23,17 +23,17 @@
 #include "FLARM/FlarmNetDatabase.hpp"
 #include "FLARM/FlarmNetReader.hpp"
 #include "FLARM/FlarmNetRecord.hpp"
+#include "FLARM/FlarmNetCache.hpp"
 #include "FLARM/FlarmId.hpp"
+#include "IO/FileCache.hpp"
+#include "Util/StringAPI.hpp"
 #include "TestUtil.hpp"
 
-int main(int argc, char **argv)
-{
-  plan_tests(15);
-
-  FlarmNetDatabase db;
-  int count = FlarmNetReader::LoadFile(_T("test/data/flarmnet/data.fln"), db);
-  ok1(count == 6);
+static const TCHAR *const PATH = _T("test/data/flarmnet/data.fln");
 
+static void
+TestLookup(const FlarmNetDatabase &db)
+{
   FlarmId id = FlarmId::Parse("DDA85C", NULL);
 
   const FlarmNetRecord *record = db.FindRecordById(id);
@@ -47,6 +47,8 @@ int main(int argc, char **argv)
   ok1(StringIsEqual(record->callsign, _T("TH")));
   ok1(StringIsEqual(record->frequency, _T("130.625")));
 
+  ok1(db.FindRecordById(FlarmId::Parse("123456", NULL)) == NULL);
+
   const FlarmNetRecord *array[3];
   ok1(db.FindRecordsByCallSign(_T("TH"), array, 3) == 2);
 
@@ -61,6 +63,13 @@ int main(int argc, char **argv)
   ok1(found4449);
   ok1(found5799);
 
+  /* the array size is respected */
+  ok1(db.FindRecordsByCallSign(_T("TH"), array, 1) == 1);
+
+  record = db.FindFirstRecordByCallSign(_T("TH"));
+  ok1(record != NULL && record == db.FindRecordById(id));
+  ok1(db.FindFirstRecordByCallSign(_T("XX")) == NULL);
+
   FlarmId ids[3];
   ok1(db.FindIdsByCallSign(_T("TH"), ids, 3) == 2);
 
@@ -75,6 +84,37 @@ int main(int argc, char **argv)
   }
   ok1(foundDDA85C);
   ok1(foundDDA896);
+}
+
+static void
+TestCache(const FlarmNetDatabase &parsed)
+{
+  FileCache cache(_T("output/test/cache"));
+  cache.Flush(_T("flarmnet"));
+
+  ok1(FlarmNetCache::Save(cache, _T("flarmnet"), PATH, parsed));
+
+  FlarmNetDatabase db;
+  ok1(FlarmNetCache::Load(cache, _T("flarmnet"), PATH, db));
+  TestLookup(db);
+
+  /* the snapshot of another path is rejected, even if the file
+     looks the same */
+  ok1(!FlarmNetCache::Load(cache, _T("flarmnet"),
+                           _T("test/data/flarmnet/./data.fln"), db));
+  ok1(db.IsEmpty());
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(41);
+
+  FlarmNetDatabase db;
+  int count = FlarmNetReader::LoadFile(PATH, db);
+  ok1(count == 6);
+
+  TestLookup(db);
+  TestCache(db);
 
   return exit_status();
 }
@@ -143,7 +143,7 @@ Run(IGCWriter &writer)
   writer.LogPoint(i);
 
   writer.Flush();
-  writer.Sign();
+  ok1(writer.Sign());
 }
 
 static void
@@ -155,7 +155,7 @@ Run(const TCHAR *path)
 
 int main(int argc, char **argv)
 {
-  plan_tests(51);
+  plan_tests(52);
 
   const TCHAR *path = _T("output/test/test.igc");
   File::Delete(path);
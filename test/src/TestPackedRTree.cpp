@@ -0,0 +1,154 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Geo/Flat/PackedRTree.hpp"
+#include "TestUtil.hpp"
+
+#include <vector>
+#include <stdlib.h>
+
+struct Item : FlatBoundingBox {
+  unsigned id;
+
+  Item(FlatGeoPoint ll, FlatGeoPoint ur, unsigned _id)
+    :FlatBoundingBox(ll, ur), id(_id) {}
+
+  bool operator==(const Item &other) const {
+    return id == other.id;
+  }
+};
+
+typedef PackedRTree<Item> Tree;
+
+struct Counter {
+  unsigned n = 0;
+
+  void operator()(const Item &) {
+    ++n;
+  }
+};
+
+struct IsEven {
+  bool operator()(const Item &item) const {
+    return item.id % 2 == 0;
+  }
+};
+
+static FlatGeoPoint
+RandomPoint()
+{
+  return FlatGeoPoint(rand() % 100000, rand() % 100000);
+}
+
+static Item
+RandomItem(unsigned id)
+{
+  const FlatGeoPoint ll = RandomPoint();
+  const FlatGeoPoint ur(ll.longitude + rand() % 2000,
+                        ll.latitude + rand() % 2000);
+  return Item(ll, ur, id);
+}
+
+/**
+ * Compare VisitWithinRange() and FindNearestIf() with a linear scan
+ * at random locations.
+ */
+static bool
+CheckQueries(const Tree &tree, const std::vector<Item> &items)
+{
+  for (unsigned i = 0; i < 200; ++i) {
+    const FlatBoundingBox box(RandomPoint());
+    const unsigned range = rand() % 5000;
+
+    const FlatBoundingBox expanded(FlatGeoPoint(box.GetLowerLeft().longitude - range,
+                                                box.GetLowerLeft().latitude - range),
+                                   FlatGeoPoint(box.GetUpperRight().longitude + range,
+                                                box.GetUpperRight().latitude + range));
+
+    unsigned expected = 0, nearest = range + 1;
+    for (const auto &item : items) {
+      if (item.Overlaps(expanded))
+        ++expected;
+
+      if (IsEven()(item))
+        nearest = std::min(nearest, item.Distance(box));
+    }
+
+    Counter counter;
+    tree.VisitWithinRange(box, range, counter);
+    if (counter.n != expected)
+      return false;
+
+    const auto found = tree.FindNearestIf(box, range, IsEven());
+    if (nearest > range) {
+      if (found.first != tree.end())
+        return false;
+    } else if (found.first == tree.end() || found.second != nearest ||
+               !IsEven()(*found.first))
+      return false;
+  }
+
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(9);
+
+  Tree tree;
+  ok1(tree.IsEmpty());
+
+  Counter counter;
+  tree.VisitWithinRange(FlatBoundingBox(FlatGeoPoint(0, 0)), 1000, counter);
+  ok1(counter.n == 0);
+
+  srand(1);
+  std::vector<Item> items;
+  for (unsigned i = 0; i < 1000; ++i) {
+    items.push_back(RandomItem(i));
+    tree.insert(items.back());
+  }
+
+  /* not indexed yet */
+  ok1(!tree.IsOptimised());
+  ok1(CheckQueries(tree, items));
+
+  tree.Optimise();
+  ok1(tree.IsOptimised());
+  ok1(tree.size() == items.size());
+  ok1(CheckQueries(tree, items));
+
+  /* partially indexed */
+  for (unsigned i = 1000; i < 1100; ++i) {
+    items.push_back(RandomItem(i));
+    tree.insert(items.back());
+  }
+
+  ok1(CheckQueries(tree, items));
+
+  tree.erase(items[500]);
+  items.erase(items.begin() + 500);
+  tree.Optimise();
+  ok1(CheckQueries(tree, items));
+
+  return exit_status();
+}
@@ -0,0 +1,102 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Job/Parallel.hpp"
+#include "Job/Job.hpp"
+#include "OS/Sleep.h"
+#include "TestUtil.hpp"
+
+#include <atomic>
+
+static std::atomic<unsigned> sequence;
+
+struct TestJob : Job {
+  unsigned delay;
+  unsigned started, finished;
+
+  explicit TestJob(unsigned _delay):delay(_delay), started(0), finished(0) {}
+
+  void Run(OperationEnvironment &env) override {
+    started = ++sequence;
+
+    env.SetText(_T("Test"));
+    env.SetProgressRange(10);
+    for (unsigned i = 0; i < 10; ++i) {
+      Sleep(delay);
+      env.SetProgressPosition(i);
+    }
+
+    finished = ++sequence;
+  }
+
+  bool IsDone() const {
+    return finished > 0;
+  }
+
+  bool IsBefore(const TestJob &other) const {
+    return finished < other.started;
+  }
+};
+
+class RecordingOperationEnvironment : public QuietOperationEnvironment {
+public:
+  unsigned range = 0, position = 0;
+
+  void SetProgressRange(unsigned _range) override {
+    range = _range;
+  }
+
+  void SetProgressPosition(unsigned _position) override {
+    if (_position > range || _position < position)
+      /* out of range or going backwards */
+      range = 0;
+
+    position = _position;
+  }
+};
+
+int main(int argc, char **argv)
+{
+  plan_tests(7);
+
+  TestJob a(5), b(1), c(2), d(1), e(3);
+
+  ParallelJobRunner runner;
+  const unsigned ia = runner.Add(a);
+  const unsigned ib = runner.Add(b);
+  const unsigned ic = runner.Add(c, {ia});
+  runner.Add(d, {ia, ib});
+  runner.Add(e, {ic});
+
+  RecordingOperationEnvironment env;
+  runner.Run(env, 2);
+
+  ok1(a.IsDone() && b.IsDone() && c.IsDone() && d.IsDone() && e.IsDone());
+  ok1(a.IsBefore(c));
+  ok1(a.IsBefore(d));
+  ok1(b.IsBefore(d));
+  ok1(c.IsBefore(e));
+  ok1(env.range == 500);
+  ok1(env.position == env.range);
+
+  return exit_status();
+}
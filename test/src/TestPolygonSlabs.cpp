@@ -0,0 +1,134 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "Geo/PolygonSlabs.hpp"
+#include "Geo/ConvexHull/PolygonInterior.hpp"
+#include "Geo/SearchPointVector.hpp"
+#include "TestUtil.hpp"
+
+#include <vector>
+#include <stdlib.h>
+
+static fixed
+RandomFraction()
+{
+  return fixed(rand() % 10000) / 10000;
+}
+
+static GeoPoint
+RandomLocation()
+{
+  return GeoPoint(Angle::Degrees(7 + RandomFraction() * 2),
+                  Angle::Degrees(51 + RandomFraction() * 2));
+}
+
+/**
+ * Generate a star-shaped polygon with many jagged edges.
+ */
+static SearchPointVector
+RandomPolygon(unsigned n)
+{
+  SearchPointVector polygon;
+  for (unsigned i = 0; i < n; ++i) {
+    const Angle a = Angle::FullCircle() * i / n;
+    const fixed r = fixed(0.2) + RandomFraction() * fixed(0.8);
+    polygon.emplace_back(GeoPoint(Angle::Degrees(8 + r * a.cos()),
+                                  Angle::Degrees(52 + r * a.sin())));
+  }
+
+  polygon.push_back(polygon.front());
+  return polygon;
+}
+
+static bool
+CheckInside(const SearchPointVector &polygon, const PolygonSlabs &slabs)
+{
+  for (unsigned i = 0; i < 2000; ++i) {
+    const GeoPoint p = RandomLocation();
+    if (slabs.IsInside(polygon, p) != PolygonInterior(p, polygon.begin(),
+                                                      polygon.end()))
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Check that VisitEdges() visits each edge overlapping the latitude
+ * range exactly once.
+ */
+static bool
+CheckVisitEdges(const SearchPointVector &polygon, const PolygonSlabs &slabs)
+{
+  const unsigned n_edges = polygon.size() - 1;
+
+  for (unsigned i = 0; i < 200; ++i) {
+    const Angle a = RandomLocation().latitude;
+    const Angle b = RandomLocation().latitude;
+
+    std::vector<unsigned> count(n_edges, 0);
+    slabs.VisitEdges(a, b, [&count](unsigned edge){
+        ++count[edge];
+      });
+
+    for (unsigned edge = 0; edge < n_edges; ++edge) {
+      if (count[edge] > 1)
+        return false;
+
+      const Angle lat1 = polygon[edge].GetLocation().latitude;
+      const Angle lat2 = polygon[edge + 1].GetLocation().latitude;
+      const bool overlaps = std::max(lat1, lat2) >= std::min(a, b) &&
+        std::min(lat1, lat2) <= std::max(a, b);
+      if (overlaps && count[edge] == 0)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(7);
+
+  PolygonSlabs slabs;
+  ok1(!slabs.IsDefined());
+
+  srand(1);
+  const SearchPointVector polygon = RandomPolygon(500);
+
+  slabs.Build(polygon, 4);
+  ok1(slabs.IsDefined());
+  ok1(CheckInside(polygon, slabs));
+  ok1(CheckVisitEdges(polygon, slabs));
+
+  /* a single slab */
+  slabs.Build(polygon, 10000);
+  ok1(CheckInside(polygon, slabs));
+  ok1(CheckVisitEdges(polygon, slabs));
+
+  slabs.Clear();
+  ok1(!slabs.IsDefined());
+
+  return exit_status();
+}
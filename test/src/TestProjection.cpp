@@ -46,12 +46,73 @@ test_simple()
                                     Angle::Zero()), 0, 0);
 }
 
+/**
+ * Check that the batch GeoToScreen() gives the same results as the
+ * scalar one.
+ */
+static void
+TestBatch(const GeoPoint &location, Angle screen_angle)
+{
+  Projection prj;
+  prj.SetScreenOrigin(160, 120);
+  prj.SetScale(fixed(0.01));
+  prj.SetGeoLocation(location);
+  prj.SetScreenAngle(screen_angle);
+
+  /* an odd number, to cover the scalar remainder */
+  constexpr unsigned n = 99;
+  GeoPoint points[n];
+  for (unsigned i = 0; i < n; ++i) {
+    const Angle angle = Angle::Degrees(i * 11.7);
+    const fixed radius = fixed(0.05) * i;
+    points[i] = GeoPoint(location.longitude +
+                         Angle::Degrees(radius * angle.cos()),
+                         location.latitude +
+                         Angle::Degrees(radius * angle.sin()));
+    points[i].Normalize();
+  }
+
+  RasterPoint batch[n];
+  prj.GeoToScreen(points, batch, n);
+
+  bool equal = true;
+  for (unsigned i = 0; i < n; ++i) {
+    const RasterPoint scalar = prj.GeoToScreen(points[i]);
+    if (scalar.x != batch[i].x || scalar.y != batch[i].y)
+      equal = false;
+  }
+
+  ok1(equal);
+}
+
+static void
+TestBatch()
+{
+  TestBatch(GeoPoint(Angle::Degrees(7.7), Angle::Degrees(51.05)),
+            Angle::Zero());
+  TestBatch(GeoPoint(Angle::Degrees(7.7), Angle::Degrees(51.05)),
+            Angle::Degrees(123));
+  TestBatch(GeoPoint(Angle::Degrees(-71.5), Angle::Degrees(-33.4)),
+            Angle::Degrees(-45));
+
+  /* across the date line */
+  TestBatch(GeoPoint(Angle::Degrees(179.9), Angle::Degrees(-40)),
+            Angle::Degrees(270));
+  TestBatch(GeoPoint(Angle::Degrees(-179.9), Angle::Degrees(10)),
+            Angle::Degrees(10));
+
+  /* close to the pole */
+  TestBatch(GeoPoint(Angle::Degrees(20), Angle::Degrees(88)),
+            Angle::Degrees(200));
+}
+
 int
 main(int argc, char **argv)
 {
-  plan_tests(4);
+  plan_tests(10);
 
   test_simple();
+  TestBatch();
 
   return exit_status();
 }
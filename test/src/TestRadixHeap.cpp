@@ -0,0 +1,188 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Util/RadixHeap.hpp"
+#include "TestUtil.hpp"
+
+#include <queue>
+#include <functional>
+#include <utility>
+#include <stdlib.h>
+
+struct Identity {
+  unsigned operator()(unsigned x) const {
+    return x;
+  }
+};
+
+typedef RadixHeap<unsigned, Identity> Heap;
+
+/**
+ * A key and the sequence number of its push() call.
+ */
+typedef std::pair<unsigned, unsigned> Item;
+
+struct GetItemKey {
+  unsigned operator()(const Item &item) const {
+    return item.first;
+  }
+};
+
+typedef RadixHeap<Item, GetItemKey> ItemHeap;
+
+/**
+ * Pop all elements, and check that they come out sorted by key, and
+ * elements with the same key in the order they were pushed.
+ */
+static bool
+PopAll(ItemHeap &heap, std::priority_queue<Item, std::vector<Item>,
+                                           std::greater<Item>> &reference)
+{
+  while (!heap.empty()) {
+    if (reference.empty() || heap.top() != reference.top())
+      return false;
+
+    heap.pop();
+    reference.pop();
+  }
+
+  return reference.empty();
+}
+
+/**
+ * Pop all elements, and check that they come out in ascending order.
+ */
+static bool
+PopAll(Heap &heap, std::priority_queue<unsigned, std::vector<unsigned>,
+                                       std::greater<unsigned>> &reference)
+{
+  while (!heap.empty()) {
+    if (reference.empty() || heap.top() != reference.top())
+      return false;
+
+    heap.pop();
+    reference.pop();
+  }
+
+  return reference.empty();
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(14);
+
+  Heap heap;
+  ok1(heap.empty());
+
+  heap.push(7);
+  heap.push(3);
+  heap.push(3);
+  heap.push(0xffffffff);
+  ok1(heap.size() == 4);
+  ok1(heap.top() == 3);
+  heap.pop();
+  ok1(heap.top() == 3);
+  heap.pop();
+  ok1(heap.top() == 7);
+
+  /* push a key below the last one popped */
+  heap.push(1);
+  ok1(heap.top() == 1);
+  heap.pop();
+  ok1(heap.top() == 7);
+  heap.pop();
+  ok1(heap.top() == 0xffffffff);
+  heap.pop();
+  ok1(heap.empty());
+
+  std::priority_queue<unsigned, std::vector<unsigned>,
+                      std::greater<unsigned>> reference;
+
+  /* monotone use, like Dijkstra's algorithm */
+  srand(1);
+  for (unsigned i = 0; i < 1000; ++i) {
+    const unsigned value = 100000 + rand() % 100000;
+    heap.push(value);
+    reference.push(value);
+  }
+
+  bool monotone = true;
+  for (unsigned i = 0; i < 500; ++i) {
+    const unsigned last = heap.top();
+    monotone = monotone && last == reference.top();
+    heap.pop();
+    reference.pop();
+
+    for (unsigned j = 0; j < 2; ++j) {
+      const unsigned value = last + rand() % 1000;
+      heap.push(value);
+      reference.push(value);
+    }
+  }
+
+  ok1(monotone);
+
+  /* push keys below the last one popped */
+  for (unsigned i = 0; i < 100; ++i) {
+    const unsigned value = rand() % 200000;
+    heap.push(value);
+    reference.push(value);
+  }
+
+  ok1(PopAll(heap, reference));
+
+  heap.push(5);
+  heap.clear();
+  ok1(heap.empty());
+
+  /* ties are resolved in push order, even when elements are moved
+     between buckets */
+  ItemHeap item_heap;
+  std::priority_queue<Item, std::vector<Item>,
+                      std::greater<Item>> item_reference;
+  unsigned sequence = 0;
+
+  for (unsigned i = 0; i < 1000; ++i) {
+    const Item item(1000 + rand() % 100, sequence++);
+    item_heap.push(item);
+    item_reference.push(item);
+  }
+
+  bool ordered = true;
+  for (unsigned i = 0; i < 500; ++i) {
+    const unsigned last = item_heap.top().first;
+    ordered = ordered && item_heap.top() == item_reference.top();
+    item_heap.pop();
+    item_reference.pop();
+
+    /* mostly monotone, sometimes below the last key popped */
+    const Item item(i % 50 == 0 ? last - rand() % 100 : last + rand() % 8,
+                    sequence++);
+    item_heap.push(item);
+    item_reference.push(item);
+  }
+
+  ok1(ordered);
+  ok1(PopAll(item_heap, item_reference));
+
+  return exit_status();
+}
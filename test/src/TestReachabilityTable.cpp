@@ -0,0 +1,182 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Task/ReachabilityTable.hpp"
+#include "Task/RoutePlannerGlue.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Route/Config.hpp"
+#include "GlideSolvers/GlideSettings.hpp"
+#include "GlideSolvers/GlidePolar.hpp"
+#include "Geo/GeoVector.hpp"
+#include "TestUtil.hpp"
+
+/**
+ * The base values are chosen so the differences at each threshold
+ * are exact in floating point.
+ */
+static ReachabilityParameters
+MakeParameters()
+{
+  return ReachabilityParameters{
+    fixed(0), fixed(1), fixed(0),
+    SpeedVector(Angle::Zero(), fixed(5)),
+    fixed(300),
+  };
+}
+
+static void
+TestParameters()
+{
+  const ReachabilityParameters a = MakeParameters();
+  ok1(a.IsCloseTo(a));
+
+  ReachabilityParameters b = a;
+  b.mc = fixed(0.09);
+  ok1(a.IsCloseTo(b));
+  b.mc = fixed(0.1);
+  ok1(!a.IsCloseTo(b));
+  b.mc = fixed(0.2);
+  ok1(!a.IsCloseTo(b));
+
+  b = a;
+  b.bugs = fixed(0.991);
+  ok1(a.IsCloseTo(b));
+  b.bugs = fixed(0.99);
+  ok1(!a.IsCloseTo(b));
+  b.bugs = fixed(0.9);
+  ok1(!a.IsCloseTo(b));
+
+  b = a;
+  b.ballast = fixed(0.009);
+  ok1(a.IsCloseTo(b));
+  b.ballast = fixed(0.01);
+  ok1(!a.IsCloseTo(b));
+  b.ballast = fixed(0.1);
+  ok1(!a.IsCloseTo(b));
+
+  /* the wind is compared as a vector: speed and direction */
+  b = a;
+  b.wind.norm = fixed(5.9);
+  ok1(a.IsCloseTo(b));
+  b.wind.norm = fixed(6);
+  ok1(!a.IsCloseTo(b));
+  b.wind.norm = fixed(4);
+  ok1(!a.IsCloseTo(b));
+  b.wind.norm = fixed(7);
+  ok1(!a.IsCloseTo(b));
+
+  b = a;
+  b.wind.bearing = Angle::Degrees(10);
+  ok1(a.IsCloseTo(b));
+  b.wind.bearing = Angle::Degrees(180);
+  ok1(!a.IsCloseTo(b));
+
+  b = a;
+  b.safety_height_arrival = fixed(301);
+  ok1(!a.IsCloseTo(b));
+  ok1(!b.IsCloseTo(a));
+}
+
+static unsigned
+AddWaypoint(Waypoints &waypoints, const GeoPoint &origin,
+            fixed distance, Waypoint::Type type, int file_num=-1)
+{
+  Waypoint wp(GeoVector(distance, Angle::Degrees(45)).EndPoint(origin));
+  wp.type = type;
+  wp.elevation = fixed(0);
+  wp.file_num = file_num;
+  return waypoints.Append(std::move(wp)).id;
+}
+
+static void
+TestTable()
+{
+  ReachabilityTable table;
+  ok1(table.Find(1) == nullptr);
+
+  const GeoPoint location(Angle::Degrees(7), Angle::Degrees(51));
+
+  Waypoints waypoints;
+  const unsigned near_airfield =
+    AddWaypoint(waypoints, location, fixed(5000), Waypoint::Type::AIRFIELD);
+  const unsigned far_airfield =
+    AddWaypoint(waypoints, location, fixed(500000), Waypoint::Type::AIRFIELD);
+  const unsigned turnpoint =
+    AddWaypoint(waypoints, location, fixed(6000), Waypoint::Type::NORMAL);
+  const unsigned watched =
+    AddWaypoint(waypoints, location, fixed(7000), Waypoint::Type::NORMAL, 3);
+  waypoints.Optimise();
+
+  GlideSettings settings;
+  settings.SetDefaults();
+  const GlidePolar polar(fixed(1));
+
+  RoutePlannerConfig config;
+  config.SetDefaults();
+
+  RoutePlannerGlue route_planner;
+  route_planner.UpdatePolar(settings, polar, polar, SpeedVector::Zero());
+
+  const AGeoPoint origin(location, RoughAltitude(1000));
+  route_planner.SolveReach(origin, config, RoughAltitude::Max(), true);
+
+  table.Calculate(route_planner, waypoints, origin, fixed(0));
+
+  ok1(table.IsValid(route_planner.GetReachSerial(), waypoints.GetSerial()));
+
+  const ReachResult *reach = table.Find(near_airfield);
+  ok1(reach != nullptr);
+  ok1(reach != nullptr && reach->IsReachableDirect());
+
+  ok1(table.Find(watched) != nullptr);
+
+  /* not landable and not watched */
+  ok1(table.Find(turnpoint) == nullptr);
+
+  /* out of range */
+  ok1(table.Find(far_airfield) == nullptr);
+
+  /* unknown */
+  ok1(table.Find(0) == nullptr);
+  ok1(table.Find(far_airfield + 100) == nullptr);
+
+  /* a new reach fan invalidates the table */
+  Serial reach_serial = route_planner.GetReachSerial();
+  route_planner.ClearReach();
+  ok1(!table.IsValid(route_planner.GetReachSerial(), waypoints.GetSerial()));
+  ok1(table.IsValid(reach_serial, waypoints.GetSerial()));
+
+  /* so does a modified waypoint database */
+  AddWaypoint(waypoints, location, fixed(8000), Waypoint::Type::AIRFIELD);
+  waypoints.Optimise();
+  ok1(!table.IsValid(reach_serial, waypoints.GetSerial()));
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(30);
+
+  TestParameters();
+  TestTable();
+
+  return exit_status();
+}
@@ -0,0 +1,110 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Terrain/SlopeShading.hpp"
+#include "TestUtil.hpp"
+
+#include <stdlib.h>
+
+static constexpr unsigned WIDTH = 300;
+static constexpr unsigned HEIGHT = 60;
+
+static short heights[WIDTH * HEIGHT];
+
+static void
+FillHeights(int range)
+{
+  for (unsigned i = 0; i < WIDTH * HEIGHT; ++i) {
+    int h = rand() % (2 * range + 1) - range;
+    if (rand() % 50 == 0)
+      /* extreme values to check the clipping */
+      h = rand() % 2 ? 32767 : -32767;
+    heights[i] = (short)h;
+  }
+}
+
+/**
+ * Compare SlopeShadingRow() with the portable implementation.
+ */
+static bool
+TestRow(unsigned q, unsigned row_minus, unsigned row_plus,
+        const SlopeShadingParameters &params)
+{
+  const short *src = heights + (HEIGHT / 2) * WIDTH + q;
+  const unsigned n = WIDTH - 2 * q;
+
+  int expected[WIDTH], actual[WIDTH];
+  SlopeShadingRowPortable(src, n, q, row_minus * WIDTH, row_plus * WIDTH,
+                          params, expected);
+  SlopeShadingRow(src, n, q, row_minus * WIDTH, row_plus * WIDTH,
+                  params, actual);
+
+  for (unsigned i = 0; i < n; ++i)
+    if (actual[i] != expected[i] ||
+        actual[i] < -63 || actual[i] > 63)
+      return false;
+
+  return true;
+}
+
+static void
+TestQuantisation(unsigned q)
+{
+  bool success = true;
+
+  for (unsigned i = 0; i < 64; ++i) {
+    FillHeights(i % 2 ? 100 : 1000);
+
+    const int sx = rand() % 511 - 255;
+    const int sy = rand() % 511 - 255;
+    const int sz = rand() % 256;
+    const int contrast = rand() % 256;
+
+    const unsigned max_factor = 8192 / (q * q);
+    const unsigned height_slope_factor =
+      i % 4 == 0 ? max_factor : 1 + rand() % max_factor;
+
+    const unsigned row_minus = 1 + rand() % q, row_plus = q;
+    const SlopeShadingParameters params = {
+      sx, sy, sz, contrast, height_slope_factor, row_minus + row_plus,
+    };
+
+    success = success && TestRow(q, row_minus, row_plus, params);
+  }
+
+  ok(success, "quantisation %u", q);
+}
+
+int main(int argc, char **argv)
+{
+  static constexpr unsigned quantisations[] = { 1, 2, 3, 5, 8, 13, 25 };
+
+  plan_tests(sizeof(quantisations) / sizeof(quantisations[0]));
+
+  srand(42);
+
+  for (auto q : quantisations)
+    TestQuantisation(q);
+
+  return exit_status();
+}
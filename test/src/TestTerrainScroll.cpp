@@ -0,0 +1,299 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2015 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * This program verifies that scrolling the #HeightMatrix and filling
+ * only the exposed strips gives the same result as filling the whole
+ * matrix at the new position, both for the matrix itself and for the
+ * image generated by #RasterRenderer.
+ */
+
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/HeightMatrix.hpp"
+#include "Terrain/RasterRenderer.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "Screen/RawBitmap.hpp"
+#include "Screen/Ramp.hpp"
+#include "Screen/Layout.hpp"
+#include "OS/Args.hpp"
+#include "OS/PathName.hpp"
+#include "Compatibility/path.h"
+#include "Operation/Operation.hpp"
+#include "Util/Macros.hpp"
+#include "TestUtil.hpp"
+
+#ifdef ENABLE_OPENGL
+#include "Geo/GeoBounds.hpp"
+#endif
+
+#include <algorithm>
+#include <vector>
+
+#include <stdio.h>
+#include <string.h>
+#include <tchar.h>
+
+unsigned Layout::scale = 1;
+unsigned Layout::scale_1024 = 1024;
+
+static constexpr unsigned SCREEN_WIDTH = 640, SCREEN_HEIGHT = 480;
+
+/**
+ * The quantisation of the #HeightMatrix tests.
+ */
+static constexpr unsigned Q = 2;
+
+struct Shift {
+  int dx, dy;
+};
+
+static bool
+Equals(const HeightMatrix &a, const HeightMatrix &b)
+{
+  return a.GetWidth() == b.GetWidth() && a.GetHeight() == b.GetHeight() &&
+    std::equal(a.GetData(), a.GetDataEnd(), b.GetData());
+}
+
+/**
+ * Call #fill for the strips exposed by HeightMatrix::Scroll(dx, dy),
+ * just like RasterRenderer does.
+ */
+template<typename F>
+static void
+FillExposed(unsigned width, unsigned height, int dx, int dy, F &&fill)
+{
+  unsigned y0 = 0, y1 = height;
+
+  if (dy > 0) {
+    y1 = height - dy;
+    fill(0, y1, width, height);
+  } else if (dy < 0) {
+    y0 = -dy;
+    fill(0, 0, width, y0);
+  }
+
+  if (dx > 0)
+    fill(width - dx, y0, width, y1);
+  else if (dx < 0)
+    fill(0, y0, -dx, y1);
+}
+
+static WindowProjection
+MakeProjection(const GeoPoint &center)
+{
+  WindowProjection projection;
+  projection.SetScreenSize({SCREEN_WIDTH, SCREEN_HEIGHT});
+  projection.SetScaleFromRadius(fixed(50000));
+  projection.SetGeoLocation(center);
+  projection.SetScreenOrigin(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+  projection.UpdateScreenBounds();
+  return projection;
+}
+
+#ifdef ENABLE_OPENGL
+
+static bool
+TestScroll(const RasterMap &map, const GeoBounds &bounds,
+           unsigned width, unsigned height, Shift shift)
+{
+  HeightMatrix scrolled;
+  scrolled.Fill(map, bounds, width, height, true);
+  scrolled.Scroll(shift.dx, shift.dy);
+  FillExposed(width, height, shift.dx, shift.dy,
+              [&](unsigned x0, unsigned y0, unsigned x1, unsigned y1){
+                scrolled.FillRect(map, bounds, shift.dx, shift.dy,
+                                  x0, y0, x1, y1, true);
+              });
+
+  HeightMatrix full;
+  full.Fill(map, bounds, width, height, true);
+  full.FillRect(map, bounds, shift.dx, shift.dy, 0, 0, width, height, true);
+
+  return Equals(scrolled, full);
+}
+
+#else
+
+static bool
+TestScroll(const RasterMap &map, const WindowProjection &projection,
+           Shift shift)
+{
+  HeightMatrix scrolled;
+  scrolled.Fill(map, projection, Q, true);
+  const unsigned width = scrolled.GetWidth(), height = scrolled.GetHeight();
+
+  scrolled.Scroll(shift.dx, shift.dy);
+  FillExposed(width, height, shift.dx, shift.dy,
+              [&](unsigned x0, unsigned y0, unsigned x1, unsigned y1){
+                scrolled.FillRect(map, projection, Q, shift.dx, shift.dy,
+                                  x0, y0, x1, y1, true);
+              });
+
+  HeightMatrix full;
+  full.Fill(map, projection, Q, true);
+  full.FillRect(map, projection, Q, shift.dx, shift.dy,
+                0, 0, width, height, true);
+
+  return Equals(scrolled, full);
+}
+
+#endif
+
+static std::vector<BGRColor>
+CopyImage(const RawBitmap &bitmap, unsigned width, unsigned height)
+{
+  std::vector<BGRColor> pixels;
+  pixels.reserve(width * height);
+
+  const BGRColor *row = bitmap.GetTopRow();
+  for (unsigned y = 0; y < height; ++y, row = bitmap.GetNextRow(row))
+    pixels.insert(pixels.end(), row, row + width);
+
+  return pixels;
+}
+
+static bool
+Equals(const std::vector<BGRColor> &a, const std::vector<BGRColor> &b)
+{
+  return a.size() == b.size() &&
+    memcmp(a.data(), b.data(), a.size() * sizeof(a.front())) == 0;
+}
+
+static std::vector<BGRColor>
+CopyImage(const RasterRenderer &renderer)
+{
+  return CopyImage(renderer.GetImage(),
+                   renderer.GetWidth(), renderer.GetHeight());
+}
+
+static void
+GenerateImage(RasterRenderer &renderer, int brightness)
+{
+  renderer.GenerateImage(true, 4, 64, brightness, Angle::Degrees(-45), false);
+}
+
+/**
+ * Pan the #RasterRenderer by the specified number of pixels, and
+ * check whether the partially redrawn image equals a complete redraw
+ * of the scrolled #HeightMatrix.
+ */
+static bool
+TestRenderer(const RasterMap &map, const WindowProjection &projection,
+             Shift shift)
+{
+  RasterRenderer renderer;
+
+  renderer.ScanMap(map, projection);
+  GenerateImage(renderer, 32);
+
+  WindowProjection new_projection = projection;
+  new_projection.SetGeoLocation(projection.ScreenToGeo(SCREEN_WIDTH / 2 +
+                                                       shift.dx,
+                                                       SCREEN_HEIGHT / 2 +
+                                                       shift.dy));
+  new_projection.UpdateScreenBounds();
+
+  renderer.ScanMap(map, new_projection);
+  GenerateImage(renderer, 32);
+  const auto scrolled = CopyImage(renderer);
+
+  /* different parameters force a complete redraw of the same
+     matrix */
+  GenerateImage(renderer, 0);
+  GenerateImage(renderer, 32);
+  const auto full = CopyImage(renderer);
+
+  return Equals(scrolled, full);
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "PATH");
+  const tstring map_path = args.ExpectNextT();
+  args.ExpectEnd();
+
+  TCHAR jp2_path[4096];
+  _tcscpy(jp2_path, map_path.c_str());
+  _tcscat(jp2_path, _T(DIR_SEPARATOR_S) _T("terrain.jp2"));
+
+  TCHAR j2w_path[4096];
+  _tcscpy(j2w_path, map_path.c_str());
+  _tcscat(j2w_path, _T(DIR_SEPARATOR_S) _T("terrain.j2w"));
+
+  NullOperationEnvironment operation;
+  RasterMap map(jp2_path, j2w_path, NULL, operation);
+  if (!map.IsDefined()) {
+    fprintf(stderr, "failed to load map\n");
+    return EXIT_FAILURE;
+  }
+
+  do {
+    map.SetViewCenter(map.GetMapCenter(), fixed(100000));
+  } while (map.IsDirty());
+
+  const WindowProjection projection = MakeProjection(map.GetMapCenter());
+
+#ifdef ENABLE_OPENGL
+  const GeoBounds bounds = projection.GetScreenBounds().Scale(fixed(1.5));
+  const int width = SCREEN_WIDTH / Q, height = SCREEN_HEIGHT / Q;
+#else
+  HeightMatrix dummy;
+  dummy.SetScreenSize(SCREEN_WIDTH, SCREEN_HEIGHT, Q);
+  const int width = dummy.GetWidth(), height = dummy.GetHeight();
+#endif
+
+  /* cell shifts, including the largest ones Scroll() allows */
+  const Shift shifts[] = {
+    { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+    { 3, -2 }, { -5, 7 }, { 17, 11 }, { -23, -19 },
+    { width - 1, 0 }, { -(width - 1), 0 },
+    { 0, height - 1 }, { 0, -(height - 1) },
+    { width - 1, height - 1 }, { -(width - 1), -(height - 1) },
+    { width - 1, -(height - 1) }, { -(width - 1), height - 1 },
+  };
+
+  /* pixel shifts which the renderer can handle by scrolling */
+  const Shift pans[] = {
+    { 5, 0 }, { 0, -6 }, { -37, 23 }, { 64, 48 }, { -100, -75 },
+  };
+
+  plan_tests(ARRAY_SIZE(shifts) + ARRAY_SIZE(pans));
+
+  for (const Shift &shift : shifts) {
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Scroll(%d, %d)", shift.dx, shift.dy);
+#ifdef ENABLE_OPENGL
+    ok(TestScroll(map, bounds, width, height, shift), msg, 0);
+#else
+    ok(TestScroll(map, projection, shift), msg, 0);
+#endif
+  }
+
+  for (const Shift &pan : pans) {
+    char msg[64];
+    snprintf(msg, sizeof(msg), "pan (%d, %d)", pan.dx, pan.dy);
+    ok(TestRenderer(map, projection, pan), msg, 0);
+  }
+
+  return exit_status();
+}
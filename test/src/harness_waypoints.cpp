@@ -100,3 +100,20 @@ bool SetupWaypoints(Waypoints &waypoints, const unsigned n)
   return true;
 }
 
+
+void
+SetupLandables(Waypoints &waypoints, unsigned n)
+{
+  for (unsigned i = 0; i < n; i++) {
+    int x = rand() % 2000 - 1000;
+    int y = rand() % 2000 - 1000;
+    Waypoint wp = waypoints.Create(GeoPoint(Angle::Degrees(x / 1000.0),
+                                            Angle::Degrees(y / 1000.0)));
+    wp.type = i % 4 == 0
+      ? Waypoint::Type::AIRFIELD
+      : Waypoint::Type::OUTLANDING;
+    wp.elevation = fixed(rand() % 500);
+    waypoints.Append(std::move(wp));
+  }
+  waypoints.Optimise();
+}
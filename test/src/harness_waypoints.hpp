@@ -29,4 +29,10 @@ class Waypoints;
 const Waypoint* lookup_waypoint(const Waypoints& waypoints, unsigned id);
 bool SetupWaypoints(Waypoints &waypoints, const unsigned n=150);
 
+/**
+ * Fills the waypoint database with n randomly placed landables
+ * (a quarter of them airfields) within one degree of the origin.
+ */
+void SetupLandables(Waypoints &waypoints, unsigned n);
+
 #endif